@@ -610,16 +610,39 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
     }
 
     const { encoding } = options;
+    logASARAccess(asarPath, filePath, info.offset);
+
+    // Serve the content straight from the archive mapping when possible.
+    if (encoding === 'utf8' || encoding === 'utf-8') {
+      const str = archive.readFileString(filePath);
+      if (str !== false) return str;
+    } else {
+      const mapped = archive.readFile(filePath);
+      if (mapped) return (encoding) ? mapped.toString(encoding) : mapped;
+    }
+
     const buffer = Buffer.alloc(info.size);
     const fd = archive.getFdAndValidateIntegrityLater();
     if (!(fd >= 0)) throw createError(AsarError.NOT_FOUND, { asarPath, filePath });
 
-    logASARAccess(asarPath, filePath, info.offset);
     fs.readSync(fd, buffer, 0, info.size, info.offset);
     validateBufferIntegrity(buffer, info.integrity);
     return (encoding) ? buffer.toString(encoding) : buffer;
   };
 
+  // Builds the fs.Dirent objects of a directory listed by readdirMany, or
+  // returns the path of the first entry that can not be stat'ed.
+  const direntsFromEntries = (filePath: string, entries: { names: string[]; types: number[] }) => {
+    const dirents = [];
+    for (let i = 0; i < entries.names.length; ++i) {
+      if (entries.types[i] === fs.constants.UV_DIRENT_UNKNOWN) {
+        return { childPath: path.join(filePath, entries.names[i]) };
+      }
+      dirents.push(new fs.Dirent(entries.names[i], entries.types[i]));
+    }
+    return dirents;
+  };
+
   const { readdir } = fs;
   fs.readdir = function (pathArgument: string, options: { encoding?: string | null; withFileTypes?: boolean } = {}, callback?: Function) {
     const pathInfo = splitPath(pathArgument);
@@ -637,6 +660,24 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
       return;
     }
 
+    if (options.withFileTypes) {
+      const [entries] = archive.readdirMany([filePath]);
+      if (!entries) {
+        const error = createError(AsarError.NOT_FOUND, { asarPath, filePath });
+        nextTick(callback!, [error]);
+        return;
+      }
+
+      const dirents = direntsFromEntries(filePath, entries);
+      if (!Array.isArray(dirents)) {
+        const error = createError(AsarError.NOT_FOUND, { asarPath, filePath: dirents.childPath });
+        nextTick(callback!, [error]);
+        return;
+      }
+      nextTick(callback!, [null, dirents]);
+      return;
+    }
+
     const files = archive.readdir(filePath);
     if (!files) {
       const error = createError(AsarError.NOT_FOUND, { asarPath, filePath });
@@ -644,28 +685,6 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
       return;
     }
 
-    if (options.withFileTypes) {
-      const dirents = [];
-      for (const file of files) {
-        const childPath = path.join(filePath, file);
-        const stats = archive.stat(childPath);
-        if (!stats) {
-          const error = createError(AsarError.NOT_FOUND, { asarPath, filePath: childPath });
-          nextTick(callback!, [error]);
-          return;
-        }
-        if (stats.isFile) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_FILE));
-        } else if (stats.isDirectory) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_DIR));
-        } else if (stats.isLink) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_LINK));
-        }
-      }
-      nextTick(callback!, [null, dirents]);
-      return;
-    }
-
     nextTick(callback!, [null, files]);
   };
 
@@ -684,30 +703,24 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
       throw createError(AsarError.INVALID_ARCHIVE, { asarPath });
     }
 
-    const files = archive.readdir(filePath);
-    if (!files) {
-      throw createError(AsarError.NOT_FOUND, { asarPath, filePath });
-    }
-
     if (options && (options as ReaddirSyncOptions).withFileTypes) {
-      const dirents = [];
-      for (const file of files) {
-        const childPath = path.join(filePath, file);
-        const stats = archive.stat(childPath);
-        if (!stats) {
-          throw createError(AsarError.NOT_FOUND, { asarPath, filePath: childPath });
-        }
-        if (stats.isFile) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_FILE));
-        } else if (stats.isDirectory) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_DIR));
-        } else if (stats.isLink) {
-          dirents.push(new fs.Dirent(file, fs.constants.UV_DIRENT_LINK));
-        }
+      const [entries] = archive.readdirMany([filePath]);
+      if (!entries) {
+        throw createError(AsarError.NOT_FOUND, { asarPath, filePath });
+      }
+
+      const dirents = direntsFromEntries(filePath, entries);
+      if (!Array.isArray(dirents)) {
+        throw createError(AsarError.NOT_FOUND, { asarPath, filePath: dirents.childPath });
       }
       return dirents;
     }
 
+    const files = archive.readdir(filePath);
+    if (!files) {
+      throw createError(AsarError.NOT_FOUND, { asarPath, filePath });
+    }
+
     return files;
   };
 
@@ -729,17 +742,60 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
       return [str, str.length > 0];
     }
 
+    logASARAccess(asarPath, filePath, info.offset);
+    const mapped = archive.readFileString(filePath);
+    if (mapped !== false) return [mapped, mapped.length > 0];
+
     const buffer = Buffer.alloc(info.size);
     const fd = archive.getFdAndValidateIntegrityLater();
     if (!(fd >= 0)) return [];
 
-    logASARAccess(asarPath, filePath, info.offset);
     fs.readSync(fd, buffer, 0, info.size, info.offset);
     validateBufferIntegrity(buffer, info.integrity);
     const str = buffer.toString('utf8');
     return [str, str.length > 0];
   };
 
+  // Module resolution stats many candidate paths in the same directories,
+  // so the entries of those directories are cached instead, along with the
+  // ones of their parents that the lookup of node_modules walks through.
+  // Archives never change once opened, so entries are never stale.
+  const moduleDirCache = new Map<string, Map<string, number> | null>();
+  const kModuleDirCacheLimit = 1000;
+
+  const getModuleEntryType = (archive: NodeJS.AsarArchive, asarPath: string, filePath: string) => {
+    if (filePath === '') return fs.constants.UV_DIRENT_DIR;
+
+    // The archive root is the empty path.
+    const parentOf = (p: string) => {
+      const dir = path.dirname(p);
+      return dir === '.' ? '' : dir;
+    };
+    const key = (dir: string) => `${asarPath}\0${dir}`;
+
+    const dirPath = parentOf(filePath);
+    if (!moduleDirCache.has(key(dirPath))) {
+      const dirs = [dirPath];
+      for (let dir = dirPath; dir !== '';) {
+        dir = parentOf(dir);
+        if (moduleDirCache.has(key(dir))) break;
+        dirs.push(dir);
+      }
+
+      if (moduleDirCache.size + dirs.length > kModuleDirCacheLimit) moduleDirCache.clear();
+      const entries = archive.readdirMany(dirs);
+      for (let i = 0; i < dirs.length; ++i) {
+        const dirEntries = entries[i];
+        moduleDirCache.set(key(dirs[i]), dirEntries
+          ? new Map(dirEntries.names.map((name, j) => [name, dirEntries.types[j]]))
+          : null);
+      }
+    }
+
+    const dirEntries = moduleDirCache.get(key(dirPath));
+    return dirEntries ? dirEntries.get(path.basename(filePath)) : undefined;
+  };
+
   const { internalModuleStat } = internalBinding('fs');
   internalBinding('fs').internalModuleStat = (pathArgument: string) => {
     const pathInfo = splitPath(pathArgument);
@@ -751,10 +807,10 @@ export const wrapFsWithAsar = (fs: Record<string, any>) => {
     if (!archive) return -34;
 
     // -ENOENT
-    const stats = archive.stat(filePath);
-    if (!stats) return -34;
+    const type = getModuleEntryType(archive, asarPath, filePath);
+    if (type === undefined || type === fs.constants.UV_DIRENT_UNKNOWN) return -34;
 
-    return (stats.isDirectory) ? 1 : 0;
+    return (type === fs.constants.UV_DIRENT_DIR) ? 1 : 0;
   };
 
   // Calling mkdir for directory inside asar archive should throw ENOTDIR
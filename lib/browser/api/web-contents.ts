@@ -3,6 +3,7 @@ import type { BrowserWindowConstructorOptions, LoadURLOptions } from 'electron/m
 
 import * as url from 'url';
 import * as path from 'path';
+import { Readable } from 'stream';
 import { openGuestWindow, makeWebPreferences, parseContentTypeFormat } from '@electron/internal/browser/guest-window-manager';
 import { parseFeatures } from '@electron/internal/browser/parse-features-string';
 import { ipcMainInternal } from '@electron/internal/browser/ipc-main-internal';
@@ -402,6 +403,43 @@ WebContents.prototype.getPrintersAsync = async function () {
   }
 };
 
+const recordings = new WeakMap<Electron.WebContents, { stream: Readable, onData: (event: Electron.Event, data: Buffer) => void }>();
+
+WebContents.prototype.startRecording = function (options = {}) {
+  if (recordings.has(this)) {
+    throw new Error('Already recording');
+  }
+  // The encoder drops frames while the consumer of the stream is behind.
+  const stream = new Readable({
+    read: () => this._setRecordingPaused(false)
+  });
+  const onData = (event: Electron.Event, data: Buffer) => {
+    if (!stream.push(data)) this._setRecordingPaused(true);
+  };
+  this._startRecording(options);
+  this.on('-recording-data' as any, onData);
+  recordings.set(this, { stream, onData });
+  return stream;
+};
+
+WebContents.prototype.stopRecording = async function () {
+  const recording = recordings.get(this);
+  if (!recording) {
+    throw new Error('Not recording');
+  }
+  recordings.delete(this);
+  try {
+    const stats = await this._stopRecording();
+    recording.stream.push(null);
+    return stats;
+  } catch (error) {
+    recording.stream.destroy(error as Error);
+    throw error;
+  } finally {
+    this.removeListener('-recording-data' as any, recording.onData);
+  }
+};
+
 WebContents.prototype.loadFile = function (filePath, options = {}) {
   if (typeof filePath !== 'string') {
     throw new Error('Must pass filePath as a string');
@@ -582,6 +620,21 @@ WebContents.prototype._init = function () {
     }
   });
 
+  this.on('-ipc-message-batch' as any, function (this: Electron.WebContents, event: Electron.IpcMainEvent, channels: string[], args: any[][]) {
+    addSenderFrameToEvent(event);
+    addReplyToEvent(event);
+    for (let i = 0; i < channels.length; i++) {
+      // Keep a throwing listener from dropping the rest of the batch, like
+      // it would not affect messages sent separately.
+      try {
+        this.emit('ipc-message', event, channels[i], ...args[i]);
+        ipcMain.emit(channels[i], event, ...args[i]);
+      } catch (error) {
+        process.nextTick(() => { throw error; });
+      }
+    }
+  });
+
   this.on('-ipc-invoke' as any, function (event: Electron.IpcMainInvokeEvent, internal: boolean, channel: string, args: any[]) {
     addSenderFrameToEvent(event);
     event._reply = (result: any) => event.sendReply({ result });
@@ -4,11 +4,24 @@ const { ipc } = process._linkedBinding('electron_renderer_ipc');
 
 const internal = false;
 
+const batchedChannels = new Set<string>();
+
 const ipcRenderer = new EventEmitter() as Electron.IpcRenderer;
 ipcRenderer.send = function (channel, ...args) {
+  if (batchedChannels.has(channel)) {
+    return ipc.sendBatched(channel, args);
+  }
   return ipc.send(internal, channel, args);
 };
 
+ipcRenderer.setBatched = function (channel, batched) {
+  if (batched) {
+    batchedChannels.add(channel);
+  } else {
+    batchedChannels.delete(channel);
+  }
+};
+
 ipcRenderer.sendSync = function (channel, ...args) {
   return ipc.sendSync(internal, channel, args);
 };
@@ -4,17 +4,23 @@
 
 #include "shell/browser/api/electron_api_protocol.h"
 
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "base/command_line.h"
 #include "base/stl_util.h"
+#include "base/strings/string_util.h"
 #include "content/common/url_schemes.h"
 #include "content/public/browser/child_process_security_policy.h"
+#include "gin/data_object_builder.h"
 #include "gin/object_template_builder.h"
+#include "shell/browser/api/electron_api_response_writer.h"
 #include "shell/browser/browser.h"
 #include "shell/browser/electron_browser_context.h"
 #include "shell/browser/protocol_registry.h"
 #include "shell/common/gin_converters/callback_converter.h"
+#include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_converters/net_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/object_template_builder.h"
@@ -197,6 +203,28 @@ ProtocolError Protocol::RegisterProtocol(ProtocolType type,
   return added ? ProtocolError::kOK : ProtocolError::kRegistered;
 }
 
+bool Protocol::RegisterDirectoryProtocol(const std::string& scheme,
+                                         gin::Arguments* args) {
+  std::map<std::string, base::FilePath> paths;
+  if (!args->GetNext(&paths)) {
+    args->ThrowTypeError("directories must be an object of paths");
+    return false;
+  }
+
+  DirectoryMapping directories;
+  for (const auto& it : paths) {
+    if (!it.second.IsAbsolute()) {
+      args->ThrowTypeError("directories must be absolute paths");
+      return false;
+    }
+    // Hosts are lower case in standard URLs.
+    directories.emplace(base::ToLowerASCII(it.first),
+                        it.second.StripTrailingSeparators());
+  }
+  return protocol_registry_->RegisterDirectoryProtocol(scheme,
+                                                       std::move(directories));
+}
+
 bool Protocol::UnregisterProtocol(const std::string& scheme,
                                   gin::Arguments* args) {
   bool removed = protocol_registry_->UnregisterProtocol(scheme);
@@ -209,6 +237,42 @@ bool Protocol::IsProtocolRegistered(const std::string& scheme) {
   return protocol_registry_->IsProtocolRegistered(scheme);
 }
 
+void Protocol::EnableResponseCache(const std::string& scheme,
+                                   gin::Arguments* args) {
+  // 32MB by default.
+  int64_t max_size = 32 * 1024 * 1024;
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("maxSize", &max_size);
+  if (max_size <= 0) {
+    args->ThrowTypeError("maxSize must be greater than 0");
+    return;
+  }
+  protocol_registry_->SetResponseCache(scheme, static_cast<size_t>(max_size));
+}
+
+void Protocol::DisableResponseCache(const std::string& scheme) {
+  protocol_registry_->SetResponseCache(scheme, 0);
+}
+
+v8::Local<v8::Value> Protocol::GetResponseCacheStats(
+    v8::Isolate* isolate,
+    const std::string& scheme) {
+  auto cache = protocol_registry_->GetResponseCache(scheme);
+  if (!cache)
+    return v8::Null(isolate);
+  ProtocolResponseCache::Stats stats = cache->GetStats();
+  return gin::DataObjectBuilder(isolate)
+      .Set("hits", static_cast<double>(stats.hits))
+      .Set("misses", static_cast<double>(stats.misses))
+      .Set("revalidations", static_cast<double>(stats.revalidations))
+      .Set("evictions", static_cast<double>(stats.evictions))
+      .Set("entries", static_cast<double>(stats.entries))
+      .Set("size", static_cast<double>(stats.size))
+      .Set("maxSize", static_cast<double>(cache->max_size()))
+      .Build();
+}
+
 ProtocolError Protocol::InterceptProtocol(ProtocolType type,
                                           const std::string& scheme,
                                           const ProtocolHandler& handler) {
@@ -289,9 +353,14 @@ gin::ObjectTemplateBuilder Protocol::GetObjectTemplateBuilder(
                  &Protocol::RegisterProtocolFor<ProtocolType::kStream>)
       .SetMethod("registerProtocol",
                  &Protocol::RegisterProtocolFor<ProtocolType::kFree>)
+      .SetMethod("registerDirectoryProtocol",
+                 &Protocol::RegisterDirectoryProtocol)
       .SetMethod("unregisterProtocol", &Protocol::UnregisterProtocol)
       .SetMethod("isProtocolRegistered", &Protocol::IsProtocolRegistered)
       .SetMethod("isProtocolHandled", &Protocol::IsProtocolHandled)
+      .SetMethod("enableResponseCache", &Protocol::EnableResponseCache)
+      .SetMethod("disableResponseCache", &Protocol::DisableResponseCache)
+      .SetMethod("getResponseCacheStats", &Protocol::GetResponseCacheStats)
       .SetMethod("interceptStringProtocol",
                  &Protocol::InterceptProtocolFor<ProtocolType::kString>)
       .SetMethod("interceptBufferProtocol",
@@ -337,6 +406,8 @@ void Initialize(v8::Local<v8::Object> exports,
   gin_helper::Dictionary dict(isolate, exports);
   dict.SetMethod("registerSchemesAsPrivileged", &RegisterSchemesAsPrivileged);
   dict.SetMethod("getStandardSchemes", &electron::api::GetStandardSchemes);
+  dict.SetMethod("createResponseWriter",
+                 &electron::api::ResponseWriter::Create);
 }
 
 }  // namespace
@@ -60,9 +60,16 @@ class Protocol : public gin::Wrappable<Protocol> {
   ProtocolError RegisterProtocol(ProtocolType type,
                                  const std::string& scheme,
                                  const ProtocolHandler& handler);
+  bool RegisterDirectoryProtocol(const std::string& scheme,
+                                 gin::Arguments* args);
   bool UnregisterProtocol(const std::string& scheme, gin::Arguments* args);
   bool IsProtocolRegistered(const std::string& scheme);
 
+  void EnableResponseCache(const std::string& scheme, gin::Arguments* args);
+  void DisableResponseCache(const std::string& scheme);
+  v8::Local<v8::Value> GetResponseCacheStats(v8::Isolate* isolate,
+                                             const std::string& scheme);
+
   ProtocolError InterceptProtocol(ProtocolType type,
                                   const std::string& scheme,
                                   const ProtocolHandler& handler);
@@ -0,0 +1,285 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/electron_api_response_writer.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "gin/arguments.h"
+#include "gin/object_template_builder.h"
+#include "services/network/public/cpp/url_loader_completion_status.h"
+#include "shell/browser/javascript_environment.h"
+#include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/error_thrower.h"
+
+#include "shell/common/node_includes.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+// The default of the network service for the pipes of response bodies.
+constexpr uint32_t kDefaultCapacity = 512 * 1024;
+constexpr uint32_t kMaxCapacity = 64 * 1024 * 1024;
+
+// Gets the data of a Buffer or a string |chunk|, strings are copied to
+// |storage|.
+bool GetChunkData(v8::Isolate* isolate,
+                  v8::Local<v8::Value> chunk,
+                  std::string* storage,
+                  base::StringPiece* data) {
+  if (node::Buffer::HasInstance(chunk)) {
+    *data = base::StringPiece(node::Buffer::Data(chunk),
+                              node::Buffer::Length(chunk));
+    return true;
+  }
+  if (chunk->IsString() && gin::ConvertFromV8(isolate, chunk, storage)) {
+    *data = *storage;
+    return true;
+  }
+  return false;
+}
+
+uint32_t ClampToUint32(size_t size) {
+  return static_cast<uint32_t>(
+      std::min<size_t>(size, std::numeric_limits<uint32_t>::max()));
+}
+
+}  // namespace
+
+gin::WrapperInfo ResponseWriter::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+ResponseWriter::ResponseWriter(mojo::ScopedDataPipeProducerHandle producer,
+                               mojo::ScopedDataPipeConsumerHandle consumer,
+                               uint32_t capacity)
+    : producer_(std::move(producer)),
+      consumer_(std::move(consumer)),
+      watcher_(FROM_HERE,
+               mojo::SimpleWatcher::ArmingPolicy::MANUAL,
+               base::SequencedTaskRunnerHandle::Get()),
+      capacity_(capacity) {
+  watcher_.Watch(producer_.get(), MOJO_HANDLE_SIGNAL_WRITABLE,
+                 base::BindRepeating(&ResponseWriter::OnWritable,
+                                     weak_factory_.GetWeakPtr()));
+}
+
+ResponseWriter::~ResponseWriter() = default;
+
+// static
+gin::Handle<ResponseWriter> ResponseWriter::Create(gin::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  uint32_t capacity = kDefaultCapacity;
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("capacity", &capacity);
+  if (capacity == 0 || capacity > kMaxCapacity) {
+    gin_helper::ErrorThrower(isolate).ThrowRangeError(base::StringPrintf(
+        "capacity must be between 1 and %u bytes", kMaxCapacity));
+    return gin::Handle<ResponseWriter>();
+  }
+
+  MojoCreateDataPipeOptions pipe_options;
+  pipe_options.struct_size = sizeof(MojoCreateDataPipeOptions);
+  pipe_options.flags = MOJO_CREATE_DATA_PIPE_FLAG_NONE;
+  pipe_options.element_num_bytes = 1;
+  pipe_options.capacity_num_bytes = capacity;
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  if (mojo::CreateDataPipe(&pipe_options, producer, consumer) !=
+      MOJO_RESULT_OK) {
+    gin_helper::ErrorThrower(isolate).ThrowError(
+        "Failed to create the data pipe");
+    return gin::Handle<ResponseWriter>();
+  }
+
+  return gin::CreateHandle(
+      isolate,
+      new ResponseWriter(std::move(producer), std::move(consumer), capacity));
+}
+
+void ResponseWriter::Start(
+    network::mojom::URLResponseHeadPtr head,
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client) {
+  DCHECK(!has_started());
+
+  url_loader_.Bind(std::move(loader));
+  url_loader_.set_disconnect_handler(base::BindOnce(
+      &ResponseWriter::Complete, base::Unretained(this), net::ERR_ABORTED));
+  client_.Bind(std::move(client));
+  client_->OnReceiveResponse(std::move(head));
+  client_->OnStartLoadingResponseBody(std::move(consumer_));
+
+  if (finished_) {
+    // The body was ended or destroyed before the request.
+    network::URLLoaderCompletionStatus status(result_);
+    status.decoded_body_length = bytes_written_;
+    client_->OnComplete(status);
+    url_loader_.reset();
+    client_.reset();
+    return;
+  }
+
+  // Keep the writer alive while the request is going on.
+  Pin(JavascriptEnvironment::GetIsolate());
+}
+
+bool ResponseWriter::Write(gin::Arguments* args) {
+  v8::Local<v8::Value> chunk;
+  std::string storage;
+  base::StringPiece data;
+  if (!args->GetNext(&chunk) ||
+      !GetChunkData(args->isolate(), chunk, &storage, &data)) {
+    args->ThrowTypeError("chunk must be a Buffer or a string");
+    return false;
+  }
+  if (ended_) {
+    gin_helper::ErrorThrower(args->isolate()).ThrowError("write after end");
+    return false;
+  }
+  return Append(data.data(), data.size()) && pending_.empty();
+}
+
+void ResponseWriter::End(gin::Arguments* args) {
+  v8::Local<v8::Value> chunk;
+  if (args->GetNext(&chunk) && !chunk->IsNullOrUndefined()) {
+    std::string storage;
+    base::StringPiece data;
+    if (!GetChunkData(args->isolate(), chunk, &storage, &data)) {
+      args->ThrowTypeError("chunk must be a Buffer or a string");
+      return;
+    }
+    if (!ended_)
+      Append(data.data(), data.size());
+  }
+  ended_ = true;
+  MaybeComplete();
+}
+
+void ResponseWriter::Destroy() {
+  Complete(net::ERR_FAILED);
+}
+
+bool ResponseWriter::Append(const char* data, size_t size) {
+  if (finished_)
+    return false;
+
+  // Once data is held, the new data goes after it.
+  if (pending_.empty()) {
+    uint32_t num_bytes = ClampToUint32(size);
+    MojoResult result =
+        producer_->WriteData(data, &num_bytes, MOJO_WRITE_DATA_FLAG_NONE);
+    if (result == MOJO_RESULT_OK) {
+      data += num_bytes;
+      size -= num_bytes;
+      bytes_written_ += num_bytes;
+    } else if (result != MOJO_RESULT_SHOULD_WAIT) {
+      Complete(net::ERR_FAILED);
+      return false;
+    }
+  }
+
+  if (size > 0) {
+    pending_.append(data, size);
+    needs_drain_ = true;
+    watcher_.ArmOrNotify();
+  }
+  return true;
+}
+
+void ResponseWriter::Flush() {
+  while (pending_offset_ < pending_.size()) {
+    uint32_t num_bytes = ClampToUint32(pending_.size() - pending_offset_);
+    MojoResult result = producer_->WriteData(
+        pending_.data() + pending_offset_, &num_bytes,
+        MOJO_WRITE_DATA_FLAG_NONE);
+    if (result == MOJO_RESULT_SHOULD_WAIT) {
+      watcher_.ArmOrNotify();
+      return;
+    }
+    if (result != MOJO_RESULT_OK) {
+      Complete(net::ERR_FAILED);
+      return;
+    }
+    pending_offset_ += num_bytes;
+    bytes_written_ += num_bytes;
+  }
+  pending_.clear();
+  pending_offset_ = 0;
+}
+
+void ResponseWriter::OnWritable(MojoResult result) {
+  if (finished_)
+    return;
+  if (result != MOJO_RESULT_OK) {
+    // The body is no longer read.
+    Complete(net::ERR_ABORTED);
+    return;
+  }
+
+  Flush();
+  if (finished_ || !pending_.empty())
+    return;
+  MaybeComplete();
+  if (!finished_ && needs_drain_) {
+    needs_drain_ = false;
+    Emit("drain");
+  }
+}
+
+void ResponseWriter::MaybeComplete() {
+  if (ended_ && pending_.empty())
+    Complete(net::OK);
+}
+
+void ResponseWriter::Complete(int result) {
+  if (finished_)
+    return;
+  finished_ = true;
+  result_ = result;
+  watcher_.Cancel();
+  producer_.reset();
+  pending_.clear();
+  pending_offset_ = 0;
+
+  bool started = client_.is_bound();
+  if (started) {
+    network::URLLoaderCompletionStatus status(result);
+    status.decoded_body_length = bytes_written_;
+    client_->OnComplete(status);
+    url_loader_.reset();
+    client_.reset();
+  }
+
+  Emit("close");
+  if (started)
+    Unpin();
+}
+
+gin::ObjectTemplateBuilder ResponseWriter::GetObjectTemplateBuilder(
+    v8::Isolate* isolate) {
+  return gin_helper::EventEmitterMixin<
+             ResponseWriter>::GetObjectTemplateBuilder(isolate)
+      .SetMethod("write", &ResponseWriter::Write)
+      .SetMethod("end", &ResponseWriter::End)
+      .SetMethod("destroy", &ResponseWriter::Destroy)
+      .SetProperty("capacity", &ResponseWriter::GetCapacity)
+      .SetProperty("writableLength", &ResponseWriter::GetWritableLength)
+      .SetProperty("destroyed", &ResponseWriter::IsDestroyed);
+}
+
+const char* ResponseWriter::GetTypeName() {
+  return "ResponseWriter";
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,130 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_ELECTRON_API_RESPONSE_WRITER_H_
+#define SHELL_BROWSER_API_ELECTRON_API_RESPONSE_WRITER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/memory/weak_ptr.h"
+#include "gin/handle.h"
+#include "gin/wrappable.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/receiver.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "mojo/public/cpp/system/simple_watcher.h"
+#include "net/base/net_errors.h"
+#include "services/network/public/mojom/url_loader.mojom.h"
+#include "services/network/public/mojom/url_response_head.mojom.h"
+#include "shell/browser/event_emitter_mixin.h"
+#include "shell/common/gin_helper/pinnable.h"
+
+namespace gin {
+class Arguments;
+}  // namespace gin
+
+namespace electron {
+
+namespace api {
+
+// The body of a response to a custom protocol, written to by JavaScript.
+//
+// The data is copied from the written chunks straight into a data pipe of a
+// fixed capacity, without a JS call per chunk to pull it like with a Node
+// stream. When the pipe is full write() returns false and the rest of the
+// chunk is held until the "drain" event, so the writes follow the speed at
+// which the body is read.
+class ResponseWriter : public gin::Wrappable<ResponseWriter>,
+                       public gin_helper::Pinnable<ResponseWriter>,
+                       public gin_helper::EventEmitterMixin<ResponseWriter>,
+                       public network::mojom::URLLoader {
+ public:
+  static gin::Handle<ResponseWriter> Create(gin::Arguments* args);
+
+  // Starts sending the body as the response of a request, a writer can only
+  // be used for one request.
+  void Start(network::mojom::URLResponseHeadPtr head,
+             mojo::PendingReceiver<network::mojom::URLLoader> loader,
+             mojo::PendingRemote<network::mojom::URLLoaderClient> client);
+  bool has_started() const { return !consumer_.is_valid(); }
+
+  // gin::Wrappable
+  static gin::WrapperInfo kWrapperInfo;
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override;
+  const char* GetTypeName() override;
+
+  // disable copy
+  ResponseWriter(const ResponseWriter&) = delete;
+  ResponseWriter& operator=(const ResponseWriter&) = delete;
+
+ private:
+  ResponseWriter(mojo::ScopedDataPipeProducerHandle producer,
+                 mojo::ScopedDataPipeConsumerHandle consumer,
+                 uint32_t capacity);
+  ~ResponseWriter() override;
+
+  // JS API
+  bool Write(gin::Arguments* args);
+  void End(gin::Arguments* args);
+  void Destroy();
+  uint32_t GetCapacity() const { return capacity_; }
+  size_t GetWritableLength() const {
+    return pending_.size() - pending_offset_;
+  }
+  bool IsDestroyed() const { return finished_; }
+
+  // Copies |data| into the pipe, and holds what does not fit. Returns false
+  // when the writer is closed.
+  bool Append(const char* data, size_t size);
+  // Moves the held data into the pipe.
+  void Flush();
+  void OnWritable(MojoResult result);
+  // Ends the body once all the data was written.
+  void MaybeComplete();
+  void Complete(int result);
+
+  // URLLoader:
+  void FollowRedirect(
+      const std::vector<std::string>& removed_headers,
+      const net::HttpRequestHeaders& modified_headers,
+      const net::HttpRequestHeaders& modified_cors_exempt_headers,
+      const absl::optional<GURL>& new_url) override {}
+  void SetPriority(net::RequestPriority priority,
+                   int32_t intra_priority_value) override {}
+  void PauseReadingBodyFromNet() override {}
+  void ResumeReadingBodyFromNet() override {}
+
+  mojo::Receiver<network::mojom::URLLoader> url_loader_{this};
+  mojo::Remote<network::mojom::URLLoaderClient> client_;
+
+  mojo::ScopedDataPipeProducerHandle producer_;
+  // Handed to the client when the response starts.
+  mojo::ScopedDataPipeConsumerHandle consumer_;
+  mojo::SimpleWatcher watcher_;
+  uint32_t capacity_;
+
+  // The data that did not fit in the pipe, from |pending_offset_|.
+  std::string pending_;
+  size_t pending_offset_ = 0;
+
+  // Whether a write returned false, so "drain" should be emitted.
+  bool needs_drain_ = false;
+  // Whether end() was called.
+  bool ended_ = false;
+  // Whether the body was completed or aborted.
+  bool finished_ = false;
+  int result_ = net::OK;
+  int64_t bytes_written_ = 0;
+
+  base::WeakPtrFactory<ResponseWriter> weak_factory_{this};
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_ELECTRON_API_RESPONSE_WRITER_H_
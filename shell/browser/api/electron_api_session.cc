@@ -252,6 +252,22 @@ namespace {
 
 const char kPersistPrefix[] = "persist:";
 
+// Gets the name of the BrowserContext of |partition|, and whether it is in
+// memory.
+std::string ParsePartition(const std::string& partition, bool* in_memory) {
+  if (partition.empty()) {
+    *in_memory = false;
+    return partition;
+  }
+  if (base::StartsWith(partition, kPersistPrefix,
+                       base::CompareCase::SENSITIVE)) {
+    *in_memory = false;
+    return partition.substr(8);
+  }
+  *in_memory = true;
+  return partition;
+}
+
 void DownloadIdCallback(content::DownloadManager* download_manager,
                         const base::FilePath& path,
                         const std::vector<GURL>& url_chain,
@@ -1125,22 +1141,36 @@ gin::Handle<Session> Session::CreateFrom(
 gin::Handle<Session> Session::FromPartition(v8::Isolate* isolate,
                                             const std::string& partition,
                                             base::DictionaryValue options) {
-  ElectronBrowserContext* browser_context;
-  if (partition.empty()) {
-    browser_context =
-        ElectronBrowserContext::From("", false, std::move(options));
-  } else if (base::StartsWith(partition, kPersistPrefix,
-                              base::CompareCase::SENSITIVE)) {
-    std::string name = partition.substr(8);
-    browser_context =
-        ElectronBrowserContext::From(name, false, std::move(options));
-  } else {
-    browser_context =
-        ElectronBrowserContext::From(partition, true, std::move(options));
-  }
+  bool in_memory;
+  std::string name = ParsePartition(partition, &in_memory);
+  ElectronBrowserContext* browser_context =
+      ElectronBrowserContext::From(name, in_memory, std::move(options));
   return CreateFrom(isolate, browser_context);
 }
 
+// static
+v8::Local<v8::Promise> Session::FromPartitionAsync(
+    v8::Isolate* isolate,
+    const std::string& partition,
+    base::DictionaryValue options) {
+  gin_helper::Promise<gin::Handle<Session>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  bool in_memory;
+  std::string name = ParsePartition(partition, &in_memory);
+  ElectronBrowserContext::FromAsync(
+      name, in_memory, std::move(options),
+      base::BindOnce(
+          [](gin_helper::Promise<gin::Handle<Session>> promise,
+             ElectronBrowserContext* browser_context) {
+            v8::HandleScope handle_scope(promise.isolate());
+            v8::Context::Scope context_scope(promise.GetContext());
+            promise.Resolve(CreateFrom(promise.isolate(), browser_context));
+          },
+          std::move(promise)));
+  return handle;
+}
+
 gin::ObjectTemplateBuilder Session::GetObjectTemplateBuilder(
     v8::Isolate* isolate) {
   return gin_helper::EventEmitterMixin<Session>::GetObjectTemplateBuilder(
@@ -1235,6 +1265,18 @@ v8::Local<v8::Value> FromPartition(const std::string& partition,
       .ToV8();
 }
 
+v8::Local<v8::Value> FromPartitionAsync(const std::string& partition,
+                                        gin::Arguments* args) {
+  if (!electron::Browser::Get()->is_ready()) {
+    args->ThrowTypeError("Session can only be received when app is ready");
+    return v8::Null(args->isolate());
+  }
+  base::DictionaryValue options;
+  args->GetNext(&options);
+  return Session::FromPartitionAsync(args->isolate(), partition,
+                                     std::move(options));
+}
+
 void Initialize(v8::Local<v8::Object> exports,
                 v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context,
@@ -1242,6 +1284,7 @@ void Initialize(v8::Local<v8::Object> exports,
   v8::Isolate* isolate = context->GetIsolate();
   gin_helper::Dictionary dict(isolate, exports);
   dict.SetMethod("fromPartition", &FromPartition);
+  dict.SetMethod("fromPartitionAsync", &FromPartitionAsync);
 }
 
 }  // namespace
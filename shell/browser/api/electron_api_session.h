@@ -80,6 +80,14 @@ class Session : public gin::Wrappable<Session>,
       const std::string& partition,
       base::DictionaryValue options = base::DictionaryValue());
 
+  // Like FromPartition, but the preferences of a new Session are read
+  // without blocking the UI thread. Resolves with the Session once it is
+  // usable.
+  static v8::Local<v8::Promise> FromPartitionAsync(
+      v8::Isolate* isolate,
+      const std::string& partition,
+      base::DictionaryValue options);
+
   ElectronBrowserContext* browser_context() const { return browser_context_; }
 
   // gin::Wrappable
@@ -4,6 +4,7 @@
 
 #include "shell/browser/api/electron_api_web_contents.h"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <set>
@@ -142,8 +143,10 @@
 #include "ui/events/base_event_utils.h"
 
 #if BUILDFLAG(ENABLE_OSR)
+#include "shell/browser/osr/osr_frame_pool.h"
 #include "shell/browser/osr/osr_render_widget_host_view.h"
 #include "shell/browser/osr/osr_web_contents_view.h"
+#include "ui/gfx/geometry/skia_conversions.h"
 #endif
 
 #if !defined(OS_MAC)
@@ -359,6 +362,104 @@ struct Converter<electron::api::WebContents::Type> {
   }
 };
 
+template <>
+struct Converter<electron::api::FrameSubscriber::PixelFormat> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      electron::api::FrameSubscriber::PixelFormat val) {
+    using PixelFormat = electron::api::FrameSubscriber::PixelFormat;
+    switch (val) {
+      case PixelFormat::kI420:
+        return StringToV8(isolate, "i420");
+      case PixelFormat::kNV12:
+        return StringToV8(isolate, "nv12");
+      default:
+        return StringToV8(isolate, "argb");
+    }
+  }
+
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     electron::api::FrameSubscriber::PixelFormat* out) {
+    using PixelFormat = electron::api::FrameSubscriber::PixelFormat;
+    std::string format;
+    if (!ConvertFromV8(isolate, val, &format))
+      return false;
+    format = base::ToLowerASCII(format);
+    if (format == "argb") {
+      *out = PixelFormat::kARGB;
+    } else if (format == "i420") {
+      *out = PixelFormat::kI420;
+    } else if (format == "nv12") {
+      *out = PixelFormat::kNV12;
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+
+template <>
+struct Converter<electron::api::FrameSubscriber::Frame> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const electron::api::FrameSubscriber::Frame& val) {
+    if (!val.planes)
+      return ConvertToV8(isolate, gfx::Image::CreateFrom1xBitmap(val.bitmap));
+
+    // The planes are given to JavaScript without a copy.
+    base::RefCountedBytes* planes = val.planes.get();
+    planes->AddRef();
+    gin_helper::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("format", val.format);
+    dict.Set("size", val.size);
+    dict.Set("data",
+             node::Buffer::New(
+                 isolate, reinterpret_cast<char*>(planes->data().data()),
+                 planes->size(),
+                 [](char* data, void* hint) {
+                   static_cast<base::RefCountedBytes*>(hint)->Release();
+                 },
+                 planes)
+                 .ToLocalChecked());
+    return dict.GetHandle();
+  }
+};
+
+template <>
+struct Converter<electron::api::FrameRecorder::Codec> {
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     electron::api::FrameRecorder::Codec* out) {
+    using Codec = electron::api::FrameRecorder::Codec;
+    std::string codec;
+    if (!ConvertFromV8(isolate, val, &codec))
+      return false;
+    if (codec == "vp8") {
+      *out = Codec::kVP8;
+    } else if (codec == "vp9") {
+      *out = Codec::kVP9;
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+
+template <>
+struct Converter<electron::api::FrameRecorder::EncodedFrame> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const electron::api::FrameRecorder::EncodedFrame& val) {
+    gin_helper::Dictionary dict(isolate, v8::Object::New(isolate));
+    dict.Set("timestamp", val.timestamp.InMillisecondsF());
+    dict.Set("keyFrame", val.key_frame);
+    dict.Set("size", val.size);
+    dict.Set("encodeTime", val.encode_time.InMillisecondsF());
+    return dict.GetHandle();
+  }
+};
+
 template <>
 struct Converter<scoped_refptr<content::DevToolsAgentHost>> {
   static v8::Local<v8::Value> ToV8(
@@ -1702,16 +1803,44 @@ void WebContents::Message(bool internal,
                  channel, std::move(arguments));
 }
 
+void WebContents::MessageBatch(std::vector<mojom::BatchedMessagePtr> messages,
+                               content::RenderFrameHost* render_frame_host) {
+  TRACE_EVENT1("electron", "WebContents::MessageBatch", "count",
+               messages.size());
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Array> channels = v8::Array::New(isolate, messages.size());
+  v8::Local<v8::Array> arguments = v8::Array::New(isolate, messages.size());
+  for (size_t i = 0; i < messages.size(); ++i) {
+    channels->Set(context, i, gin::StringToV8(isolate, messages[i]->channel))
+        .Check();
+    arguments
+        ->Set(context, i,
+              electron::DeserializeV8Value(isolate, messages[i]->arguments))
+        .Check();
+  }
+  // webContents.emit('-ipc-message-batch', new Event(), channels, arguments);
+  EmitWithSender("-ipc-message-batch", render_frame_host,
+                 electron::mojom::ElectronBrowser::InvokeCallback(), channels,
+                 arguments);
+}
+
 void WebContents::Invoke(
     bool internal,
     const std::string& channel,
     blink::CloneableMessage arguments,
+    std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers,
     electron::mojom::ElectronBrowser::InvokeCallback callback,
     content::RenderFrameHost* render_frame_host) {
   TRACE_EVENT1("electron", "WebContents::Invoke", "channel", channel);
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Value> arguments_value = electron::DeserializeV8Value(
+      isolate, arguments, std::move(shared_buffers));
   // webContents.emit('-ipc-invoke', new Event(), internal, channel, arguments);
   EmitWithSender("-ipc-invoke", render_frame_host, std::move(callback),
-                 internal, channel, std::move(arguments));
+                 internal, channel, arguments_value);
 }
 
 void WebContents::OnFirstNonEmptyLayout(
@@ -2921,6 +3050,10 @@ void WebContents::SendInputEvent(v8::Isolate* isolate,
         blink::WebKeyboardEvent::Type::kRawKeyDown,
         blink::WebInputEvent::Modifiers::kNoModifiers, ui::EventTimeForNow());
     if (gin::ConvertFromV8(isolate, input_event, &keyboard_event)) {
+#if BUILDFLAG(ENABLE_OSR)
+      if (IsOffScreen())
+        GetOffScreenRenderWidgetHostView()->WakeFramePacing();
+#endif
       rwh->ForwardKeyboardEvent(keyboard_event);
       return;
     }
@@ -2957,27 +3090,164 @@ void WebContents::SendInputEvent(v8::Isolate* isolate,
       v8::Exception::Error(gin::StringToV8(isolate, "Invalid event object")));
 }
 
-void WebContents::BeginFrameSubscription(gin::Arguments* args) {
-  bool only_dirty = false;
-  FrameSubscriber::FrameCaptureCallback callback;
-
-  if (args->Length() > 1) {
-    if (!args->GetNext(&only_dirty)) {
+int WebContents::BeginFrameSubscription(gin::Arguments* args) {
+  FrameSubscriber::Options options;
+  FrameSubscriber::FrameCallback callback;
+
+  // Subscriptions with options are added, the one without replaced.
+  bool has_options = false;
+  v8::Local<v8::Value> first = args->PeekNext();
+  if (!first.IsEmpty() && first->IsObject() && !first->IsFunction()) {
+    gin_helper::Dictionary dict;
+    args->GetNext(&dict);
+    has_options = true;
+    dict.Get("size", &options.size);
+    dict.Get("frameRate", &options.frame_rate);
+    dict.Get("onlyDirty", &options.only_dirty);
+    if (dict.Has("format") && !dict.Get("format", &options.format)) {
+      args->ThrowTypeError("Invalid pixel format");
+      return 0;
+    }
+  } else if (args->Length() > 1) {
+    if (!args->GetNext(&options.only_dirty)) {
       args->ThrowError();
-      return;
+      return 0;
     }
   }
   if (!args->GetNext(&callback)) {
     args->ThrowError();
+    return 0;
+  }
+
+  if (!frame_subscriber_)
+    frame_subscriber_ = std::make_unique<FrameSubscriber>(web_contents());
+  if (!has_options && frame_subscription_id_)
+    frame_subscriber_->RemoveSubscription(frame_subscription_id_);
+  int id = frame_subscriber_->AddSubscription(options, callback);
+  if (!has_options)
+    frame_subscription_id_ = id;
+  return id;
+}
+
+void WebContents::EndFrameSubscription(gin::Arguments* args) {
+  int id = 0;
+  if (args->GetNext(&id) && frame_subscriber_) {
+    frame_subscriber_->RemoveSubscription(id);
+    if (id == frame_subscription_id_)
+      frame_subscription_id_ = 0;
+    if (frame_subscriber_->HasSubscriptions())
+      return;
+  }
+  frame_subscription_id_ = 0;
+  // The capturer stops with the last subscription, unless it feeds a
+  // recording.
+  if (frame_subscriber_ && frame_recorder_) {
+    frame_subscriber_->RemoveOtherSubscriptions(
+        frame_recorder_subscription_id_);
+  } else {
+    frame_subscriber_.reset();
+  }
+}
+
+void WebContents::StartRecording(gin::Arguments* args) {
+  if (frame_recorder_) {
+    gin_helper::ErrorThrower(args->isolate()).ThrowError("Already recording");
     return;
   }
 
-  frame_subscriber_ =
-      std::make_unique<FrameSubscriber>(web_contents(), callback, only_dirty);
+  FrameRecorder::Options options;
+  FrameSubscriber::Options subscription_options;
+  subscription_options.format = FrameSubscriber::PixelFormat::kI420;
+  gin_helper::Dictionary dict;
+  if (args->GetNext(&dict)) {
+    if (dict.Has("codec") && !dict.Get("codec", &options.codec)) {
+      args->ThrowTypeError("Invalid codec");
+      return;
+    }
+    dict.Get("bitrate", &options.bitrate);
+    dict.Get("frameRate", &options.frame_rate);
+    dict.Get("size", &subscription_options.size);
+    dict.Get("path", &options.path);
+  }
+  if (options.bitrate <= 0 || options.frame_rate <= 0) {
+    args->ThrowTypeError("Invalid bitrate or frame rate");
+    return;
+  }
+  subscription_options.frame_rate = options.frame_rate;
+
+  auto weak_this = weak_factory_.GetWeakPtr();
+  frame_recorder_ = std::make_unique<FrameRecorder>(
+      options, base::BindRepeating(&WebContents::OnRecordingData, weak_this),
+      base::BindRepeating(&WebContents::OnRecordedFrame, weak_this));
+  if (!frame_subscriber_)
+    frame_subscriber_ = std::make_unique<FrameSubscriber>(web_contents());
+  frame_recorder_subscription_id_ = frame_subscriber_->AddSubscription(
+      subscription_options,
+      base::BindRepeating(&FrameRecorder::OnFrame,
+                          base::Unretained(frame_recorder_.get())));
 }
 
-void WebContents::EndFrameSubscription() {
-  frame_subscriber_.reset();
+void WebContents::SetRecordingPaused(bool paused) {
+  if (frame_recorder_)
+    frame_recorder_->SetPaused(paused);
+}
+
+v8::Local<v8::Promise> WebContents::StopRecording(v8::Isolate* isolate) {
+  gin_helper::Promise<gin_helper::Dictionary> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  if (!frame_recorder_) {
+    promise.RejectWithErrorMessage("Not recording");
+    return handle;
+  }
+
+  // The frame subscription holds a pointer to the recorder.
+  if (frame_subscriber_) {
+    frame_subscriber_->RemoveSubscription(frame_recorder_subscription_id_);
+    if (!frame_subscriber_->HasSubscriptions())
+      frame_subscriber_.reset();
+  }
+  frame_recorder_subscription_id_ = 0;
+
+  // The recorder goes away once the encoder is done with its frames.
+  FrameRecorder* recorder = frame_recorder_.get();
+  recorder->Stop(base::BindOnce(
+      [](std::unique_ptr<FrameRecorder> recorder,
+         gin_helper::Promise<gin_helper::Dictionary> promise,
+         const FrameRecorder::Stats& stats) {
+        if (!stats.error.empty()) {
+          promise.RejectWithErrorMessage(stats.error);
+          return;
+        }
+        v8::HandleScope handle_scope(promise.isolate());
+        gin_helper::Dictionary dict =
+            gin::Dictionary::CreateEmpty(promise.isolate());
+        dict.Set("framesEncoded", stats.frames_encoded);
+        dict.Set("framesDropped", stats.frames_dropped);
+        dict.Set("averageEncodeTime",
+                 stats.average_encode_time.InMillisecondsF());
+        promise.Resolve(dict);
+      },
+      std::move(frame_recorder_), std::move(promise)));
+  return handle;
+}
+
+void WebContents::OnRecordingData(scoped_refptr<base::RefCountedBytes> data) {
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  base::RefCountedBytes* bytes = data.release();
+  Emit("-recording-data",
+       node::Buffer::New(
+           isolate, reinterpret_cast<char*>(bytes->data().data()),
+           bytes->size(),
+           [](char* data, void* hint) {
+             static_cast<base::RefCountedBytes*>(hint)->Release();
+           },
+           bytes)
+           .ToLocalChecked());
+}
+
+void WebContents::OnRecordedFrame(const FrameRecorder::EncodedFrame& frame) {
+  Emit("recorded-frame", frame);
 }
 
 void WebContents::StartDrag(const gin_helper::Dictionary& item,
@@ -3124,8 +3394,89 @@ bool WebContents::IsOffScreen() const {
 }
 
 #if BUILDFLAG(ENABLE_OSR)
-void WebContents::OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap) {
-  Emit("paint", dirty_rect, gfx::Image::CreateFrom1xBitmap(bitmap));
+namespace {
+
+// Most paint events can use this many buffers at once.
+constexpr int kMaxFrameBufferCount = 16;
+
+// Dirty areas made of more rects are given as their bounds.
+constexpr size_t kMaxDirtyRectCount = 8;
+
+struct LentFrame {
+  scoped_refptr<OffScreenFramePool> pool;
+  OffScreenFramePool::Frame frame;
+};
+
+void FreeLentFrame(char* data, void* hint) {
+  auto* lent_frame = static_cast<LentFrame*>(hint);
+  lent_frame->pool->ReleaseFrame(lent_frame->frame);
+  delete lent_frame;
+}
+
+// The frame goes back to the pool once released, or once its buffer has been
+// garbage collected.
+void SetLentFrame(v8::Isolate* isolate,
+                  scoped_refptr<OffScreenFramePool> pool,
+                  const OffScreenFramePool::Frame& frame,
+                  gin_helper::Dictionary* dict) {
+  OffScreenFrameBuffer* buffer = frame.buffer.get();
+  dict->Set("buffer",
+            node::Buffer::New(isolate, reinterpret_cast<char*>(buffer->data()),
+                              buffer->byte_size(), &FreeLentFrame,
+                              new LentFrame{pool, frame})
+                .ToLocalChecked());
+  dict->Set("release",
+            base::BindOnce(&OffScreenFramePool::ReleaseFrame, pool, frame));
+}
+
+std::vector<gfx::Rect> GetDirtyRects(const SkRegion& region) {
+  std::vector<gfx::Rect> rects;
+  for (SkRegion::Iterator it(region); !it.done(); it.next()) {
+    if (rects.size() == kMaxDirtyRectCount)
+      return {gfx::SkIRectToRect(region.getBounds())};
+    rects.push_back(gfx::SkIRectToRect(it.rect()));
+  }
+  return rects;
+}
+
+}  // namespace
+
+bool WebContents::OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap) {
+  paint_damage_.op(gfx::RectToSkIRect(dirty_rect), SkRegion::kUnion_Op);
+
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  gin_helper::Dictionary frame_dict = gin::Dictionary::CreateEmpty(isolate);
+  if (frame_pool_) {
+    OffScreenFramePool::Frame frame;
+    // Skips the frame while JavaScript holds all the buffers.
+    if (!frame_pool_->LendFrame(bitmap, dirty_rect, &frame))
+      return false;
+    SetLentFrame(isolate, frame_pool_, frame, &frame_dict);
+  }
+
+  // With a pool the frame is only copied into the lent buffer, and the image
+  // is empty. Otherwise images may outlive the frames lent by the video
+  // capturer, so they get their own pixels.
+  gfx::Image image;
+  if (!frame_pool_) {
+    SkBitmap image_bitmap = bitmap;
+    if (bitmap.isImmutable()) {
+      SkBitmap copy;
+      if (!copy.tryAllocPixels(bitmap.info()) ||
+          !bitmap.readPixels(copy.pixmap()))
+        return false;
+      image_bitmap = copy;
+    }
+    image = gfx::Image::CreateFrom1xBitmap(image_bitmap);
+  }
+
+  frame_dict.Set("size", gfx::Size(bitmap.width(), bitmap.height()));
+  frame_dict.Set("dirtyRects", GetDirtyRects(paint_damage_));
+  gfx::Rect dirty_bounds = gfx::SkIRectToRect(paint_damage_.getBounds());
+  paint_damage_.setEmpty();
+  Emit("paint", dirty_bounds, image, frame_dict.GetHandle());
+  return true;
 }
 
 void WebContents::StartPainting() {
@@ -3155,6 +3506,47 @@ int WebContents::GetFrameRate() const {
   auto* osr_wcv = GetOffScreenWebContentsView();
   return osr_wcv ? osr_wcv->GetFrameRate() : 0;
 }
+
+void WebContents::SetFrameBufferCount(int count) {
+  // Frames lent by the previous pool are given back to it.
+  frame_pool_ = nullptr;
+  if (count > 0) {
+    frame_pool_ = base::MakeRefCounted<OffScreenFramePool>(
+        std::min(count, kMaxFrameBufferCount));
+  }
+}
+
+int WebContents::GetFrameBufferCount() const {
+  return frame_pool_ ? frame_pool_->capacity() : 0;
+}
+
+void WebContents::SetFramePacing(const gin_helper::Dictionary& options) {
+  OffScreenFramePacer::Options pacing;
+  options.Get("adaptive", &pacing.adaptive);
+  options.Get("idleFrameRate", &pacing.idle_frame_rate);
+  options.Get("idleFrameCount", &pacing.idle_frame_count);
+  auto* osr_wcv = GetOffScreenWebContentsView();
+  if (osr_wcv)
+    osr_wcv->SetFramePacing(pacing);
+}
+
+void WebContents::NotifyVSync() {
+  auto* osr_wcv = GetOffScreenWebContentsView();
+  if (osr_wcv)
+    osr_wcv->NotifyVSync();
+}
+
+v8::Local<v8::Value> WebContents::GetFrameStats(v8::Isolate* isolate) const {
+  OffScreenFramePacer::Stats stats;
+  auto* osr_wcv = GetOffScreenWebContentsView();
+  if (osr_wcv)
+    stats = osr_wcv->GetFrameStats();
+  gin_helper::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+  dict.Set("framesProduced", stats.frames_produced);
+  dict.Set("framesSkipped", stats.frames_skipped);
+  dict.Set("averageLatency", stats.average_latency.InMillisecondsF());
+  return dict.GetHandle();
+}
 #endif
 
 void WebContents::Invalidate() {
@@ -3916,6 +4308,9 @@ v8::Local<v8::ObjectTemplate> WebContents::FillObjectTemplate(
       .SetMethod("sendInputEvent", &WebContents::SendInputEvent)
       .SetMethod("beginFrameSubscription", &WebContents::BeginFrameSubscription)
       .SetMethod("endFrameSubscription", &WebContents::EndFrameSubscription)
+      .SetMethod("_startRecording", &WebContents::StartRecording)
+      .SetMethod("_setRecordingPaused", &WebContents::SetRecordingPaused)
+      .SetMethod("_stopRecording", &WebContents::StopRecording)
       .SetMethod("startDrag", &WebContents::StartDrag)
       .SetMethod("attachToIframe", &WebContents::AttachToIframe)
       .SetMethod("detachFromOuterFrame", &WebContents::DetachFromOuterFrame)
@@ -3926,6 +4321,11 @@ v8::Local<v8::ObjectTemplate> WebContents::FillObjectTemplate(
       .SetMethod("isPainting", &WebContents::IsPainting)
       .SetMethod("setFrameRate", &WebContents::SetFrameRate)
       .SetMethod("getFrameRate", &WebContents::GetFrameRate)
+      .SetMethod("setFrameBufferCount", &WebContents::SetFrameBufferCount)
+      .SetMethod("getFrameBufferCount", &WebContents::GetFrameBufferCount)
+      .SetMethod("setFramePacing", &WebContents::SetFramePacing)
+      .SetMethod("notifyVSync", &WebContents::NotifyVSync)
+      .SetMethod("getFrameStats", &WebContents::GetFrameStats)
 #endif
       .SetMethod("invalidate", &WebContents::Invalidate)
       .SetMethod("setZoomLevel", &WebContents::SetZoomLevel)
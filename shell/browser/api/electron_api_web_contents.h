@@ -32,6 +32,7 @@
 #include "gin/wrappable.h"
 #include "mojo/public/cpp/bindings/receiver_set.h"
 #include "printing/buildflags/buildflags.h"
+#include "shell/browser/api/frame_recorder.h"
 #include "shell/browser/api/frame_subscriber.h"
 #include "shell/browser/api/save_page_handler.h"
 #include "shell/browser/event_emitter_mixin.h"
@@ -43,6 +44,7 @@
 #include "shell/common/gin_helper/constructible.h"
 #include "shell/common/gin_helper/error_thrower.h"
 #include "shell/common/gin_helper/pinnable.h"
+#include "third_party/skia/include/core/SkRegion.h"
 #include "ui/base/models/image_model.h"
 #include "ui/gfx/image/image.h"
 
@@ -89,6 +91,7 @@ class WebDialogHelper;
 class NativeWindow;
 
 #if BUILDFLAG(ENABLE_OSR)
+class OffScreenFramePool;
 class OffScreenRenderWidgetHostView;
 class OffScreenWebContentsView;
 #endif
@@ -264,8 +267,13 @@ class WebContents : public ExclusiveAccessContext,
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
 
   // Subscribe to the frame updates.
-  void BeginFrameSubscription(gin::Arguments* args);
-  void EndFrameSubscription();
+  int BeginFrameSubscription(gin::Arguments* args);
+  void EndFrameSubscription(gin::Arguments* args);
+
+  // Encode the frames into a video.
+  void StartRecording(gin::Arguments* args);
+  void SetRecordingPaused(bool paused);
+  v8::Local<v8::Promise> StopRecording(v8::Isolate* isolate);
 
   // Dragging native items.
   void StartDrag(const gin_helper::Dictionary& item, gin::Arguments* args);
@@ -283,12 +291,18 @@ class WebContents : public ExclusiveAccessContext,
   // Methods for offscreen rendering
   bool IsOffScreen() const;
 #if BUILDFLAG(ENABLE_OSR)
-  void OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap);
+  // Returns whether a 'paint' event was emitted for the frame.
+  bool OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap);
   void StartPainting();
   void StopPainting();
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  void SetFrameBufferCount(int count);
+  int GetFrameBufferCount() const;
+  void SetFramePacing(const gin_helper::Dictionary& options);
+  void NotifyVSync();
+  v8::Local<v8::Value> GetFrameStats(v8::Isolate* isolate) const;
 #endif
   void Invalidate();
   gfx::Size GetSizeForNewRenderView(content::WebContents*) override;
@@ -405,9 +419,12 @@ class WebContents : public ExclusiveAccessContext,
                const std::string& channel,
                blink::CloneableMessage arguments,
                content::RenderFrameHost* render_frame_host);
+  void MessageBatch(std::vector<mojom::BatchedMessagePtr> messages,
+                    content::RenderFrameHost* render_frame_host);
   void Invoke(bool internal,
               const std::string& channel,
               blink::CloneableMessage arguments,
+              std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers,
               electron::mojom::ElectronBrowser::InvokeCallback callback,
               content::RenderFrameHost* render_frame_host);
   void OnFirstNonEmptyLayout(content::RenderFrameHost* render_frame_host);
@@ -477,6 +494,10 @@ class WebContents : public ExclusiveAccessContext,
       gin::Handle<class Session> session,
       const gin_helper::Dictionary& options);
 
+  // Callbacks of the frame recorder.
+  void OnRecordingData(scoped_refptr<base::RefCountedBytes> data);
+  void OnRecordedFrame(const FrameRecorder::EncodedFrame& frame);
+
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
   void InitWithExtensionView(v8::Isolate* isolate,
                              content::WebContents* web_contents,
@@ -743,6 +764,17 @@ class WebContents : public ExclusiveAccessContext,
   std::unique_ptr<ElectronJavaScriptDialogManager> dialog_manager_;
   std::unique_ptr<WebViewGuestDelegate> guest_delegate_;
   std::unique_ptr<FrameSubscriber> frame_subscriber_;
+  // The subscription begun without options, which a new one replaces.
+  int frame_subscription_id_ = 0;
+  std::unique_ptr<FrameRecorder> frame_recorder_;
+  int frame_recorder_subscription_id_ = 0;
+
+#if BUILDFLAG(ENABLE_OSR)
+  // The buffers lent to the paint event, when it uses a pool.
+  scoped_refptr<OffScreenFramePool> frame_pool_;
+  // The area painted since the last paint event, as frames can be skipped.
+  SkRegion paint_damage_;
+#endif
 
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
   std::unique_ptr<extensions::ScriptExecutor> script_executor_;
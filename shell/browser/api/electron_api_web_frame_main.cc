@@ -168,7 +168,7 @@ void WebFrameMain::Send(v8::Isolate* isolate,
                         const std::string& channel,
                         v8::Local<v8::Value> args) {
   blink::CloneableMessage message;
-  if (!gin::ConvertFromV8(isolate, args, &message)) {
+  if (!electron::SerializeV8Value(isolate, args, &message, channel)) {
     isolate->ThrowException(v8::Exception::Error(
         gin::StringToV8(isolate, "Failed to serialize arguments")));
     return;
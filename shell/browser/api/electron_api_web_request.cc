@@ -6,15 +6,20 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "base/stl_util.h"
+#include "base/strings/string_util.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/values.h"
 #include "extensions/browser/api/web_request/web_request_resource_type.h"
 #include "gin/converter.h"
 #include "gin/dictionary.h"
 #include "gin/object_template_builder.h"
 #include "net/http/http_content_disposition.h"
+#include "net/http/http_util.h"
 #include "shell/browser/api/electron_api_session.h"
 #include "shell/browser/api/electron_api_web_contents.h"
 #include "shell/browser/api/electron_api_web_frame_main.h"
@@ -27,55 +32,73 @@
 #include "shell/common/gin_converters/std_converter.h"
 #include "shell/common/gin_converters/value_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace gin {
 
 template <>
 struct Converter<extensions::WebRequestResourceType> {
-  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
-                                   extensions::WebRequestResourceType type) {
-    const char* result;
+  static const char* GetName(extensions::WebRequestResourceType type) {
     switch (type) {
       case extensions::WebRequestResourceType::MAIN_FRAME:
-        result = "mainFrame";
-        break;
+        return "mainFrame";
       case extensions::WebRequestResourceType::SUB_FRAME:
-        result = "subFrame";
-        break;
+        return "subFrame";
       case extensions::WebRequestResourceType::STYLESHEET:
-        result = "stylesheet";
-        break;
+        return "stylesheet";
       case extensions::WebRequestResourceType::SCRIPT:
-        result = "script";
-        break;
+        return "script";
       case extensions::WebRequestResourceType::IMAGE:
-        result = "image";
-        break;
+        return "image";
       case extensions::WebRequestResourceType::FONT:
-        result = "font";
-        break;
+        return "font";
       case extensions::WebRequestResourceType::OBJECT:
-        result = "object";
-        break;
+        return "object";
       case extensions::WebRequestResourceType::XHR:
-        result = "xhr";
-        break;
+        return "xhr";
       case extensions::WebRequestResourceType::PING:
-        result = "ping";
-        break;
+        return "ping";
       case extensions::WebRequestResourceType::CSP_REPORT:
-        result = "cspReport";
-        break;
+        return "cspReport";
       case extensions::WebRequestResourceType::MEDIA:
-        result = "media";
-        break;
+        return "media";
       case extensions::WebRequestResourceType::WEB_SOCKET:
-        result = "webSocket";
-        break;
+        return "webSocket";
       default:
-        result = "other";
+        return "other";
     }
-    return StringToV8(isolate, result);
+  }
+
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   extensions::WebRequestResourceType type) {
+    return StringToV8(isolate, GetName(type));
+  }
+
+  static bool FromV8(v8::Isolate* isolate,
+                     v8::Local<v8::Value> val,
+                     extensions::WebRequestResourceType* out) {
+    std::string name;
+    if (!ConvertFromV8(isolate, val, &name))
+      return false;
+    for (auto type : {extensions::WebRequestResourceType::MAIN_FRAME,
+                      extensions::WebRequestResourceType::SUB_FRAME,
+                      extensions::WebRequestResourceType::STYLESHEET,
+                      extensions::WebRequestResourceType::SCRIPT,
+                      extensions::WebRequestResourceType::IMAGE,
+                      extensions::WebRequestResourceType::FONT,
+                      extensions::WebRequestResourceType::OBJECT,
+                      extensions::WebRequestResourceType::XHR,
+                      extensions::WebRequestResourceType::PING,
+                      extensions::WebRequestResourceType::CSP_REPORT,
+                      extensions::WebRequestResourceType::MEDIA,
+                      extensions::WebRequestResourceType::WEB_SOCKET,
+                      extensions::WebRequestResourceType::OTHER}) {
+      if (name == GetName(type)) {
+        *out = type;
+        return true;
+      }
+    }
+    return false;
   }
 };
 
@@ -97,15 +120,8 @@ struct UserData : public base::SupportsUserData::Data {
 
 // Test whether the URL of |request| matches |patterns|.
 bool MatchesFilterCondition(extensions::WebRequestInfo* info,
-                            const std::set<URLPattern>& patterns) {
-  if (patterns.empty())
-    return true;
-
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(info->url))
-      return true;
-  }
-  return false;
+                            const URLPatternMatcher& patterns) {
+  return patterns.is_empty() || patterns.MatchesURL(info->url);
 }
 
 // Convert HttpResponseHeaders to V8.
@@ -146,8 +162,85 @@ v8::Local<v8::Value> HttpResponseHeadersToV8(
   return gin::ConvertToV8(v8::Isolate::GetCurrent(), response_headers);
 }
 
-// Overloaded by multiple types to fill the |details| object.
+// The fields of the details which are converted when a listener first reads
+// them, as most listeners only look at a few fields. A single holder keeps
+// them for the whole details object.
+class LazyDetails : public gin::Wrappable<LazyDetails> {
+ public:
+  static gin::WrapperInfo kWrapperInfo;
+
+  LazyDetails() = default;
+  ~LazyDetails() override = default;
+
+  // disable copy
+  LazyDetails(const LazyDetails&) = delete;
+  LazyDetails& operator=(const LazyDetails&) = delete;
+
+  // Defines the fields set in |lazy| on |details|. Each property then holds
+  // the converted value, so changes to it are kept.
+  static void Install(std::unique_ptr<LazyDetails> lazy,
+                      gin_helper::Dictionary* details) {
+    std::vector<base::StringPiece> keys;
+    if (lazy->response_headers)
+      keys.push_back(kResponseHeaders);
+    if (lazy->upload_data)
+      keys.push_back(kUploadData);
+    if (lazy->request_headers)
+      keys.push_back(kRequestHeaders);
+    if (keys.empty())
+      return;
+
+    v8::Isolate* isolate = details->isolate();
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Value> data =
+        gin::CreateHandle(isolate, lazy.release()).ToV8();
+    for (base::StringPiece key : keys) {
+      details->GetHandle()
+          ->SetLazyDataProperty(context, gin::StringToV8(isolate, key),
+                                &GetValue, data)
+          .Check();
+    }
+  }
+
+  scoped_refptr<net::HttpResponseHeaders> response_headers;
+  scoped_refptr<network::ResourceRequestBody> upload_data;
+  absl::optional<net::HttpRequestHeaders> request_headers;
+
+ private:
+  static constexpr char kResponseHeaders[] = "responseHeaders";
+  static constexpr char kUploadData[] = "uploadData";
+  static constexpr char kRequestHeaders[] = "requestHeaders";
+
+  static void GetValue(v8::Local<v8::Name> property,
+                       const v8::PropertyCallbackInfo<v8::Value>& info) {
+    v8::Isolate* isolate = info.GetIsolate();
+    LazyDetails* lazy = nullptr;
+    std::string key;
+    if (!gin::ConvertFromV8(isolate, info.Data(), &lazy) ||
+        !gin::ConvertFromV8(isolate, property, &key))
+      return;
+
+    if (key == kResponseHeaders && lazy->response_headers) {
+      info.GetReturnValue().Set(
+          HttpResponseHeadersToV8(lazy->response_headers.get()));
+      lazy->response_headers.reset();
+    } else if (key == kUploadData && lazy->upload_data) {
+      info.GetReturnValue().Set(gin::ConvertToV8(isolate, *lazy->upload_data));
+      lazy->upload_data.reset();
+    } else if (key == kRequestHeaders && lazy->request_headers) {
+      info.GetReturnValue().Set(
+          gin::ConvertToV8(isolate, *lazy->request_headers));
+      lazy->request_headers.reset();
+    }
+  }
+};
+
+gin::WrapperInfo LazyDetails::kWrapperInfo = {gin::kEmbedderNativeGin};
+
+// Overloaded by multiple types to fill the |details| object, and the fields
+// of |lazy| that are only converted on access.
 void ToDictionary(gin_helper::Dictionary* details,
+                  LazyDetails* lazy,
                   extensions::WebRequestInfo* info) {
   details->Set("id", info->id);
   details->Set("url", info->url);
@@ -160,8 +253,7 @@ void ToDictionary(gin_helper::Dictionary* details,
     details->Set("fromCache", info->response_from_cache);
     details->Set("statusLine", info->response_headers->GetStatusLine());
     details->Set("statusCode", info->response_headers->response_code());
-    details->Set("responseHeaders",
-                 HttpResponseHeadersToV8(info->response_headers.get()));
+    lazy->response_headers = info->response_headers;
   }
 
   auto* render_frame_host =
@@ -179,35 +271,36 @@ void ToDictionary(gin_helper::Dictionary* details,
 }
 
 void ToDictionary(gin_helper::Dictionary* details,
+                  LazyDetails* lazy,
                   const network::ResourceRequest& request) {
   details->Set("referrer", request.referrer);
-  if (request.request_body)
-    details->Set("uploadData", *request.request_body);
+  lazy->upload_data = request.request_body;
 }
 
 void ToDictionary(gin_helper::Dictionary* details,
+                  LazyDetails* lazy,
                   const net::HttpRequestHeaders& headers) {
-  details->Set("requestHeaders", headers);
+  lazy->request_headers = headers;
 }
 
-void ToDictionary(gin_helper::Dictionary* details, const GURL& location) {
+void ToDictionary(gin_helper::Dictionary* details,
+                  LazyDetails* lazy,
+                  const GURL& location) {
   details->Set("redirectURL", location);
 }
 
-void ToDictionary(gin_helper::Dictionary* details, int net_error) {
+void ToDictionary(gin_helper::Dictionary* details,
+                  LazyDetails* lazy,
+                  int net_error) {
   details->Set("error", net::ErrorToString(net_error));
 }
 
 // Helper function to fill |details| with arbitrary |args|.
-template <typename Arg>
-void FillDetails(gin_helper::Dictionary* details, Arg arg) {
-  ToDictionary(details, arg);
-}
-
-template <typename Arg, typename... Args>
-void FillDetails(gin_helper::Dictionary* details, Arg arg, Args... args) {
-  ToDictionary(details, arg);
-  FillDetails(details, args...);
+template <typename... Args>
+void FillDetails(gin_helper::Dictionary* details, const Args&... args) {
+  auto lazy = std::make_unique<LazyDetails>();
+  (ToDictionary(details, lazy.get(), args), ...);
+  LazyDetails::Install(std::move(lazy), details);
 }
 
 // Fill the native types with the result from the response object.
@@ -243,23 +336,138 @@ void ReadFromResponse(v8::Isolate* isolate,
   }
 }
 
+bool ParseHeaderOperations(
+    const gin_helper::Dictionary& action,
+    const char* key,
+    std::vector<WebRequestRules::HeaderOperation>* operations,
+    std::string* error) {
+  std::vector<gin_helper::Dictionary> headers;
+  if (!action.Get(key, &headers))
+    return true;
+  for (const auto& header : headers) {
+    WebRequestRules::HeaderOperation operation;
+    std::string type;
+    if (!header.Get("header", &operation.header) ||
+        !net::HttpUtil::IsValidHeaderName(operation.header)) {
+      *error = std::string("Invalid header name in ") + key;
+      return false;
+    }
+    header.Get("operation", &type);
+    if (type == "set") {
+      operation.type = WebRequestRules::HeaderOperation::Type::kSet;
+      if (!header.Get("value", &operation.value) ||
+          !net::HttpUtil::IsValidHeaderValue(operation.value)) {
+        *error = "Invalid value for header " + operation.header;
+        return false;
+      }
+    } else if (type == "remove") {
+      operation.type = WebRequestRules::HeaderOperation::Type::kRemove;
+    } else {
+      *error = "Header operation must be 'set' or 'remove'";
+      return false;
+    }
+    operations->push_back(std::move(operation));
+  }
+  return true;
+}
+
+bool ParseRule(const gin_helper::Dictionary& dict,
+               WebRequestRules::Rule* rule,
+               std::string* error) {
+  dict.Get("priority", &rule->priority);
+  if (rule->priority < 1) {
+    *error = "Rule priority must be at least 1";
+    return false;
+  }
+
+  gin_helper::Dictionary condition;
+  if (dict.Get("condition", &condition)) {
+    std::set<std::string> urls;
+    condition.Get("urls", &urls);
+    for (const std::string& url : urls) {
+      URLPattern pattern(URLPattern::SCHEME_ALL);
+      const URLPattern::ParseResult result = pattern.Parse(url);
+      if (result != URLPattern::ParseResult::kSuccess) {
+        *error = "Invalid url pattern " + url + ": " +
+                 URLPattern::GetParseResultString(result);
+        return false;
+      }
+      rule->urls.insert(pattern);
+    }
+    if (condition.Has("resourceTypes") &&
+        !condition.Get("resourceTypes", &rule->resource_types)) {
+      *error = "Invalid resource type";
+      return false;
+    }
+    std::set<std::string> methods;
+    condition.Get("methods", &methods);
+    for (const std::string& method : methods)
+      rule->methods.insert(base::ToUpperASCII(method));
+  }
+
+  gin_helper::Dictionary action;
+  std::string type;
+  if (!dict.Get("action", &action) || !action.Get("type", &type)) {
+    *error = "Rule must have an action type";
+    return false;
+  }
+  if (type == "allow") {
+    rule->action = WebRequestRules::Rule::Action::kAllow;
+  } else if (type == "block") {
+    rule->action = WebRequestRules::Rule::Action::kBlock;
+  } else if (type == "redirect") {
+    rule->action = WebRequestRules::Rule::Action::kRedirect;
+    if (!action.Get("redirectURL", &rule->redirect_url) ||
+        !rule->redirect_url.is_valid()) {
+      *error = "Redirect rules must have a valid redirectURL";
+      return false;
+    }
+  } else if (type == "modifyHeaders") {
+    rule->action = WebRequestRules::Rule::Action::kModifyHeaders;
+    if (!ParseHeaderOperations(action, "requestHeaders",
+                               &rule->request_headers, error) ||
+        !ParseHeaderOperations(action, "responseHeaders",
+                               &rule->response_headers, error)) {
+      return false;
+    }
+    if (rule->request_headers.empty() && rule->response_headers.empty()) {
+      *error = "modifyHeaders rules must modify requestHeaders or "
+               "responseHeaders";
+      return false;
+    }
+  } else {
+    *error = "Unknown rule action type " + type;
+    return false;
+  }
+  return true;
+}
+
 }  // namespace
 
 gin::WrapperInfo WebRequest::kWrapperInfo = {gin::kEmbedderNativeGin};
 
 WebRequest::SimpleListenerInfo::SimpleListenerInfo(
-    std::set<URLPattern> patterns_,
-    SimpleListener listener_)
-    : url_patterns(std::move(patterns_)), listener(listener_) {}
+    const std::set<URLPattern>& patterns_,
+    SimpleListener listener_,
+    bool batched_)
+    : url_patterns(patterns_), listener(listener_), batched(batched_) {}
 WebRequest::SimpleListenerInfo::SimpleListenerInfo() = default;
 WebRequest::SimpleListenerInfo::~SimpleListenerInfo() = default;
+WebRequest::SimpleListenerInfo::SimpleListenerInfo(SimpleListenerInfo&&) =
+    default;
+WebRequest::SimpleListenerInfo& WebRequest::SimpleListenerInfo::operator=(
+    SimpleListenerInfo&&) = default;
 
 WebRequest::ResponseListenerInfo::ResponseListenerInfo(
-    std::set<URLPattern> patterns_,
+    const std::set<URLPattern>& patterns_,
     ResponseListener listener_)
-    : url_patterns(std::move(patterns_)), listener(listener_) {}
+    : url_patterns(patterns_), listener(listener_) {}
 WebRequest::ResponseListenerInfo::ResponseListenerInfo() = default;
 WebRequest::ResponseListenerInfo::~ResponseListenerInfo() = default;
+WebRequest::ResponseListenerInfo::ResponseListenerInfo(
+    ResponseListenerInfo&&) = default;
+WebRequest::ResponseListenerInfo& WebRequest::ResponseListenerInfo::operator=(
+    ResponseListenerInfo&&) = default;
 
 WebRequest::WebRequest(v8::Isolate* isolate,
                        content::BrowserContext* browser_context)
@@ -293,7 +501,8 @@ gin::ObjectTemplateBuilder WebRequest::GetObjectTemplateBuilder(
       .SetMethod("onErrorOccurred",
                  &WebRequest::SetSimpleListener<SimpleEvent::kOnErrorOccurred>)
       .SetMethod("onCompleted",
-                 &WebRequest::SetSimpleListener<SimpleEvent::kOnCompleted>);
+                 &WebRequest::SetSimpleListener<SimpleEvent::kOnCompleted>)
+      .SetMethod("setRules", &WebRequest::SetRules);
 }
 
 const char* WebRequest::GetTypeName() {
@@ -301,13 +510,24 @@ const char* WebRequest::GetTypeName() {
 }
 
 bool WebRequest::HasListener() const {
-  return !(simple_listeners_.empty() && response_listeners_.empty());
+  return !(simple_listeners_.empty() && response_listeners_.empty() &&
+           rules_.empty());
 }
 
 int WebRequest::OnBeforeRequest(extensions::WebRequestInfo* info,
                                 const network::ResourceRequest& request,
                                 net::CompletionOnceCallback callback,
                                 GURL* new_url) {
+  // The rules run before the listeners, and the requests they decide never
+  // reach JavaScript.
+  switch (rules_.OnBeforeRequest(*info, new_url)) {
+    case WebRequestRules::Result::kBlocked:
+      return net::ERR_BLOCKED_BY_CLIENT;
+    case WebRequestRules::Result::kDecided:
+      return net::OK;
+    case WebRequestRules::Result::kNone:
+      break;
+  }
   return HandleResponseEvent(ResponseEvent::kOnBeforeRequest, info,
                              std::move(callback), new_url, request);
 }
@@ -316,6 +536,9 @@ int WebRequest::OnBeforeSendHeaders(extensions::WebRequestInfo* info,
                                     const network::ResourceRequest& request,
                                     BeforeSendHeadersCallback callback,
                                     net::HttpRequestHeaders* headers) {
+  if (rules_.OnBeforeSendHeaders(*info, headers) !=
+      WebRequestRules::Result::kNone)
+    return net::OK;
   return HandleResponseEvent(
       ResponseEvent::kOnBeforeSendHeaders, info,
       base::BindOnce(std::move(callback), std::set<std::string>(),
@@ -330,6 +553,10 @@ int WebRequest::OnHeadersReceived(
     const net::HttpResponseHeaders* original_response_headers,
     scoped_refptr<net::HttpResponseHeaders>* override_response_headers,
     GURL* allowed_unsafe_redirect_url) {
+  if (rules_.OnHeadersReceived(*info, original_response_headers,
+                               override_response_headers) !=
+      WebRequestRules::Result::kNone)
+    return net::OK;
   const std::string& status_line =
       original_response_headers ? original_response_headers->GetStatusLine()
                                 : std::string();
@@ -376,6 +603,26 @@ void WebRequest::OnRequestWillBeDestroyed(extensions::WebRequestInfo* info) {
   callbacks_.erase(info->id);
 }
 
+void WebRequest::SetRules(gin::Arguments* args) {
+  std::vector<gin_helper::Dictionary> dicts;
+  if (!args->GetNext(&dicts)) {
+    args->ThrowTypeError("Must pass an Array of rules");
+    return;
+  }
+
+  std::vector<WebRequestRules::Rule> rules;
+  for (const auto& dict : dicts) {
+    WebRequestRules::Rule rule;
+    std::string error;
+    if (!ParseRule(dict, &rule, &error)) {
+      args->ThrowTypeError(error);
+      return;
+    }
+    rules.push_back(std::move(rule));
+  }
+  rules_.SetRules(std::move(rules));
+}
+
 template <WebRequest::SimpleEvent event>
 void WebRequest::SetSimpleListener(gin::Arguments* args) {
   SetListener<SimpleListener>(event, &simple_listeners_, args);
@@ -392,8 +639,9 @@ void WebRequest::SetListener(Event event,
                              gin::Arguments* args) {
   v8::Local<v8::Value> arg;
 
-  // { urls }.
+  // { urls, batched }.
   std::set<std::string> filter_patterns;
+  bool batched = false;
   gin::Dictionary dict(args->isolate());
   if (args->GetNext(&arg) && !arg->IsFunction()) {
     // Note that gin treats Function as Dictionary when doing conversions, so we
@@ -404,6 +652,7 @@ void WebRequest::SetListener(Event event,
         args->ThrowTypeError("Parameter 'filter' must have property 'urls'.");
         return;
       }
+      dict.Get("batched", &batched);
       args->GetNext(&arg);
     }
   }
@@ -430,16 +679,35 @@ void WebRequest::SetListener(Event event,
     return;
   }
 
-  if (listener.is_null())
+  // Only the events which end a stage of requests, and which many requests
+  // reach at once, can be batched.
+  bool can_be_batched = false;
+  if constexpr (std::is_same<Event, SimpleEvent>::value) {
+    can_be_batched = event == SimpleEvent::kOnResponseStarted ||
+                     event == SimpleEvent::kOnCompleted ||
+                     event == SimpleEvent::kOnErrorOccurred;
+  }
+  if (batched && !listener.is_null() && !can_be_batched) {
+    args->ThrowTypeError(
+        "Only onResponseStarted, onCompleted and onErrorOccurred can be "
+        "batched.");
+    return;
+  }
+
+  // The patterns are compiled once here rather than on every request.
+  if (listener.is_null()) {
     listeners->erase(event);
-  else
-    (*listeners)[event] = {std::move(patterns), std::move(listener)};
+  } else if constexpr (std::is_same<Listener, SimpleListener>::value) {
+    (*listeners)[event] = {patterns, std::move(listener), batched};
+  } else {
+    (*listeners)[event] = {patterns, std::move(listener)};
+  }
 }
 
 template <typename... Args>
 void WebRequest::HandleSimpleEvent(SimpleEvent event,
                                    extensions::WebRequestInfo* request_info,
-                                   Args... args) {
+                                   const Args&... args) {
   const auto iter = simple_listeners_.find(event);
   if (iter == std::end(simple_listeners_))
     return;
@@ -452,15 +720,46 @@ void WebRequest::HandleSimpleEvent(SimpleEvent event,
   v8::HandleScope handle_scope(isolate);
   gin_helper::Dictionary details(isolate, v8::Object::New(isolate));
   FillDetails(&details, request_info, args...);
+
+  if (info.batched) {
+    // The details of the events of this task go to the listener together,
+    // in one call.
+    auto& batch = batched_details_[event];
+    if (batch.empty()) {
+      base::SequencedTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(&WebRequest::FlushBatchedDetails,
+                                    weak_factory_.GetWeakPtr(), event));
+    }
+    batch.emplace_back(isolate, details.GetHandle());
+    return;
+  }
+
   info.listener.Run(gin::ConvertToV8(isolate, details));
 }
 
+void WebRequest::FlushBatchedDetails(SimpleEvent event) {
+  auto batch = batched_details_.extract(event);
+  const auto iter = simple_listeners_.find(event);
+  // The listener was removed or replaced since.
+  if (batch.empty() || iter == std::end(simple_listeners_) ||
+      !iter->second.batched)
+    return;
+
+  v8::Isolate* isolate = JavascriptEnvironment::GetIsolate();
+  v8::HandleScope handle_scope(isolate);
+  std::vector<v8::Local<v8::Value>> details;
+  details.reserve(batch.mapped().size());
+  for (const auto& value : batch.mapped())
+    details.push_back(value.Get(isolate));
+  iter->second.listener.Run(gin::ConvertToV8(isolate, details));
+}
+
 template <typename Out, typename... Args>
 int WebRequest::HandleResponseEvent(ResponseEvent event,
                                     extensions::WebRequestInfo* request_info,
                                     net::CompletionOnceCallback callback,
                                     Out out,
-                                    Args... args) {
+                                    const Args&... args) {
   const auto iter = response_listeners_.find(event);
   if (iter == std::end(response_listeners_))
     return net::OK;
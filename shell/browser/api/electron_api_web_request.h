@@ -7,13 +7,17 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
+#include "base/memory/weak_ptr.h"
 #include "base/values.h"
 #include "extensions/common/url_pattern.h"
 #include "gin/arguments.h"
 #include "gin/handle.h"
 #include "gin/wrappable.h"
+#include "shell/browser/net/url_pattern_matcher.h"
 #include "shell/browser/net/web_request_api_interface.h"
+#include "shell/browser/net/web_request_rules.h"
 
 namespace content {
 class BrowserContext;
@@ -104,6 +108,9 @@ class WebRequest : public gin::Wrappable<WebRequest>, public WebRequestAPI {
   using ResponseListener =
       base::RepeatingCallback<void(v8::Local<v8::Value>, ResponseCallback)>;
 
+  // Replaces the declarative rules.
+  void SetRules(gin::Arguments* args);
+
   template <SimpleEvent event>
   void SetSimpleListener(gin::Arguments* args);
   template <ResponseEvent event>
@@ -114,41 +121,54 @@ class WebRequest : public gin::Wrappable<WebRequest>, public WebRequestAPI {
   template <typename... Args>
   void HandleSimpleEvent(SimpleEvent event,
                          extensions::WebRequestInfo* info,
-                         Args... args);
+                         const Args&... args);
   template <typename Out, typename... Args>
   int HandleResponseEvent(ResponseEvent event,
                           extensions::WebRequestInfo* info,
                           net::CompletionOnceCallback callback,
                           Out out,
-                          Args... args);
+                          const Args&... args);
+
+  // Delivers the details queued for a batched listener of |event|.
+  void FlushBatchedDetails(SimpleEvent event);
 
   template <typename T>
   void OnListenerResult(uint64_t id, T out, v8::Local<v8::Value> response);
 
   struct SimpleListenerInfo {
-    std::set<URLPattern> url_patterns;
+    URLPatternMatcher url_patterns;
     SimpleListener listener;
+    // Whether the listener gets the details of the events of a task at once.
+    bool batched = false;
 
-    SimpleListenerInfo(std::set<URLPattern>, SimpleListener);
+    SimpleListenerInfo(const std::set<URLPattern>&, SimpleListener, bool);
     SimpleListenerInfo();
     ~SimpleListenerInfo();
+    SimpleListenerInfo(SimpleListenerInfo&&);
+    SimpleListenerInfo& operator=(SimpleListenerInfo&&);
   };
 
   struct ResponseListenerInfo {
-    std::set<URLPattern> url_patterns;
+    URLPatternMatcher url_patterns;
     ResponseListener listener;
 
-    ResponseListenerInfo(std::set<URLPattern>, ResponseListener);
+    ResponseListenerInfo(const std::set<URLPattern>&, ResponseListener);
     ResponseListenerInfo();
     ~ResponseListenerInfo();
+    ResponseListenerInfo(ResponseListenerInfo&&);
+    ResponseListenerInfo& operator=(ResponseListenerInfo&&);
   };
 
   std::map<SimpleEvent, SimpleListenerInfo> simple_listeners_;
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
   std::map<uint64_t, net::CompletionOnceCallback> callbacks_;
+  std::map<SimpleEvent, std::vector<v8::Global<v8::Value>>> batched_details_;
+  WebRequestRules rules_;
 
   // Weak-ref, it manages us.
   content::BrowserContext* browser_context_;
+
+  base::WeakPtrFactory<WebRequest> weak_factory_{this};
 };
 
 }  // namespace api
@@ -0,0 +1,331 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/api/frame_recorder.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/bind_post_task.h"
+#include "base/files/file.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "third_party/libvpx/source/libvpx/vpx/vp8cx.h"
+#include "third_party/libvpx/source/libvpx/vpx/vpx_encoder.h"
+#include "third_party/libyuv/include/libyuv/scale.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+// Frames given to the encoder and not encoded yet, beyond which new frames
+// are dropped rather than queued.
+constexpr int kMaxFramesInFlight = 2;
+
+// The speed of the realtime modes of VP8 and VP9, trading quality for time.
+constexpr int kEncoderSpeed = 8;
+
+// Timestamps are in milliseconds.
+constexpr int kTimebase = 1000;
+
+constexpr size_t kIvfFileHeaderSize = 32;
+constexpr size_t kIvfFrameCountOffset = 24;
+
+// IVF stores its fields in little endian.
+void AppendLittleEndian(std::vector<uint8_t>* out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i)
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+}  // namespace
+
+// Lives on the sequence of the encoder.
+class FrameRecorder::Encoder {
+ public:
+  Encoder(const Options& options, const DataCallback& data_callback)
+      : options_(options), data_callback_(data_callback) {
+    if (!options_.path.empty()) {
+      file_.Initialize(options_.path, base::File::FLAG_CREATE_ALWAYS |
+                                          base::File::FLAG_WRITE);
+      if (!file_.IsValid())
+        Fail("Failed to open " + options_.path.AsUTF8Unsafe());
+    }
+  }
+
+  ~Encoder() {
+    if (initialized_)
+      vpx_codec_destroy(&codec_);
+  }
+
+  // disable copy
+  Encoder(const Encoder&) = delete;
+  Encoder& operator=(const Encoder&) = delete;
+
+  EncodedFrame Encode(scoped_refptr<base::RefCountedBytes> planes,
+                      const gfx::Size& size,
+                      base::TimeDelta timestamp) {
+    EncodedFrame result;
+    result.timestamp = timestamp;
+    if (!stats_.error.empty() || finished_)
+      return result;
+    if (!initialized_ && !Initialize(size))
+      return result;
+
+    base::TimeTicks start = base::TimeTicks::Now();
+
+    // The stream keeps the size of its first frame.
+    const uint8_t* data = planes->front();
+    if (size != size_) {
+      ScaleFrame(data, size);
+      data = scaled_planes_.data();
+    }
+
+    vpx_image_t image;
+    WrapFrame(data, &image);
+    int64_t pts = std::max(timestamp.InMilliseconds(), last_pts_ + 1);
+    last_pts_ = pts;
+    vpx_enc_frame_flags_t flags =
+        stats_.frames_encoded == 0 ? VPX_EFLAG_FORCE_KF : 0;
+    vpx_codec_err_t error =
+        vpx_codec_encode(&codec_, &image, pts, kTimebase / options_.frame_rate,
+                         flags, VPX_DL_REALTIME);
+    if (error != VPX_CODEC_OK) {
+      Fail(std::string("Failed to encode frame: ") +
+           vpx_codec_err_to_string(error));
+      return result;
+    }
+    WritePackets(&result);
+    Flush();
+
+    result.encode_time = base::TimeTicks::Now() - start;
+    ++stats_.frames_encoded;
+    total_encode_time_ += result.encode_time;
+    return result;
+  }
+
+  Stats Finish() {
+    if (finished_)
+      return stats_;
+    finished_ = true;
+
+    if (initialized_ && stats_.error.empty()) {
+      vpx_codec_encode(&codec_, nullptr, -1, 0, 0, VPX_DL_REALTIME);
+      WritePackets(nullptr);
+      Flush();
+    }
+    if (file_.IsValid()) {
+      // The header was written before the frames were counted.
+      if (initialized_) {
+        std::vector<uint8_t> count;
+        AppendLittleEndian(&count, frame_count_, 4);
+        file_.Write(kIvfFrameCountOffset,
+                    reinterpret_cast<const char*>(count.data()), count.size());
+      }
+      file_.Close();
+    }
+
+    if (stats_.frames_encoded)
+      stats_.average_encode_time = total_encode_time_ / stats_.frames_encoded;
+    return stats_;
+  }
+
+ private:
+  bool Initialize(const gfx::Size& size) {
+    if (size.IsEmpty()) {
+      Fail("Invalid frame size");
+      return false;
+    }
+
+    vpx_codec_iface_t* iface = options_.codec == Codec::kVP9
+                                   ? vpx_codec_vp9_cx()
+                                   : vpx_codec_vp8_cx();
+    vpx_codec_enc_cfg_t config;
+    vpx_codec_err_t error = vpx_codec_enc_config_default(iface, &config, 0);
+    if (error == VPX_CODEC_OK) {
+      config.g_w = size.width();
+      config.g_h = size.height();
+      config.g_timebase.num = 1;
+      config.g_timebase.den = kTimebase;
+      // Frames come out as soon as they go in.
+      config.g_lag_in_frames = 0;
+      config.rc_end_usage = VPX_CBR;
+      config.rc_target_bitrate = std::max(1, options_.bitrate / 1000);
+      config.kf_max_dist = options_.frame_rate * 10;
+      error = vpx_codec_enc_init(&codec_, iface, &config, 0);
+    }
+    if (error != VPX_CODEC_OK) {
+      Fail(std::string("Failed to initialize encoder: ") +
+           vpx_codec_err_to_string(error));
+      return false;
+    }
+    initialized_ = true;
+    vpx_codec_control(&codec_, VP8E_SET_CPUUSED, kEncoderSpeed);
+    size_ = size;
+
+    const char* fourcc = options_.codec == Codec::kVP9 ? "VP90" : "VP80";
+    pending_.insert(pending_.end(), {'D', 'K', 'I', 'F'});
+    AppendLittleEndian(&pending_, 0, 2);  // version
+    AppendLittleEndian(&pending_, kIvfFileHeaderSize, 2);
+    pending_.insert(pending_.end(), fourcc, fourcc + 4);
+    AppendLittleEndian(&pending_, size.width(), 2);
+    AppendLittleEndian(&pending_, size.height(), 2);
+    AppendLittleEndian(&pending_, kTimebase, 4);
+    AppendLittleEndian(&pending_, 1, 4);
+    // The frame count, unknown while streaming.
+    AppendLittleEndian(&pending_, 0, 4);
+    AppendLittleEndian(&pending_, 0, 4);  // unused
+    return true;
+  }
+
+  void ScaleFrame(const uint8_t* data, const gfx::Size& size) {
+    int width = size.width();
+    int chroma_width = (width + 1) / 2;
+    const uint8_t* u = data + width * size.height();
+    const uint8_t* v = u + chroma_width * ((size.height() + 1) / 2);
+
+    int scaled_width = size_.width();
+    int scaled_chroma_width = (scaled_width + 1) / 2;
+    size_t y_size = static_cast<size_t>(scaled_width) * size_.height();
+    size_t chroma_size =
+        static_cast<size_t>(scaled_chroma_width) * ((size_.height() + 1) / 2);
+    scaled_planes_.resize(y_size + 2 * chroma_size);
+    uint8_t* scaled_y = scaled_planes_.data();
+    uint8_t* scaled_u = scaled_y + y_size;
+    uint8_t* scaled_v = scaled_u + chroma_size;
+    libyuv::I420Scale(data, width, u, chroma_width, v, chroma_width, width,
+                      size.height(), scaled_y, scaled_width, scaled_u,
+                      scaled_chroma_width, scaled_v, scaled_chroma_width,
+                      scaled_width, size_.height(), libyuv::kFilterBilinear);
+  }
+
+  // The planes of the frame follow each other without padding.
+  void WrapFrame(const uint8_t* data, vpx_image_t* image) {
+    int width = size_.width();
+    int chroma_width = (width + 1) / 2;
+    auto* y = const_cast<uint8_t*>(data);
+    vpx_img_wrap(image, VPX_IMG_FMT_I420, width, size_.height(), 1, y);
+    image->planes[VPX_PLANE_U] = y + width * size_.height();
+    image->planes[VPX_PLANE_V] =
+        image->planes[VPX_PLANE_U] + chroma_width * ((size_.height() + 1) / 2);
+    image->stride[VPX_PLANE_Y] = width;
+    image->stride[VPX_PLANE_U] = chroma_width;
+    image->stride[VPX_PLANE_V] = chroma_width;
+  }
+
+  void WritePackets(EncodedFrame* result) {
+    vpx_codec_iter_t iter = nullptr;
+    while (const vpx_codec_cx_pkt_t* packet =
+               vpx_codec_get_cx_data(&codec_, &iter)) {
+      if (packet->kind != VPX_CODEC_CX_FRAME_PKT)
+        continue;
+      const auto* data = static_cast<const uint8_t*>(packet->data.frame.buf);
+      size_t size = packet->data.frame.sz;
+      AppendLittleEndian(&pending_, size, 4);
+      AppendLittleEndian(&pending_, packet->data.frame.pts, 8);
+      pending_.insert(pending_.end(), data, data + size);
+      ++frame_count_;
+      if (result) {
+        result->size += size;
+        if (packet->data.frame.flags & VPX_FRAME_IS_KEY)
+          result->key_frame = true;
+      }
+    }
+  }
+
+  void Flush() {
+    if (pending_.empty())
+      return;
+    if (file_.IsValid()) {
+      int size = static_cast<int>(pending_.size());
+      if (file_.WriteAtCurrentPos(reinterpret_cast<const char*>(
+                                      pending_.data()),
+                                  size) != size) {
+        Fail("Failed to write " + options_.path.AsUTF8Unsafe());
+      }
+      pending_.clear();
+    } else {
+      data_callback_.Run(base::RefCountedBytes::TakeVector(&pending_));
+    }
+  }
+
+  void Fail(const std::string& error) {
+    if (stats_.error.empty())
+      stats_.error = error;
+  }
+
+  const Options options_;
+  const DataCallback data_callback_;
+  base::File file_;
+
+  vpx_codec_ctx_t codec_;
+  bool initialized_ = false;
+  bool finished_ = false;
+  gfx::Size size_;
+  int64_t last_pts_ = -1;
+  uint32_t frame_count_ = 0;
+
+  // The output not written yet.
+  std::vector<uint8_t> pending_;
+  std::vector<uint8_t> scaled_planes_;
+
+  Stats stats_;
+  base::TimeDelta total_encode_time_;
+};
+
+FrameRecorder::FrameRecorder(const Options& options,
+                             const DataCallback& data_callback,
+                             const EncodedFrameCallback& encoded_frame_callback)
+    : encoded_frame_callback_(encoded_frame_callback),
+      encoder_(base::ThreadPool::CreateSequencedTaskRunner(
+                   {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+                    base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN}),
+               options,
+               base::BindPostTask(base::SequencedTaskRunnerHandle::Get(),
+                                  data_callback)) {}
+
+FrameRecorder::~FrameRecorder() = default;
+
+void FrameRecorder::OnFrame(const FrameSubscriber::Frame& frame,
+                            const gfx::Rect& damage) {
+  if (stopped_ || !frame.planes)
+    return;
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (start_time_.is_null())
+    start_time_ = now;
+  if (paused_ || frames_in_flight_ >= kMaxFramesInFlight) {
+    ++frames_dropped_;
+    return;
+  }
+
+  ++frames_in_flight_;
+  encoder_.AsyncCall(&Encoder::Encode)
+      .WithArgs(frame.planes, frame.size, now - start_time_)
+      .Then(base::BindOnce(&FrameRecorder::OnFrameEncoded,
+                           weak_ptr_factory_.GetWeakPtr()));
+}
+
+void FrameRecorder::Stop(StopCallback callback) {
+  stopped_ = true;
+  encoder_.AsyncCall(&Encoder::Finish)
+      .Then(base::BindOnce(
+          [](uint64_t frames_dropped, StopCallback callback, Stats stats) {
+            stats.frames_dropped = frames_dropped;
+            std::move(callback).Run(stats);
+          },
+          frames_dropped_, std::move(callback)));
+}
+
+void FrameRecorder::OnFrameEncoded(const EncodedFrame& frame) {
+  --frames_in_flight_;
+  encoded_frame_callback_.Run(frame);
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,106 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_API_FRAME_RECORDER_H_
+#define SHELL_BROWSER_API_FRAME_RECORDER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/sequence_bound.h"
+#include "base/time/time.h"
+#include "shell/browser/api/frame_subscriber.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace electron {
+
+namespace api {
+
+// Encodes the I420 frames of a FrameSubscriber subscription with libvpx, into
+// an IVF stream written to a file or handed out in chunks. Encoding runs on a
+// sequence of its own, and frames arriving while it is busy or paused are
+// dropped.
+class FrameRecorder {
+ public:
+  enum class Codec { kVP8, kVP9 };
+
+  struct Options {
+    Codec codec = Codec::kVP8;
+    // In bits per second.
+    int bitrate = 2500000;
+    int frame_rate = 30;
+    // Writes to the file if not empty, otherwise to the data callback.
+    base::FilePath path;
+  };
+
+  struct EncodedFrame {
+    // From the start of the recording.
+    base::TimeDelta timestamp;
+    bool key_frame = false;
+    // Zero when the encoder dropped the frame.
+    size_t size = 0;
+    base::TimeDelta encode_time;
+  };
+
+  struct Stats {
+    uint64_t frames_encoded = 0;
+    uint64_t frames_dropped = 0;
+    base::TimeDelta average_encode_time;
+    // Set when the recording failed.
+    std::string error;
+  };
+
+  using DataCallback =
+      base::RepeatingCallback<void(scoped_refptr<base::RefCountedBytes>)>;
+  using EncodedFrameCallback =
+      base::RepeatingCallback<void(const EncodedFrame&)>;
+  using StopCallback = base::OnceCallback<void(const Stats&)>;
+
+  FrameRecorder(const Options& options,
+                const DataCallback& data_callback,
+                const EncodedFrameCallback& encoded_frame_callback);
+  ~FrameRecorder();
+
+  // disable copy
+  FrameRecorder(const FrameRecorder&) = delete;
+  FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+  // The callback of the frame subscription feeding the recorder.
+  void OnFrame(const FrameSubscriber::Frame& frame, const gfx::Rect& damage);
+
+  // Drops new frames while paused, to apply backpressure from the consumer
+  // of the data.
+  void SetPaused(bool paused) { paused_ = paused; }
+
+  // Encodes the frames in flight and finishes the stream. Frames are no longer
+  // accepted.
+  void Stop(StopCallback callback);
+
+ private:
+  class Encoder;
+
+  void OnFrameEncoded(const EncodedFrame& frame);
+
+  const EncodedFrameCallback encoded_frame_callback_;
+
+  base::SequenceBound<Encoder> encoder_;
+
+  base::TimeTicks start_time_;
+  int frames_in_flight_ = 0;
+  uint64_t frames_dropped_ = 0;
+  bool paused_ = false;
+  bool stopped_ = false;
+
+  base::WeakPtrFactory<FrameRecorder> weak_ptr_factory_{this};
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_API_FRAME_RECORDER_H_
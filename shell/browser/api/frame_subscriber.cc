@@ -4,30 +4,108 @@
 
 #include "shell/browser/api/frame_subscriber.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
+#include "base/containers/cxx20_erase.h"
 #include "content/public/browser/render_view_host.h"
 #include "content/public/browser/render_widget_host.h"
 #include "content/public/browser/render_widget_host_view.h"
+#include "media/base/video_frame_metadata.h"
 #include "media/capture/mojom/video_capture_buffer.mojom.h"
 #include "media/capture/mojom/video_capture_types.mojom.h"
 #include "mojo/public/cpp/bindings/remote.h"
+#include "third_party/libyuv/include/libyuv/convert_from_argb.h"
+#include "third_party/libyuv/include/libyuv/scale_argb.h"
+#include "ui/gfx/geometry/rect_conversions.h"
 #include "ui/gfx/geometry/size_conversions.h"
-#include "ui/gfx/image/image.h"
-#include "ui/gfx/skbitmap_operations.h"
 
 namespace electron {
 
 namespace api {
 
-constexpr static int kMaxFrameRate = 30;
+namespace {
 
-FrameSubscriber::FrameSubscriber(content::WebContents* web_contents,
-                                 const FrameCaptureCallback& callback,
-                                 bool only_dirty)
+constexpr int kMaxFrameRate = 60;
+
+// Scales |size| down to fit in |bounds|, keeping its aspect ratio.
+gfx::Size GetScaledSize(const gfx::Size& size, const gfx::Size& bounds) {
+  if (bounds.IsEmpty() || (size.width() <= bounds.width() &&
+                           size.height() <= bounds.height()))
+    return size;
+  float scale = std::min(
+      static_cast<float>(bounds.width()) / size.width(),
+      static_cast<float>(bounds.height()) / size.height());
+  gfx::Size scaled =
+      gfx::ToFlooredSize(gfx::ScaleSize(gfx::SizeF(size), scale));
+  scaled.SetToMax(gfx::Size(1, 1));
+  return scaled;
+}
+
+// Copies |bitmap|, scaled to |size|, into a bitmap of its own, so that the
+// capturer can recycle the frame.
+SkBitmap CopyScaledBitmap(const SkBitmap& bitmap, const gfx::Size& size) {
+  SkBitmap copy;
+  if (!copy.tryAllocPixels(
+          SkImageInfo::MakeN32Premul(size.width(), size.height())))
+    return SkBitmap();
+  if (size.width() == bitmap.width() && size.height() == bitmap.height()) {
+    if (!bitmap.readPixels(copy.pixmap()))
+      return SkBitmap();
+    return copy;
+  }
+  libyuv::ARGBScale(static_cast<const uint8_t*>(bitmap.getPixels()),
+                    static_cast<int>(bitmap.rowBytes()), bitmap.width(),
+                    bitmap.height(), static_cast<uint8_t*>(copy.getPixels()),
+                    static_cast<int>(copy.rowBytes()), size.width(),
+                    size.height(), libyuv::kFilterBilinear);
+  return copy;
+}
+
+// Returns the planes of |bitmap| in |format|, one after the other.
+scoped_refptr<base::RefCountedBytes> ConvertToYUV(
+    const SkBitmap& bitmap,
+    FrameSubscriber::PixelFormat format) {
+  int width = bitmap.width();
+  int height = bitmap.height();
+  int chroma_width = (width + 1) / 2;
+  int chroma_height = (height + 1) / 2;
+  size_t y_size = static_cast<size_t>(width) * height;
+  size_t chroma_size = static_cast<size_t>(chroma_width) * chroma_height;
+  auto planes =
+      base::MakeRefCounted<base::RefCountedBytes>(y_size + 2 * chroma_size);
+  uint8_t* y = planes->data().data();
+  const auto* argb = static_cast<const uint8_t*>(bitmap.getPixels());
+  int argb_stride = static_cast<int>(bitmap.rowBytes());
+  if (format == FrameSubscriber::PixelFormat::kI420) {
+    uint8_t* u = y + y_size;
+    uint8_t* v = u + chroma_size;
+    libyuv::ARGBToI420(argb, argb_stride, y, width, u, chroma_width, v,
+                       chroma_width, width, height);
+  } else {
+    libyuv::ARGBToNV12(argb, argb_stride, y, width, y + y_size,
+                       chroma_width * 2, width, height);
+  }
+  return planes;
+}
+
+}  // namespace
+
+FrameSubscriber::Frame::Frame() = default;
+FrameSubscriber::Frame::Frame(const Frame&) = default;
+FrameSubscriber::Frame::~Frame() = default;
+FrameSubscriber::Frame& FrameSubscriber::Frame::operator=(const Frame&) =
+    default;
+
+FrameSubscriber::Subscription::Subscription() = default;
+FrameSubscriber::Subscription::Subscription(const Subscription&) = default;
+FrameSubscriber::Subscription::~Subscription() = default;
+
+FrameSubscriber::FrameSubscriber(content::WebContents* web_contents)
     : content::WebContentsObserver(web_contents),
-      callback_(callback),
-      only_dirty_(only_dirty) {
+      capture_period_(base::TimeDelta::FromSeconds(1) /
+                      Options().frame_rate) {
   content::RenderViewHost* rvh = web_contents->GetRenderViewHost();
   if (rvh)
     AttachToHost(rvh->GetWidget());
@@ -35,6 +113,40 @@ FrameSubscriber::FrameSubscriber(content::WebContents* web_contents,
 
 FrameSubscriber::~FrameSubscriber() = default;
 
+int FrameSubscriber::AddSubscription(const Options& options,
+                                     const FrameCallback& callback) {
+  int id = next_subscription_id_++;
+  Subscription& subscription = subscriptions_[id];
+  subscription.options = options;
+  subscription.options.frame_rate =
+      std::max(1, std::min(options.frame_rate, kMaxFrameRate));
+  subscription.callback = callback;
+  UpdateCaptureRate();
+  if (video_capturer_)
+    video_capturer_->RequestRefreshFrame();
+  return id;
+}
+
+void FrameSubscriber::RemoveSubscription(int id) {
+  subscriptions_.erase(id);
+  UpdateCaptureRate();
+}
+
+void FrameSubscriber::RemoveOtherSubscriptions(int id) {
+  base::EraseIf(subscriptions_,
+                [id](const auto& entry) { return entry.first != id; });
+  UpdateCaptureRate();
+}
+
+void FrameSubscriber::UpdateCaptureRate() {
+  int frame_rate = 1;
+  for (const auto& it : subscriptions_)
+    frame_rate = std::max(frame_rate, it.second.options.frame_rate);
+  capture_period_ = base::TimeDelta::FromSeconds(1) / frame_rate;
+  if (video_capturer_)
+    video_capturer_->SetMinCapturePeriod(capture_period_);
+}
+
 void FrameSubscriber::AttachToHost(content::RenderWidgetHost* host) {
   host_ = host;
 
@@ -51,8 +163,7 @@ void FrameSubscriber::AttachToHost(content::RenderWidgetHost* host) {
   video_capturer_->SetMinSizeChangePeriod(base::TimeDelta());
   video_capturer_->SetFormat(media::PIXEL_FORMAT_ARGB,
                              gfx::ColorSpace::CreateREC709());
-  video_capturer_->SetMinCapturePeriod(base::TimeDelta::FromSeconds(1) /
-                                       kMaxFrameRate);
+  video_capturer_->SetMinCapturePeriod(capture_period_);
   video_capturer_->Start(this);
 }
 
@@ -141,7 +252,14 @@ void FrameSubscriber::OnFrameCaptured(
       new FramePinner{std::move(mapping), std::move(callbacks_remote)});
   bitmap.setImmutable();
 
-  Done(content_rect, bitmap);
+  gfx::Rect damage(content_rect.size());
+  absl::optional<gfx::Rect> update_rect = info->metadata.capture_update_rect;
+  if (update_rect.has_value() && !update_rect->IsEmpty()) {
+    damage = *update_rect - content_rect.OffsetFromOrigin();
+    damage.Intersect(gfx::Rect(content_rect.size()));
+  }
+
+  Done(damage, bitmap);
 }
 
 void FrameSubscriber::OnStopped() {}
@@ -152,22 +270,105 @@ void FrameSubscriber::Done(const gfx::Rect& damage, const SkBitmap& frame) {
   if (frame.drawsNothing())
     return;
 
-  const SkBitmap& bitmap = only_dirty_ ? SkBitmapOperations::CreateTiledBitmap(
-                                             frame, damage.x(), damage.y(),
-                                             damage.width(), damage.height())
-                                       : frame;
+  struct ConvertedFrame {
+    gfx::Size size;
+    PixelFormat format;
+    Frame frame;
+  };
+  struct Delivery {
+    int id;
+    Frame frame;
+    gfx::Rect dirty_rect;
+  };
 
-  // Copying SkBitmap does not copy the internal pixels, we have to manually
-  // allocate and write pixels otherwise crash may happen when the original
-  // frame is modified.
-  SkBitmap copy;
-  copy.allocPixels(SkImageInfo::Make(bitmap.width(), bitmap.height(),
-                                     kN32_SkColorType, kPremul_SkAlphaType));
-  SkPixmap pixmap;
-  bool success = bitmap.peekPixels(&pixmap) && copy.writePixels(pixmap, 0, 0);
-  CHECK(success);
+  // Frames are only scaled and converted once for each size and format,
+  // whatever the number of subscriptions that want them.
+  std::vector<std::pair<gfx::Size, SkBitmap>> scaled_bitmaps;
+  std::vector<ConvertedFrame> converted_frames;
+  std::vector<Delivery> deliveries;
 
-  callback_.Run(gfx::Image::CreateFrom1xBitmap(copy), damage);
+  base::TimeTicks now = base::TimeTicks::Now();
+  gfx::Size frame_size(frame.width(), frame.height());
+  for (auto& it : subscriptions_) {
+    Subscription& subscription = it.second;
+    const Options& options = subscription.options;
+    subscription.pending_damage.Union(damage);
+
+    // Tolerates half a capture period of jitter, so that a subscription at
+    // half the capture rate gets every other frame.
+    base::TimeDelta period =
+        base::TimeDelta::FromSeconds(1) / options.frame_rate;
+    if (!subscription.last_frame_time.is_null() &&
+        now - subscription.last_frame_time + capture_period_ / 2 < period)
+      continue;
+
+    gfx::Size size = GetScaledSize(frame_size, options.size);
+    auto converted = std::find_if(
+        converted_frames.begin(), converted_frames.end(),
+        [&](const ConvertedFrame& entry) {
+          return entry.size == size && entry.format == options.format;
+        });
+    if (converted == converted_frames.end()) {
+      auto scaled = std::find_if(
+          scaled_bitmaps.begin(), scaled_bitmaps.end(),
+          [&](const auto& entry) { return entry.first == size; });
+      if (scaled == scaled_bitmaps.end()) {
+        scaled_bitmaps.emplace_back(size, CopyScaledBitmap(frame, size));
+        scaled = scaled_bitmaps.end() - 1;
+      }
+      if (scaled->second.drawsNothing())
+        continue;
+
+      ConvertedFrame new_frame;
+      new_frame.size = size;
+      new_frame.format = options.format;
+      new_frame.frame.format = options.format;
+      new_frame.frame.size = size;
+      if (options.format == PixelFormat::kARGB)
+        new_frame.frame.bitmap = scaled->second;
+      else
+        new_frame.frame.planes = ConvertToYUV(scaled->second, options.format);
+      converted_frames.push_back(std::move(new_frame));
+      converted = converted_frames.end() - 1;
+    }
+
+    gfx::Rect dirty_rect = subscription.pending_damage;
+    if (size != frame_size) {
+      dirty_rect = gfx::ToEnclosingRect(gfx::ScaleRect(
+          gfx::RectF(dirty_rect),
+          static_cast<float>(size.width()) / frame_size.width(),
+          static_cast<float>(size.height()) / frame_size.height()));
+      dirty_rect.Intersect(gfx::Rect(size));
+    }
+
+    Frame delivered = converted->frame;
+    if (options.only_dirty && options.format == PixelFormat::kARGB) {
+      SkBitmap dirty;
+      if (!dirty.tryAllocPixels(SkImageInfo::MakeN32Premul(
+              dirty_rect.width(), dirty_rect.height())) ||
+          !delivered.bitmap.readPixels(dirty.pixmap(), dirty_rect.x(),
+                                       dirty_rect.y()))
+        continue;
+      delivered.bitmap = dirty;
+      delivered.size = dirty_rect.size();
+    }
+
+    subscription.last_frame_time = now;
+    subscription.pending_damage = gfx::Rect();
+    deliveries.push_back({it.first, std::move(delivered), dirty_rect});
+  }
+
+  // The callbacks can end subscriptions, or destroy the subscriber.
+  base::WeakPtr<FrameSubscriber> weak_this = weak_ptr_factory_.GetWeakPtr();
+  for (const Delivery& delivery : deliveries) {
+    if (!weak_this)
+      return;
+    auto it = subscriptions_.find(delivery.id);
+    if (it == subscriptions_.end())
+      continue;
+    FrameCallback callback = it->second.callback;
+    callback.Run(delivery.frame, delivery.dirty_rect);
+  }
 }
 
 gfx::Size FrameSubscriber::GetRenderViewSize() const {
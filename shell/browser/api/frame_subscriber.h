@@ -5,46 +5,93 @@
 #ifndef SHELL_BROWSER_API_FRAME_SUBSCRIBER_H_
 #define SHELL_BROWSER_API_FRAME_SUBSCRIBER_H_
 
+#include <map>
 #include <memory>
 #include <string>
 
 #include "base/callback.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "components/viz/host/client_frame_sink_video_capturer.h"
 #include "content/public/browser/web_contents.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
 #include "v8/include/v8.h"
 
-namespace gfx {
-class Image;
-class Rect;
-}  // namespace gfx
-
 namespace electron {
 
 namespace api {
 
 class WebContents;
 
+// Captures the frames of a WebContents once, and hands them to any number of
+// subscriptions, each at its own size, frame rate and pixel format.
 class FrameSubscriber : public content::WebContentsObserver,
                         public viz::mojom::FrameSinkVideoConsumer {
  public:
-  using FrameCaptureCallback =
-      base::RepeatingCallback<void(const gfx::Image&, const gfx::Rect&)>;
-
-  FrameSubscriber(content::WebContents* web_contents,
-                  const FrameCaptureCallback& callback,
-                  bool only_dirty);
+  enum class PixelFormat { kARGB, kI420, kNV12 };
+
+  struct Options {
+    // The frames are scaled down to fit in it, the size of the view if empty.
+    gfx::Size size;
+    int frame_rate = 30;
+    PixelFormat format = PixelFormat::kARGB;
+    // Only gives the dirty area of ARGB frames.
+    bool only_dirty = false;
+  };
+
+  struct Frame {
+    Frame();
+    Frame(const Frame&);
+    ~Frame();
+    Frame& operator=(const Frame&);
+
+    PixelFormat format = PixelFormat::kARGB;
+    gfx::Size size;
+    // The pixels of kARGB frames.
+    SkBitmap bitmap;
+    // The planes of kI420 and kNV12 frames, one after the other.
+    scoped_refptr<base::RefCountedBytes> planes;
+  };
+
+  using FrameCallback =
+      base::RepeatingCallback<void(const Frame&, const gfx::Rect&)>;
+
+  explicit FrameSubscriber(content::WebContents* web_contents);
   ~FrameSubscriber() override;
 
   // disable copy
   FrameSubscriber(const FrameSubscriber&) = delete;
   FrameSubscriber& operator=(const FrameSubscriber&) = delete;
 
+  // Returns the id of the new subscription.
+  int AddSubscription(const Options& options, const FrameCallback& callback);
+  void RemoveSubscription(int id);
+  // Removes every subscription but |id|.
+  void RemoveOtherSubscriptions(int id);
+  bool HasSubscriptions() const { return !subscriptions_.empty(); }
+
  private:
+  struct Subscription {
+    Subscription();
+    Subscription(const Subscription&);
+    ~Subscription();
+
+    Options options;
+    FrameCallback callback;
+    base::TimeTicks last_frame_time;
+    // The damage of the frames skipped to keep to the frame rate.
+    gfx::Rect pending_damage;
+  };
+
   void AttachToHost(content::RenderWidgetHost* host);
   void DetachFromHost();
+  // Captures at the highest frame rate of the subscriptions.
+  void UpdateCaptureRate();
 
   void RenderFrameCreated(content::RenderFrameHost* render_frame_host) override;
   void RenderViewDeleted(content::RenderViewHost* host) override;
@@ -66,10 +113,11 @@ class FrameSubscriber : public content::WebContentsObserver,
   // Get the pixel size of render view.
   gfx::Size GetRenderViewSize() const;
 
-  FrameCaptureCallback callback_;
-  bool only_dirty_;
+  std::map<int, Subscription> subscriptions_;
+  int next_subscription_id_ = 1;
+  base::TimeDelta capture_period_;
 
-  content::RenderWidgetHost* host_;
+  content::RenderWidgetHost* host_ = nullptr;
   std::unique_ptr<viz::ClientFrameSinkVideoCapturer> video_capturer_;
 
   base::WeakPtrFactory<FrameSubscriber> weak_ptr_factory_{this};
@@ -0,0 +1,49 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/electron_asar_host_impl.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/task/thread_pool.h"
+#include "mojo/public/cpp/bindings/self_owned_receiver.h"
+#include "shell/common/asar/archive.h"
+#include "shell/common/asar/asar_util.h"
+
+namespace electron {
+
+namespace {
+
+void BindOnBlockingSequence(
+    mojo::PendingReceiver<mojom::ElectronAsarHost> receiver) {
+  mojo::MakeSelfOwnedReceiver(std::make_unique<ElectronAsarHostImpl>(),
+                              std::move(receiver));
+}
+
+}  // namespace
+
+ElectronAsarHostImpl::ElectronAsarHostImpl() = default;
+
+ElectronAsarHostImpl::~ElectronAsarHostImpl() = default;
+
+// static
+void ElectronAsarHostImpl::Create(
+    mojo::PendingReceiver<mojom::ElectronAsarHost> receiver) {
+  base::ThreadPool::CreateSequencedTaskRunner(
+      {base::MayBlock(), base::TaskPriority::USER_BLOCKING})
+      ->PostTask(FROM_HERE, base::BindOnce(&BindOnBlockingSequence,
+                                           std::move(receiver)));
+}
+
+void ElectronAsarHostImpl::GetArchiveIndex(const base::FilePath& path,
+                                           GetArchiveIndexCallback callback) {
+  std::shared_ptr<asar::Archive> archive = asar::GetCachedAsarArchive(path);
+  // An invalid region is sent as null.
+  std::move(callback).Run(archive ? archive->ShareIndex()
+                                  : base::ReadOnlySharedMemoryRegion());
+}
+
+}  // namespace electron
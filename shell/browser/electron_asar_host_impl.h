@@ -0,0 +1,37 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_ELECTRON_ASAR_HOST_IMPL_H_
+#define SHELL_BROWSER_ELECTRON_ASAR_HOST_IMPL_H_
+
+#include "electron/shell/common/api/api.mojom.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+
+namespace electron {
+
+// Hands renderer processes the index of the asar archives opened by the
+// browser process, so that each archive is only parsed once. Only archives
+// the browser already opened are shared, a renderer can not make the browser
+// open arbitrary files.
+class ElectronAsarHostImpl : public mojom::ElectronAsarHost {
+ public:
+  ElectronAsarHostImpl();
+  ~ElectronAsarHostImpl() override;
+
+  // Binds |receiver| on a sequence that may block, since sharing an archive
+  // for the first time reads its header.
+  static void Create(mojo::PendingReceiver<mojom::ElectronAsarHost> receiver);
+
+  // disable copy
+  ElectronAsarHostImpl(const ElectronAsarHostImpl&) = delete;
+  ElectronAsarHostImpl& operator=(const ElectronAsarHostImpl&) = delete;
+
+  // mojom::ElectronAsarHost:
+  void GetArchiveIndex(const base::FilePath& path,
+                       GetArchiveIndexCallback callback) override;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_ELECTRON_ASAR_HOST_IMPL_H_
@@ -63,6 +63,7 @@
 #include "services/network/public/cpp/features.h"
 #include "services/network/public/cpp/resource_request_body.h"
 #include "services/network/public/cpp/self_deleting_url_loader_factory.h"
+#include "shell/app/command_line_args.h"
 #include "shell/app/electron_crash_reporter_client.h"
 #include "shell/browser/api/electron_api_app.h"
 #include "shell/browser/api/electron_api_crash_reporter.h"
@@ -72,6 +73,7 @@
 #include "shell/browser/api/electron_api_web_request.h"
 #include "shell/browser/badging/badge_manager.h"
 #include "shell/browser/child_web_contents_tracker.h"
+#include "shell/browser/electron_asar_host_impl.h"
 #include "shell/browser/electron_autofill_driver_factory.h"
 #include "shell/browser/electron_browser_context.h"
 #include "shell/browser/electron_browser_handler_impl.h"
@@ -642,6 +644,12 @@ void ElectronBrowserClient::AppendExtraCommandLineSwitches(
         web_preferences->AppendCommandLineSwitches(
             command_line, IsRendererSubFrame(process_id));
     }
+
+    // The renderer makes the same decision when picking its client.
+    if (IsSandboxEnabled(command_line))
+      renderers_with_node_.erase(process_id);
+    else
+      renderers_with_node_.insert(process_id);
   }
 }
 
@@ -952,6 +960,7 @@ void ElectronBrowserClient::RenderProcessHostDestroyed(
   int process_id = host->GetID();
   pending_processes_.erase(process_id);
   renderer_is_subframe_.erase(process_id);
+  renderers_with_node_.erase(process_id);
   host->RemoveObserver(this);
 }
 
@@ -1514,6 +1523,14 @@ bool ElectronBrowserClient::ShouldEnableStrictSiteIsolation() {
 void ElectronBrowserClient::BindHostReceiverForRenderer(
     content::RenderProcessHost* render_process_host,
     mojo::GenericPendingReceiver receiver) {
+  if (auto host_receiver = receiver.As<mojom::ElectronAsarHost>()) {
+    // Sandboxed renderers never read archives, so they are not given the
+    // indices of the archives the browser process opened.
+    if (base::Contains(renderers_with_node_, render_process_host->GetID()))
+      ElectronAsarHostImpl::Create(std::move(host_receiver));
+    return;
+  }
+
 #if BUILDFLAG(ENABLE_BUILTIN_SPELLCHECKER)
   if (auto host_receiver = receiver.As<spellcheck::mojom::SpellCheckHost>()) {
     SpellCheckHostChromeImpl::Create(render_process_host->GetID(),
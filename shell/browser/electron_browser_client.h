@@ -303,6 +303,9 @@ class ElectronBrowserClient : public content::ContentBrowserClient,
 
   std::set<int> renderer_is_subframe_;
 
+  // Renderer processes which run Node, and may read asar archives.
+  std::set<int> renderers_with_node_;
+
   std::unique_ptr<PlatformNotificationService> notification_service_;
   std::unique_ptr<NotificationPresenter> notification_presenter_;
 
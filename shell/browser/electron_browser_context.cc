@@ -42,6 +42,7 @@
 #include "shell/browser/electron_browser_main_parts.h"
 #include "shell/browser/electron_download_manager_delegate.h"
 #include "shell/browser/electron_permission_manager.h"
+#include "shell/browser/json_pref_store_loader.h"
 #include "shell/browser/net/resolve_proxy_helper.h"
 #include "shell/browser/pref_store_delegate.h"
 #include "shell/browser/protocol_registry.h"
@@ -91,6 +92,21 @@ std::string MakePartitionName(const std::string& input) {
   return net::EscapePath(base::ToLowerASCII(input));
 }
 
+base::FilePath GetPartitionPath(const std::string& partition, bool in_memory) {
+  base::FilePath path;
+  CHECK(base::PathService::Get(chrome::DIR_USER_DATA, &path));
+
+  if (!in_memory && !partition.empty())
+    path = path.Append(FILE_PATH_LITERAL("Partitions"))
+               .Append(base::FilePath::FromUTF8Unsafe(
+                   MakePartitionName(partition)));
+  return path;
+}
+
+base::FilePath GetPrefsPath(const base::FilePath& partition_path) {
+  return partition_path.Append(FILE_PATH_LITERAL("Preferences"));
+}
+
 }  // namespace
 
 // static
@@ -101,9 +117,11 @@ ElectronBrowserContext::browser_context_map() {
   return *browser_context_map;
 }
 
-ElectronBrowserContext::ElectronBrowserContext(const std::string& partition,
-                                               bool in_memory,
-                                               base::DictionaryValue options)
+ElectronBrowserContext::ElectronBrowserContext(
+    const std::string& partition,
+    bool in_memory,
+    base::DictionaryValue options,
+    scoped_refptr<JsonPrefStore> user_pref_store)
     : storage_policy_(base::MakeRefCounted<SpecialStoragePolicy>()),
       protocol_registry_(base::WrapUnique(new ProtocolRegistry)),
       in_memory_(in_memory),
@@ -118,17 +136,12 @@ ElectronBrowserContext::ElectronBrowserContext(const std::string& partition,
   base::StringToInt(command_line->GetSwitchValueASCII(switches::kDiskCacheSize),
                     &max_cache_size_);
 
-  CHECK(base::PathService::Get(chrome::DIR_USER_DATA, &path_));
-
-  if (!in_memory && !partition.empty())
-    path_ = path_.Append(FILE_PATH_LITERAL("Partitions"))
-                .Append(base::FilePath::FromUTF8Unsafe(
-                    MakePartitionName(partition)));
+  path_ = GetPartitionPath(partition, in_memory);
 
   BrowserContextDependencyManager::GetInstance()->MarkBrowserContextLive(this);
 
   // Initialize Pref Registry.
-  InitPrefs();
+  InitPrefs(std::move(user_pref_store));
 
   cookie_change_notifier_ = std::make_unique<CookieChangeNotifier>(this);
 
@@ -157,14 +170,16 @@ ElectronBrowserContext::~ElectronBrowserContext() {
                             std::move(resource_context_));
 }
 
-void ElectronBrowserContext::InitPrefs() {
-  auto prefs_path = GetPath().Append(FILE_PATH_LITERAL("Preferences"));
+void ElectronBrowserContext::InitPrefs(
+    scoped_refptr<JsonPrefStore> user_pref_store) {
   base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (!user_pref_store) {
+    user_pref_store =
+        base::MakeRefCounted<JsonPrefStore>(GetPrefsPath(GetPath()));
+    user_pref_store->ReadPrefs();  // Synchronous.
+  }
   PrefServiceFactory prefs_factory;
-  scoped_refptr<JsonPrefStore> pref_store =
-      base::MakeRefCounted<JsonPrefStore>(prefs_path);
-  pref_store->ReadPrefs();  // Synchronous.
-  prefs_factory.set_user_prefs(pref_store);
+  prefs_factory.set_user_prefs(std::move(user_pref_store));
 
 #if BUILDFLAG(ENABLE_ELECTRON_EXTENSIONS)
   if (!in_memory_) {
@@ -425,11 +440,49 @@ ElectronBrowserContext* ElectronBrowserContext::From(
     return browser_context;
   }
 
-  auto* new_context =
-      new ElectronBrowserContext(partition, in_memory, std::move(options));
+  auto* new_context = new ElectronBrowserContext(
+      partition, in_memory, std::move(options), nullptr);
   browser_context_map()[key] =
       std::unique_ptr<ElectronBrowserContext>(new_context);
   return new_context;
 }
 
+// static
+void ElectronBrowserContext::FromAsync(
+    const std::string& partition,
+    bool in_memory,
+    base::DictionaryValue options,
+    base::OnceCallback<void(ElectronBrowserContext*)> callback) {
+  auto it = browser_context_map().find(PartitionKey(partition, in_memory));
+  if (it != browser_context_map().end() && it->second) {
+    std::move(callback).Run(it->second.get());
+    return;
+  }
+
+  LoadJsonPrefStore(
+      GetPrefsPath(GetPartitionPath(partition, in_memory)),
+      base::BindOnce(&ElectronBrowserContext::OnPrefStoreLoaded, partition,
+                     in_memory, std::move(options), std::move(callback)));
+}
+
+// static
+void ElectronBrowserContext::OnPrefStoreLoaded(
+    const std::string& partition,
+    bool in_memory,
+    base::DictionaryValue options,
+    base::OnceCallback<void(ElectronBrowserContext*)> callback,
+    scoped_refptr<JsonPrefStore> user_pref_store) {
+  // The BrowserContext may have been created while the file was read, in
+  // which case the store that was read is dropped.
+  PartitionKey key(partition, in_memory);
+  std::unique_ptr<ElectronBrowserContext>& browser_context =
+      browser_context_map()[key];
+  if (!browser_context) {
+    browser_context = base::WrapUnique(
+        new ElectronBrowserContext(partition, in_memory, std::move(options),
+                                   std::move(user_pref_store)));
+  }
+  std::move(callback).Run(browser_context.get());
+}
+
 }  // namespace electron
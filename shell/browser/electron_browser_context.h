@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 
+#include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "chrome/browser/predictors/preconnect_manager.h"
 #include "content/public/browser/browser_context.h"
@@ -19,6 +20,7 @@
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
 #include "shell/browser/media/media_device_id_salt.h"
 
+class JsonPrefStore;
 class PrefService;
 class ValueMapPrefStore;
 
@@ -81,6 +83,15 @@ class ElectronBrowserContext : public content::BrowserContext {
       bool in_memory,
       base::DictionaryValue options = base::DictionaryValue());
 
+  // Like From, but a new BrowserContext is only created once its preferences
+  // were read on the thread pool, instead of blocking the UI thread on the
+  // read. |callback| gets the existing BrowserContext when there is one.
+  static void FromAsync(
+      const std::string& partition,
+      bool in_memory,
+      base::DictionaryValue options,
+      base::OnceCallback<void(ElectronBrowserContext*)> callback);
+
   static BrowserContextMap& browser_context_map();
 
   void SetUserAgent(const std::string& user_agent);
@@ -149,12 +160,22 @@ class ElectronBrowserContext : public content::BrowserContext {
   ~ElectronBrowserContext() override;
 
  private:
+  // |user_pref_store| is the store of the Preferences file when it was
+  // already read, otherwise it is read synchronously.
   ElectronBrowserContext(const std::string& partition,
                          bool in_memory,
-                         base::DictionaryValue options);
+                         base::DictionaryValue options,
+                         scoped_refptr<JsonPrefStore> user_pref_store);
+
+  static void OnPrefStoreLoaded(
+      const std::string& partition,
+      bool in_memory,
+      base::DictionaryValue options,
+      base::OnceCallback<void(ElectronBrowserContext*)> callback,
+      scoped_refptr<JsonPrefStore> user_pref_store);
 
   // Initialize pref registry.
-  void InitPrefs();
+  void InitPrefs(scoped_refptr<JsonPrefStore> user_pref_store);
 
   ValueMapPrefStore* in_memory_pref_store_ = nullptr;
 
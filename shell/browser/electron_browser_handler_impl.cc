@@ -10,7 +10,9 @@
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
+#include "mojo/public/cpp/bindings/message.h"
 #include "mojo/public/cpp/bindings/self_owned_receiver.h"
+#include "shell/common/v8_value_serializer.h"
 
 namespace electron {
 ElectronBrowserHandlerImpl::ElectronBrowserHandlerImpl(
@@ -47,14 +49,30 @@ void ElectronBrowserHandlerImpl::Message(bool internal,
                               GetRenderFrameHost());
   }
 }
-void ElectronBrowserHandlerImpl::Invoke(bool internal,
-                                        const std::string& channel,
-                                        blink::CloneableMessage arguments,
-                                        InvokeCallback callback) {
+void ElectronBrowserHandlerImpl::MessageBatch(
+    std::vector<mojom::BatchedMessagePtr> messages) {
+  api::WebContents* api_web_contents = api::WebContents::From(web_contents());
+  if (api_web_contents) {
+    api_web_contents->MessageBatch(std::move(messages), GetRenderFrameHost());
+  }
+}
+
+void ElectronBrowserHandlerImpl::Invoke(
+    bool internal,
+    const std::string& channel,
+    blink::CloneableMessage arguments,
+    std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers,
+    InvokeCallback callback) {
+  if (!AreSharedBuffersWithinLimits(shared_buffers)) {
+    mojo::ReportBadMessage("Too many or too large shared buffers");
+    return;
+  }
+
   api::WebContents* api_web_contents = api::WebContents::From(web_contents());
   if (api_web_contents) {
     api_web_contents->Invoke(internal, channel, std::move(arguments),
-                             std::move(callback), GetRenderFrameHost());
+                             std::move(shared_buffers), std::move(callback),
+                             GetRenderFrameHost());
   }
 }
 
@@ -37,9 +37,11 @@ class ElectronBrowserHandlerImpl : public mojom::ElectronBrowser,
   void Message(bool internal,
                const std::string& channel,
                blink::CloneableMessage arguments) override;
+  void MessageBatch(std::vector<mojom::BatchedMessagePtr> messages) override;
   void Invoke(bool internal,
               const std::string& channel,
               blink::CloneableMessage arguments,
+              std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers,
               InvokeCallback callback) override;
   void OnFirstNonEmptyLayout() override;
   void ReceivePostMessage(const std::string& channel,
@@ -0,0 +1,56 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/json_pref_store_loader.h"
+
+#include <string>
+#include <utility>
+
+#include "base/files/file_path.h"
+#include "components/prefs/json_pref_store.h"
+
+namespace electron {
+
+namespace {
+
+// Waits for the read of a store, and deletes itself once it is done.
+class JsonPrefStoreLoader : public PrefStore::Observer {
+ public:
+  JsonPrefStoreLoader(scoped_refptr<JsonPrefStore> store,
+                      JsonPrefStoreLoadedCallback callback)
+      : store_(std::move(store)), callback_(std::move(callback)) {
+    store_->AddObserver(this);
+  }
+
+  // disable copy
+  JsonPrefStoreLoader(const JsonPrefStoreLoader&) = delete;
+  JsonPrefStoreLoader& operator=(const JsonPrefStoreLoader&) = delete;
+
+  // PrefStore::Observer:
+  void OnPrefValueChanged(const std::string& key) override {}
+  void OnInitializationCompleted(bool succeeded) override {
+    store_->RemoveObserver(this);
+    std::move(callback_).Run(std::move(store_));
+    delete this;
+  }
+
+ private:
+  ~JsonPrefStoreLoader() override = default;
+
+  scoped_refptr<JsonPrefStore> store_;
+  JsonPrefStoreLoadedCallback callback_;
+};
+
+}  // namespace
+
+void LoadJsonPrefStore(const base::FilePath& path,
+                       JsonPrefStoreLoadedCallback callback) {
+  auto store = base::MakeRefCounted<JsonPrefStore>(path);
+  new JsonPrefStoreLoader(store, std::move(callback));
+  // The file is read on the file task runner of the store, and the result is
+  // handed back to this sequence.
+  store->ReadPrefsAsync(nullptr);
+}
+
+}  // namespace electron
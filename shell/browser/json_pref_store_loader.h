@@ -0,0 +1,33 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_JSON_PREF_STORE_LOADER_H_
+#define SHELL_BROWSER_JSON_PREF_STORE_LOADER_H_
+
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+
+class JsonPrefStore;
+
+namespace base {
+class FilePath;
+}
+
+namespace electron {
+
+using JsonPrefStoreLoadedCallback =
+    base::OnceCallback<void(scoped_refptr<JsonPrefStore>)>;
+
+// Reads the JSON pref store at |path| on the thread pool, without blocking the
+// current sequence, and runs |callback| on it once the store is initialized.
+// A missing or unreadable file gives an empty store, like a synchronous read.
+//
+// Each store reads from its own sequence, so stores loaded together are read
+// in parallel.
+void LoadJsonPrefStore(const base::FilePath& path,
+                       JsonPrefStoreLoadedCallback callback);
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_JSON_PREF_STORE_LOADER_H_
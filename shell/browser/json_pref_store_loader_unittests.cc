@@ -0,0 +1,150 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/json_pref_store_loader.h"
+
+#include <string>
+#include <vector>
+
+#include "base/barrier_closure.h"
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_writer.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/task_environment.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "components/prefs/json_pref_store.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace electron {
+
+namespace {
+
+scoped_refptr<JsonPrefStore> Load(const base::FilePath& path) {
+  scoped_refptr<JsonPrefStore> result;
+  base::RunLoop run_loop;
+  LoadJsonPrefStore(path, base::BindOnce(
+                              [](scoped_refptr<JsonPrefStore>* result,
+                                 base::OnceClosure quit,
+                                 scoped_refptr<JsonPrefStore> store) {
+                                *result = std::move(store);
+                                std::move(quit).Run();
+                              },
+                              &result, run_loop.QuitClosure()));
+  run_loop.Run();
+  return result;
+}
+
+// Writes Preferences like the ones of a partition that was used for a while.
+void WritePreferences(const base::FilePath& path) {
+  base::Value hosts(base::Value::Type::DICTIONARY);
+  for (int i = 0; i < 300; ++i)
+    hosts.SetDoubleKey(base::StringPrintf("host%d.example.com", i), 1.5);
+  base::Value zoom_levels(base::Value::Type::DICTIONARY);
+  zoom_levels.SetKey("12345678901234567890", std::move(hosts));
+
+  base::Value paths(base::Value::Type::LIST);
+  for (int i = 0; i < 50; ++i)
+    paths.Append(base::StringPrintf("/home/user/projects/project%d", i));
+
+  base::Value prefs(base::Value::Type::DICTIONARY);
+  prefs.SetPath("partition.per_host_zoom_levels", std::move(zoom_levels));
+  prefs.SetPath("devtools.file_system_paths", std::move(paths));
+  prefs.SetStringPath("download.default_directory", "/home/user/Downloads");
+
+  std::string json;
+  ASSERT_TRUE(base::JSONWriter::Write(prefs, &json));
+  ASSERT_TRUE(base::CreateDirectory(path.DirName()));
+  ASSERT_TRUE(base::WriteFile(path, json));
+}
+
+}  // namespace
+
+TEST(JsonPrefStoreLoaderTest, LoadsPrefs) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("Preferences");
+  ASSERT_TRUE(base::WriteFile(path, R"({"a": {"b": 1}})"));
+
+  scoped_refptr<JsonPrefStore> store = Load(path);
+  ASSERT_TRUE(store);
+  EXPECT_TRUE(store->IsInitializationComplete());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, store->GetReadError());
+  const base::Value* value = nullptr;
+  ASSERT_TRUE(store->GetValue("a.b", &value));
+  EXPECT_EQ(base::Value(1), *value);
+}
+
+TEST(JsonPrefStoreLoaderTest, LoadsMissingFilesAsEmptyStores) {
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  scoped_refptr<JsonPrefStore> store =
+      Load(temp_dir.GetPath().AppendASCII("Preferences"));
+  ASSERT_TRUE(store);
+  EXPECT_TRUE(store->IsInitializationComplete());
+  EXPECT_EQ(PersistentPrefStore::PREF_READ_ERROR_NO_FILE,
+            store->GetReadError());
+  EXPECT_TRUE(store->GetValues()->DictEmpty());
+}
+
+// Compares the startup of 50 persistent partitions whose Preferences are read
+// one after the other on the UI thread, with loading them together.
+TEST(JsonPrefStoreLoaderTest, StartupPerformance) {
+  constexpr int kPartitions = 50;
+  base::test::TaskEnvironment task_environment;
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  std::vector<base::FilePath> paths;
+  for (int i = 0; i < kPartitions; ++i) {
+    paths.push_back(temp_dir.GetPath()
+                        .AppendASCII(base::StringPrintf("partition%d", i))
+                        .AppendASCII("Preferences"));
+    WritePreferences(paths.back());
+  }
+
+  base::ElapsedTimer sync_timer;
+  for (const auto& path : paths) {
+    auto store = base::MakeRefCounted<JsonPrefStore>(path);
+    ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, store->ReadPrefs());
+  }
+  base::TimeDelta sync_time = sync_timer.Elapsed();
+
+  base::RunLoop run_loop;
+  base::RepeatingClosure barrier =
+      base::BarrierClosure(kPartitions, run_loop.QuitClosure());
+  base::ElapsedTimer async_timer;
+  for (const auto& path : paths) {
+    LoadJsonPrefStore(path, base::BindOnce(
+                                [](base::RepeatingClosure done,
+                                   scoped_refptr<JsonPrefStore> store) {
+                                  EXPECT_EQ(
+                                      PersistentPrefStore::PREF_READ_ERROR_NONE,
+                                      store->GetReadError());
+                                  done.Run();
+                                },
+                                barrier));
+  }
+  // The UI thread is only busy while posting the reads and handling their
+  // results.
+  base::TimeDelta async_post_time = async_timer.Elapsed();
+  run_loop.Run();
+  base::TimeDelta async_time = async_timer.Elapsed();
+
+  perf_test::PerfResultReporter reporter("PrefsStartup", "50_partitions");
+  reporter.RegisterImportantMetric("_sync_reads", "us");
+  reporter.RegisterImportantMetric("_async_reads", "us");
+  reporter.RegisterImportantMetric("_async_post", "us");
+  reporter.AddResult("_sync_reads", sync_time);
+  reporter.AddResult("_async_reads", async_time);
+  reporter.AddResult("_async_post", async_post_time);
+}
+
+}  // namespace electron
@@ -5,11 +5,16 @@
 #include "shell/browser/net/asar/asar_url_loader.h"
 
 #include <algorithm>
+#include <cinttypes>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
@@ -18,16 +23,16 @@
 #include "mojo/public/cpp/bindings/receiver.h"
 #include "mojo/public/cpp/bindings/remote.h"
 #include "mojo/public/cpp/system/data_pipe_producer.h"
-#include "mojo/public/cpp/system/file_data_source.h"
 #include "net/base/filename_util.h"
+#include "net/base/net_errors.h"
 #include "net/base/mime_sniffer.h"
 #include "net/base/mime_util.h"
 #include "net/http/http_byte_range.h"
 #include "net/http/http_util.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
-#include "shell/browser/net/asar/asar_file_validator.h"
 #include "shell/common/asar/archive.h"
 #include "shell/common/asar/asar_util.h"
+#include "shell/common/asar/integrity_verifier.h"
 
 namespace asar {
 
@@ -50,13 +55,348 @@ net::Error ConvertMojoResultToNetError(MojoResult result) {
   }
 }
 
-constexpr size_t kDefaultFileUrlPipeSize = 65536;
+// The pipe is sized after the response, so that small files are written in
+// one go and large ones need fewer wake-ups of the consumer.
+constexpr uint64_t kMinFileUrlPipeSize = 65536;
+constexpr uint64_t kMaxFileUrlPipeSize = 2 * 1024 * 1024;
 
 // Because this makes things simpler.
-static_assert(kDefaultFileUrlPipeSize >= net::kMaxBytesToSniff,
+static_assert(kMinFileUrlPipeSize >= net::kMaxBytesToSniff,
               "Default file data pipe size must be at least as large as a MIME-"
               "type sniffing buffer.");
 
+// Requests with more ranges than this are not satisfiable.
+constexpr size_t kMaxByteRanges = 64;
+
+uint32_t GetPipeSize(uint64_t bytes_to_send) {
+  return std::min(std::max(bytes_to_send, kMinFileUrlPipeSize),
+                  kMaxFileUrlPipeSize);
+}
+
+// Reads a file of an archive, or an unpacked file, with positional reads
+// starting wherever the consumer is. When the file has an integrity payload
+// the blocks covering the bytes read are copied out and the copy is
+// validated, so that the bytes handed out are the validated ones. Sequential
+// reads validate each block once.
+class AsarFileReader {
+ public:
+  // |file_data| is the content of the file in the archive mapping, which is
+  // read from instead of |file| when not empty. |file_offset| is the offset
+  // of the file in |file|.
+  AsarFileReader(std::shared_ptr<Archive> archive,
+                 base::span<const uint8_t> file_data,
+                 base::File file,
+                 uint64_t file_offset,
+                 uint64_t file_size,
+                 absl::optional<IntegrityPayload> integrity)
+      : archive_(std::move(archive)),
+        file_data_(file_data),
+        file_(std::move(file)),
+        file_offset_(file_offset),
+        file_size_(file_size),
+        integrity_(std::move(integrity)) {}
+
+  // disable copy
+  AsarFileReader(const AsarFileReader&) = delete;
+  AsarFileReader& operator=(const AsarFileReader&) = delete;
+
+  // Fills |buffer| with the bytes at |offset| of the file, which must be in
+  // bounds.
+  MojoResult Read(uint64_t offset, base::span<char> buffer) {
+    DCHECK_LE(offset + buffer.size(), file_size_);
+    if (buffer.empty())
+      return MOJO_RESULT_OK;
+
+    if (integrity_)
+      return ReadVerifiedBlocks(offset, buffer);
+
+    if (!file_data_.empty()) {
+      memcpy(buffer.data(), file_data_.data() + offset, buffer.size());
+      return MOJO_RESULT_OK;
+    }
+
+    return file_.ReadAndCheck(file_offset_ + offset,
+                              base::as_writable_bytes(buffer))
+               ? MOJO_RESULT_OK
+               : MOJO_RESULT_UNKNOWN;
+  }
+
+  // Validates an empty file, which Read() never sees any block of.
+  bool VerifyEmptyFile() const {
+    return !integrity_ || integrity_->blocks.empty() ||
+           IntegrityVerifier::VerifyBlock(base::span<const uint8_t>(),
+                                          integrity_->blocks[0]);
+  }
+
+ private:
+  // Serves the bytes from validated copies of the blocks covering them.
+  MojoResult ReadVerifiedBlocks(uint64_t offset, base::span<char> buffer) {
+    uint64_t block_size = integrity_->block_size;
+    if (block_size == 0)
+      return MOJO_RESULT_UNKNOWN;
+
+    while (!buffer.empty()) {
+      if (!blocks_offset_ || offset < *blocks_offset_ ||
+          offset >= *blocks_offset_ + blocks_.size()) {
+        size_t first_block = offset / block_size;
+        size_t last_block = (offset + buffer.size() - 1) / block_size;
+        if (!ReadBlocks(first_block, last_block))
+          return MOJO_RESULT_UNKNOWN;
+      }
+
+      uint64_t offset_in_blocks = offset - *blocks_offset_;
+      size_t size = std::min<uint64_t>(buffer.size(),
+                                       blocks_.size() - offset_in_blocks);
+      memcpy(buffer.data(), blocks_.data() + offset_in_blocks, size);
+      buffer = buffer.subspan(size);
+      offset += size;
+    }
+    return MOJO_RESULT_OK;
+  }
+
+  // Copies the blocks from |first_block| to |last_block| out of the mapping,
+  // or reads them from |file_|, then validates the copy. The blocks are
+  // hashed in parallel when there are several of them.
+  bool ReadBlocks(size_t first_block, size_t last_block) {
+    if (last_block >= integrity_->blocks.size())
+      return false;
+
+    uint64_t block_size = integrity_->block_size;
+    uint64_t begin = first_block * block_size;
+    uint64_t end = std::min((last_block + 1) * block_size, file_size_);
+    blocks_offset_.reset();
+    blocks_.resize(end - begin);
+    if (!file_data_.empty())
+      memcpy(blocks_.data(), file_data_.data() + begin, blocks_.size());
+    else if (!file_.ReadAndCheck(file_offset_ + begin, blocks_))
+      return false;
+
+    if (!IntegrityVerifier::Verify(*integrity_, first_block, blocks_)) {
+      LOG(FATAL) << "Failed to validate block while streaming ASAR file";
+      return false;
+    }
+    blocks_offset_ = begin;
+    return true;
+  }
+
+  // Keeps the mapping alive.
+  std::shared_ptr<Archive> archive_;
+  const base::span<const uint8_t> file_data_;
+  base::File file_;
+  const uint64_t file_offset_;
+  const uint64_t file_size_;
+  const absl::optional<IntegrityPayload> integrity_;
+
+  // The validated copy of the last blocks read, and its offset in the file.
+  absl::optional<uint64_t> blocks_offset_;
+  std::vector<uint8_t> blocks_;
+};
+
+// Streams a response made of parts: ranges of a file and, for multipart
+// responses, the text around them. The parts are read in order by the
+// |mojo::DataPipeProducer|, straight into the data pipe.
+class AsarDataSource : public mojo::DataPipeProducer::DataSource {
+ public:
+  explicit AsarDataSource(std::unique_ptr<AsarFileReader> reader)
+      : reader_(std::move(reader)) {}
+  ~AsarDataSource() override = default;
+
+  // disable copy
+  AsarDataSource(const AsarDataSource&) = delete;
+  AsarDataSource& operator=(const AsarDataSource&) = delete;
+
+  void AddText(std::string text) {
+    Part part;
+    part.position = length_;
+    part.length = text.size();
+    part.text = std::move(text);
+    length_ += part.length;
+    parts_.push_back(std::move(part));
+  }
+
+  void AddRange(uint64_t first_byte, uint64_t length) {
+    if (length == 0)
+      return;
+    Part part;
+    part.position = length_;
+    part.length = length;
+    part.is_range = true;
+    part.file_offset = first_byte;
+    length_ += length;
+    parts_.push_back(std::move(part));
+  }
+
+  // mojo::DataPipeProducer::DataSource:
+  uint64_t GetLength() const override { return length_; }
+  ReadResult Read(uint64_t offset, base::span<char> buffer) override {
+    ReadResult result;
+    if (offset > length_) {
+      result.result = MOJO_RESULT_OUT_OF_RANGE;
+      return result;
+    }
+
+    // Reads are sequential, so the lookup resumes from the last part read.
+    if (current_part_ >= parts_.size() ||
+        offset < parts_[current_part_].position)
+      current_part_ = 0;
+
+    size_t bytes_read = 0;
+    while (bytes_read < buffer.size() && current_part_ < parts_.size()) {
+      const Part& part = parts_[current_part_];
+      uint64_t position = offset + bytes_read;
+      if (position >= part.position + part.length) {
+        ++current_part_;
+        continue;
+      }
+
+      uint64_t offset_in_part = position - part.position;
+      size_t size = std::min<uint64_t>(buffer.size() - bytes_read,
+                                       part.length - offset_in_part);
+      if (part.is_range) {
+        MojoResult read_result =
+            reader_->Read(part.file_offset + offset_in_part,
+                          buffer.subspan(bytes_read, size));
+        if (read_result != MOJO_RESULT_OK) {
+          result.result = read_result;
+          break;
+        }
+      } else {
+        memcpy(buffer.data() + bytes_read, part.text.data() + offset_in_part,
+               size);
+      }
+      bytes_read += size;
+    }
+    result.bytes_read = bytes_read;
+    return result;
+  }
+
+ private:
+  struct Part {
+    // Position of the part in the response.
+    uint64_t position = 0;
+    uint64_t length = 0;
+    bool is_range = false;
+    // Offset of the range in the file.
+    uint64_t file_offset = 0;
+    std::string text;
+  };
+
+  std::unique_ptr<AsarFileReader> reader_;
+  std::vector<Part> parts_;
+  size_t current_part_ = 0;
+  uint64_t length_ = 0;
+};
+
+// Files are told apart by their modification time and size, and the files of
+// an archive by their place in it too.
+std::string MakeETag(base::Time last_modified, uint64_t offset, uint64_t size) {
+  return base::StringPrintf(
+      "\"%" PRIx64 "-%" PRIx64 "-%" PRIx64 "\"",
+      static_cast<uint64_t>(
+          last_modified.ToDeltaSinceWindowsEpoch().InMicroseconds()),
+      offset, size);
+}
+
+bool MatchesETag(const net::HttpRequestHeaders& headers,
+                 const std::string& etag) {
+  std::string if_none_match;
+  if (!headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch,
+                         &if_none_match))
+    return false;
+  net::HttpUtil::ValuesIterator values(if_none_match.begin(),
+                                       if_none_match.end(), ',');
+  while (values.GetNext()) {
+    // The comparison is weak, as for any GET request.
+    base::StringPiece value = values.value_piece();
+    if (base::StartsWith(value, "W/"))
+      value.remove_prefix(2);
+    if (value == "*" || value == etag)
+      return true;
+  }
+  return false;
+}
+
+// Opens the file at |relative_path| of the archive at |asar_path|. |etag| is
+// only set when not null.
+net::Error OpenArchiveFile(const base::FilePath& asar_path,
+                           const base::FilePath& relative_path,
+                           std::unique_ptr<AsarFileReader>* reader,
+                           uint64_t* size,
+                           std::string* etag) {
+  // Parse asar archive.
+  std::shared_ptr<Archive> archive = GetOrCreateAsarArchive(asar_path);
+  Archive::FileInfo info;
+  if (!archive || !archive->GetFileInfo(relative_path, &info))
+    return net::ERR_FILE_NOT_FOUND;
+
+  // For unpacked path, read like normal file.
+  base::FilePath real_path;
+  if (info.unpacked) {
+    archive->CopyFileOut(relative_path, &real_path);
+    info.offset = 0;
+  }
+
+  if (etag) {
+    base::File::Info file_info;
+    if (!base::GetFileInfo(info.unpacked ? real_path : archive->path(),
+                           &file_info))
+      return net::ERR_FILE_NOT_FOUND;
+    *etag = MakeETag(file_info.last_modified, info.offset, info.size);
+  }
+
+  // Packed files are served straight from the archive mapping, which saves
+  // a read syscall per chunk.
+  base::span<const uint8_t> file_data;
+  if (!info.unpacked) {
+    base::span<const uint8_t> mapped_data = archive->GetMappedData();
+    if (info.offset + info.size <= mapped_data.size())
+      file_data = mapped_data.subspan(info.offset, info.size);
+  }
+
+  // Note that while the |Archive| already opens a |base::File|, we still need
+  // to create a new |base::File| here, as it might be accessed by multiple
+  // requests at the same time.
+  base::File file;
+  if (file_data.empty() && info.size > 0) {
+    file.Initialize(info.unpacked ? real_path : archive->path(),
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid())
+      return net::FileErrorToNetError(file.error_details());
+  }
+
+  *reader = std::make_unique<AsarFileReader>(
+      archive, file_data, std::move(file), info.offset, info.size,
+      std::move(info.integrity));
+  if (info.size == 0 && !(*reader)->VerifyEmptyFile()) {
+    LOG(FATAL) << "Failed to validate empty ASAR file";
+    return net::ERR_FAILED;
+  }
+  *size = info.size;
+  return net::OK;
+}
+
+// Opens a file that is not in an archive, which is read with positional
+// reads like an unpacked file. |etag| is only set when not null.
+net::Error OpenFile(const base::FilePath& path,
+                    std::unique_ptr<AsarFileReader>* reader,
+                    uint64_t* size,
+                    std::string* etag) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return net::FileErrorToNetError(file.error_details());
+  base::File::Info info;
+  if (!file.GetInfo(&info) || info.is_directory || info.size < 0)
+    return net::ERR_FILE_NOT_FOUND;
+
+  if (etag)
+    *etag = MakeETag(info.last_modified, 0, info.size);
+  *size = info.size;
+  *reader = std::make_unique<AsarFileReader>(
+      nullptr, base::span<const uint8_t>(), std::move(file), 0, info.size,
+      absl::nullopt);
+  return net::OK;
+}
+
 // Modified from the |FileURLLoader| in |file_url_loader_factory.cc|, to serve
 // asar files instead of normal files.
 class AsarURLLoader : public network::mojom::URLLoader {
@@ -65,13 +405,14 @@ class AsarURLLoader : public network::mojom::URLLoader {
       const network::ResourceRequest& request,
       network::mojom::URLLoaderRequest loader,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
-      scoped_refptr<net::HttpResponseHeaders> extra_response_headers) {
+      scoped_refptr<net::HttpResponseHeaders> extra_response_headers,
+      bool generate_etag) {
     // Owns itself. Will live as long as its URLLoader and URLLoaderClientPtr
     // bindings are alive - essentially until either the client gives up or all
     // file data has been sent to it.
     auto* asar_url_loader = new AsarURLLoader;
     asar_url_loader->Start(request, std::move(loader), std::move(client),
-                           std::move(extra_response_headers));
+                           std::move(extra_response_headers), generate_etag);
   }
 
   // network::mojom::URLLoader:
@@ -96,7 +437,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
   void Start(const network::ResourceRequest& request,
              mojo::PendingReceiver<network::mojom::URLLoader> loader,
              mojo::PendingRemote<network::mojom::URLLoaderClient> client,
-             scoped_refptr<net::HttpResponseHeaders> extra_response_headers) {
+             scoped_refptr<net::HttpResponseHeaders> extra_response_headers,
+             bool generate_etag) {
     auto head = network::mojom::URLResponseHead::New();
     head->request_start = base::TimeTicks::Now();
     head->response_start = base::TimeTicks::Now();
@@ -114,7 +456,8 @@ class AsarURLLoader : public network::mojom::URLLoader {
 
     // Determine whether it is an asar file.
     base::FilePath asar_path, relative_path;
-    if (!GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    bool is_asar = GetAsarArchivePath(path, &asar_path, &relative_path);
+    if (!is_asar && !generate_etag) {
       content::CreateFileURLLoaderBypassingSecurityChecks(
           request, std::move(loader), std::move(client), nullptr, false,
           extra_response_headers);
@@ -127,76 +470,35 @@ class AsarURLLoader : public network::mojom::URLLoader {
     receiver_.set_disconnect_handler(base::BindOnce(
         &AsarURLLoader::OnConnectionError, base::Unretained(this)));
 
-    // Parse asar archive.
-    std::shared_ptr<Archive> archive = GetOrCreateAsarArchive(asar_path);
-    Archive::FileInfo info;
-    if (!archive || !archive->GetFileInfo(relative_path, &info)) {
-      OnClientComplete(net::ERR_FILE_NOT_FOUND);
-      return;
-    }
-    bool is_verifying_file = info.integrity.has_value();
-
-    // For unpacked path, read like normal file.
-    base::FilePath real_path;
-    if (info.unpacked) {
-      archive->CopyFileOut(relative_path, &real_path);
-      info.offset = 0;
-    }
-
-    mojo::ScopedDataPipeProducerHandle producer_handle;
-    mojo::ScopedDataPipeConsumerHandle consumer_handle;
-    if (mojo::CreateDataPipe(kDefaultFileUrlPipeSize, producer_handle,
-                             consumer_handle) != MOJO_RESULT_OK) {
-      OnClientComplete(net::ERR_FAILED);
+    std::unique_ptr<AsarFileReader> reader;
+    uint64_t file_size = 0;
+    std::string etag;
+    std::string* etag_out = generate_etag ? &etag : nullptr;
+    net::Error error =
+        is_asar ? OpenArchiveFile(asar_path, relative_path, &reader,
+                                  &file_size, etag_out)
+                : OpenFile(path, &reader, &file_size, etag_out);
+    if (error != net::OK) {
+      OnClientComplete(error);
       return;
     }
 
-    // Note that while the |Archive| already opens a |base::File|, we still need
-    // to create a new |base::File| here, as it might be accessed by multiple
-    // requests at the same time.
-    base::File file(info.unpacked ? real_path : archive->path(),
-                    base::File::FLAG_OPEN | base::File::FLAG_READ);
-    auto file_data_source =
-        std::make_unique<mojo::FileDataSource>(file.Duplicate());
-    std::unique_ptr<mojo::DataPipeProducer::DataSource> readable_data_source;
-    mojo::FileDataSource* file_data_source_raw = file_data_source.get();
-    AsarFileValidator* file_validator_raw = nullptr;
-    uint32_t block_size = 0;
-    if (info.integrity.has_value()) {
-      block_size = info.integrity.value().block_size;
-      auto asar_validator = std::make_unique<AsarFileValidator>(
-          std::move(info.integrity.value()), std::move(file));
-      file_validator_raw = asar_validator.get();
-      readable_data_source.reset(new mojo::FilteredDataSource(
-          std::move(file_data_source), std::move(asar_validator)));
-    } else {
-      readable_data_source = std::move(file_data_source);
-    }
-
-    std::vector<char> initial_read_buffer(
-        std::min(static_cast<uint32_t>(net::kMaxBytesToSniff), info.size));
-    auto read_result = readable_data_source.get()->Read(
-        info.offset, base::span<char>(initial_read_buffer));
-    if (read_result.result != MOJO_RESULT_OK) {
-      OnClientComplete(ConvertMojoResultToNetError(read_result.result));
-      return;
+    // A matching If-None-Match header takes precedence over the Range one.
+    bool not_modified = false;
+    if (!etag.empty() && head->headers) {
+      head->headers->SetHeader("ETag", etag);
+      not_modified = MatchesETag(request.headers, etag);
     }
 
+    std::vector<net::HttpByteRange> ranges;
     std::string range_header;
-    net::HttpByteRange byte_range;
-    if (request.headers.GetHeader(net::HttpRequestHeaders::kRange,
+    if (!not_modified &&
+        request.headers.GetHeader(net::HttpRequestHeaders::kRange,
                                   &range_header)) {
-      // Handle a simple Range header for a single range.
-      std::vector<net::HttpByteRange> ranges;
-      bool fail = false;
-      if (net::HttpUtil::ParseRangeHeader(range_header, &ranges) &&
-          ranges.size() == 1) {
-        byte_range = ranges[0];
-        if (!byte_range.ComputeBounds(info.size))
-          fail = true;
-      } else {
-        fail = true;
-      }
+      bool fail = !net::HttpUtil::ParseRangeHeader(range_header, &ranges) ||
+                  ranges.empty() || ranges.size() > kMaxByteRanges;
+      for (size_t i = 0; !fail && i < ranges.size(); ++i)
+        fail = !ranges[i].ComputeBounds(file_size);
 
       if (fail) {
         OnClientComplete(net::ERR_REQUEST_RANGE_NOT_SATISFIABLE);
@@ -204,141 +506,106 @@ class AsarURLLoader : public network::mojom::URLLoader {
       }
     }
 
-    uint64_t first_byte_to_send = 0;
-    uint64_t total_bytes_dropped_from_head = initial_read_buffer.size();
-    uint64_t total_bytes_to_send = info.size;
-
-    if (byte_range.IsValid()) {
-      first_byte_to_send = byte_range.first_byte_position();
-      total_bytes_to_send =
-          byte_range.last_byte_position() - first_byte_to_send + 1;
-    }
-
-    total_bytes_written_ = total_bytes_to_send;
-
-    head->content_length = base::saturated_cast<int64_t>(total_bytes_to_send);
-
-    if (first_byte_to_send < read_result.bytes_read) {
-      // Write any data we read for MIME sniffing, constraining by range where
-      // applicable. This will always fit in the pipe (see assertion near
-      // |kDefaultFileUrlPipeSize| definition).
-      uint32_t write_size = std::min(
-          static_cast<uint32_t>(read_result.bytes_read - first_byte_to_send),
-          static_cast<uint32_t>(total_bytes_to_send));
-      const uint32_t expected_write_size = write_size;
-      MojoResult result =
-          producer_handle->WriteData(&initial_read_buffer[first_byte_to_send],
-                                     &write_size, MOJO_WRITE_DATA_FLAG_NONE);
-      if (result != MOJO_RESULT_OK || write_size != expected_write_size) {
-        OnFileWritten(result);
+    if (!net::GetMimeTypeFromFile(path, &head->mime_type) && !not_modified) {
+      std::vector<char> sniff_buffer(
+          std::min<uint64_t>(net::kMaxBytesToSniff, file_size));
+      MojoResult read_result = reader->Read(0, base::span<char>(sniff_buffer));
+      if (read_result != MOJO_RESULT_OK) {
+        OnClientComplete(ConvertMojoResultToNetError(read_result));
         return;
       }
 
-      // Discount the bytes we just sent from the total range.
-      first_byte_to_send = read_result.bytes_read;
-      total_bytes_to_send -= write_size;
-    } else if (is_verifying_file &&
-               first_byte_to_send >= static_cast<uint64_t>(block_size)) {
-      // If validation is active and the range of bytes the request wants starts
-      // beyond the first block we need to read the next 4MB-1KB to validate
-      // that block. Then we can skip ahead to the target block in the SetRange
-      // call below If we hit this case it is assumed that none of the data read
-      // will be needed by the producer
-      uint64_t bytes_to_drop = block_size - net::kMaxBytesToSniff;
-      total_bytes_dropped_from_head += bytes_to_drop;
-      std::vector<char> abandoned_buffer(bytes_to_drop);
-      auto abandon_read_result =
-          readable_data_source.get()->Read(info.offset + net::kMaxBytesToSniff,
-                                           base::span<char>(abandoned_buffer));
-      if (abandon_read_result.result != MOJO_RESULT_OK) {
-        OnClientComplete(
-            ConvertMojoResultToNetError(abandon_read_result.result));
-        return;
-      }
-    }
-
-    if (!net::GetMimeTypeFromFile(path, &head->mime_type)) {
       std::string new_type;
       net::SniffMimeType(
-          base::StringPiece(initial_read_buffer.data(), read_result.bytes_read),
+          base::StringPiece(sniff_buffer.data(), sniff_buffer.size()),
           request.url, head->mime_type,
           net::ForceSniffFileUrlsForHtml::kDisabled, &new_type);
       head->mime_type.assign(new_type);
       head->did_mime_sniff = true;
     }
+    std::string content_type = head->mime_type;
+
+    auto data_source = std::make_unique<AsarDataSource>(std::move(reader));
+    if (not_modified) {
+      // The client already has the file, the response has no body.
+      head->headers->ReplaceStatusLine("HTTP/1.1 304 Not Modified");
+    } else if (ranges.empty()) {
+      data_source->AddRange(0, file_size);
+    } else if (ranges.size() == 1) {
+      const net::HttpByteRange& range = ranges[0];
+      data_source->AddRange(
+          range.first_byte_position(),
+          range.last_byte_position() - range.first_byte_position() + 1);
+      SetPartialContent(head.get());
+      head->headers->AddHeader(
+          net::HttpResponseHeaders::kContentRange,
+          base::StringPrintf("bytes %" PRId64 "-%" PRId64 "/%" PRIu64,
+                             range.first_byte_position(),
+                             range.last_byte_position(), file_size));
+    } else {
+      // Several ranges are sent as a multipart/byteranges body.
+      std::string boundary = net::GenerateMimeMultipartBoundary();
+      for (const auto& range : ranges) {
+        data_source->AddText(base::StringPrintf(
+            "%s--%s\r\nContent-Type: %s\r\n"
+            "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRIu64
+            "\r\n\r\n",
+            data_source->GetLength() ? "\r\n" : "", boundary.c_str(),
+            head->mime_type.c_str(), range.first_byte_position(),
+            range.last_byte_position(), file_size));
+        data_source->AddRange(
+            range.first_byte_position(),
+            range.last_byte_position() - range.first_byte_position() + 1);
+      }
+      data_source->AddText(
+          base::StringPrintf("\r\n--%s--\r\n", boundary.c_str()));
+
+      SetPartialContent(head.get());
+      head->mime_type = "multipart/byteranges";
+      content_type = "multipart/byteranges; boundary=" + boundary;
+    }
+
+    uint64_t total_bytes_to_send = data_source->GetLength();
+    total_bytes_written_ = total_bytes_to_send;
+    head->content_length = base::saturated_cast<int64_t>(total_bytes_to_send);
+
+    mojo::ScopedDataPipeProducerHandle producer_handle;
+    mojo::ScopedDataPipeConsumerHandle consumer_handle;
+    if (mojo::CreateDataPipe(GetPipeSize(total_bytes_to_send), producer_handle,
+                             consumer_handle) != MOJO_RESULT_OK) {
+      OnClientComplete(net::ERR_FAILED);
+      return;
+    }
+
     if (head->headers) {
       head->headers->AddHeader(net::HttpRequestHeaders::kContentType,
-                               head->mime_type.c_str());
+                               content_type.c_str());
     }
     client_->OnReceiveResponse(std::move(head));
     client_->OnStartLoadingResponseBody(std::move(consumer_handle));
 
     if (total_bytes_to_send == 0) {
       // There's definitely no more data, so we're already done.
-      // We provide the range data to the file validator so that
-      // it can validate the tiny amount of data we did send
-      if (file_validator_raw)
-        file_validator_raw->SetRange(info.offset + first_byte_to_send,
-                                     total_bytes_dropped_from_head,
-                                     info.offset + info.size);
       OnFileWritten(MOJO_RESULT_OK);
       return;
     }
 
-    if (is_verifying_file) {
-      int start_block = first_byte_to_send / block_size;
-
-      // If we're starting from the first block, we might not be starting from
-      // where we sniffed. We might be a few KB into a file so we need to read
-      // the data in the middle so it gets hashed.
-      //
-      // If we're starting from a later block we might be starting half-way
-      // through the block regardless of what was sniffed.  We need to read the
-      // data from the start of our initial block up to the start of our actual
-      // read point so it gets hashed.
-      uint64_t bytes_to_drop =
-          start_block == 0 ? first_byte_to_send - net::kMaxBytesToSniff
-                           : first_byte_to_send - (start_block * block_size);
-      if (file_validator_raw)
-        file_validator_raw->SetCurrentBlock(start_block);
-
-      if (bytes_to_drop > 0) {
-        uint64_t dropped_bytes_offset =
-            info.offset + (start_block * block_size);
-        if (start_block == 0)
-          dropped_bytes_offset += net::kMaxBytesToSniff;
-        total_bytes_dropped_from_head += bytes_to_drop;
-        std::vector<char> abandoned_buffer(bytes_to_drop);
-        auto abandon_read_result = readable_data_source.get()->Read(
-            dropped_bytes_offset, base::span<char>(abandoned_buffer));
-        if (abandon_read_result.result != MOJO_RESULT_OK) {
-          OnClientComplete(
-              ConvertMojoResultToNetError(abandon_read_result.result));
-          return;
-        }
-      }
-    }
-
-    // In case of a range request, seek to the appropriate position before
-    // sending the remaining bytes asynchronously. Under normal conditions
-    // (i.e., no range request) this Seek is effectively a no-op.
-    //
-    // Note that in Electron we also need to add file offset.
-    file_data_source_raw->SetRange(
-        first_byte_to_send + info.offset,
-        first_byte_to_send + info.offset + total_bytes_to_send);
-    if (file_validator_raw)
-      file_validator_raw->SetRange(info.offset + first_byte_to_send,
-                                   total_bytes_dropped_from_head,
-                                   info.offset + info.size);
-
     data_producer_ =
         std::make_unique<mojo::DataPipeProducer>(std::move(producer_handle));
     data_producer_->Write(
-        std::move(readable_data_source),
+        std::move(data_source),
         base::BindOnce(&AsarURLLoader::OnFileWritten, base::Unretained(this)));
   }
 
+  static void SetPartialContent(network::mojom::URLResponseHead* head) {
+    if (!head->headers) {
+      head->headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+          "HTTP/1.1 206 Partial Content");
+    } else {
+      head->headers->ReplaceStatusLine("HTTP/1.1 206 Partial Content");
+    }
+  }
+
   void OnConnectionError() {
     receiver_.reset();
     MaybeDeleteSelf();
@@ -385,20 +652,40 @@ class AsarURLLoader : public network::mojom::URLLoader {
   size_t total_bytes_written_ = 0;
 };
 
-}  // namespace
-
-void CreateAsarURLLoader(
+void StartAsarURLLoader(
     const network::ResourceRequest& request,
     network::mojom::URLLoaderRequest loader,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
-    scoped_refptr<net::HttpResponseHeaders> extra_response_headers) {
+    scoped_refptr<net::HttpResponseHeaders> extra_response_headers,
+    bool generate_etag) {
   auto task_runner = base::ThreadPool::CreateSequencedTaskRunner(
       {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
        base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
   task_runner->PostTask(
       FROM_HERE,
       base::BindOnce(&AsarURLLoader::CreateAndStart, request, std::move(loader),
-                     std::move(client), std::move(extra_response_headers)));
+                     std::move(client), std::move(extra_response_headers),
+                     generate_etag));
+}
+
+}  // namespace
+
+void CreateAsarURLLoader(
+    const network::ResourceRequest& request,
+    network::mojom::URLLoaderRequest loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    scoped_refptr<net::HttpResponseHeaders> extra_response_headers) {
+  StartAsarURLLoader(request, std::move(loader), std::move(client),
+                     std::move(extra_response_headers), false);
+}
+
+void CreateAsarURLLoaderWithETag(
+    const network::ResourceRequest& request,
+    network::mojom::URLLoaderRequest loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    scoped_refptr<net::HttpResponseHeaders> extra_response_headers) {
+  StartAsarURLLoader(request, std::move(loader), std::move(client),
+                     std::move(extra_response_headers), true);
 }
 
 }  // namespace asar
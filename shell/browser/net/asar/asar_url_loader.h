@@ -17,6 +17,15 @@ void CreateAsarURLLoader(
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     scoped_refptr<net::HttpResponseHeaders> extra_response_headers);
 
+// Like CreateAsarURLLoader, but files that are not in an archive are read by
+// the same loader instead of Chromium's, and responses get an ETag. Requests
+// with a matching If-None-Match header get a 304 with no body.
+void CreateAsarURLLoaderWithETag(
+    const network::ResourceRequest& request,
+    network::mojom::URLLoaderRequest loader,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    scoped_refptr<net::HttpResponseHeaders> extra_response_headers);
+
 }  // namespace asar
 
 #endif  // SHELL_BROWSER_NET_ASAR_ASAR_URL_LOADER_H_
@@ -0,0 +1,117 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/directory_url_loader_factory.h"
+
+#include <utility>
+
+#include "base/strings/string_util.h"
+#include "base/task/thread_pool.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "net/base/escape.h"
+#include "net/base/filename_util.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_response_headers.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/url_loader_completion_status.h"
+#include "shell/browser/net/asar/asar_url_loader.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+// static
+mojo::PendingRemote<network::mojom::URLLoaderFactory>
+DirectoryURLLoaderFactory::Create(DirectoryMapping directories) {
+  mojo::PendingRemote<network::mojom::URLLoaderFactory> pending_remote;
+
+  // The factory is bound on its own sequence, so that the requests are
+  // received there instead of on the UI thread. It will delete itself when
+  // there are no more receivers - see the
+  // SelfDeletingURLLoaderFactory::OnDisconnect method.
+  auto task_runner = base::ThreadPool::CreateSequencedTaskRunner(
+      {base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+  task_runner->PostTask(
+      FROM_HERE,
+      base::BindOnce(
+          [](DirectoryMapping directories,
+             mojo::PendingReceiver<network::mojom::URLLoaderFactory>
+                 factory_receiver) {
+            new DirectoryURLLoaderFactory(std::move(directories),
+                                          std::move(factory_receiver));
+          },
+          std::move(directories),
+          pending_remote.InitWithNewPipeAndPassReceiver()));
+
+  return pending_remote;
+}
+
+// static
+bool DirectoryURLLoaderFactory::GetFilePath(const DirectoryMapping& directories,
+                                            const GURL& url,
+                                            base::FilePath* path) {
+  auto it = directories.find(url.host());
+  if (it == directories.end())
+    return false;
+
+  // Escaped separators and dots are unescaped before the path is checked.
+  std::string unescaped = net::UnescapeBinaryURLComponent(url.path_piece());
+  if (unescaped.find('\0') != std::string::npos ||
+      unescaped.find('\\') != std::string::npos)
+    return false;
+#if defined(OS_WIN)
+  // Drive letters and alternate data streams.
+  if (unescaped.find(':') != std::string::npos)
+    return false;
+#endif
+
+  std::string relative_path(
+      base::TrimString(unescaped, "/", base::TRIM_LEADING));
+  if (relative_path.empty() || base::EndsWith(relative_path, "/"))
+    relative_path += "index.html";
+
+  base::FilePath relative = base::FilePath::FromUTF8Unsafe(relative_path);
+  if (relative.IsAbsolute() || relative.ReferencesParent())
+    return false;
+
+  *path = it->second.Append(relative);
+  return true;
+}
+
+DirectoryURLLoaderFactory::DirectoryURLLoaderFactory(
+    DirectoryMapping directories,
+    mojo::PendingReceiver<network::mojom::URLLoaderFactory> factory_receiver)
+    : network::SelfDeletingURLLoaderFactory(std::move(factory_receiver)),
+      directories_(std::move(directories)) {}
+
+DirectoryURLLoaderFactory::~DirectoryURLLoaderFactory() = default;
+
+void DirectoryURLLoaderFactory::CreateLoaderAndStart(
+    mojo::PendingReceiver<network::mojom::URLLoader> loader,
+    int32_t request_id,
+    uint32_t options,
+    const network::ResourceRequest& request,
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    const net::MutableNetworkTrafficAnnotationTag& traffic_annotation) {
+  base::FilePath path;
+  if (!GetFilePath(directories_, request.url, &path)) {
+    mojo::Remote<network::mojom::URLLoaderClient> client_remote(
+        std::move(client));
+    client_remote->OnComplete(
+        network::URLLoaderCompletionStatus(net::ERR_FILE_NOT_FOUND));
+    return;
+  }
+
+  network::ResourceRequest file_request(request);
+  file_request.url = net::FilePathToFileURL(path);
+
+  // Add header to ignore CORS, like the file protocol handlers.
+  auto headers =
+      base::MakeRefCounted<net::HttpResponseHeaders>("HTTP/1.1 200 OK");
+  headers->AddHeader("Access-Control-Allow-Origin", "*");
+  asar::CreateAsarURLLoaderWithETag(file_request, std::move(loader),
+                                    std::move(client), std::move(headers));
+}
+
+}  // namespace electron
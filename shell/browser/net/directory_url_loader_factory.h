@@ -0,0 +1,66 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_DIRECTORY_URL_LOADER_FACTORY_H_
+#define SHELL_BROWSER_NET_DIRECTORY_URL_LOADER_FACTORY_H_
+
+#include <map>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/pending_remote.h"
+#include "services/network/public/cpp/self_deleting_url_loader_factory.h"
+
+class GURL;
+
+namespace electron {
+
+// Maps the hosts of a scheme to the directories, or asar archives, their files
+// are served from.
+using DirectoryMapping = std::map<std::string, base::FilePath>;
+
+// Serves the requests of a scheme from the files of a DirectoryMapping.
+//
+// Unlike the factory of a protocol handler, the factory lives on a sequence
+// of the thread pool and the files are read by the asar loader there too, so
+// the UI thread never sees the requests.
+class DirectoryURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
+ public:
+  static mojo::PendingRemote<network::mojom::URLLoaderFactory> Create(
+      DirectoryMapping directories);
+
+  // Gets the file |url| maps to. Returns false when the host is not mapped or
+  // the path could point outside of the directory.
+  static bool GetFilePath(const DirectoryMapping& directories,
+                          const GURL& url,
+                          base::FilePath* path);
+
+  // disable copy
+  DirectoryURLLoaderFactory(const DirectoryURLLoaderFactory&) = delete;
+  DirectoryURLLoaderFactory& operator=(const DirectoryURLLoaderFactory&) =
+      delete;
+
+ private:
+  DirectoryURLLoaderFactory(
+      DirectoryMapping directories,
+      mojo::PendingReceiver<network::mojom::URLLoaderFactory> factory_receiver);
+  ~DirectoryURLLoaderFactory() override;
+
+  // network::mojom::URLLoaderFactory:
+  void CreateLoaderAndStart(
+      mojo::PendingReceiver<network::mojom::URLLoader> loader,
+      int32_t request_id,
+      uint32_t options,
+      const network::ResourceRequest& request,
+      mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+      const net::MutableNetworkTrafficAnnotationTag& traffic_annotation)
+      override;
+
+  const DirectoryMapping directories_;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_DIRECTORY_URL_LOADER_FACTORY_H_
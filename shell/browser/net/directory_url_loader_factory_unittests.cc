@@ -0,0 +1,80 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/directory_url_loader_factory.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+namespace {
+
+base::FilePath GetRoot() {
+#if defined(OS_WIN)
+  return base::FilePath(FILE_PATH_LITERAL("C:\\app"));
+#else
+  return base::FilePath(FILE_PATH_LITERAL("/app"));
+#endif
+}
+
+DirectoryMapping CreateMapping() {
+  DirectoryMapping directories;
+  directories["main"] = GetRoot().AppendASCII("renderer");
+  directories["assets"] = GetRoot().AppendASCII("assets.asar");
+  return directories;
+}
+
+}  // namespace
+
+TEST(DirectoryURLLoaderFactoryTest, MapsHostsToDirectories) {
+  DirectoryMapping directories = CreateMapping();
+  base::FilePath path;
+  EXPECT_TRUE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://main/js/index.js"), &path));
+  EXPECT_EQ(GetRoot().AppendASCII("renderer").AppendASCII("js").AppendASCII(
+                "index.js"),
+            path);
+
+  EXPECT_TRUE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://assets/a%20b.png?v=1#top"), &path));
+  EXPECT_EQ(GetRoot().AppendASCII("assets.asar").AppendASCII("a b.png"), path);
+
+  EXPECT_FALSE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://other/index.html"), &path));
+}
+
+TEST(DirectoryURLLoaderFactoryTest, ServesIndexOfDirectories) {
+  DirectoryMapping directories = CreateMapping();
+  base::FilePath path;
+  EXPECT_TRUE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://main/"), &path));
+  EXPECT_EQ(GetRoot().AppendASCII("renderer").AppendASCII("index.html"), path);
+
+  EXPECT_TRUE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://main/docs/"), &path));
+  EXPECT_EQ(GetRoot().AppendASCII("renderer").AppendASCII("docs").AppendASCII(
+                "index.html"),
+            path);
+}
+
+TEST(DirectoryURLLoaderFactoryTest, RejectsPathsOutsideOfDirectories) {
+  DirectoryMapping directories = CreateMapping();
+  base::FilePath path;
+  EXPECT_FALSE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://main/..%2Fsecret"), &path));
+  EXPECT_FALSE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://main/js/%2e%2e%2f%2e%2e%2fsecret"), &path));
+  EXPECT_FALSE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://main/js%5C..%5Csecret"), &path));
+  EXPECT_FALSE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://main/a%00b"), &path));
+
+  // Leading separators do not make the path absolute.
+  EXPECT_TRUE(DirectoryURLLoaderFactory::GetFilePath(
+      directories, GURL("https://main//%2Fetc/passwd"), &path));
+  EXPECT_TRUE(GetRoot().AppendASCII("renderer").IsParent(path));
+}
+
+}  // namespace electron
@@ -21,6 +21,7 @@
 #include "net/url_request/redirect_util.h"
 #include "services/network/public/cpp/url_loader_completion_status.h"
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
+#include "shell/browser/api/electron_api_response_writer.h"
 #include "shell/browser/api/electron_api_session.h"
 #include "shell/browser/electron_browser_context.h"
 #include "shell/browser/net/asar/asar_url_loader.h"
@@ -154,6 +155,12 @@ network::mojom::URLResponseHeadPtr ToResponseHead(
 struct WriteData {
   mojo::Remote<network::mojom::URLLoaderClient> client;
   std::string data;
+  // When sending a Buffer, the Buffer is written without copying its data to
+  // |data|.
+  v8::Global<v8::Value> buffer;
+  // The body of a cached response.
+  scoped_refptr<base::RefCountedString> cached_body;
+  base::StringPiece contents;
   std::unique_ptr<mojo::DataPipeProducer> producer;
 };
 
@@ -161,13 +168,58 @@ void OnWrite(std::unique_ptr<WriteData> write_data, MojoResult result) {
   network::URLLoaderCompletionStatus status(net::ERR_FAILED);
   if (result == MOJO_RESULT_OK) {
     status = network::URLLoaderCompletionStatus(net::OK);
-    status.encoded_data_length = write_data->data.size();
-    status.encoded_body_length = write_data->data.size();
-    status.decoded_body_length = write_data->data.size();
+    status.encoded_data_length = write_data->contents.size();
+    status.encoded_body_length = write_data->contents.size();
+    status.decoded_body_length = write_data->contents.size();
   }
   write_data->client->OnComplete(status);
 }
 
+// Helper to send the contents of |write_data| as response.
+void SendWriteData(mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+                   network::mojom::URLResponseHeadPtr head,
+                   std::unique_ptr<WriteData> write_data) {
+  mojo::Remote<network::mojom::URLLoaderClient> client_remote(
+      std::move(client));
+
+  // Add header to ignore CORS.
+  head->headers->AddHeader("Access-Control-Allow-Origin", "*");
+  client_remote->OnReceiveResponse(std::move(head));
+
+  // Code below follows the pattern of data_url_loader_factory.cc.
+  mojo::ScopedDataPipeProducerHandle producer;
+  mojo::ScopedDataPipeConsumerHandle consumer;
+  if (mojo::CreateDataPipe(nullptr, producer, consumer) != MOJO_RESULT_OK) {
+    client_remote->OnComplete(
+        network::URLLoaderCompletionStatus(net::ERR_INSUFFICIENT_RESOURCES));
+    return;
+  }
+
+  client_remote->OnStartLoadingResponseBody(std::move(consumer));
+
+  write_data->client = std::move(client_remote);
+  write_data->producer =
+      std::make_unique<mojo::DataPipeProducer>(std::move(producer));
+  auto* producer_ptr = write_data->producer.get();
+
+  base::StringPiece string_piece(write_data->contents);
+  producer_ptr->Write(
+      std::make_unique<mojo::StringDataSource>(
+          string_piece, mojo::StringDataSource::AsyncWritingMode::
+                            STRING_STAYS_VALID_UNTIL_COMPLETION),
+      base::BindOnce(OnWrite, std::move(write_data)));
+}
+
+void SendCachedResponse(
+    mojo::PendingRemote<network::mojom::URLLoaderClient> client,
+    ProtocolResponseCache::Response response) {
+  auto write_data = std::make_unique<WriteData>();
+  write_data->cached_body = std::move(response.body);
+  write_data->contents = write_data->cached_body->data();
+  SendWriteData(std::move(client), std::move(response.head),
+                std::move(write_data));
+}
+
 }  // namespace
 
 ElectronURLLoaderFactory::RedirectedRequest::RedirectedRequest(
@@ -250,12 +302,13 @@ void ElectronURLLoaderFactory::RedirectedRequest::DeleteThis() {
 // static
 mojo::PendingRemote<network::mojom::URLLoaderFactory>
 ElectronURLLoaderFactory::Create(ProtocolType type,
-                                 const ProtocolHandler& handler) {
+                                 const ProtocolHandler& handler,
+                                 scoped_refptr<ProtocolResponseCache> cache) {
   mojo::PendingRemote<network::mojom::URLLoaderFactory> pending_remote;
 
   // The ElectronURLLoaderFactory will delete itself when there are no more
   // receivers - see the SelfDeletingURLLoaderFactory::OnDisconnect method.
-  new ElectronURLLoaderFactory(type, handler,
+  new ElectronURLLoaderFactory(type, handler, std::move(cache),
                                pending_remote.InitWithNewPipeAndPassReceiver());
 
   return pending_remote;
@@ -264,10 +317,12 @@ ElectronURLLoaderFactory::Create(ProtocolType type,
 ElectronURLLoaderFactory::ElectronURLLoaderFactory(
     ProtocolType type,
     const ProtocolHandler& handler,
+    scoped_refptr<ProtocolResponseCache> cache,
     mojo::PendingReceiver<network::mojom::URLLoaderFactory> factory_receiver)
     : network::SelfDeletingURLLoaderFactory(std::move(factory_receiver)),
       type_(type),
-      handler_(handler) {}
+      handler_(handler),
+      cache_(std::move(cache)) {}
 
 ElectronURLLoaderFactory::~ElectronURLLoaderFactory() = default;
 
@@ -286,11 +341,23 @@ void ElectronURLLoaderFactory::CreateLoaderAndStart(
   mojo::PendingRemote<network::mojom::URLLoaderFactory> target_factory;
   this->Clone(target_factory.InitWithNewPipeAndPassReceiver());
 
+  // Answer from the cache without calling the handler, otherwise the request
+  // may get the validators of a stale cached response.
+  network::ResourceRequest handler_request = request;
+  if (cache_) {
+    ProtocolResponseCache::Response cached;
+    if (cache_->Lookup(&handler_request, &cached)) {
+      SendCachedResponse(std::move(client), std::move(cached));
+      return;
+    }
+  }
+
   handler_.Run(
-      request,
+      handler_request,
       base::BindOnce(&ElectronURLLoaderFactory::StartLoading, std::move(loader),
-                     request_id, options, request, std::move(client),
-                     traffic_annotation, std::move(target_factory), type_));
+                     request_id, options, handler_request, std::move(client),
+                     traffic_annotation, std::move(target_factory), type_,
+                     cache_));
 }
 
 // static
@@ -315,6 +382,7 @@ void ElectronURLLoaderFactory::StartLoading(
     const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
     mojo::PendingRemote<network::mojom::URLLoaderFactory> target_factory,
     ProtocolType type,
+    scoped_refptr<ProtocolResponseCache> cache,
     gin::Arguments* args) {
   // Send network error when there is no argument passed.
   //
@@ -340,6 +408,15 @@ void ElectronURLLoaderFactory::StartLoading(
 
   network::mojom::URLResponseHeadPtr head = ToResponseHead(dict);
 
+  // The handler confirmed that the cached response is still valid.
+  if (cache) {
+    ProtocolResponseCache::Response cached;
+    if (cache->Revalidate(request, *head->headers, &cached)) {
+      SendCachedResponse(std::move(client), std::move(cached));
+      return;
+    }
+  }
+
   // Handle redirection.
   //
   // Note that with NetworkService, sending the "Location" header no longer
@@ -391,11 +468,12 @@ void ElectronURLLoaderFactory::StartLoading(
 
   switch (type) {
     case ProtocolType::kBuffer:
-      StartLoadingBuffer(std::move(client), std::move(head), dict);
+      StartLoadingBuffer(request, std::move(client), std::move(head),
+                         cache.get(), dict);
       break;
     case ProtocolType::kString:
-      StartLoadingString(std::move(client), std::move(head), dict,
-                         args->isolate(), response);
+      StartLoadingString(request, std::move(client), std::move(head),
+                         cache.get(), dict, args->isolate(), response);
       break;
     case ProtocolType::kFile:
       StartLoadingFile(std::move(loader), request, std::move(client),
@@ -418,15 +496,17 @@ void ElectronURLLoaderFactory::StartLoading(
       }
       StartLoading(std::move(loader), request_id, options, request,
                    std::move(client), traffic_annotation,
-                   std::move(target_factory), type, args);
+                   std::move(target_factory), type, std::move(cache), args);
       break;
   }
 }
 
 // static
 void ElectronURLLoaderFactory::StartLoadingBuffer(
+    const network::ResourceRequest& request,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::mojom::URLResponseHeadPtr head,
+    ProtocolResponseCache* cache,
     const gin_helper::Dictionary& dict) {
   v8::Local<v8::Value> buffer = dict.GetHandle();
   dict.Get("data", &buffer);
@@ -438,15 +518,21 @@ void ElectronURLLoaderFactory::StartLoadingBuffer(
     return;
   }
 
-  SendContents(
-      std::move(client), std::move(head),
-      std::string(node::Buffer::Data(buffer), node::Buffer::Length(buffer)));
+  auto write_data = std::make_unique<WriteData>();
+  write_data->buffer.Reset(dict.isolate(), buffer);
+  write_data->contents = base::StringPiece(node::Buffer::Data(buffer),
+                                           node::Buffer::Length(buffer));
+  if (cache)
+    cache->Store(request, *head, write_data->contents);
+  SendWriteData(std::move(client), std::move(head), std::move(write_data));
 }
 
 // static
 void ElectronURLLoaderFactory::StartLoadingString(
+    const network::ResourceRequest& request,
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::mojom::URLResponseHeadPtr head,
+    ProtocolResponseCache* cache,
     const gin_helper::Dictionary& dict,
     v8::Isolate* isolate,
     v8::Local<v8::Value> response) {
@@ -463,6 +549,8 @@ void ElectronURLLoaderFactory::StartLoadingString(
     return;
   }
 
+  if (cache)
+    cache->Store(request, *head, contents);
   SendContents(std::move(client), std::move(head), std::move(contents));
 }
 
@@ -579,6 +667,21 @@ void ElectronURLLoaderFactory::StartLoadingStream(
     return;
   }
 
+  // A writer created by protocol.createResponseWriter().
+  api::ResponseWriter* writer = nullptr;
+  if (gin::ConvertFromV8(dict.isolate(), stream, &writer)) {
+    if (writer->has_started()) {
+      // The writer already sent the response of another request.
+      mojo::Remote<network::mojom::URLLoaderClient> client_remote(
+          std::move(client));
+      client_remote->OnComplete(
+          network::URLLoaderCompletionStatus(net::ERR_FAILED));
+      return;
+    }
+    writer->Start(std::move(head), std::move(loader), std::move(client));
+    return;
+  }
+
   gin_helper::Dictionary data = ToDict(dict.isolate(), stream);
   v8::Local<v8::Value> method;
   if (!data.Get("on", &method) || !method->IsFunction() ||
@@ -599,37 +702,10 @@ void ElectronURLLoaderFactory::SendContents(
     mojo::PendingRemote<network::mojom::URLLoaderClient> client,
     network::mojom::URLResponseHeadPtr head,
     std::string data) {
-  mojo::Remote<network::mojom::URLLoaderClient> client_remote(
-      std::move(client));
-
-  // Add header to ignore CORS.
-  head->headers->AddHeader("Access-Control-Allow-Origin", "*");
-  client_remote->OnReceiveResponse(std::move(head));
-
-  // Code below follows the pattern of data_url_loader_factory.cc.
-  mojo::ScopedDataPipeProducerHandle producer;
-  mojo::ScopedDataPipeConsumerHandle consumer;
-  if (mojo::CreateDataPipe(nullptr, producer, consumer) != MOJO_RESULT_OK) {
-    client_remote->OnComplete(
-        network::URLLoaderCompletionStatus(net::ERR_INSUFFICIENT_RESOURCES));
-    return;
-  }
-
-  client_remote->OnStartLoadingResponseBody(std::move(consumer));
-
   auto write_data = std::make_unique<WriteData>();
-  write_data->client = std::move(client_remote);
   write_data->data = std::move(data);
-  write_data->producer =
-      std::make_unique<mojo::DataPipeProducer>(std::move(producer));
-  auto* producer_ptr = write_data->producer.get();
-
-  base::StringPiece string_piece(write_data->data);
-  producer_ptr->Write(
-      std::make_unique<mojo::StringDataSource>(
-          string_piece, mojo::StringDataSource::AsyncWritingMode::
-                            STRING_STAYS_VALID_UNTIL_COMPLETION),
-      base::BindOnce(OnWrite, std::move(write_data)));
+  write_data->contents = write_data->data;
+  SendWriteData(std::move(client), std::move(head), std::move(write_data));
 }
 
 }  // namespace electron
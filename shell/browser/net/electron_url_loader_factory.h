@@ -20,6 +20,7 @@
 #include "services/network/public/mojom/url_loader.mojom.h"
 #include "services/network/public/mojom/url_loader_factory.mojom.h"
 #include "services/network/public/mojom/url_response_head.mojom.h"
+#include "shell/browser/net/protocol_response_cache.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
@@ -97,7 +98,8 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
 
   static mojo::PendingRemote<network::mojom::URLLoaderFactory> Create(
       ProtocolType type,
-      const ProtocolHandler& handler);
+      const ProtocolHandler& handler,
+      scoped_refptr<ProtocolResponseCache> cache);
 
   // network::mojom::URLLoaderFactory:
   void CreateLoaderAndStart(
@@ -118,6 +120,7 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
       const net::MutableNetworkTrafficAnnotationTag& traffic_annotation,
       mojo::PendingRemote<network::mojom::URLLoaderFactory> target_factory,
       ProtocolType type,
+      scoped_refptr<ProtocolResponseCache> cache,
       gin::Arguments* args);
 
   // disable copy
@@ -128,6 +131,7 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
   ElectronURLLoaderFactory(
       ProtocolType type,
       const ProtocolHandler& handler,
+      scoped_refptr<ProtocolResponseCache> cache,
       mojo::PendingReceiver<network::mojom::URLLoaderFactory> factory_receiver);
   ~ElectronURLLoaderFactory() override;
 
@@ -136,12 +140,16 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
       int32_t request_id,
       const network::URLLoaderCompletionStatus& status);
   static void StartLoadingBuffer(
+      const network::ResourceRequest& request,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       network::mojom::URLResponseHeadPtr head,
+      ProtocolResponseCache* cache,
       const gin_helper::Dictionary& dict);
   static void StartLoadingString(
+      const network::ResourceRequest& request,
       mojo::PendingRemote<network::mojom::URLLoaderClient> client,
       network::mojom::URLResponseHeadPtr head,
+      ProtocolResponseCache* cache,
       const gin_helper::Dictionary& dict,
       v8::Isolate* isolate,
       v8::Local<v8::Value> response);
@@ -173,6 +181,8 @@ class ElectronURLLoaderFactory : public network::SelfDeletingURLLoaderFactory {
 
   ProtocolType type_;
   ProtocolHandler handler_;
+  // Null when the responses of the scheme are not cached.
+  scoped_refptr<ProtocolResponseCache> cache_;
 };
 
 }  // namespace electron
@@ -0,0 +1,229 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/protocol_response_cache.h"
+
+#include <utility>
+
+#include "base/strings/string_util.h"
+#include "net/base/load_flags.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "services/network/public/cpp/resource_request.h"
+
+namespace electron {
+
+namespace {
+
+// Gets the values of the request headers named by the Vary header, returns
+// false when the response varies on anything.
+bool GetVaryKey(const net::HttpResponseHeaders& headers,
+                const net::HttpRequestHeaders& request_headers,
+                std::string* key) {
+  size_t iter = 0;
+  std::string name;
+  while (headers.EnumerateHeader(&iter, "vary", &name)) {
+    if (name == "*")
+      return false;
+    std::string value;
+    request_headers.GetHeader(name, &value);
+    key->append(base::ToLowerASCII(name));
+    key->append(":");
+    key->append(value);
+    key->append("\n");
+  }
+  return true;
+}
+
+bool IsFresh(const net::HttpResponseHeaders& headers,
+             base::Time request_time,
+             base::Time response_time) {
+  return headers.RequiresValidation(request_time, response_time,
+                                    base::Time::Now()) == net::VALIDATION_NONE;
+}
+
+}  // namespace
+
+ProtocolResponseCache::Response::Response() = default;
+ProtocolResponseCache::Response::~Response() = default;
+ProtocolResponseCache::Response::Response(Response&&) = default;
+ProtocolResponseCache::Response& ProtocolResponseCache::Response::operator=(
+    Response&&) = default;
+
+ProtocolResponseCache::Entry::Entry() = default;
+ProtocolResponseCache::Entry::~Entry() = default;
+ProtocolResponseCache::Entry::Entry(Entry&&) = default;
+ProtocolResponseCache::Entry& ProtocolResponseCache::Entry::operator=(
+    Entry&&) = default;
+
+ProtocolResponseCache::ProtocolResponseCache(size_t max_size)
+    : entries_(EntryCache::NO_AUTO_EVICT), max_size_(max_size) {}
+
+ProtocolResponseCache::~ProtocolResponseCache() = default;
+
+bool ProtocolResponseCache::Lookup(network::ResourceRequest* request,
+                                   Response* response) {
+  if (request->method != net::HttpRequestHeaders::kGetMethod)
+    return false;
+
+  auto it = Find(*request);
+  if (it == entries_.end() || (request->load_flags & net::LOAD_BYPASS_CACHE)) {
+    stats_.misses++;
+    return false;
+  }
+
+  const Entry& entry = it->second;
+  if (!(request->load_flags & net::LOAD_VALIDATE_CACHE) &&
+      IsFresh(*entry.headers, entry.request_time, entry.response_time)) {
+    stats_.hits++;
+    *response = CreateResponse(entry);
+    return true;
+  }
+
+  // Let the handler confirm the cached response, unless the page sent its own
+  // conditional request.
+  stats_.misses++;
+  net::HttpRequestHeaders& headers = request->headers;
+  if (headers.HasHeader(net::HttpRequestHeaders::kIfNoneMatch) ||
+      headers.HasHeader(net::HttpRequestHeaders::kIfModifiedSince))
+    return false;
+  std::string validator;
+  if (entry.headers->EnumerateHeader(nullptr, "etag", &validator))
+    headers.SetHeader(net::HttpRequestHeaders::kIfNoneMatch, validator);
+  if (entry.headers->EnumerateHeader(nullptr, "last-modified", &validator))
+    headers.SetHeader(net::HttpRequestHeaders::kIfModifiedSince, validator);
+  return false;
+}
+
+bool ProtocolResponseCache::Store(const network::ResourceRequest& request,
+                                  const network::mojom::URLResponseHead& head,
+                                  base::StringPiece body) {
+  const net::HttpResponseHeaders* headers = head.headers.get();
+  if (request.method != net::HttpRequestHeaders::kGetMethod || !headers ||
+      headers->response_code() != net::HTTP_OK ||
+      headers->HasHeaderValue("cache-control", "no-store"))
+    return false;
+
+  Entry entry;
+  if (!GetVaryKey(*headers, request.headers, &entry.vary_key))
+    return false;
+
+  // Responses that are neither fresh nor can be revalidated would never be
+  // used.
+  entry.request_time = entry.response_time = base::Time::Now();
+  if (!IsFresh(*headers, entry.request_time, entry.response_time) &&
+      !headers->HasHeader("etag") && !headers->HasHeader("last-modified"))
+    return false;
+
+  entry.size = request.url.spec().size() + headers->raw_headers().size() +
+               body.size();
+  if (entry.size > max_size_)
+    return false;
+
+  // The headers of the response are modified as it is sent.
+  entry.headers =
+      base::MakeRefCounted<net::HttpResponseHeaders>(headers->raw_headers());
+  entry.mime_type = head.mime_type;
+  entry.charset = head.charset;
+  entry.body = base::MakeRefCounted<base::RefCountedString>(std::string(body));
+
+  auto it = entries_.Peek(request.url.spec());
+  if (it != entries_.end()) {
+    size_ -= it->second.size;
+    entries_.Erase(it);
+  }
+  size_ += entry.size;
+  entries_.Put(request.url.spec(), std::move(entry));
+  Evict();
+  return true;
+}
+
+bool ProtocolResponseCache::Revalidate(const network::ResourceRequest& request,
+                                       const net::HttpResponseHeaders& headers,
+                                       Response* response) {
+  if (headers.response_code() != net::HTTP_NOT_MODIFIED)
+    return false;
+
+  auto it = Find(request);
+  if (it == entries_.end())
+    return false;
+
+  // The 304 must be for the validators of the cached response.
+  Entry& entry = it->second;
+  std::string request_validator, validator;
+  bool matches = false;
+  if (request.headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch,
+                                &request_validator)) {
+    matches = entry.headers->EnumerateHeader(nullptr, "etag", &validator) &&
+              validator == request_validator;
+  } else if (request.headers.GetHeader(
+                 net::HttpRequestHeaders::kIfModifiedSince,
+                 &request_validator)) {
+    matches =
+        entry.headers->EnumerateHeader(nullptr, "last-modified", &validator) &&
+        validator == request_validator;
+  }
+  if (!matches)
+    return false;
+
+  stats_.revalidations++;
+  size_ -= entry.size;
+  entry.size -= entry.headers->raw_headers().size();
+  entry.headers->Update(headers);
+  entry.size += entry.headers->raw_headers().size();
+  size_ += entry.size;
+  entry.request_time = entry.response_time = base::Time::Now();
+  *response = CreateResponse(entry);
+  Evict();
+  return true;
+}
+
+void ProtocolResponseCache::Clear() {
+  entries_.Clear();
+  size_ = 0;
+}
+
+ProtocolResponseCache::Stats ProtocolResponseCache::GetStats() const {
+  Stats stats = stats_;
+  stats.entries = entries_.size();
+  stats.size = size_;
+  return stats;
+}
+
+ProtocolResponseCache::EntryCache::iterator ProtocolResponseCache::Find(
+    const network::ResourceRequest& request) {
+  auto it = entries_.Get(request.url.spec());
+  if (it == entries_.end())
+    return it;
+  std::string vary_key;
+  if (!GetVaryKey(*it->second.headers, request.headers, &vary_key) ||
+      vary_key != it->second.vary_key)
+    return entries_.end();
+  return it;
+}
+
+ProtocolResponseCache::Response ProtocolResponseCache::CreateResponse(
+    const Entry& entry) const {
+  Response response;
+  response.head = network::mojom::URLResponseHead::New();
+  response.head->headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+      entry.headers->raw_headers());
+  response.head->mime_type = entry.mime_type;
+  response.head->charset = entry.charset;
+  response.head->content_length = entry.body->size();
+  response.body = entry.body;
+  return response;
+}
+
+void ProtocolResponseCache::Evict() {
+  while (size_ > max_size_ && !entries_.empty()) {
+    auto it = entries_.rbegin();
+    size_ -= it->second.size;
+    entries_.Erase(it);
+    stats_.evictions++;
+  }
+}
+
+}  // namespace electron
@@ -0,0 +1,125 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+#define SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "services/network/public/mojom/url_response_head.mojom.h"
+
+namespace net {
+class HttpResponseHeaders;
+}  // namespace net
+
+namespace network {
+struct ResourceRequest;
+}  // namespace network
+
+namespace electron {
+
+// Memory cache of the responses of a custom protocol, so requests for
+// unchanged resources are answered without calling the handler.
+//
+// Like the HTTP cache, responses are keyed by URL and the request headers
+// named by their Vary header, and are served while fresh according to their
+// Cache-Control or Expires headers. Stale responses with an ETag or a
+// Last-Modified header are revalidated by calling the handler with a
+// conditional request, which can respond with a 304 to reuse the cached body.
+//
+// The cache is only used on the UI thread.
+class ProtocolResponseCache : public base::RefCounted<ProtocolResponseCache> {
+ public:
+  struct Response {
+    Response();
+    ~Response();
+    Response(Response&&);
+    Response& operator=(Response&&);
+
+    network::mojom::URLResponseHeadPtr head;
+    scoped_refptr<base::RefCountedString> body;
+  };
+
+  struct Stats {
+    // Requests served from the cache without calling the handler.
+    uint64_t hits = 0;
+    // Requests for which the handler was called.
+    uint64_t misses = 0;
+    // Misses to which the handler responded with a 304.
+    uint64_t revalidations = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+    size_t size = 0;
+  };
+
+  explicit ProtocolResponseCache(size_t max_size);
+
+  // disable copy
+  ProtocolResponseCache(const ProtocolResponseCache&) = delete;
+  ProtocolResponseCache& operator=(const ProtocolResponseCache&) = delete;
+
+  // Returns true and fills |response| when a fresh response to |request| is
+  // cached. Otherwise adds the validators of a stale response to |request|.
+  bool Lookup(network::ResourceRequest* request, Response* response);
+
+  // Caches the response to |request| if it can be. Returns whether it was
+  // cached.
+  bool Store(const network::ResourceRequest& request,
+             const network::mojom::URLResponseHead& head,
+             base::StringPiece body);
+
+  // Returns true and fills |response| with the cached response when |headers|
+  // is a 304 confirming the validators sent with |request|.
+  bool Revalidate(const network::ResourceRequest& request,
+                  const net::HttpResponseHeaders& headers,
+                  Response* response);
+
+  void Clear();
+
+  size_t max_size() const { return max_size_; }
+  Stats GetStats() const;
+
+ private:
+  friend class base::RefCounted<ProtocolResponseCache>;
+
+  struct Entry {
+    Entry();
+    ~Entry();
+    Entry(Entry&&);
+    Entry& operator=(Entry&&);
+
+    scoped_refptr<net::HttpResponseHeaders> headers;
+    std::string mime_type;
+    std::string charset;
+    scoped_refptr<base::RefCountedString> body;
+    // The values of the request headers named by the Vary header.
+    std::string vary_key;
+    base::Time request_time;
+    base::Time response_time;
+    size_t size = 0;
+  };
+
+  using EntryCache = base::HashingMRUCache<std::string, Entry>;
+
+  ~ProtocolResponseCache();
+
+  // Returns the entry of |request|, taking Vary into account.
+  EntryCache::iterator Find(const network::ResourceRequest& request);
+  Response CreateResponse(const Entry& entry) const;
+  void Evict();
+
+  EntryCache entries_;
+  size_t max_size_;
+  size_t size_ = 0;
+  Stats stats_;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
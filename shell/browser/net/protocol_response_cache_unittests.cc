@@ -0,0 +1,170 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/protocol_response_cache.h"
+
+#include <string>
+
+#include "net/base/load_flags.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_util.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+namespace {
+
+network::ResourceRequest CreateRequest(const std::string& url) {
+  network::ResourceRequest request;
+  request.url = GURL(url);
+  request.method = "GET";
+  return request;
+}
+
+// |headers| are separated by newlines.
+network::mojom::URLResponseHeadPtr CreateHead(const std::string& headers) {
+  auto head = network::mojom::URLResponseHead::New();
+  head->headers = base::MakeRefCounted<net::HttpResponseHeaders>(
+      net::HttpUtil::AssembleRawHeaders(headers));
+  head->mime_type = "text/plain";
+  return head;
+}
+
+std::string GetBody(const ProtocolResponseCache::Response& response) {
+  return response.body->data();
+}
+
+}  // namespace
+
+TEST(ProtocolResponseCacheTest, ServesFreshResponses) {
+  auto cache = base::MakeRefCounted<ProtocolResponseCache>(1024);
+  auto request = CreateRequest("app://host/a.js");
+  ProtocolResponseCache::Response response;
+  EXPECT_FALSE(cache->Lookup(&request, &response));
+
+  EXPECT_TRUE(cache->Store(
+      request, *CreateHead("HTTP/1.1 200 OK\nCache-Control: max-age=3600"),
+      "body"));
+  EXPECT_TRUE(cache->Lookup(&request, &response));
+  EXPECT_EQ("body", GetBody(response));
+  EXPECT_EQ("text/plain", response.head->mime_type);
+  EXPECT_EQ(200, response.head->headers->response_code());
+
+  // Other URLs and methods are not served.
+  auto other = CreateRequest("app://host/b.js");
+  EXPECT_FALSE(cache->Lookup(&other, &response));
+  request.method = "POST";
+  EXPECT_FALSE(cache->Lookup(&request, &response));
+
+  ProtocolResponseCache::Stats stats = cache->GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(1u, stats.entries);
+}
+
+TEST(ProtocolResponseCacheTest, SkipsUncacheableResponses) {
+  auto cache = base::MakeRefCounted<ProtocolResponseCache>(1024);
+  auto request = CreateRequest("app://host/a.js");
+  EXPECT_FALSE(cache->Store(
+      request,
+      *CreateHead("HTTP/1.1 200 OK\nCache-Control: no-store, max-age=60"),
+      "body"));
+  EXPECT_FALSE(cache->Store(request, *CreateHead("HTTP/1.1 200 OK"), "body"));
+  EXPECT_FALSE(cache->Store(
+      request, *CreateHead("HTTP/1.1 404 Not Found\nCache-Control: max-age=60"),
+      "body"));
+  EXPECT_FALSE(cache->Store(
+      request,
+      *CreateHead("HTTP/1.1 200 OK\nCache-Control: max-age=60\nVary: *"),
+      "body"));
+  EXPECT_FALSE(cache->Store(
+      request, *CreateHead("HTTP/1.1 200 OK\nCache-Control: max-age=60"),
+      std::string(2048, 'a')));
+  EXPECT_EQ(0u, cache->GetStats().entries);
+}
+
+TEST(ProtocolResponseCacheTest, KeysByVary) {
+  auto cache = base::MakeRefCounted<ProtocolResponseCache>(1024);
+  auto request = CreateRequest("app://host/a.js");
+  request.headers.SetHeader("Accept-Language", "en");
+  EXPECT_TRUE(cache->Store(
+      request,
+      *CreateHead("HTTP/1.1 200 OK\nCache-Control: max-age=60\n"
+                  "Vary: Accept-Language"),
+      "hello"));
+
+  ProtocolResponseCache::Response response;
+  auto same = CreateRequest("app://host/a.js");
+  same.headers.SetHeader("accept-language", "en");
+  EXPECT_TRUE(cache->Lookup(&same, &response));
+  auto other = CreateRequest("app://host/a.js");
+  other.headers.SetHeader("Accept-Language", "fr");
+  EXPECT_FALSE(cache->Lookup(&other, &response));
+}
+
+TEST(ProtocolResponseCacheTest, RevalidatesStaleResponses) {
+  auto cache = base::MakeRefCounted<ProtocolResponseCache>(1024);
+  auto request = CreateRequest("app://host/a.js");
+  EXPECT_TRUE(cache->Store(
+      request, *CreateHead("HTTP/1.1 200 OK\nCache-Control: no-cache\n"
+                           "ETag: \"v1\""),
+      "body"));
+
+  // The stale response is not served, the request gets its validator.
+  ProtocolResponseCache::Response response;
+  auto conditional = CreateRequest("app://host/a.js");
+  EXPECT_FALSE(cache->Lookup(&conditional, &response));
+  std::string validator;
+  EXPECT_TRUE(conditional.headers.GetHeader("If-None-Match", &validator));
+  EXPECT_EQ("\"v1\"", validator);
+
+  // A 304 for other validators does not use the cached body.
+  auto other = CreateRequest("app://host/a.js");
+  other.headers.SetHeader("If-None-Match", "\"v0\"");
+  auto not_modified = CreateHead("HTTP/1.1 304 Not Modified\nETag: \"v1\"");
+  EXPECT_FALSE(cache->Revalidate(other, *not_modified->headers, &response));
+
+  EXPECT_TRUE(
+      cache->Revalidate(conditional, *not_modified->headers, &response));
+  EXPECT_EQ("body", GetBody(response));
+  EXPECT_EQ(200, response.head->headers->response_code());
+  EXPECT_EQ(1u, cache->GetStats().revalidations);
+
+  // The handler decides again when the page bypasses the cache.
+  auto reload = CreateRequest("app://host/a.js");
+  reload.load_flags = net::LOAD_BYPASS_CACHE;
+  EXPECT_FALSE(cache->Lookup(&reload, &response));
+  EXPECT_FALSE(reload.headers.HasHeader("If-None-Match"));
+}
+
+TEST(ProtocolResponseCacheTest, EvictsLeastRecentlyUsed) {
+  const std::string body(300, 'a');
+  auto cache = base::MakeRefCounted<ProtocolResponseCache>(1024);
+  auto head = CreateHead("HTTP/1.1 200 OK\nCache-Control: max-age=60");
+  auto a = CreateRequest("app://host/a");
+  auto b = CreateRequest("app://host/b");
+  auto c = CreateRequest("app://host/c");
+  EXPECT_TRUE(cache->Store(a, *head, body));
+  EXPECT_TRUE(cache->Store(b, *head, body));
+
+  ProtocolResponseCache::Response response;
+  EXPECT_TRUE(cache->Lookup(&a, &response));
+  EXPECT_TRUE(cache->Store(c, *head, body));
+
+  ProtocolResponseCache::Stats stats = cache->GetStats();
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(2u, stats.entries);
+  EXPECT_LE(stats.size, 1024u);
+  EXPECT_TRUE(cache->Lookup(&a, &response));
+  EXPECT_FALSE(cache->Lookup(&b, &response));
+  EXPECT_TRUE(cache->Lookup(&c, &response));
+
+  cache->Clear();
+  EXPECT_EQ(0u, cache->GetStats().size);
+  EXPECT_FALSE(cache->Lookup(&a, &response));
+}
+
+}  // namespace electron
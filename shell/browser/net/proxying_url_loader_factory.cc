@@ -823,7 +823,8 @@ void ProxyingURLLoaderFactory::CreateLoaderAndStart(
         request, base::BindOnce(&ElectronURLLoaderFactory::StartLoading,
                                 std::move(loader), request_id, options, request,
                                 std::move(client), traffic_annotation,
-                                std::move(loader_remote), it->second.first));
+                                std::move(loader_remote), it->second.first,
+                                scoped_refptr<ProtocolResponseCache>()));
     return;
   }
 
@@ -0,0 +1,99 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/url_pattern_matcher.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "base/strings/string_util.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+namespace {
+
+// "example.com." and "example.com" are the same host.
+base::StringPiece TrimHost(base::StringPiece host) {
+  return base::TrimString(host, ".", base::TRIM_TRAILING);
+}
+
+}  // namespace
+
+URLPatternMatcher::URLPatternMatcher() = default;
+
+URLPatternMatcher::URLPatternMatcher(const std::set<URLPattern>& patterns)
+    : URLPatternMatcher(
+          std::vector<URLPattern>(patterns.begin(), patterns.end())) {}
+
+URLPatternMatcher::URLPatternMatcher(std::vector<URLPattern> patterns)
+    : patterns_(std::move(patterns)) {
+  std::map<std::string, std::vector<size_t>> by_host;
+  for (size_t i = 0; i < patterns_.size(); ++i) {
+    const URLPattern& pattern = patterns_[i];
+    base::StringPiece host = TrimHost(pattern.host());
+    if (pattern.match_all_urls() || host.empty())
+      any_host_.push_back(i);
+    else
+      by_host[std::string(host)].push_back(i);
+  }
+  by_host_ = base::flat_map<std::string, std::vector<size_t>>(by_host.begin(),
+                                                              by_host.end());
+}
+
+URLPatternMatcher::~URLPatternMatcher() = default;
+
+URLPatternMatcher::URLPatternMatcher(URLPatternMatcher&&) = default;
+URLPatternMatcher& URLPatternMatcher::operator=(URLPatternMatcher&&) =
+    default;
+
+bool URLPatternMatcher::MatchesURL(const GURL& url) const {
+  return VisitCandidates(url, [&](const std::vector<size_t>& candidates) {
+    for (size_t index : candidates) {
+      if (patterns_[index].MatchesURL(url))
+        return true;
+    }
+    return false;
+  });
+}
+
+std::vector<size_t> URLPatternMatcher::GetMatches(const GURL& url) const {
+  std::vector<size_t> matches;
+  VisitCandidates(url, [&](const std::vector<size_t>& candidates) {
+    for (size_t index : candidates) {
+      if (patterns_[index].MatchesURL(url))
+        matches.push_back(index);
+    }
+    return false;
+  });
+  std::sort(matches.begin(), matches.end());
+  return matches;
+}
+
+template <typename Visitor>
+bool URLPatternMatcher::VisitCandidates(const GURL& url, Visitor visit) const {
+  if (visit(any_host_))
+    return true;
+  if (by_host_.empty())
+    return false;
+
+  // URLPattern matches filesystem: URLs by their inner URL.
+  const GURL* host_url = url.inner_url() ? url.inner_url() : &url;
+  base::StringPiece host = TrimHost(host_url->host_piece());
+  // Looks up the host and each domain it is a subdomain of, which covers the
+  // patterns matching subdomains.
+  while (!host.empty()) {
+    auto it = by_host_.find(std::string(host));
+    if (it != by_host_.end() && visit(it->second))
+      return true;
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+  return false;
+}
+
+}  // namespace electron
@@ -0,0 +1,68 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
+#define SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace electron {
+
+// Matches URLs against a set of URLPatterns without testing each of them.
+//
+// The patterns are indexed by host, so a URL is only tested against the
+// patterns of its host and of the domains it is a subdomain of, plus the
+// patterns that match any host. The candidates are then tested with
+// URLPattern::MatchesURL, so the result is the same as testing every pattern.
+// The index is built once, the matcher is meant to be rebuilt when the
+// patterns change.
+class URLPatternMatcher {
+ public:
+  URLPatternMatcher();
+  explicit URLPatternMatcher(const std::set<URLPattern>& patterns);
+  explicit URLPatternMatcher(std::vector<URLPattern> patterns);
+  ~URLPatternMatcher();
+
+  URLPatternMatcher(URLPatternMatcher&&);
+  URLPatternMatcher& operator=(URLPatternMatcher&&);
+
+  // disable copy
+  URLPatternMatcher(const URLPatternMatcher&) = delete;
+  URLPatternMatcher& operator=(const URLPatternMatcher&) = delete;
+
+  // Whether |url| matches any of the patterns.
+  bool MatchesURL(const GURL& url) const;
+
+  // Returns the indices of the patterns matching |url|, in ascending order.
+  // The indices are those of the vector the matcher was built from.
+  std::vector<size_t> GetMatches(const GURL& url) const;
+
+  bool is_empty() const { return patterns_.empty(); }
+  size_t size() const { return patterns_.size(); }
+
+ private:
+  // Runs |visit| on each list of candidate patterns for |url|, until it
+  // returns true.
+  template <typename Visitor>
+  bool VisitCandidates(const GURL& url, Visitor visit) const;
+
+  std::vector<URLPattern> patterns_;
+
+  // The patterns with a host, keyed by the host without trailing dots.
+  base::flat_map<std::string, std::vector<size_t>> by_host_;
+
+  // The patterns matching any host, and those without a host like file URLs.
+  std::vector<size_t> any_host_;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_URL_PATTERN_MATCHER_H_
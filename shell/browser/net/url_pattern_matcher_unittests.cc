@@ -0,0 +1,163 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/url_pattern_matcher.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "url/gurl.h"
+
+namespace electron {
+
+namespace {
+
+std::set<URLPattern> ParsePatterns(const std::vector<std::string>& specs) {
+  std::set<URLPattern> patterns;
+  for (const auto& spec : specs) {
+    URLPattern pattern(URLPattern::SCHEME_ALL);
+    EXPECT_EQ(URLPattern::ParseResult::kSuccess, pattern.Parse(spec)) << spec;
+    patterns.insert(pattern);
+  }
+  return patterns;
+}
+
+bool MatchesLinearly(const std::set<URLPattern>& patterns, const GURL& url) {
+  for (const auto& pattern : patterns) {
+    if (pattern.MatchesURL(url))
+      return true;
+  }
+  return false;
+}
+
+// A filter list like the ones of content blockers, with a pattern per host.
+std::set<URLPattern> CreateFilterList(int count) {
+  std::vector<std::string> specs;
+  for (int i = 0; i < count; ++i) {
+    switch (i % 3) {
+      case 0:
+        specs.push_back(base::StringPrintf("*://*.tracker%d.com/*", i));
+        break;
+      case 1:
+        specs.push_back(base::StringPrintf("https://ads%d.example.net/*", i));
+        break;
+      default:
+        specs.push_back(base::StringPrintf("*://cdn%d.org/ads/*", i));
+    }
+  }
+  return ParsePatterns(specs);
+}
+
+std::vector<GURL> CreateRequests(int count) {
+  std::vector<GURL> urls;
+  for (int i = 0; i < count; ++i) {
+    urls.emplace_back(base::StringPrintf("https://www.site%d.com/page", i));
+    urls.emplace_back(base::StringPrintf("https://a.b.tracker%d.com/p.js", i));
+    urls.emplace_back(base::StringPrintf("http://ads%d.example.net/x", i));
+    urls.emplace_back(base::StringPrintf("https://cdn%d.org/img/a.png", i));
+  }
+  return urls;
+}
+
+}  // namespace
+
+TEST(URLPatternMatcherTest, Empty) {
+  URLPatternMatcher matcher;
+  EXPECT_TRUE(matcher.is_empty());
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://example.com/")));
+}
+
+TEST(URLPatternMatcherTest, MatchesHosts) {
+  URLPatternMatcher matcher(ParsePatterns({
+      "https://example.com/*",
+      "*://*.example.org/api/*",
+      "http://127.0.0.1/*",
+  }));
+  EXPECT_EQ(3u, matcher.size());
+
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://example.com/a")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://example.com./a")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("http://example.com/a")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://www.example.com/a")));
+
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://example.org/api/v1")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://a.b.example.org/api/v1")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://a.example.org/static/x")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://notexample.org/api/v1")));
+
+  EXPECT_TRUE(matcher.MatchesURL(GURL("http://127.0.0.1:8080/")));
+}
+
+TEST(URLPatternMatcherTest, MatchesAnyHost) {
+  URLPatternMatcher all_urls(ParsePatterns({"<all_urls>"}));
+  EXPECT_TRUE(all_urls.MatchesURL(GURL("https://example.com/")));
+  EXPECT_TRUE(all_urls.MatchesURL(GURL("file:///tmp/a.txt")));
+
+  URLPatternMatcher matcher(ParsePatterns({
+      "*://*/*.js",
+      "file:///tmp/*",
+  }));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("https://example.com/app.js")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("https://example.com/app.css")));
+  EXPECT_TRUE(matcher.MatchesURL(GURL("file:///tmp/a.txt")));
+  EXPECT_FALSE(matcher.MatchesURL(GURL("file:///etc/hosts")));
+}
+
+TEST(URLPatternMatcherTest, MatchesLikeEachPattern) {
+  std::set<URLPattern> patterns = CreateFilterList(300);
+  for (const auto& pattern : ParsePatterns({"wss://*/*", "*://*.com/login"}))
+    patterns.insert(pattern);
+  URLPatternMatcher matcher(patterns);
+
+  std::vector<GURL> urls = CreateRequests(400);
+  urls.emplace_back("wss://socket.example.com/");
+  urls.emplace_back("https://shop.com/login");
+  urls.emplace_back("filesystem:https://tracker3.com/temporary/a");
+  urls.emplace_back("about:blank");
+  for (const auto& url : urls)
+    EXPECT_EQ(MatchesLinearly(patterns, url), matcher.MatchesURL(url)) << url;
+}
+
+TEST(URLPatternMatcherTest, MatchPerformance) {
+  constexpr int kRequests = 500;
+  const std::vector<GURL> urls = CreateRequests(kRequests);
+
+  for (int count : {100, 1000, 20000}) {
+    std::set<URLPattern> patterns = CreateFilterList(count);
+
+    base::ElapsedTimer build_timer;
+    URLPatternMatcher matcher(patterns);
+    base::TimeDelta build_time = build_timer.Elapsed();
+
+    size_t linear_matches = 0;
+    base::ElapsedTimer linear_timer;
+    for (const auto& url : urls)
+      linear_matches += MatchesLinearly(patterns, url);
+    base::TimeDelta linear_time = linear_timer.Elapsed();
+
+    size_t indexed_matches = 0;
+    base::ElapsedTimer indexed_timer;
+    for (const auto& url : urls)
+      indexed_matches += matcher.MatchesURL(url);
+    base::TimeDelta indexed_time = indexed_timer.Elapsed();
+
+    EXPECT_EQ(linear_matches, indexed_matches);
+
+    perf_test::PerfResultReporter reporter(
+        "URLPatternMatcher", base::StringPrintf("%d_patterns", count));
+    reporter.RegisterImportantMetric("_linear", "requests/s");
+    reporter.RegisterImportantMetric("_indexed", "requests/s");
+    reporter.RegisterImportantMetric("_build", "ms");
+    reporter.AddResult("_linear", urls.size() / linear_time.InSecondsF());
+    reporter.AddResult("_indexed", urls.size() / indexed_time.InSecondsF());
+    reporter.AddResult("_build", build_time.InMillisecondsF());
+  }
+}
+
+}  // namespace electron
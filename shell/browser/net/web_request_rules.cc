@@ -0,0 +1,150 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/web_request_rules.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/containers/contains.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+
+namespace electron {
+
+WebRequestRules::Rule::Rule() = default;
+WebRequestRules::Rule::~Rule() = default;
+WebRequestRules::Rule::Rule(Rule&&) = default;
+WebRequestRules::Rule& WebRequestRules::Rule::operator=(Rule&&) = default;
+
+WebRequestRules::WebRequestRules() = default;
+
+WebRequestRules::~WebRequestRules() = default;
+
+void WebRequestRules::SetRules(std::vector<Rule> rules) {
+  // At the same priority, allow rules apply first, then block, redirect and
+  // modifyHeaders rules, like in declarativeNetRequest.
+  std::stable_sort(rules.begin(), rules.end(),
+                   [](const Rule& a, const Rule& b) {
+                     if (a.priority != b.priority)
+                       return a.priority > b.priority;
+                     return a.action < b.action;
+                   });
+  rules_ = std::move(rules);
+
+  // One index over the patterns of all the rules, rather than one per rule.
+  std::vector<URLPattern> patterns;
+  pattern_rules_.clear();
+  rules_without_urls_.clear();
+  for (size_t i = 0; i < rules_.size(); ++i) {
+    if (rules_[i].urls.empty())
+      rules_without_urls_.push_back(i);
+    for (const auto& pattern : rules_[i].urls) {
+      patterns.push_back(pattern);
+      pattern_rules_.push_back(i);
+    }
+  }
+  url_matcher_ = URLPatternMatcher(std::move(patterns));
+}
+
+WebRequestRules::Result WebRequestRules::OnBeforeRequest(
+    const extensions::WebRequestInfo& info,
+    GURL* new_url) const {
+  for (const Rule* rule : GetMatchingRules(info)) {
+    switch (rule->action) {
+      case Rule::Action::kAllow:
+        // Nothing is decided, the listeners are still called.
+        return Result::kNone;
+      case Rule::Action::kBlock:
+        return Result::kBlocked;
+      case Rule::Action::kRedirect:
+        // The redirected request may match the rule again.
+        if (rule->redirect_url == info.url)
+          continue;
+        *new_url = rule->redirect_url;
+        return Result::kDecided;
+      case Rule::Action::kModifyHeaders:
+        break;
+    }
+  }
+  return Result::kNone;
+}
+
+WebRequestRules::Result WebRequestRules::OnBeforeSendHeaders(
+    const extensions::WebRequestInfo& info,
+    net::HttpRequestHeaders* headers) const {
+  Result result = Result::kNone;
+  for (const Rule* rule : GetMatchingRules(info)) {
+    if (rule->action == Rule::Action::kAllow)
+      break;
+    if (rule->action != Rule::Action::kModifyHeaders ||
+        rule->request_headers.empty())
+      continue;
+    for (const auto& operation : rule->request_headers) {
+      if (operation.type == HeaderOperation::Type::kSet)
+        headers->SetHeader(operation.header, operation.value);
+      else
+        headers->RemoveHeader(operation.header);
+    }
+    result = Result::kDecided;
+  }
+  return result;
+}
+
+WebRequestRules::Result WebRequestRules::OnHeadersReceived(
+    const extensions::WebRequestInfo& info,
+    const net::HttpResponseHeaders* original_response_headers,
+    scoped_refptr<net::HttpResponseHeaders>* override_response_headers) const {
+  if (!original_response_headers)
+    return Result::kNone;
+
+  Result result = Result::kNone;
+  for (const Rule* rule : GetMatchingRules(info)) {
+    if (rule->action == Rule::Action::kAllow)
+      break;
+    if (rule->action != Rule::Action::kModifyHeaders ||
+        rule->response_headers.empty())
+      continue;
+    if (!*override_response_headers) {
+      *override_response_headers =
+          base::MakeRefCounted<net::HttpResponseHeaders>(
+              original_response_headers->raw_headers());
+    }
+    net::HttpResponseHeaders* headers = override_response_headers->get();
+    for (const auto& operation : rule->response_headers) {
+      if (operation.type == HeaderOperation::Type::kSet)
+        headers->SetHeader(operation.header, operation.value);
+      else
+        headers->RemoveHeader(operation.header);
+    }
+    result = Result::kDecided;
+  }
+  return result;
+}
+
+std::vector<const WebRequestRules::Rule*> WebRequestRules::GetMatchingRules(
+    const extensions::WebRequestInfo& info) const {
+  std::vector<size_t> indices = rules_without_urls_;
+  if (!url_matcher_.is_empty()) {
+    for (size_t pattern : url_matcher_.GetMatches(info.url))
+      indices.push_back(pattern_rules_[pattern]);
+  }
+  // The indices follow the order of the rules.
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+  std::vector<const Rule*> rules;
+  for (size_t index : indices) {
+    const Rule& rule = rules_[index];
+    if (!rule.resource_types.empty() &&
+        !base::Contains(rule.resource_types, info.web_request_type))
+      continue;
+    if (!rule.methods.empty() && !base::Contains(rule.methods, info.method))
+      continue;
+    rules.push_back(&rule);
+  }
+  return rules;
+}
+
+}  // namespace electron
@@ -0,0 +1,115 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_refptr.h"
+#include "extensions/browser/api/web_request/web_request_info.h"
+#include "extensions/browser/api/web_request/web_request_resource_type.h"
+#include "extensions/common/url_pattern.h"
+#include "shell/browser/net/url_pattern_matcher.h"
+#include "url/gurl.h"
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+}  // namespace net
+
+namespace electron {
+
+// Declarative webRequest rules, along the lines of the declarativeNetRequest
+// API of extensions. They block, redirect or modify the headers of requests
+// without calling into JavaScript.
+//
+// At each stage of a request the matching rules are applied in order of
+// priority. An allow rule stops the rules of lower priority from applying,
+// without deciding anything itself. When a rule applies to a stage, the rules
+// decide it and the listeners of the stage are not called.
+class WebRequestRules {
+ public:
+  struct HeaderOperation {
+    enum class Type { kSet, kRemove };
+
+    Type type = Type::kSet;
+    std::string header;
+    std::string value;
+  };
+
+  struct Rule {
+    enum class Action { kAllow, kBlock, kRedirect, kModifyHeaders };
+
+    Rule();
+    ~Rule();
+    Rule(Rule&&);
+    Rule& operator=(Rule&&);
+
+    // Higher priorities apply first.
+    int priority = 1;
+
+    // The conditions, which match every request when empty.
+    std::set<URLPattern> urls;
+    std::set<extensions::WebRequestResourceType> resource_types;
+    // Upper case.
+    std::set<std::string> methods;
+
+    Action action = Action::kBlock;
+    GURL redirect_url;
+    std::vector<HeaderOperation> request_headers;
+    std::vector<HeaderOperation> response_headers;
+  };
+
+  enum class Result {
+    // No rule applies, the listeners decide.
+    kNone,
+    // The rules decided, the request goes on.
+    kDecided,
+    kBlocked,
+  };
+
+  WebRequestRules();
+  ~WebRequestRules();
+
+  // disable copy
+  WebRequestRules(const WebRequestRules&) = delete;
+  WebRequestRules& operator=(const WebRequestRules&) = delete;
+
+  // Replaces the rules, which are indexed once here.
+  void SetRules(std::vector<Rule> rules);
+
+  bool empty() const { return rules_.empty(); }
+
+  Result OnBeforeRequest(const extensions::WebRequestInfo& info,
+                         GURL* new_url) const;
+  Result OnBeforeSendHeaders(const extensions::WebRequestInfo& info,
+                             net::HttpRequestHeaders* headers) const;
+  Result OnHeadersReceived(
+      const extensions::WebRequestInfo& info,
+      const net::HttpResponseHeaders* original_response_headers,
+      scoped_refptr<net::HttpResponseHeaders>* override_response_headers)
+      const;
+
+ private:
+  // Returns the rules matching |info|, in the order they apply.
+  std::vector<const Rule*> GetMatchingRules(
+      const extensions::WebRequestInfo& info) const;
+
+  // Sorted by priority.
+  std::vector<Rule> rules_;
+
+  // The URL patterns of the rules, and the rule of each of them.
+  URLPatternMatcher url_matcher_;
+  std::vector<size_t> pattern_rules_;
+
+  // The rules without URL patterns.
+  std::vector<size_t> rules_without_urls_;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_NET_WEB_REQUEST_RULES_H_
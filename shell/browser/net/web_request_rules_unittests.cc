@@ -0,0 +1,211 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/net/web_request_rules.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace electron {
+
+namespace {
+
+using Action = WebRequestRules::Rule::Action;
+using Result = WebRequestRules::Result;
+
+WebRequestRules::Rule CreateRule(Action action,
+                                 int priority,
+                                 const std::vector<std::string>& urls = {}) {
+  WebRequestRules::Rule rule;
+  rule.action = action;
+  rule.priority = priority;
+  for (const auto& spec : urls) {
+    URLPattern pattern(URLPattern::SCHEME_ALL);
+    EXPECT_EQ(URLPattern::ParseResult::kSuccess, pattern.Parse(spec)) << spec;
+    rule.urls.insert(pattern);
+  }
+  return rule;
+}
+
+WebRequestRules::Rule CreateHeaderRule(int priority,
+                                       const std::string& header,
+                                       const std::string& value) {
+  WebRequestRules::Rule rule = CreateRule(Action::kModifyHeaders, priority);
+  WebRequestRules::HeaderOperation operation;
+  operation.header = header;
+  operation.value = value;
+  rule.request_headers.push_back(operation);
+  rule.response_headers.push_back(operation);
+  return rule;
+}
+
+extensions::WebRequestInfo CreateInfo(
+    const std::string& url,
+    const std::string& method = "GET",
+    extensions::WebRequestResourceType type =
+        extensions::WebRequestResourceType::OTHER) {
+  extensions::WebRequestInfoInitParams params;
+  params.url = GURL(url);
+  params.method = method;
+  params.web_request_type = type;
+  return extensions::WebRequestInfo(std::move(params));
+}
+
+}  // namespace
+
+TEST(WebRequestRulesTest, AppliesHigherPrioritiesFirst) {
+  WebRequestRules rules;
+  std::vector<WebRequestRules::Rule> rule_list;
+  rule_list.push_back(CreateRule(Action::kBlock, 1));
+  WebRequestRules::Rule redirect = CreateRule(Action::kRedirect, 2);
+  redirect.redirect_url = GURL("https://example.com/redirected");
+  rule_list.push_back(std::move(redirect));
+  rules.SetRules(std::move(rule_list));
+
+  GURL new_url;
+  EXPECT_EQ(Result::kDecided,
+            rules.OnBeforeRequest(CreateInfo("https://example.com/"),
+                                  &new_url));
+  EXPECT_EQ(GURL("https://example.com/redirected"), new_url);
+
+  // The redirected request does not match the redirect again.
+  EXPECT_EQ(Result::kBlocked,
+            rules.OnBeforeRequest(
+                CreateInfo("https://example.com/redirected"), &new_url));
+}
+
+TEST(WebRequestRulesTest, AppliesAllowRulesFirstAtEqualPriority) {
+  WebRequestRules rules;
+  std::vector<WebRequestRules::Rule> rule_list;
+  rule_list.push_back(CreateRule(Action::kBlock, 1));
+  rule_list.push_back(
+      CreateRule(Action::kAllow, 1, {"https://example.com/allowed"}));
+  rules.SetRules(std::move(rule_list));
+
+  GURL new_url;
+  EXPECT_EQ(Result::kNone,
+            rules.OnBeforeRequest(CreateInfo("https://example.com/allowed"),
+                                  &new_url));
+  EXPECT_EQ(Result::kBlocked,
+            rules.OnBeforeRequest(CreateInfo("https://example.com/"),
+                                  &new_url));
+}
+
+TEST(WebRequestRulesTest, LeavesAllowedRequestsToListeners) {
+  WebRequestRules rules;
+  std::vector<WebRequestRules::Rule> rule_list;
+  rule_list.push_back(CreateHeaderRule(3, "Applied", "yes"));
+  rule_list.push_back(CreateRule(Action::kAllow, 2));
+  rule_list.push_back(CreateHeaderRule(1, "Skipped", "yes"));
+  rules.SetRules(std::move(rule_list));
+
+  extensions::WebRequestInfo info = CreateInfo("https://example.com/");
+  GURL new_url;
+  EXPECT_EQ(Result::kNone, rules.OnBeforeRequest(info, &new_url));
+  EXPECT_TRUE(new_url.is_empty());
+
+  // Rules of higher priority than the allow rule still apply.
+  net::HttpRequestHeaders headers;
+  EXPECT_EQ(Result::kDecided, rules.OnBeforeSendHeaders(info, &headers));
+  EXPECT_TRUE(headers.HasHeader("Applied"));
+  EXPECT_FALSE(headers.HasHeader("Skipped"));
+
+  // With nothing above it, the allow rule leaves the stage to the listeners.
+  rule_list.clear();
+  rule_list.push_back(CreateRule(Action::kAllow, 2));
+  rule_list.push_back(CreateHeaderRule(1, "Skipped", "yes"));
+  rules.SetRules(std::move(rule_list));
+  headers.Clear();
+  EXPECT_EQ(Result::kNone, rules.OnBeforeSendHeaders(info, &headers));
+  EXPECT_FALSE(headers.HasHeader("Skipped"));
+
+  auto response_headers =
+      net::HttpResponseHeaders::TryToCreate("HTTP/1.1 200 OK\r\n");
+  ASSERT_TRUE(response_headers);
+  scoped_refptr<net::HttpResponseHeaders> override_headers;
+  EXPECT_EQ(Result::kNone,
+            rules.OnHeadersReceived(info, response_headers.get(),
+                                    &override_headers));
+  EXPECT_FALSE(override_headers);
+}
+
+TEST(WebRequestRulesTest, ModifiesResponseHeaders) {
+  WebRequestRules rules;
+  std::vector<WebRequestRules::Rule> rule_list;
+  rule_list.push_back(CreateHeaderRule(1, "Custom", "Changed"));
+  rules.SetRules(std::move(rule_list));
+
+  auto response_headers =
+      net::HttpResponseHeaders::TryToCreate("HTTP/1.1 200 OK\r\nCustom: 1\r\n");
+  ASSERT_TRUE(response_headers);
+  scoped_refptr<net::HttpResponseHeaders> override_headers;
+  EXPECT_EQ(Result::kDecided,
+            rules.OnHeadersReceived(CreateInfo("https://example.com/"),
+                                    response_headers.get(),
+                                    &override_headers));
+  ASSERT_TRUE(override_headers);
+  std::string value;
+  EXPECT_TRUE(override_headers->GetNormalizedHeader("Custom", &value));
+  EXPECT_EQ("Changed", value);
+  // The original headers are left alone.
+  EXPECT_TRUE(response_headers->GetNormalizedHeader("Custom", &value));
+  EXPECT_EQ("1", value);
+}
+
+TEST(WebRequestRulesTest, MatchesConditions) {
+  WebRequestRules rules;
+  std::vector<WebRequestRules::Rule> rule_list;
+  WebRequestRules::Rule rule =
+      CreateRule(Action::kBlock, 1, {"*://*.tracker.com/*"});
+  rule.resource_types.insert(extensions::WebRequestResourceType::XHR);
+  rule.methods.insert("POST");
+  rule_list.push_back(std::move(rule));
+  rules.SetRules(std::move(rule_list));
+
+  GURL new_url;
+  EXPECT_EQ(Result::kBlocked,
+            rules.OnBeforeRequest(
+                CreateInfo("https://ads.tracker.com/collect", "POST",
+                           extensions::WebRequestResourceType::XHR),
+                &new_url));
+  // Each condition has to match.
+  EXPECT_EQ(Result::kNone,
+            rules.OnBeforeRequest(
+                CreateInfo("https://example.com/collect", "POST",
+                           extensions::WebRequestResourceType::XHR),
+                &new_url));
+  EXPECT_EQ(Result::kNone,
+            rules.OnBeforeRequest(
+                CreateInfo("https://ads.tracker.com/collect", "GET",
+                           extensions::WebRequestResourceType::XHR),
+                &new_url));
+  EXPECT_EQ(Result::kNone,
+            rules.OnBeforeRequest(
+                CreateInfo("https://ads.tracker.com/collect", "POST",
+                           extensions::WebRequestResourceType::IMAGE),
+                &new_url));
+}
+
+TEST(WebRequestRulesTest, ReplacesRules) {
+  WebRequestRules rules;
+  EXPECT_TRUE(rules.empty());
+  std::vector<WebRequestRules::Rule> rule_list;
+  rule_list.push_back(CreateRule(Action::kBlock, 1));
+  rules.SetRules(std::move(rule_list));
+  EXPECT_FALSE(rules.empty());
+
+  rules.SetRules(std::vector<WebRequestRules::Rule>());
+  EXPECT_TRUE(rules.empty());
+  GURL new_url;
+  EXPECT_EQ(Result::kNone,
+            rules.OnBeforeRequest(CreateInfo("https://example.com/"),
+                                  &new_url));
+}
+
+}  // namespace electron
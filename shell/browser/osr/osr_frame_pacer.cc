@@ -0,0 +1,101 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/osr/osr_frame_pacer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace electron {
+
+namespace {
+
+// The same bounds as the frame rate of the view.
+constexpr int kMaxFrameRate = 240;
+
+const base::TimeDelta kMinFrameInterval =
+    base::TimeDelta::FromSeconds(1) / kMaxFrameRate;
+const base::TimeDelta kMaxFrameInterval = base::TimeDelta::FromSeconds(1);
+
+}  // namespace
+
+OffScreenFramePacer::OffScreenFramePacer() = default;
+
+OffScreenFramePacer::~OffScreenFramePacer() = default;
+
+void OffScreenFramePacer::SetOptions(const Options& options) {
+  options_ = options;
+  options_.idle_frame_rate =
+      std::max(1, std::min(options_.idle_frame_rate, kMaxFrameRate));
+  options_.idle_frame_count = std::max(1, options_.idle_frame_count);
+  if (!options_.adaptive)
+    Wake();
+}
+
+base::TimeDelta OffScreenFramePacer::GetFrameInterval(int frame_rate) const {
+  base::TimeDelta interval = GetCaptureInterval(frame_rate);
+  if (idle_) {
+    interval = std::max(
+        interval, base::TimeDelta::FromSeconds(1) / options_.idle_frame_rate);
+  }
+  return interval;
+}
+
+base::TimeDelta OffScreenFramePacer::GetCaptureInterval(int frame_rate) const {
+  // The average interval of the vsync is rounded to a whole frame rate, so
+  // that its jitter does not change the interval of every frame.
+  if (!vsync_interval_.is_zero()) {
+    frame_rate =
+        static_cast<int>(std::lround(1.0 / vsync_interval_.InSecondsF()));
+  }
+  return base::TimeDelta::FromSeconds(1) / frame_rate;
+}
+
+bool OffScreenFramePacer::OnFrameCaptured(bool damaged,
+                                          base::TimeDelta latency) {
+  if (damaged) {
+    frames_without_damage_ = 0;
+    idle_ = false;
+  } else if (options_.adaptive) {
+    if (++frames_without_damage_ >= options_.idle_frame_count)
+      idle_ = true;
+    ++stats_.frames_skipped;
+    return false;
+  }
+
+  if (!latency.is_zero()) {
+    base::TimeDelta& average = stats_.average_latency;
+    average = average.is_zero() ? latency : average + (latency - average) / 8;
+  }
+  return true;
+}
+
+void OffScreenFramePacer::OnVSync(base::TimeTicks now) {
+  if (!last_vsync_.is_null()) {
+    // Pauses of the consumer do not change the interval.
+    base::TimeDelta interval = now - last_vsync_;
+    if (interval >= kMinFrameInterval && interval <= kMaxFrameInterval) {
+      base::TimeDelta& average = vsync_interval_;
+      average =
+          average.is_zero() ? interval : average + (interval - average) / 8;
+    }
+  }
+  last_vsync_ = now;
+  timebase_ = now;
+}
+
+void OffScreenFramePacer::ResetVSync() {
+  last_vsync_ = base::TimeTicks();
+  vsync_interval_ = base::TimeDelta();
+  timebase_ = base::TimeTicks::Now();
+}
+
+bool OffScreenFramePacer::Wake() {
+  frames_without_damage_ = 0;
+  bool was_idle = idle_;
+  idle_ = false;
+  return was_idle;
+}
+
+}  // namespace electron
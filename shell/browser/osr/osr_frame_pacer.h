@@ -0,0 +1,83 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_OSR_OSR_FRAME_PACER_H_
+#define SHELL_BROWSER_OSR_OSR_FRAME_PACER_H_
+
+#include <cstdint>
+
+#include "base/time/time.h"
+
+namespace electron {
+
+// Decides how often an offscreen view produces frames. In adaptive mode the
+// frame rate drops while captured frames have no damage, and comes back on
+// the first damaged frame or input. Captures are not slowed down while idle,
+// so damage is noticed as soon as the compositor draws it. A consumer can
+// also give the vsync its frames follow.
+class OffScreenFramePacer {
+ public:
+  struct Options {
+    bool adaptive = false;
+    // The frame rate while idle.
+    int idle_frame_rate = 1;
+    // The number of frames without damage after which the view is idle.
+    int idle_frame_count = 30;
+  };
+
+  struct Stats {
+    uint64_t frames_produced = 0;
+    uint64_t frames_skipped = 0;
+    // Recent average of the time from capture to paint.
+    base::TimeDelta average_latency;
+  };
+
+  OffScreenFramePacer();
+  ~OffScreenFramePacer();
+
+  // disable copy
+  OffScreenFramePacer(const OffScreenFramePacer&) = delete;
+  OffScreenFramePacer& operator=(const OffScreenFramePacer&) = delete;
+
+  void SetOptions(const Options& options);
+  const Options& options() const { return options_; }
+
+  // Returns the time between frames, given the frame rate of the view.
+  base::TimeDelta GetFrameInterval(int frame_rate) const;
+  // Returns the shortest time between captures, which ignores the idle state.
+  base::TimeDelta GetCaptureInterval(int frame_rate) const;
+  // The time frames are aligned to.
+  base::TimeTicks timebase() const { return timebase_; }
+
+  // Returns whether a captured frame should be painted. Frames without damage
+  // are skipped in adaptive mode. |latency| is zero when unknown.
+  bool OnFrameCaptured(bool damaged, base::TimeDelta latency);
+  void OnFramePainted() { ++stats_.frames_produced; }
+
+  // Called on each vsync of the consumer, so that frames follow it.
+  void OnVSync(base::TimeTicks now);
+  // Stops following the vsync of the consumer.
+  void ResetVSync();
+
+  // Leaves the idle state, e.g. on input. Returns whether the view was idle.
+  bool Wake();
+
+  bool is_idle() const { return idle_; }
+  const Stats& stats() const { return stats_; }
+
+ private:
+  Options options_;
+  Stats stats_;
+
+  int frames_without_damage_ = 0;
+  bool idle_ = false;
+
+  base::TimeTicks timebase_ = base::TimeTicks::Now();
+  base::TimeTicks last_vsync_;
+  base::TimeDelta vsync_interval_;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_OSR_OSR_FRAME_PACER_H_
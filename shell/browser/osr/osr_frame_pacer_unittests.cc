@@ -0,0 +1,108 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/osr/osr_frame_pacer.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace electron {
+
+namespace {
+
+OffScreenFramePacer::Options AdaptiveOptions() {
+  OffScreenFramePacer::Options options;
+  options.adaptive = true;
+  options.idle_frame_rate = 2;
+  options.idle_frame_count = 3;
+  return options;
+}
+
+}  // namespace
+
+TEST(OffScreenFramePacerTest, PaintsAllFramesByDefault) {
+  OffScreenFramePacer pacer;
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(pacer.OnFrameCaptured(false, base::TimeDelta()));
+  EXPECT_FALSE(pacer.is_idle());
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1) / 60, pacer.GetFrameInterval(60));
+}
+
+TEST(OffScreenFramePacerTest, IdlesWithoutDamage) {
+  OffScreenFramePacer pacer;
+  pacer.SetOptions(AdaptiveOptions());
+  EXPECT_FALSE(pacer.OnFrameCaptured(false, base::TimeDelta()));
+  EXPECT_FALSE(pacer.OnFrameCaptured(false, base::TimeDelta()));
+  EXPECT_FALSE(pacer.is_idle());
+  EXPECT_FALSE(pacer.OnFrameCaptured(false, base::TimeDelta()));
+  EXPECT_TRUE(pacer.is_idle());
+  EXPECT_EQ(3u, pacer.stats().frames_skipped);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(500),
+            pacer.GetFrameInterval(60));
+  // Damage drawn while idle is still captured right away.
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1) / 60,
+            pacer.GetCaptureInterval(60));
+
+  // Damage ramps the frame rate back up at once.
+  EXPECT_TRUE(pacer.OnFrameCaptured(true, base::TimeDelta()));
+  EXPECT_FALSE(pacer.is_idle());
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1) / 60, pacer.GetFrameInterval(60));
+}
+
+TEST(OffScreenFramePacerTest, WakesOnInput) {
+  OffScreenFramePacer pacer;
+  pacer.SetOptions(AdaptiveOptions());
+  for (int i = 0; i < 3; ++i)
+    pacer.OnFrameCaptured(false, base::TimeDelta());
+  EXPECT_TRUE(pacer.Wake());
+  EXPECT_FALSE(pacer.is_idle());
+  EXPECT_FALSE(pacer.Wake());
+}
+
+TEST(OffScreenFramePacerTest, AveragesLatency) {
+  OffScreenFramePacer pacer;
+  pacer.OnFrameCaptured(true, base::TimeDelta::FromMilliseconds(8));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(8),
+            pacer.stats().average_latency);
+  // Unknown latencies are left out.
+  pacer.OnFrameCaptured(true, base::TimeDelta());
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(8),
+            pacer.stats().average_latency);
+  pacer.OnFrameCaptured(true, base::TimeDelta::FromMilliseconds(16));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(9),
+            pacer.stats().average_latency);
+}
+
+TEST(OffScreenFramePacerTest, FollowsVSync) {
+  OffScreenFramePacer pacer;
+  base::TimeTicks now = base::TimeTicks::Now();
+  pacer.OnVSync(now);
+  EXPECT_EQ(now, pacer.timebase());
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1) / 60, pacer.GetFrameInterval(60));
+
+  now += base::TimeDelta::FromMilliseconds(10);
+  pacer.OnVSync(now);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(10), pacer.GetFrameInterval(60));
+
+  // Pauses of the consumer are left out.
+  now += base::TimeDelta::FromSeconds(5);
+  pacer.OnVSync(now);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(10), pacer.GetFrameInterval(60));
+
+  pacer.ResetVSync();
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1) / 60, pacer.GetFrameInterval(60));
+}
+
+TEST(OffScreenFramePacerTest, IgnoresVSyncJitter) {
+  OffScreenFramePacer pacer;
+  base::TimeTicks now = base::TimeTicks::Now();
+  pacer.OnVSync(now);
+  for (int i = 0; i < 10; ++i) {
+    now += base::TimeDelta::FromMicroseconds(i % 2 ? 16600 : 16800);
+    pacer.OnVSync(now);
+    EXPECT_EQ(base::TimeDelta::FromSeconds(1) / 60,
+              pacer.GetFrameInterval(30));
+  }
+}
+
+}  // namespace electron
@@ -0,0 +1,157 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/osr/osr_frame_pool.h"
+
+#include <utility>
+
+#include "base/logging.h"
+#include "base/memory/writable_shared_memory_region.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+#include "ui/gfx/geometry/skia_conversions.h"
+
+namespace electron {
+
+namespace {
+
+SkImageInfo GetFrameImageInfo(const gfx::Size& size) {
+  return SkImageInfo::MakeN32Premul(size.width(), size.height());
+}
+
+void ReleaseFrameBuffer(void* addr, void* context) {
+  static_cast<OffScreenFrameBuffer*>(context)->Release();
+}
+
+}  // namespace
+
+// static
+scoped_refptr<OffScreenFrameBuffer> OffScreenFrameBuffer::Create(
+    const gfx::Size& size) {
+  size_t byte_size = GetFrameImageInfo(size).computeMinByteSize();
+  if (byte_size == 0 || byte_size == SIZE_MAX)
+    return nullptr;
+  base::WritableSharedMemoryMapping mapping =
+      base::WritableSharedMemoryRegion::Create(byte_size).Map();
+  if (!mapping.IsValid()) {
+    LOG(ERROR) << "Failed to allocate a frame buffer of " << byte_size
+               << " bytes";
+    return nullptr;
+  }
+  return base::WrapRefCounted(
+      new OffScreenFrameBuffer(size, std::move(mapping)));
+}
+
+OffScreenFrameBuffer::OffScreenFrameBuffer(
+    const gfx::Size& size,
+    base::WritableSharedMemoryMapping mapping)
+    : size_(size), mapping_(std::move(mapping)) {}
+
+OffScreenFrameBuffer::~OffScreenFrameBuffer() = default;
+
+SkBitmap OffScreenFrameBuffer::GetBitmap() {
+  SkImageInfo info = GetFrameImageInfo(size_);
+  AddRef();
+  SkBitmap bitmap;
+  bitmap.installPixels(info, data(), info.minRowBytes(), &ReleaseFrameBuffer,
+                       this);
+  return bitmap;
+}
+
+OffScreenFramePool::Frame::Frame() = default;
+OffScreenFramePool::Frame::Frame(const Frame&) = default;
+OffScreenFramePool::Frame::~Frame() = default;
+OffScreenFramePool::Frame& OffScreenFramePool::Frame::operator=(const Frame&) =
+    default;
+
+OffScreenFramePool::Slot::Slot() = default;
+OffScreenFramePool::Slot::Slot(Slot&&) = default;
+OffScreenFramePool::Slot::~Slot() = default;
+OffScreenFramePool::Slot& OffScreenFramePool::Slot::operator=(Slot&&) =
+    default;
+
+OffScreenFramePool::OffScreenFramePool(size_t capacity) : slots_(capacity) {}
+
+OffScreenFramePool::~OffScreenFramePool() = default;
+
+bool OffScreenFramePool::LendFrame(const SkBitmap& bitmap,
+                                   const gfx::Rect& damage_rect,
+                                   Frame* frame) {
+  gfx::Size size(bitmap.width(), bitmap.height());
+  SkIRect bounds = SkIRect::MakeWH(size.width(), size.height());
+  SkIRect damage = gfx::RectToSkIRect(damage_rect);
+  if (!damage.intersect(bounds))
+    damage.setEmpty();
+
+  SkRegion copy_region;
+  {
+    base::AutoLock auto_lock(lock_);
+    // Prefers a free buffer of the right size, which does not have to be
+    // allocated again.
+    Slot* free_slot = nullptr;
+    for (Slot& slot : slots_) {
+      if (slot.lent)
+        continue;
+      if (!free_slot || (slot.buffer && slot.buffer->size() == size))
+        free_slot = &slot;
+    }
+    // The skipped frame is still damage for all the buffers.
+    for (Slot& slot : slots_) {
+      if (&slot != free_slot)
+        slot.stale.op(damage, SkRegion::kUnion_Op);
+    }
+    if (!free_slot)
+      return false;
+
+    if (!free_slot->buffer || free_slot->buffer->size() != size) {
+      free_slot->buffer = OffScreenFrameBuffer::Create(size);
+      free_slot->stale.setRect(bounds);
+    }
+    if (!free_slot->buffer)
+      return false;
+    copy_region = free_slot->stale;
+    copy_region.op(damage, SkRegion::kUnion_Op);
+    free_slot->stale.setEmpty();
+    free_slot->lent = true;
+    frame->buffer = free_slot->buffer;
+    frame->slot = free_slot - slots_.data();
+    frame->generation = ++free_slot->generation;
+  }
+
+  // The buffer is lent, so it can be written without the lock.
+  SkImageInfo info = GetFrameImageInfo(size);
+  uint8_t* data = frame->buffer->data();
+  for (SkRegion::Iterator it(copy_region); !it.done(); it.next()) {
+    const SkIRect& rect = it.rect();
+    if (!bitmap.readPixels(info.makeWH(rect.width(), rect.height()),
+                           data + info.computeOffset(rect.x(), rect.y(),
+                                                     info.minRowBytes()),
+                           info.minRowBytes(), rect.x(), rect.y())) {
+      {
+        base::AutoLock auto_lock(lock_);
+        slots_[frame->slot].stale.setRect(bounds);
+      }
+      ReleaseFrame(*frame);
+      return false;
+    }
+  }
+  return true;
+}
+
+void OffScreenFramePool::ReleaseFrame(const Frame& frame) {
+  base::AutoLock auto_lock(lock_);
+  DCHECK_LT(frame.slot, slots_.size());
+  Slot& slot = slots_[frame.slot];
+  if (slot.generation == frame.generation)
+    slot.lent = false;
+}
+
+size_t OffScreenFramePool::lent_count() {
+  base::AutoLock auto_lock(lock_);
+  size_t count = 0;
+  for (const Slot& slot : slots_)
+    count += slot.lent;
+  return count;
+}
+
+}  // namespace electron
@@ -0,0 +1,111 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_OSR_OSR_FRAME_POOL_H_
+#define SHELL_BROWSER_OSR_OSR_FRAME_POOL_H_
+
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/shared_memory_mapping.h"
+#include "base/synchronization/lock.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkRegion.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace electron {
+
+// Shared memory holding the pixels of one frame of the pool.
+class OffScreenFrameBuffer
+    : public base::RefCountedThreadSafe<OffScreenFrameBuffer> {
+ public:
+  static scoped_refptr<OffScreenFrameBuffer> Create(const gfx::Size& size);
+
+  // disable copy
+  OffScreenFrameBuffer(const OffScreenFrameBuffer&) = delete;
+  OffScreenFrameBuffer& operator=(const OffScreenFrameBuffer&) = delete;
+
+  // Returns a bitmap of the buffer, which keeps the buffer alive.
+  SkBitmap GetBitmap();
+
+  const gfx::Size& size() const { return size_; }
+  uint8_t* data() { return mapping_.GetMemoryAsSpan<uint8_t>().data(); }
+  size_t byte_size() const { return mapping_.size(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<OffScreenFrameBuffer>;
+
+  OffScreenFrameBuffer(const gfx::Size& size,
+                       base::WritableSharedMemoryMapping mapping);
+  ~OffScreenFrameBuffer();
+
+  gfx::Size size_;
+  base::WritableSharedMemoryMapping mapping_;
+};
+
+// A ring of reusable frame buffers for the paint event, so that painting does
+// not allocate a frame each time. Each frame is lent until it is released,
+// and frames are skipped while all the buffers are lent, so that a slow
+// consumer does not queue up memory. Frames can be released from any thread.
+class OffScreenFramePool
+    : public base::RefCountedThreadSafe<OffScreenFramePool> {
+ public:
+  struct Frame {
+    Frame();
+    Frame(const Frame&);
+    ~Frame();
+    Frame& operator=(const Frame&);
+
+    scoped_refptr<OffScreenFrameBuffer> buffer;
+    size_t slot = 0;
+    uint64_t generation = 0;
+  };
+
+  explicit OffScreenFramePool(size_t capacity);
+
+  // disable copy
+  OffScreenFramePool(const OffScreenFramePool&) = delete;
+  OffScreenFramePool& operator=(const OffScreenFramePool&) = delete;
+
+  // Copies |bitmap| into a free buffer and lends it. Returns false when all
+  // the buffers are lent. Each buffer remembers what was damaged since it
+  // was last written, so only that area is copied, |damage_rect| included.
+  bool LendFrame(const SkBitmap& bitmap,
+                 const gfx::Rect& damage_rect,
+                 Frame* frame);
+
+  // Gives the buffer of |frame| back. Releasing a frame more than once is
+  // harmless.
+  void ReleaseFrame(const Frame& frame);
+
+  size_t capacity() const { return slots_.size(); }
+  size_t lent_count();
+
+ private:
+  friend class base::RefCountedThreadSafe<OffScreenFramePool>;
+
+  struct Slot {
+    Slot();
+    Slot(Slot&&);
+    ~Slot();
+    Slot& operator=(Slot&&);
+
+    scoped_refptr<OffScreenFrameBuffer> buffer;
+    // Incremented each time the slot is lent, to tell stale releases apart.
+    uint64_t generation = 0;
+    bool lent = false;
+    // The area painted since the buffer was last written.
+    SkRegion stale;
+  };
+
+  ~OffScreenFramePool();
+
+  base::Lock lock_;
+  std::vector<Slot> slots_;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_OSR_OSR_FRAME_POOL_H_
@@ -33,7 +33,7 @@
 #include "media/base/video_frame.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/public/common/input/web_input_event.h"
-#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 #include "ui/compositor/compositor.h"
 #include "ui/compositor/layer.h"
 #include "ui/compositor/layer_type.h"
@@ -43,6 +43,7 @@
 #include "ui/gfx/canvas.h"
 #include "ui/gfx/geometry/dip_util.h"
 #include "ui/gfx/geometry/size_conversions.h"
+#include "ui/gfx/geometry/skia_conversions.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/native_widget_types.h"
 #include "ui/gfx/skbitmap_operations.h"
@@ -120,6 +121,22 @@ ui::MouseWheelEvent UiMouseWheelEventFromWebMouseEvent(
                              std::floor(event.delta_y));
 }
 
+// Writes the part of |bitmap|, drawn at |origin|, that lies in |clip|.
+void WriteBitmapRect(const SkBitmap& bitmap,
+                     const gfx::Point& origin,
+                     const gfx::Rect& clip,
+                     SkBitmap* target) {
+  gfx::Rect rect(origin, gfx::Size(bitmap.width(), bitmap.height()));
+  rect.Intersect(clip);
+  SkPixmap pixmap;
+  SkPixmap subset;
+  if (rect.IsEmpty() || !bitmap.peekPixels(&pixmap) ||
+      !pixmap.extractSubset(
+          &subset, gfx::RectToSkIRect(rect - origin.OffsetFromOrigin())))
+    return;
+  target->writePixels(subset, rect.x(), rect.y());
+}
+
 }  // namespace
 
 class ElectronDelegatedFrameHostClient
@@ -189,7 +206,9 @@ OffScreenRenderWidgetHostView::OffScreenRenderWidgetHostView(
       painting_(painting),
       cursor_manager_(std::make_unique<content::CursorManager>(this)),
       mouse_wheel_phase_handler_(this),
-      backing_(std::make_unique<SkBitmap>()) {
+      backing_(std::make_unique<SkBitmap>()),
+      backing_surfaces_(!transparent),
+      composited_surfaces_(false) {
   DCHECK(render_widget_host_);
   DCHECK(!render_widget_host_->GetView());
 
@@ -233,8 +252,8 @@ OffScreenRenderWidgetHostView::OffScreenRenderWidgetHostView(
     video_consumer_ = std::make_unique<OffScreenVideoConsumer>(
         this, base::BindRepeating(&OffScreenRenderWidgetHostView::OnPaint,
                                   weak_ptr_factory_.GetWeakPtr()));
+    capture_interval_ = GetCaptureInterval();
     video_consumer_->SetActive(IsPainting());
-    video_consumer_->SetFrameRate(GetFrameRate());
   }
 }
 
@@ -426,7 +445,11 @@ content::CursorManager* OffScreenRenderWidgetHostView::GetCursorManager() {
   return cursor_manager_.get();
 }
 
-void OffScreenRenderWidgetHostView::SetIsLoading(bool loading) {}
+void OffScreenRenderWidgetHostView::SetIsLoading(bool loading) {
+  // The page is about to change without any input.
+  if (loading)
+    WakeFramePacing();
+}
 
 void OffScreenRenderWidgetHostView::TextInputStateChanged(
     const ui::mojom::TextInputState& params) {}
@@ -558,6 +581,7 @@ const viz::FrameSinkId& OffScreenRenderWidgetHostView::GetFrameSinkId() const {
 }
 
 void OffScreenRenderWidgetHostView::DidNavigate() {
+  WakeFramePacing();
   ResizeRootLayer(true);
   if (delegated_frame_host_)
     delegated_frame_host_->DidNavigate();
@@ -673,9 +697,22 @@ bool OffScreenRenderWidgetHostView::UpdateNSViewAndDisplay() {
 
 void OffScreenRenderWidgetHostView::OnPaint(const gfx::Rect& damage_rect,
                                             const SkBitmap& bitmap) {
-  backing_ = std::make_unique<SkBitmap>();
-  backing_->allocN32Pixels(bitmap.width(), bitmap.height(), !transparent_);
-  bitmap.readPixels(backing_->pixmap());
+  if (bitmap.isImmutable()) {
+    // Frames of the video capturer stay valid until dropped, so they are
+    // kept as they are, and the consumers that keep them copy them.
+    *backing_ = bitmap;
+  } else {
+    // The canvas of the software output device is painted again, on whichever
+    // of the backings no consumer keeps. The reference to the previous frame
+    // is dropped first, so that its backing counts as free.
+    backing_->reset();
+    gfx::Size size(bitmap.width(), bitmap.height());
+    gfx::Rect draw_rect;
+    SkBitmap* surface =
+        backing_surfaces_.GetSurface(size, gfx::Rect(size), &draw_rect);
+    bitmap.readPixels(surface->pixmap());
+    *backing_ = *surface;
+  }
 
   if (IsPopupWidget() && parent_callback_) {
     parent_callback_.Run(this->popup_position_);
@@ -700,41 +737,64 @@ void OffScreenRenderWidgetHostView::CompositeFrame(
   HoldResize();
 
   gfx::Size size_in_pixels = SizeInPixels();
+  gfx::Rect frame_rect(size_in_pixels);
+  gfx::Rect dirty_rect = gfx::IntersectRects(frame_rect, damage_rect);
 
   SkBitmap frame;
 
   // Optimize for the case when there is no popup
   if (proxy_views_.empty() && !popup_host_view_) {
     frame = GetBacking();
+    // The area of the popups that went away is dirty.
+    if (!composited_layers_.empty())
+      dirty_rect = frame_rect;
+    composited_surfaces_.Reset();
+    composited_layers_.clear();
   } else {
     float sf = GetCurrentDeviceScaleFactor();
-    frame.allocN32Pixels(size_in_pixels.width(), size_in_pixels.height(),
-                         false);
-    if (!GetBacking().drawsNothing()) {
-      SkCanvas canvas(frame);
-      canvas.writePixels(GetBacking(), 0, 0);
-
-      if (popup_host_view_ && !popup_host_view_->GetBacking().drawsNothing()) {
-        gfx::Rect rect = popup_host_view_->popup_position_;
-        gfx::Point origin_in_pixels =
-            gfx::ToFlooredPoint(gfx::ConvertPointToPixels(rect.origin(), sf));
-        canvas.writePixels(popup_host_view_->GetBacking(), origin_in_pixels.x(),
-                           origin_in_pixels.y());
-      }
+    std::vector<std::pair<const SkBitmap*, gfx::Point>> layers;
+    if (popup_host_view_ && !popup_host_view_->GetBacking().drawsNothing()) {
+      gfx::Rect rect = popup_host_view_->popup_position_;
+      layers.emplace_back(
+          &popup_host_view_->GetBacking(),
+          gfx::ToFlooredPoint(gfx::ConvertPointToPixels(rect.origin(), sf)));
+    }
+    for (auto* proxy_view : proxy_views_) {
+      gfx::Rect rect = proxy_view->GetBounds();
+      layers.emplace_back(
+          proxy_view->GetBitmap(),
+          gfx::ToFlooredPoint(gfx::ConvertPointToPixels(rect.origin(), sf)));
+    }
+    std::vector<gfx::Rect> layer_rects;
+    for (const auto& layer : layers) {
+      layer_rects.emplace_back(
+          layer.second,
+          gfx::Size(layer.first->width(), layer.first->height()));
+    }
 
-      for (auto* proxy_view : proxy_views_) {
-        gfx::Rect rect = proxy_view->GetBounds();
-        gfx::Point origin_in_pixels =
-            gfx::ToFlooredPoint(gfx::ConvertPointToPixels(rect.origin(), sf));
-        canvas.writePixels(*proxy_view->GetBitmap(), origin_in_pixels.x(),
-                           origin_in_pixels.y());
-      }
+    // The composited frames are kept, and only their damaged area is drawn
+    // again, unless the layers moved.
+    if (layer_rects != composited_layers_) {
+      dirty_rect = frame_rect;
+      composited_layers_ = std::move(layer_rects);
+    }
+    gfx::Rect draw_rect;
+    SkBitmap* surface =
+        composited_surfaces_.GetSurface(size_in_pixels, dirty_rect, &draw_rect);
+    if (draw_rect == frame_rect)
+      surface->eraseColor(SK_ColorTRANSPARENT);
+
+    if (!GetBacking().drawsNothing()) {
+      WriteBitmapRect(GetBacking(), gfx::Point(), draw_rect, surface);
+      for (const auto& layer : layers)
+        WriteBitmapRect(*layer.first, layer.second, draw_rect, surface);
     }
+    frame = *surface;
   }
 
   paint_callback_running_ = true;
-  callback_.Run(gfx::IntersectRects(gfx::Rect(size_in_pixels), damage_rect),
-                frame);
+  if (callback_.Run(dirty_rect, frame))
+    frame_pacer_.OnFramePainted();
   paint_callback_running_ = false;
 
   ReleaseResize();
@@ -772,6 +832,7 @@ void OffScreenRenderWidgetHostView::ReleaseResize() {
 }
 
 void OffScreenRenderWidgetHostView::SynchronizeVisualProperties() {
+  WakeFramePacing();
   if (hold_resize_) {
     if (!pending_resize_)
       pending_resize_ = true;
@@ -783,6 +844,7 @@ void OffScreenRenderWidgetHostView::SynchronizeVisualProperties() {
 
 void OffScreenRenderWidgetHostView::SendMouseEvent(
     const blink::WebMouseEvent& event) {
+  WakeFramePacing();
   for (auto* proxy_view : proxy_views_) {
     gfx::Rect bounds = proxy_view->GetBounds();
     if (bounds.Contains(event.PositionInWidget().x(),
@@ -821,6 +883,7 @@ void OffScreenRenderWidgetHostView::SendMouseEvent(
 
 void OffScreenRenderWidgetHostView::SendMouseWheelEvent(
     const blink::WebMouseWheelEvent& event) {
+  WakeFramePacing();
   for (auto* proxy_view : proxy_views_) {
     gfx::Rect bounds = proxy_view->GetBounds();
     if (bounds.Contains(event.PositionInWidget().x(),
@@ -938,12 +1001,10 @@ void OffScreenRenderWidgetHostView::SetFrameRate(int frame_rate) {
     frame_rate_ = frame_rate;
   }
 
+  // A new frame rate replaces the one of the consumer's vsync.
+  frame_pacer_.ResetVSync();
   SetupFrameRate(true);
 
-  if (video_consumer_) {
-    video_consumer_->SetFrameRate(GetFrameRate());
-  }
-
   for (auto* guest_host_view : guest_host_views_)
     guest_host_view->SetFrameRate(frame_rate);
 }
@@ -952,6 +1013,39 @@ int OffScreenRenderWidgetHostView::GetFrameRate() const {
   return frame_rate_;
 }
 
+base::TimeDelta OffScreenRenderWidgetHostView::GetFrameInterval() const {
+  return frame_pacer_.GetFrameInterval(frame_rate_);
+}
+
+base::TimeDelta OffScreenRenderWidgetHostView::GetCaptureInterval() const {
+  return frame_pacer_.GetCaptureInterval(frame_rate_);
+}
+
+void OffScreenRenderWidgetHostView::SetFramePacing(
+    const OffScreenFramePacer::Options& options) {
+  frame_pacer_.SetOptions(options);
+  SetupFrameRate(true);
+}
+
+void OffScreenRenderWidgetHostView::NotifyVSync() {
+  frame_pacer_.OnVSync(base::TimeTicks::Now());
+  SetupFrameRate(true);
+}
+
+void OffScreenRenderWidgetHostView::WakeFramePacing() {
+  if (frame_pacer_.Wake())
+    SetupFrameRate(true);
+}
+
+bool OffScreenRenderWidgetHostView::OnFrameCaptured(bool damaged,
+                                                    base::TimeDelta latency) {
+  bool was_idle = frame_pacer_.is_idle();
+  bool paint = frame_pacer_.OnFrameCaptured(damaged, latency);
+  if (frame_pacer_.is_idle() != was_idle)
+    SetupFrameRate(true);
+  return paint;
+}
+
 ui::Layer* OffScreenRenderWidgetHostView::GetRootLayer() const {
   return root_layer_.get();
 }
@@ -970,12 +1064,21 @@ void OffScreenRenderWidgetHostView::SetupFrameRate(bool force) {
   if (!force && frame_rate_threshold_us_ != 0)
     return;
 
-  frame_rate_threshold_us_ = 1000000 / frame_rate_;
+  base::TimeDelta interval = GetFrameInterval();
+  frame_rate_threshold_us_ = interval.InMicroseconds();
 
   if (compositor_) {
-    compositor_->SetDisplayVSyncParameters(
-        base::TimeTicks::Now(),
-        base::TimeDelta::FromMicroseconds(frame_rate_threshold_us_));
+    compositor_->SetDisplayVSyncParameters(frame_pacer_.timebase(), interval);
+  }
+
+  // The capturer is told over IPC, and the vsync of a consumer only moves the
+  // timebase most of the time. It keeps its rate while idle, so the first
+  // frame the compositor draws with damage wakes the view without waiting for
+  // an idle capture.
+  base::TimeDelta capture_interval = GetCaptureInterval();
+  if (video_consumer_ && capture_interval != capture_interval_) {
+    capture_interval_ = capture_interval;
+    video_consumer_->SetFrameInterval(capture_interval);
   }
 }
 
@@ -24,7 +24,9 @@
 #include "content/browser/renderer_host/render_widget_host_impl.h"  // nogncheck
 #include "content/browser/renderer_host/render_widget_host_view_base.h"  // nogncheck
 #include "content/browser/web_contents/web_contents_view.h"  // nogncheck
+#include "shell/browser/osr/osr_frame_pacer.h"
 #include "shell/browser/osr/osr_host_display_client.h"
+#include "shell/browser/osr/osr_surfaces.h"
 #include "shell/browser/osr/osr_video_consumer.h"
 #include "shell/browser/osr/osr_view_proxy.h"
 #include "third_party/blink/public/platform/web_vector.h"
@@ -52,7 +54,9 @@ class ElectronBeginFrameTimer;
 
 class ElectronDelegatedFrameHostClient;
 
-typedef base::RepeatingCallback<void(const gfx::Rect&, const SkBitmap&)>
+// Returns whether the frame was emitted, frames can be dropped by the
+// receiver.
+typedef base::RepeatingCallback<bool(const gfx::Rect&, const SkBitmap&)>
     OnPaintCallback;
 typedef base::RepeatingCallback<void(const gfx::Rect&)> OnPopupPaintCallback;
 
@@ -203,6 +207,19 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
 
+  // The time between frames, following the frame rate and the pacing.
+  base::TimeDelta GetFrameInterval() const;
+  // The shortest time between frames of the video capturer.
+  base::TimeDelta GetCaptureInterval() const;
+  void SetFramePacing(const OffScreenFramePacer::Options& options);
+  const OffScreenFramePacer& frame_pacer() const { return frame_pacer_; }
+  // Aligns the frames with a vsync of the consumer, which is now.
+  void NotifyVSync();
+  // Restores the frame rate of an idle view, e.g. on input.
+  void WakeFramePacing();
+  // Returns whether a frame of the video capturer should be painted.
+  bool OnFrameCaptured(bool damaged, base::TimeDelta latency);
+
   ui::Layer* GetRootLayer() const;
 
   content::DelegatedFrameHost* GetDelegatedFrameHost() const;
@@ -249,6 +266,8 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
 
   int frame_rate_ = 0;
   int frame_rate_threshold_us_ = 0;
+  base::TimeDelta capture_interval_;
+  OffScreenFramePacer frame_pacer_;
 
   base::Time last_time_ = base::Time::Now();
 
@@ -293,6 +312,13 @@ class OffScreenRenderWidgetHostView : public content::RenderWidgetHostViewBase,
   SkColor background_color_ = SkColor();
 
   std::unique_ptr<SkBitmap> backing_;
+  // The backings the software output device is painted on in turn.
+  OffScreenSurfaces backing_surfaces_;
+
+  // The backing with the popup and the proxy views drawn over it, which is
+  // only drawn again where damaged, and the bounds of the layers in it.
+  OffScreenSurfaces composited_surfaces_;
+  std::vector<gfx::Rect> composited_layers_;
 
   base::WeakPtrFactory<OffScreenRenderWidgetHostView> weak_ptr_factory_{this};
 };
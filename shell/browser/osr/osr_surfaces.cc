@@ -0,0 +1,52 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/osr/osr_surfaces.h"
+
+namespace electron {
+
+namespace {
+
+// Whether |bitmap| can be drawn again as a frame of |size|, which is the case
+// once no consumer refers to its pixels.
+bool IsReusable(const SkBitmap& bitmap, const gfx::Size& size) {
+  return bitmap.pixelRef() && bitmap.pixelRef()->unique() &&
+         !bitmap.isImmutable() && bitmap.width() == size.width() &&
+         bitmap.height() == size.height();
+}
+
+}  // namespace
+
+OffScreenSurfaces::OffScreenSurfaces(bool opaque) : opaque_(opaque) {}
+
+OffScreenSurfaces::~OffScreenSurfaces() = default;
+
+SkBitmap* OffScreenSurfaces::GetSurface(const gfx::Size& size,
+                                        const gfx::Rect& damage_rect,
+                                        gfx::Rect* draw_rect) {
+  for (auto& surface : surfaces_)
+    surface.stale_rect.Union(damage_rect);
+
+  // The surface drawn last is the least behind.
+  if (!IsReusable(surfaces_[current_].bitmap, size))
+    current_ = 1 - current_;
+  Surface& surface = surfaces_[current_];
+  if (!IsReusable(surface.bitmap, size)) {
+    // The pixels stay alive as long as a consumer keeps them.
+    surface.bitmap.allocN32Pixels(size.width(), size.height(), opaque_);
+    surface.stale_rect = gfx::Rect(size);
+    ++allocation_count_;
+  }
+
+  *draw_rect = gfx::IntersectRects(surface.stale_rect, gfx::Rect(size));
+  surface.stale_rect = gfx::Rect();
+  return &surface.bitmap;
+}
+
+void OffScreenSurfaces::Reset() {
+  surfaces_.fill(Surface());
+  current_ = 0;
+}
+
+}  // namespace electron
@@ -0,0 +1,58 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_BROWSER_OSR_OSR_SURFACES_H_
+#define SHELL_BROWSER_OSR_OSR_SURFACES_H_
+
+#include <array>
+#include <cstdint>
+
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace electron {
+
+// Two surfaces an offscreen view draws its frames on in turn, so that one of
+// them is free while a consumer keeps the frame on the other. A surface is
+// only behind by the damage of the frames drawn since it was last drawn, so
+// that only this area has to be drawn again.
+class OffScreenSurfaces {
+ public:
+  explicit OffScreenSurfaces(bool opaque);
+  ~OffScreenSurfaces();
+
+  // disable copy
+  OffScreenSurfaces(const OffScreenSurfaces&) = delete;
+  OffScreenSurfaces& operator=(const OffScreenSurfaces&) = delete;
+
+  // Returns the surface to draw a frame of |size| with |damage_rect| on, and
+  // sets |draw_rect| to the area of it to draw. A surface is allocated, and
+  // drawn whole, only when consumers keep both surfaces or the size changed.
+  SkBitmap* GetSurface(const gfx::Size& size,
+                       const gfx::Rect& damage_rect,
+                       gfx::Rect* draw_rect);
+
+  // Drops both surfaces.
+  void Reset();
+
+  uint64_t allocation_count() const { return allocation_count_; }
+
+ private:
+  struct Surface {
+    SkBitmap bitmap;
+    // The damage of the frames drawn on the other surface since this one was
+    // last drawn.
+    gfx::Rect stale_rect;
+  };
+
+  const bool opaque_;
+  std::array<Surface, 2> surfaces_;
+  size_t current_ = 0;
+  uint64_t allocation_count_ = 0;
+};
+
+}  // namespace electron
+
+#endif  // SHELL_BROWSER_OSR_OSR_SURFACES_H_
@@ -0,0 +1,73 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/browser/osr/osr_surfaces.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace electron {
+
+TEST(OffScreenSurfacesTest, ReusesSurfacesKeptByConsumers) {
+  OffScreenSurfaces surfaces(false);
+  const gfx::Size size(100, 50);
+  const gfx::Rect small_rect(10, 10, 5, 5);
+  gfx::Rect draw_rect;
+
+  // A popup shows up, so the whole frame is drawn, and the consumer keeps it
+  // until the next frame, as the image of a paint event does.
+  SkBitmap kept = *surfaces.GetSurface(size, gfx::Rect(size), &draw_rect);
+  EXPECT_EQ(gfx::Rect(size), draw_rect);
+  EXPECT_EQ(1u, surfaces.allocation_count());
+
+  SkBitmap* surface = surfaces.GetSurface(size, small_rect, &draw_rect);
+  EXPECT_NE(kept.getPixels(), surface->getPixels());
+  EXPECT_EQ(gfx::Rect(size), draw_rect);
+  EXPECT_EQ(2u, surfaces.allocation_count());
+  kept = *surface;
+
+  // From now on a small damage rect draws only itself, and the damage of the
+  // frame on the other surface, without any allocation.
+  const gfx::Rect other_rect(50, 20, 5, 5);
+  surface = surfaces.GetSurface(size, other_rect, &draw_rect);
+  EXPECT_NE(kept.getPixels(), surface->getPixels());
+  EXPECT_EQ(gfx::UnionRects(small_rect, other_rect), draw_rect);
+  kept = *surface;
+
+  surface = surfaces.GetSurface(size, small_rect, &draw_rect);
+  EXPECT_EQ(gfx::UnionRects(small_rect, other_rect), draw_rect);
+  kept = *surface;
+  EXPECT_EQ(2u, surfaces.allocation_count());
+}
+
+TEST(OffScreenSurfacesTest, DrawsOnTheSameSurfaceWhenNotKept) {
+  OffScreenSurfaces surfaces(true);
+  const gfx::Size size(100, 50);
+  gfx::Rect draw_rect;
+
+  SkBitmap* surface = surfaces.GetSurface(size, gfx::Rect(size), &draw_rect);
+  void* pixels = surface->getPixels();
+  surface = surfaces.GetSurface(size, gfx::Rect(1, 2, 3, 4), &draw_rect);
+  EXPECT_EQ(pixels, surface->getPixels());
+  EXPECT_EQ(gfx::Rect(1, 2, 3, 4), draw_rect);
+  EXPECT_EQ(1u, surfaces.allocation_count());
+}
+
+TEST(OffScreenSurfacesTest, AllocatesWhenBothAreKeptOrResized) {
+  OffScreenSurfaces surfaces(false);
+  const gfx::Size size(100, 50);
+  gfx::Rect draw_rect;
+
+  SkBitmap first = *surfaces.GetSurface(size, gfx::Rect(size), &draw_rect);
+  SkBitmap second = *surfaces.GetSurface(size, gfx::Rect(size), &draw_rect);
+  surfaces.GetSurface(size, gfx::Rect(1, 1), &draw_rect);
+  EXPECT_EQ(gfx::Rect(size), draw_rect);
+  EXPECT_EQ(3u, surfaces.allocation_count());
+
+  const gfx::Size larger(200, 50);
+  surfaces.GetSurface(larger, gfx::Rect(1, 1), &draw_rect);
+  EXPECT_EQ(gfx::Rect(larger), draw_rect);
+  EXPECT_EQ(4u, surfaces.allocation_count());
+}
+
+}  // namespace electron
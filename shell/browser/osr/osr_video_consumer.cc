@@ -26,7 +26,7 @@ OffScreenVideoConsumer::OffScreenVideoConsumer(
   video_capturer_->SetMinSizeChangePeriod(base::TimeDelta());
   video_capturer_->SetFormat(media::PIXEL_FORMAT_ARGB,
                              gfx::ColorSpace::CreateREC709());
-  SetFrameRate(view_->GetFrameRate());
+  SetFrameInterval(view_->GetCaptureInterval());
 }
 
 OffScreenVideoConsumer::~OffScreenVideoConsumer() = default;
@@ -39,9 +39,8 @@ void OffScreenVideoConsumer::SetActive(bool active) {
   }
 }
 
-void OffScreenVideoConsumer::SetFrameRate(int frame_rate) {
-  video_capturer_->SetMinCapturePeriod(base::TimeDelta::FromSeconds(1) /
-                                       frame_rate);
+void OffScreenVideoConsumer::SetFrameInterval(base::TimeDelta interval) {
+  video_capturer_->SetMinCapturePeriod(interval);
 }
 
 void OffScreenVideoConsumer::SizeChanged() {
@@ -70,6 +69,18 @@ void OffScreenVideoConsumer::OnFrameCaptured(
     callbacks_remote->Done();
     return;
   }
+
+  // An empty update rect means that nothing changed since the last frame.
+  absl::optional<gfx::Rect> update_rect = info->metadata.capture_update_rect;
+  bool damaged = !update_rect.has_value() || !update_rect->IsEmpty();
+  base::TimeDelta latency;
+  if (info->metadata.capture_begin_time.has_value())
+    latency = base::TimeTicks::Now() - *info->metadata.capture_begin_time;
+  if (!view_->OnFrameCaptured(damaged, latency)) {
+    callbacks_remote->Done();
+    return;
+  }
+
   base::ReadOnlySharedMemoryMapping mapping = data.Map();
   if (!mapping.IsValid()) {
     DLOG(ERROR) << "Shared memory mapping failed.";
@@ -112,7 +123,6 @@ void OffScreenVideoConsumer::OnFrameCaptured(
       new FramePinner{std::move(mapping), callbacks_remote.Unbind()});
   bitmap.setImmutable();
 
-  absl::optional<gfx::Rect> update_rect = info->metadata.capture_update_rect;
   if (!update_rect.has_value() || update_rect->IsEmpty()) {
     update_rect = content_rect;
   }
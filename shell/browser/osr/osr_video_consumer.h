@@ -10,6 +10,7 @@
 
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "components/viz/host/client_frame_sink_video_capturer.h"
 #include "media/capture/mojom/video_capture_types.mojom.h"
 
@@ -31,7 +32,7 @@ class OffScreenVideoConsumer : public viz::mojom::FrameSinkVideoConsumer {
   OffScreenVideoConsumer& operator=(const OffScreenVideoConsumer&) = delete;
 
   void SetActive(bool active);
-  void SetFrameRate(int frame_rate);
+  void SetFrameInterval(base::TimeDelta interval);
   void SizeChanged();
 
  private:
@@ -118,9 +118,11 @@ OffScreenWebContentsView::CreateViewForWidget(
         render_widget_host->GetView());
   }
 
-  return new OffScreenRenderWidgetHostView(
+  auto* view = new OffScreenRenderWidgetHostView(
       transparent_, painting_, GetFrameRate(), callback_, render_widget_host,
       nullptr, GetSize());
+  view->SetFramePacing(frame_pacing_);
+  return view;
 }
 
 content::RenderWidgetHostViewBase*
@@ -207,6 +209,31 @@ int OffScreenWebContentsView::GetFrameRate() const {
   }
 }
 
+void OffScreenWebContentsView::SetFramePacing(
+    const OffScreenFramePacer::Options& options) {
+  auto* view = GetView();
+  frame_pacing_ = options;
+  if (view != nullptr) {
+    view->SetFramePacing(options);
+  }
+}
+
+void OffScreenWebContentsView::NotifyVSync() {
+  auto* view = GetView();
+  if (view != nullptr) {
+    view->NotifyVSync();
+  }
+}
+
+OffScreenFramePacer::Stats OffScreenWebContentsView::GetFrameStats() const {
+  auto* view = GetView();
+  if (view != nullptr) {
+    return view->frame_pacer().stats();
+  } else {
+    return OffScreenFramePacer::Stats();
+  }
+}
+
 OffScreenRenderWidgetHostView* OffScreenWebContentsView::GetView() const {
   if (web_contents_) {
     return static_cast<OffScreenRenderWidgetHostView*>(
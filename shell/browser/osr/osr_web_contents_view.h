@@ -11,6 +11,7 @@
 #include "content/browser/renderer_host/render_view_host_delegate_view.h"  // nogncheck
 #include "content/browser/web_contents/web_contents_view.h"  // nogncheck
 #include "content/public/browser/web_contents.h"
+#include "shell/browser/osr/osr_frame_pacer.h"
 #include "shell/browser/osr/osr_render_widget_host_view.h"
 #include "third_party/blink/public/common/page/drag_mojom_traits.h"
 
@@ -79,6 +80,9 @@ class OffScreenWebContentsView : public content::WebContentsView,
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  void SetFramePacing(const OffScreenFramePacer::Options& options);
+  void NotifyVSync();
+  OffScreenFramePacer::Stats GetFrameStats() const;
 
  private:
 #if defined(OS_MAC)
@@ -93,6 +97,7 @@ class OffScreenWebContentsView : public content::WebContentsView,
   const bool transparent_;
   bool painting_ = true;
   int frame_rate_ = 60;
+  OffScreenFramePacer::Options frame_pacing_;
   OnPaintCallback callback_;
 
   // Weak refs.
@@ -4,6 +4,8 @@
 
 #include "shell/browser/protocol_registry.h"
 
+#include <utility>
+
 #include "base/stl_util.h"
 #include "content/public/browser/web_contents.h"
 #include "shell/browser/electron_browser_context.h"
@@ -40,22 +42,56 @@ void ProtocolRegistry::RegisterURLLoaderFactories(
 
   for (const auto& it : handlers_) {
     factories->emplace(it.first, ElectronURLLoaderFactory::Create(
-                                     it.second.first, it.second.second));
+                                     it.second.first, it.second.second,
+                                     GetResponseCache(it.first)));
   }
+  for (const auto& it : directory_handlers_)
+    factories->emplace(it.first, DirectoryURLLoaderFactory::Create(it.second));
 }
 
 bool ProtocolRegistry::RegisterProtocol(ProtocolType type,
                                         const std::string& scheme,
                                         const ProtocolHandler& handler) {
+  if (base::Contains(directory_handlers_, scheme))
+    return false;
   return base::TryEmplace(handlers_, scheme, type, handler).second;
 }
 
+bool ProtocolRegistry::RegisterDirectoryProtocol(
+    const std::string& scheme,
+    DirectoryMapping directories) {
+  if (base::Contains(handlers_, scheme))
+    return false;
+  return directory_handlers_.emplace(scheme, std::move(directories)).second;
+}
+
 bool ProtocolRegistry::UnregisterProtocol(const std::string& scheme) {
-  return handlers_.erase(scheme) != 0;
+  // The responses of the old handler are no longer valid.
+  auto cache = GetResponseCache(scheme);
+  if (cache)
+    cache->Clear();
+  return (handlers_.erase(scheme) + directory_handlers_.erase(scheme)) != 0;
 }
 
 bool ProtocolRegistry::IsProtocolRegistered(const std::string& scheme) {
-  return base::Contains(handlers_, scheme);
+  return base::Contains(handlers_, scheme) ||
+         base::Contains(directory_handlers_, scheme);
+}
+
+void ProtocolRegistry::SetResponseCache(const std::string& scheme,
+                                        size_t max_size) {
+  if (max_size == 0) {
+    response_caches_.erase(scheme);
+  } else {
+    response_caches_[scheme] =
+        base::MakeRefCounted<ProtocolResponseCache>(max_size);
+  }
+}
+
+scoped_refptr<ProtocolResponseCache> ProtocolRegistry::GetResponseCache(
+    const std::string& scheme) const {
+  auto it = response_caches_.find(scheme);
+  return it == response_caches_.end() ? nullptr : it->second;
 }
 
 bool ProtocolRegistry::InterceptProtocol(ProtocolType type,
@@ -5,10 +5,13 @@
 #ifndef SHELL_BROWSER_PROTOCOL_REGISTRY_H_
 #define SHELL_BROWSER_PROTOCOL_REGISTRY_H_
 
+#include <map>
 #include <string>
 
 #include "content/public/browser/content_browser_client.h"
+#include "shell/browser/net/directory_url_loader_factory.h"
 #include "shell/browser/net/electron_url_loader_factory.h"
+#include "shell/browser/net/protocol_response_cache.h"
 
 namespace content {
 class BrowserContext;
@@ -31,13 +34,27 @@ class ProtocolRegistry {
 
   const HandlersMap& intercept_handlers() const { return intercept_handlers_; }
   const HandlersMap& handlers() const { return handlers_; }
+  const std::map<std::string, DirectoryMapping>& directory_handlers() const {
+    return directory_handlers_;
+  }
 
   bool RegisterProtocol(ProtocolType type,
                         const std::string& scheme,
                         const ProtocolHandler& handler);
+  // Serves |scheme| from the files of |directories| without a handler.
+  bool RegisterDirectoryProtocol(const std::string& scheme,
+                                 DirectoryMapping directories);
   bool UnregisterProtocol(const std::string& scheme);
   bool IsProtocolRegistered(const std::string& scheme);
 
+  // Caches the responses of the handler of |scheme|, up to |max_size| bytes.
+  // A |max_size| of 0 disables the cache. Only the factories created after
+  // the call use the new cache.
+  void SetResponseCache(const std::string& scheme, size_t max_size);
+  // Returns null when the responses of |scheme| are not cached.
+  scoped_refptr<ProtocolResponseCache> GetResponseCache(
+      const std::string& scheme) const;
+
   bool InterceptProtocol(ProtocolType type,
                          const std::string& scheme,
                          const ProtocolHandler& handler);
@@ -51,6 +68,9 @@ class ProtocolRegistry {
 
   HandlersMap handlers_;
   HandlersMap intercept_handlers_;
+  std::map<std::string, DirectoryMapping> directory_handlers_;
+  std::map<std::string, scoped_refptr<ProtocolResponseCache>>
+      response_caches_;
 };
 
 }  // namespace electron
@@ -703,10 +703,17 @@ void InspectableWebContents::LoadNetworkResource(DispatchCallback callback,
         std::make_unique<network::WrapperPendingSharedURLLoaderFactory>(
             std::move(pending_remote)));
   } else if (protocol_registry->IsProtocolRegistered(gurl.scheme())) {
-    auto& protocol_handler = protocol_registry->handlers().at(gurl.scheme());
-    mojo::PendingRemote<network::mojom::URLLoaderFactory> pending_remote =
-        ElectronURLLoaderFactory::Create(protocol_handler.first,
-                                         protocol_handler.second);
+    mojo::PendingRemote<network::mojom::URLLoaderFactory> pending_remote;
+    const auto& directory_handlers = protocol_registry->directory_handlers();
+    auto directories = directory_handlers.find(gurl.scheme());
+    if (directories != directory_handlers.end()) {
+      pending_remote = DirectoryURLLoaderFactory::Create(directories->second);
+    } else {
+      auto& protocol_handler = protocol_registry->handlers().at(gurl.scheme());
+      pending_remote = ElectronURLLoaderFactory::Create(
+          protocol_handler.first, protocol_handler.second,
+          protocol_registry->GetResponseCache(gurl.scheme()));
+    }
     url_loader_factory = network::SharedURLLoaderFactory::Create(
         std::make_unique<network::WrapperPendingSharedURLLoaderFactory>(
             std::move(pending_remote)));
@@ -31,6 +31,10 @@ const char kPartitionDefaultZoomLevel[] = "partition.default_zoom_level";
 // be displayed at the default zoom level.
 const char kPartitionPerHostZoomLevels[] = "partition.per_host_zoom_levels";
 
+// Delay after a per-host zoom level change before the preference is updated.
+constexpr base::TimeDelta kZoomLevelWriteDelay =
+    base::TimeDelta::FromSeconds(1);
+
 std::string GetHash(const base::FilePath& partition_path) {
   size_t int_key = std::hash<base::FilePath>()(partition_path);
   return base::NumberToString(int_key);
@@ -51,7 +55,10 @@ ZoomLevelDelegate::ZoomLevelDelegate(PrefService* pref_service,
   partition_key_ = GetHash(partition_path);
 }
 
-ZoomLevelDelegate::~ZoomLevelDelegate() = default;
+ZoomLevelDelegate::~ZoomLevelDelegate() {
+  // The partition is shut down before its preferences.
+  WritePendingZoomLevels();
+}
 
 void ZoomLevelDelegate::SetDefaultZoomLevelPref(double level) {
   if (blink::PageZoomValuesEqual(level, host_zoom_map_->GetDefaultZoomLevel()))
@@ -78,14 +85,28 @@ void ZoomLevelDelegate::OnZoomLevelChanged(
   if (change.mode != content::HostZoomMap::ZOOM_CHANGED_FOR_HOST)
     return;
 
-  double level = change.zoom_level;
+  bool modification_is_removal = blink::PageZoomValuesEqual(
+      change.zoom_level, host_zoom_map_->GetDefaultZoomLevel());
+  if (modification_is_removal)
+    pending_zoom_levels_[change.host] = absl::nullopt;
+  else
+    pending_zoom_levels_[change.host] = change.zoom_level;
+
+  if (!write_timer_.IsRunning()) {
+    write_timer_.Start(FROM_HERE, kZoomLevelWriteDelay, this,
+                       &ZoomLevelDelegate::WritePendingZoomLevels);
+  }
+}
+
+void ZoomLevelDelegate::WritePendingZoomLevels() {
+  write_timer_.Stop();
+  if (pending_zoom_levels_.empty())
+    return;
+
   DictionaryPrefUpdate update(pref_service_, kPartitionPerHostZoomLevels);
   base::DictionaryValue* host_zoom_dictionaries = update.Get();
   DCHECK(host_zoom_dictionaries);
 
-  bool modification_is_removal =
-      blink::PageZoomValuesEqual(level, host_zoom_map_->GetDefaultZoomLevel());
-
   base::DictionaryValue* host_zoom_dictionary = nullptr;
   if (!host_zoom_dictionaries->GetDictionary(partition_key_,
                                              &host_zoom_dictionary)) {
@@ -93,10 +114,13 @@ void ZoomLevelDelegate::OnZoomLevelChanged(
         partition_key_, std::make_unique<base::DictionaryValue>());
   }
 
-  if (modification_is_removal)
-    host_zoom_dictionary->RemoveKey(change.host);
-  else
-    host_zoom_dictionary->SetKey(change.host, base::Value(level));
+  for (const auto& it : pending_zoom_levels_) {
+    if (it.second)
+      host_zoom_dictionary->SetKey(it.first, base::Value(*it.second));
+    else
+      host_zoom_dictionary->RemoveKey(it.first);
+  }
+  pending_zoom_levels_.clear();
 }
 
 void ZoomLevelDelegate::ExtractPerHostZoomLevels(
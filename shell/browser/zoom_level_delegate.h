@@ -5,11 +5,14 @@
 #ifndef SHELL_BROWSER_ZOOM_LEVEL_DELEGATE_H_
 #define SHELL_BROWSER_ZOOM_LEVEL_DELEGATE_H_
 
+#include <map>
 #include <string>
 
+#include "base/timer/timer.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/host_zoom_map.h"
 #include "content/public/browser/zoom_level_delegate.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace base {
 class DictionaryValue;
@@ -25,7 +28,8 @@ namespace electron {
 // levels in HostZoomMap and preference system. All changes
 // to the per-partition default zoom levels flow through this
 // class. Any changes to per-host levels are updated when HostZoomMap calls
-// OnZoomLevelChanged.
+// OnZoomLevelChanged, batched so that a burst of changes, like when zooming
+// with the mouse wheel, updates the preference once.
 class ZoomLevelDelegate : public content::ZoomLevelDelegate {
  public:
   static void RegisterPrefs(PrefRegistrySimple* pref_registry);
@@ -53,10 +57,18 @@ class ZoomLevelDelegate : public content::ZoomLevelDelegate {
   // zoom levels (if any) managed by this class (for its associated partition).
   void OnZoomLevelChanged(const content::HostZoomMap::ZoomLevelChange& change);
 
+  // Writes the per-host zoom levels changed since the last write.
+  void WritePendingZoomLevels();
+
   PrefService* pref_service_;
   content::HostZoomMap* host_zoom_map_ = nullptr;
   base::CallbackListSubscription zoom_subscription_;
   std::string partition_key_;
+
+  // The levels of the changed hosts, no level meaning that the host is back
+  // to the default level.
+  std::map<std::string, absl::optional<double>> pending_zoom_levels_;
+  base::OneShotTimer write_timer_;
 };
 
 }  // namespace electron
@@ -2,8 +2,13 @@
 // Use of this source code is governed by the MIT license that can be
 // found in the LICENSE file.
 
+#include <memory>
+#include <utility>
 #include <vector>
 
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_util.h"
+#include "gin/arguments.h"
 #include "gin/handle.h"
 #include "gin/object_template_builder.h"
 #include "gin/wrappable.h"
@@ -14,15 +19,44 @@
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/node_includes.h"
 #include "shell/common/node_util.h"
+#include "uv.h"  // NOLINT(build/include_directory)
 
 namespace {
 
+// Strings shorter than this are cheaper to copy than to track as external.
+constexpr size_t kExternalStringThreshold = 64 * 1024;
+
+// Exposes the ASCII content of a validated copy of a file to V8 without
+// copying it again. The copy is on the heap and never changes, unlike the
+// archive mapping, which follows the archive on disk and raises SIGBUS once
+// the archive is truncated, for instance by an update.
+class ValidatedOneByteString
+    : public v8::String::ExternalOneByteStringResource {
+ public:
+  explicit ValidatedOneByteString(scoped_refptr<base::RefCountedMemory> bytes)
+      : bytes_(std::move(bytes)) {}
+
+  // disable copy
+  ValidatedOneByteString(const ValidatedOneByteString&) = delete;
+  ValidatedOneByteString& operator=(const ValidatedOneByteString&) = delete;
+
+  // v8::String::ExternalOneByteStringResource:
+  const char* data() const override { return bytes_->front_as<char>(); }
+  size_t length() const override { return bytes_->size(); }
+
+ private:
+  // Keeps the copy alive when the archive evicts it.
+  scoped_refptr<base::RefCountedMemory> bytes_;
+};
+
 class Archive : public gin::Wrappable<Archive> {
  public:
   static gin::Handle<Archive> Create(v8::Isolate* isolate,
                                      const base::FilePath& path) {
-    auto archive = std::make_unique<asar::Archive>(path);
-    if (!archive->Init())
+    // Shares the archive with the native readers, so that the browser process
+    // can hand its index to renderers.
+    std::shared_ptr<asar::Archive> archive = asar::GetOrCreateAsarArchive(path);
+    if (!archive)
       return gin::Handle<Archive>();
     return gin::CreateHandle(isolate, new Archive(isolate, std::move(archive)));
   }
@@ -35,8 +69,12 @@ class Archive : public gin::Wrappable<Archive> {
         .SetMethod("getFileInfo", &Archive::GetFileInfo)
         .SetMethod("stat", &Archive::Stat)
         .SetMethod("readdir", &Archive::Readdir)
+        .SetMethod("readdirMany", &Archive::ReaddirMany)
         .SetMethod("realpath", &Archive::Realpath)
         .SetMethod("copyFileOut", &Archive::CopyFileOut)
+        .SetMethod("readFile", &Archive::ReadFile)
+        .SetMethod("readFileString", &Archive::ReadFileString)
+        .SetMethod("writeIndex", &Archive::WriteIndex)
         .SetMethod("getFdAndValidateIntegrityLater", &Archive::GetFD);
   }
 
@@ -47,7 +85,7 @@ class Archive : public gin::Wrappable<Archive> {
   Archive& operator=(const Archive&) = delete;
 
  protected:
-  Archive(v8::Isolate* isolate, std::unique_ptr<asar::Archive> archive)
+  Archive(v8::Isolate* isolate, std::shared_ptr<asar::Archive> archive)
       : archive_(std::move(archive)) {}
 
   // Reads the offset and size of file.
@@ -100,6 +138,42 @@ class Archive : public gin::Wrappable<Archive> {
     return gin::ConvertToV8(isolate, files);
   }
 
+  // Batched fs.readdir(path, { withFileTypes: true }). Each directory gives
+  // its entries as { names, types }, types being uv_dirent_type_t values and
+  // UV_DIRENT_UNKNOWN for entries that can not be stat'ed.
+  v8::Local<v8::Value> ReaddirMany(v8::Isolate* isolate,
+                                   const std::vector<base::FilePath>& paths) {
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Array> result = v8::Array::New(isolate, paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+      std::vector<base::FilePath> files;
+      if (!archive_ || !archive_->Readdir(paths[i], &files)) {
+        result->Set(context, i, v8::False(isolate)).Check();
+        continue;
+      }
+
+      std::vector<int> types;
+      types.reserve(files.size());
+      for (const auto& file : files) {
+        asar::Archive::Stats stats;
+        if (!archive_->Stat(paths[i].Append(file), &stats))
+          types.push_back(UV_DIRENT_UNKNOWN);
+        else if (stats.is_directory)
+          types.push_back(UV_DIRENT_DIR);
+        else if (stats.is_link)
+          types.push_back(UV_DIRENT_LINK);
+        else
+          types.push_back(UV_DIRENT_FILE);
+      }
+
+      gin_helper::Dictionary dict(isolate, v8::Object::New(isolate));
+      dict.Set("names", files);
+      dict.Set("types", types);
+      result->Set(context, i, dict.GetHandle()).Check();
+    }
+    return result;
+  }
+
   // Returns the path of file with symbol link resolved.
   v8::Local<v8::Value> Realpath(v8::Isolate* isolate,
                                 const base::FilePath& path) {
@@ -118,6 +192,61 @@ class Archive : public gin::Wrappable<Archive> {
     return gin::ConvertToV8(isolate, new_path);
   }
 
+  // Copies the file out of the archive mapping, or out of its validated copy,
+  // into a new Buffer. Script can write to a Buffer, so it never shares the
+  // bytes of the archive.
+  v8::Local<v8::Value> ReadFile(v8::Isolate* isolate,
+                                const base::FilePath& path) {
+    if (!archive_)
+      return v8::False(isolate);
+    scoped_refptr<base::RefCountedMemory> bytes =
+        archive_->ReadFileBytes(path, nullptr);
+    if (!bytes)
+      return v8::False(isolate);
+    return node::Buffer::Copy(isolate, bytes->front_as<char>(), bytes->size())
+        .ToLocalChecked();
+  }
+
+  // Decodes the file as UTF-8 straight from the archive mapping. Strings never
+  // point into the mapping, which may go away under them. Large ASCII files
+  // of archives whose integrity is validated, which most scripts are, become
+  // external strings sharing the validated copy instead.
+  v8::Local<v8::Value> ReadFileString(v8::Isolate* isolate,
+                                      const base::FilePath& path) {
+    if (!archive_)
+      return v8::False(isolate);
+    bool mapped;
+    scoped_refptr<base::RefCountedMemory> bytes =
+        archive_->ReadFileBytes(path, &mapped);
+    if (!bytes)
+      return v8::False(isolate);
+
+    base::StringPiece str(bytes->front_as<char>(), bytes->size());
+    if (!mapped && str.size() >= kExternalStringThreshold &&
+        base::IsStringASCII(str)) {
+      v8::Local<v8::String> result;
+      if (v8::String::NewExternalOneByte(
+              isolate, new ValidatedOneByteString(std::move(bytes)))
+              .ToLocal(&result))
+        return result;
+      return v8::False(isolate);
+    }
+
+    v8::Local<v8::String> result;
+    if (!v8::String::NewFromUtf8(isolate, str.data(),
+                                 v8::NewStringType::kNormal, str.size())
+             .ToLocal(&result))
+      return v8::False(isolate);
+    return result;
+  }
+
+  // Writes the precomputed index sidecar of the archive.
+  bool WriteIndex(gin::Arguments* args) {
+    base::FilePath path;
+    args->GetNext(&path);
+    return archive_ && archive_->WriteIndexFile(path);
+  }
+
   // Return the file descriptor.
   int GetFD() const {
     if (!archive_)
@@ -126,7 +255,7 @@ class Archive : public gin::Wrappable<Archive> {
   }
 
  private:
-  std::unique_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
 };
 
 // static
@@ -156,6 +285,12 @@ v8::Local<v8::Value> SplitPath(v8::Isolate* isolate,
   return dict.GetHandle();
 }
 
+// Bytes of asar index this process shares with the browser process instead of
+// holding its own copy.
+double GetSharedIndexBytes() {
+  return asar::Archive::GetSharedIndexBytes();
+}
+
 void Initialize(v8::Local<v8::Object> exports,
                 v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context,
@@ -164,6 +299,7 @@ void Initialize(v8::Local<v8::Object> exports,
   dict.SetMethod("createArchive", &Archive::Create);
   dict.SetMethod("splitPath", &SplitPath);
   dict.SetMethod("initAsarSupport", &InitAsarSupport);
+  dict.SetMethod("getSharedIndexBytes", &GetSharedIndexBytes);
 }
 
 }  // namespace
@@ -4,11 +4,13 @@
 
 #include "shell/common/api/electron_api_native_image.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/strings/pattern.h"
@@ -20,23 +22,33 @@
 #include "gin/per_isolate_data.h"
 #include "gin/wrappable.h"
 #include "net/base/data_url.h"
+#include "shell/common/api/image_job_queue.h"
+#include "shell/common/api/thumbnail_service.h"
 #include "shell/common/asar/asar_util.h"
 #include "shell/common/gin_converters/file_path_converter.h"
 #include "shell/common/gin_converters/gfx_converter.h"
+#include "shell/common/gin_converters/image_converter.h"
 #include "shell/common/gin_converters/gurl_converter.h"
 #include "shell/common/gin_converters/value_converter.h"
 #include "shell/common/gin_helper/dictionary.h"
+#include "shell/common/gin_helper/error_thrower.h"
 #include "shell/common/gin_helper/function_template_extensions.h"
+#include "shell/common/gin_helper/locker.h"
 #include "shell/common/gin_helper/object_template_builder.h"
+#include "shell/common/gin_helper/promise.h"
 #include "shell/common/node_includes.h"
+#include "shell/common/pixel_kernels.h"
 #include "shell/common/skia_util.h"
+#include "skia/ext/image_operations.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 #include "ui/base/layout.h"
 #include "ui/base/webui/web_ui_util.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/image/image_skia.h"
 #include "ui/gfx/image/image_skia_operations.h"
@@ -78,6 +90,170 @@ base::FilePath NormalizePath(const base::FilePath& path) {
   }
 }
 
+// Reads the pixel format of |options|, which is the native N32 order unless
+// given.
+bool GetPixelFormat(const gin_helper::Dictionary& options,
+                    pixels::Format* format) {
+  *format = kN32_SkColorType == kRGBA_8888_SkColorType ? pixels::Format::kRGBA
+                                                       : pixels::Format::kBGRA;
+  std::string name;
+  if (!options.Get("format", &name))
+    return true;
+  if (name == "bgra")
+    *format = pixels::Format::kBGRA;
+  else if (name == "rgba")
+    *format = pixels::Format::kRGBA;
+  else if (name == "gray")
+    *format = pixels::Format::kGray;
+  else
+    return false;
+  return true;
+}
+
+using ImageReps = std::vector<gfx::ImageSkiaRep>;
+
+// The representations the thread pool works on. Their pixels are marked
+// immutable, so that they are shared with the image rather than copied.
+ImageReps SnapshotReps(const gfx::ImageSkia& image) {
+  ImageReps reps = image.image_reps();
+  if (reps.empty() && !image.isNull())
+    reps.push_back(image.GetRepresentation(1.0f));
+  for (const auto& rep : reps) {
+    SkBitmap bitmap = rep.GetBitmap();
+    bitmap.setImmutable();
+  }
+  return reps;
+}
+
+SkBitmap SnapshotBitmap(const gfx::ImageSkia& image, float scale_factor) {
+  SkBitmap bitmap = image.GetRepresentation(scale_factor).GetBitmap();
+  bitmap.setImmutable();
+  return bitmap;
+}
+
+std::vector<unsigned char> EncodePNG(const SkBitmap& bitmap) {
+  std::vector<unsigned char> encoded;
+  if (!bitmap.isNull())
+    gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded);
+  return encoded;
+}
+
+std::vector<unsigned char> EncodeJPEG(const SkBitmap& bitmap, int quality) {
+  std::vector<unsigned char> encoded;
+  if (!bitmap.isNull())
+    gfx::JPEGCodec::Encode(bitmap, quality, &encoded);
+  return encoded;
+}
+
+ImageReps ResizeReps(const ImageReps& reps,
+                     skia::ImageOperations::ResizeMethod method,
+                     const gfx::Size& size) {
+  ImageReps resized;
+  for (const auto& rep : reps) {
+    gfx::Size pixel_size = gfx::ScaleToCeiledSize(size, rep.scale());
+    SkBitmap bitmap = skia::ImageOperations::Resize(
+        rep.GetBitmap(), method, pixel_size.width(), pixel_size.height());
+    if (!bitmap.isNull())
+      resized.emplace_back(bitmap, rep.scale());
+  }
+  return resized;
+}
+
+// Copies the pixels, so that the result does not keep the whole image alive.
+ImageReps CropReps(const ImageReps& reps, const gfx::Rect& rect) {
+  ImageReps cropped;
+  for (const auto& rep : reps) {
+    const SkBitmap& bitmap = rep.GetBitmap();
+    gfx::Rect subset = gfx::ScaleToEnclosingRect(rect, rep.scale());
+    subset.Intersect(gfx::Rect(bitmap.width(), bitmap.height()));
+    SkBitmap result;
+    if (subset.IsEmpty() ||
+        !result.tryAllocPixels(
+            bitmap.info().makeWH(subset.width(), subset.height())) ||
+        !bitmap.readPixels(result.pixmap(), subset.x(), subset.y()))
+      continue;
+    cropped.emplace_back(result, rep.scale());
+  }
+  return cropped;
+}
+
+ImageReps DecodeBuffer(const std::string& data,
+                       int width,
+                       int height,
+                       double scale_factor) {
+  gfx::ImageSkia image_skia;
+  electron::util::AddImageSkiaRepFromBuffer(
+      &image_skia, reinterpret_cast<const unsigned char*>(data.data()),
+      data.size(), width, height, scale_factor);
+  return image_skia.image_reps();
+}
+
+void ResolveWithBuffer(gin_helper::Promise<v8::Local<v8::Value>> promise,
+                       std::vector<unsigned char> data) {
+  v8::Isolate* isolate = promise.isolate();
+  gin_helper::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(
+      v8::Local<v8::Context>::New(isolate, promise.GetContext()));
+
+  // The buffer takes the encoded data without a copy.
+  auto* encoded = new std::vector<unsigned char>(std::move(data));
+  v8::Local<v8::Value> buffer =
+      node::Buffer::New(
+          isolate, reinterpret_cast<char*>(encoded->data()), encoded->size(),
+          [](char* data, void* hint) {
+            delete static_cast<std::vector<unsigned char>*>(hint);
+          },
+          encoded)
+          .ToLocalChecked();
+  promise.Resolve(buffer);
+}
+
+// The image is put together on the calling sequence, which owns it.
+void ResolveWithReps(gin_helper::Promise<gfx::Image> promise, ImageReps reps) {
+  gfx::ImageSkia image_skia;
+  for (const auto& rep : reps)
+    image_skia.AddRepresentation(rep);
+  promise.Resolve(gfx::Image(image_skia));
+}
+
+// Returns the size of a resize with |options|, in DIP, keeping the aspect
+// ratio when only one dimension is given. Empty when the image would be.
+gfx::Size GetResizedSize(const base::DictionaryValue& options,
+                         const gfx::Size& image_size,
+                         float aspect_ratio) {
+  gfx::Size size = image_size;
+  int width = size.width();
+  int height = size.height();
+  bool width_set = options.GetInteger("width", &width);
+  bool height_set = options.GetInteger("height", &height);
+  size.SetSize(width, height);
+
+  if (width <= 0 && height <= 0) {
+    return gfx::Size();
+  } else if (width_set && !height_set) {
+    // Scale height to preserve original aspect ratio
+    size.set_height(width);
+    size = gfx::ScaleToRoundedSize(size, 1.f, 1.f / aspect_ratio);
+  } else if (height_set && !width_set) {
+    // Scale width to preserve original aspect ratio
+    size.set_width(height);
+    size = gfx::ScaleToRoundedSize(size, aspect_ratio, 1.f);
+  }
+  return size;
+}
+
+skia::ImageOperations::ResizeMethod GetResizeMethod(
+    const base::DictionaryValue& options) {
+  std::string quality;
+  options.GetString("quality", &quality);
+  if (quality == "good")
+    return skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
+  else if (quality == "better")
+    return skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
+  return skia::ImageOperations::ResizeMethod::RESIZE_BEST;
+}
+
 #if defined(OS_MAC)
 bool IsTemplateFilename(const base::FilePath& path) {
   return (base::MatchPattern(path.value(), "*Template.*") ||
@@ -221,24 +397,87 @@ v8::Local<v8::Value> NativeImage::ToPNG(gin::Arguments* args) {
 }
 
 v8::Local<v8::Value> NativeImage::ToBitmap(gin::Arguments* args) {
-  float scale_factor = GetScaleFactorFromOptions(args);
+  v8::Isolate* isolate = args->isolate();
+  float scale_factor = 1.0f;
+  gfx::Rect rect;
+  bool has_rect = false;
+  pixels::Format format;
+  bool premultiplied = true;
+  v8::Local<v8::Value> target;
+  gin_helper::Dictionary options = gin::Dictionary::CreateEmpty(isolate);
+  args->GetNext(&options);
+  options.Get("scaleFactor", &scale_factor);
+  has_rect = options.Get("rect", &rect);
+  options.Get("premultiplied", &premultiplied);
+  if (!GetPixelFormat(options, &format)) {
+    args->ThrowTypeError("format must be 'bgra', 'rgba' or 'gray'");
+    return v8::Undefined(isolate);
+  }
+  if (options.Get("buffer", &target) && !target->IsArrayBufferView() &&
+      !target->IsArrayBuffer()) {
+    args->ThrowTypeError("buffer must be a Buffer or an ArrayBuffer");
+    return v8::Undefined(isolate);
+  }
 
   const SkBitmap bitmap =
       image_.AsImageSkia().GetRepresentation(scale_factor).GetBitmap();
 
-  SkImageInfo info =
-      SkImageInfo::MakeN32Premul(bitmap.width(), bitmap.height());
+  // Only copies |rect| when given, like the dirty rects of paint events.
+  gfx::Rect bounds(bitmap.width(), bitmap.height());
+  if (has_rect)
+    rect.Intersect(bounds);
+  else
+    rect = bounds;
+
+  // Converts straight from the pixels of the image when they are N32, and
+  // from a copy otherwise.
+  SkPixmap pixmap;
+  SkBitmap copy;
+  SkIRect subset = SkIRect::MakeXYWH(rect.x(), rect.y(), rect.width(),
+                                     rect.height());
+  if (!bitmap.peekPixels(&pixmap) ||
+      pixmap.colorType() != kN32_SkColorType ||
+      pixmap.alphaType() != kPremul_SkAlphaType ||
+      !pixmap.extractSubset(&pixmap, subset)) {
+    if (!copy.tryAllocN32Pixels(rect.width(), rect.height()) ||
+        !bitmap.readPixels(copy.pixmap(), rect.x(), rect.y()))
+      return node::Buffer::New(isolate, 0).ToLocalChecked();
+    pixmap = copy.pixmap();
+  }
 
-  auto array_buffer =
-      v8::ArrayBuffer::New(args->isolate(), info.computeMinByteSize());
-  auto backing_store = array_buffer->GetBackingStore();
-  if (bitmap.readPixels(info, backing_store->Data(), info.minRowBytes(), 0,
-                        0)) {
-    return node::Buffer::New(args->isolate(), array_buffer, 0,
-                             info.computeMinByteSize())
-        .ToLocalChecked();
+  size_t row_bytes =
+      static_cast<size_t>(rect.width()) * pixels::GetBytesPerPixel(format);
+  size_t size_bytes = row_bytes * rect.height();
+
+  // Writes into the memory of the caller when given, so that the same memory
+  // is reused from frame to frame.
+  v8::Local<v8::ArrayBuffer> array_buffer;
+  size_t offset = 0;
+  if (target.IsEmpty()) {
+    array_buffer = v8::ArrayBuffer::New(isolate, size_bytes);
+  } else if (target->IsArrayBufferView()) {
+    auto view = target.As<v8::ArrayBufferView>();
+    array_buffer = view->Buffer();
+    offset = view->ByteOffset();
+    if (view->ByteLength() < size_bytes) {
+      gin_helper::ErrorThrower(isolate).ThrowRangeError("buffer is too small");
+      return v8::Undefined(isolate);
+    }
+  } else {
+    array_buffer = target.As<v8::ArrayBuffer>();
+    if (array_buffer->ByteLength() < size_bytes) {
+      gin_helper::ErrorThrower(isolate).ThrowRangeError("buffer is too small");
+      return v8::Undefined(isolate);
+    }
   }
-  return node::Buffer::New(args->isolate(), 0).ToLocalChecked();
+
+  auto* data =
+      static_cast<uint8_t*>(array_buffer->GetBackingStore()->Data()) + offset;
+  if (size_bytes == 0 || !pixels::ConvertFromN32(pixmap, format, premultiplied,
+                                                 data, row_bytes))
+    return node::Buffer::New(isolate, 0).ToLocalChecked();
+  return node::Buffer::New(isolate, array_buffer, offset, size_bytes)
+      .ToLocalChecked();
 }
 
 v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
@@ -252,6 +491,39 @@ v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
       .ToLocalChecked();
 }
 
+v8::Local<v8::Promise> NativeImage::ToPNGAsync(gin::Arguments* args) {
+  float scale_factor = GetScaleFactorFromOptions(args);
+  gin_helper::Promise<v8::Local<v8::Value>> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  // Raw 1x PNG bytes need no encoding.
+  if (scale_factor == 1.0f &&
+      image_.HasRepresentation(gfx::Image::kImageRepPNG)) {
+    scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
+    ResolveWithBuffer(std::move(promise),
+                      std::vector<unsigned char>(png->front(),
+                                                 png->front() + png->size()));
+    return handle;
+  }
+
+  ImageJobQueue::GetInstance()->PostJobAndReply(
+      base::BindOnce(&EncodePNG,
+                     SnapshotBitmap(image_.AsImageSkia(), scale_factor)),
+      base::BindOnce(&ResolveWithBuffer, std::move(promise)));
+  return handle;
+}
+
+v8::Local<v8::Promise> NativeImage::ToJPEGAsync(v8::Isolate* isolate,
+                                                int quality) {
+  gin_helper::Promise<v8::Local<v8::Value>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  ImageJobQueue::GetInstance()->PostJobAndReply(
+      base::BindOnce(&EncodeJPEG, SnapshotBitmap(image_.AsImageSkia(), 1.0f),
+                     quality),
+      base::BindOnce(&ResolveWithBuffer, std::move(promise)));
+  return handle;
+}
+
 std::string NativeImage::ToDataURL(gin::Arguments* args) {
   float scale_factor = GetScaleFactorFromOptions(args);
 
@@ -334,41 +606,38 @@ gin::Handle<NativeImage> NativeImage::Resize(gin::Arguments* args,
                                              base::DictionaryValue options) {
   float scale_factor = GetScaleFactorFromOptions(args);
 
-  gfx::Size size = GetSize(scale_factor);
-  int width = size.width();
-  int height = size.height();
-  bool width_set = options.GetInteger("width", &width);
-  bool height_set = options.GetInteger("height", &height);
-  size.SetSize(width, height);
-
-  if (width <= 0 && height <= 0) {
+  gfx::Size size = GetResizedSize(options, GetSize(scale_factor),
+                                  GetAspectRatio(scale_factor));
+  if (size.IsEmpty())
     return CreateEmpty(args->isolate());
-  } else if (width_set && !height_set) {
-    // Scale height to preserve original aspect ratio
-    size.set_height(width);
-    size =
-        gfx::ScaleToRoundedSize(size, 1.f, 1.f / GetAspectRatio(scale_factor));
-  } else if (height_set && !width_set) {
-    // Scale width to preserve original aspect ratio
-    size.set_width(height);
-    size = gfx::ScaleToRoundedSize(size, GetAspectRatio(scale_factor), 1.f);
-  }
-
-  skia::ImageOperations::ResizeMethod method =
-      skia::ImageOperations::ResizeMethod::RESIZE_BEST;
-  std::string quality;
-  options.GetString("quality", &quality);
-  if (quality == "good")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
-  else if (quality == "better")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
 
   gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
-      image_.AsImageSkia(), method, size);
+      image_.AsImageSkia(), GetResizeMethod(options), size);
   return gin::CreateHandle(
       args->isolate(), new NativeImage(args->isolate(), gfx::Image(resized)));
 }
 
+v8::Local<v8::Promise> NativeImage::ResizeAsync(
+    gin::Arguments* args,
+    base::DictionaryValue options) {
+  float scale_factor = GetScaleFactorFromOptions(args);
+  gin_helper::Promise<gfx::Image> promise(args->isolate());
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  gfx::Size size = GetResizedSize(options, GetSize(scale_factor),
+                                  GetAspectRatio(scale_factor));
+  if (size.IsEmpty()) {
+    promise.Resolve(gfx::Image());
+    return handle;
+  }
+
+  ImageJobQueue::GetInstance()->PostJobAndReply(
+      base::BindOnce(&ResizeReps, SnapshotReps(image_.AsImageSkia()),
+                     GetResizeMethod(options), size),
+      base::BindOnce(&ResolveWithReps, std::move(promise)));
+  return handle;
+}
+
 gin::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
                                            const gfx::Rect& rect) {
   gfx::ImageSkia cropped =
@@ -377,6 +646,23 @@ gin::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
                            new NativeImage(isolate, gfx::Image(cropped)));
 }
 
+v8::Local<v8::Promise> NativeImage::CropAsync(v8::Isolate* isolate,
+                                              const gfx::Rect& rect) {
+  gin_helper::Promise<gfx::Image> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+
+  gfx::Rect bounds = gfx::IntersectRects(rect, gfx::Rect(GetSize(1.0f)));
+  if (bounds.IsEmpty()) {
+    promise.Resolve(gfx::Image());
+    return handle;
+  }
+
+  ImageJobQueue::GetInstance()->PostJobAndReply(
+      base::BindOnce(&CropReps, SnapshotReps(image_.AsImageSkia()), bounds),
+      base::BindOnce(&ResolveWithReps, std::move(promise)));
+  return handle;
+}
+
 void NativeImage::AddRepresentation(const gin_helper::Dictionary& options) {
   int width = 0;
   int height = 0;
@@ -500,8 +786,17 @@ gin::Handle<NativeImage> NativeImage::CreateFromBitmap(
     return gin::Handle<NativeImage>();
   }
 
-  auto info = SkImageInfo::MakeN32(width, height, kPremul_SkAlphaType);
-  auto size_bytes = info.computeMinByteSize();
+  pixels::Format format;
+  if (!GetPixelFormat(options, &format)) {
+    thrower.ThrowTypeError("format must be 'bgra', 'rgba' or 'gray'");
+    return gin::Handle<NativeImage>();
+  }
+  bool premultiplied = true;
+  options.Get("premultiplied", &premultiplied);
+
+  size_t row_bytes =
+      static_cast<size_t>(width) * pixels::GetBytesPerPixel(format);
+  size_t size_bytes = row_bytes * height;
 
   if (size_bytes != node::Buffer::Length(buffer)) {
     thrower.ThrowError("invalid buffer size");
@@ -516,7 +811,9 @@ gin::Handle<NativeImage> NativeImage::CreateFromBitmap(
 
   SkBitmap bitmap;
   bitmap.allocN32Pixels(width, height, false);
-  bitmap.writePixels({info, node::Buffer::Data(buffer), bitmap.rowBytes()});
+  pixels::ConvertToN32(
+      reinterpret_cast<const uint8_t*>(node::Buffer::Data(buffer)), row_bytes,
+      format, premultiplied, bitmap.pixmap());
 
   gfx::ImageSkia image_skia =
       gfx::ImageSkia::CreateFromBitmap(bitmap, scale_factor);
@@ -552,6 +849,79 @@ gin::Handle<NativeImage> NativeImage::CreateFromBuffer(
   return Create(args->isolate(), gfx::Image(image_skia));
 }
 
+// static
+v8::Local<v8::Promise> NativeImage::CreateFromBufferAsync(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> buffer,
+    gin::Arguments* args) {
+  gin_helper::Promise<gfx::Image> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  if (!node::Buffer::HasInstance(buffer)) {
+    promise.RejectWithErrorMessage("buffer must be a node Buffer");
+    return handle;
+  }
+
+  int width = 0;
+  int height = 0;
+  double scale_factor = 1.;
+
+  gin_helper::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("width", &width);
+    options.Get("height", &height);
+    options.Get("scaleFactor", &scale_factor);
+  }
+
+  // The buffer can change while it is decoded.
+  std::string data(node::Buffer::Data(buffer), node::Buffer::Length(buffer));
+  ImageJobQueue::GetInstance()->PostJobAndReply(
+      base::BindOnce(&DecodeBuffer, std::move(data), width, height,
+                     scale_factor),
+      base::BindOnce(&ResolveWithReps, std::move(promise)));
+  return handle;
+}
+
+// static
+v8::Local<v8::Promise> NativeImage::CreateThumbnailsFromPaths(
+    v8::Isolate* isolate,
+    const std::vector<base::FilePath>& paths,
+    const gfx::Size& size) {
+  gin_helper::Promise<std::vector<gfx::Image>> promise(isolate);
+  v8::Local<v8::Promise> handle = promise.GetHandle();
+  if (size.IsEmpty()) {
+    promise.RejectWithErrorMessage("size must not be empty");
+    return handle;
+  }
+
+  std::vector<base::FilePath> normalized_paths;
+  normalized_paths.reserve(paths.size());
+  for (const auto& path : paths)
+    normalized_paths.push_back(NormalizePath(path));
+
+  ThumbnailService::GetInstance()->CreateThumbnails(
+      normalized_paths, size,
+      base::BindOnce(
+          [](gin_helper::Promise<std::vector<gfx::Image>> promise,
+             std::vector<SkBitmap> thumbnails) {
+            std::vector<gfx::Image> images;
+            images.reserve(thumbnails.size());
+            for (const auto& thumbnail : thumbnails) {
+              images.push_back(thumbnail.isNull()
+                                   ? gfx::Image()
+                                   : gfx::Image::CreateFrom1xBitmap(thumbnail));
+            }
+            promise.Resolve(images);
+          },
+          std::move(promise)));
+  return handle;
+}
+
+// static
+void NativeImage::SetThumbnailCacheLimit(int64_t bytes) {
+  ThumbnailService::GetInstance()->SetCacheLimit(
+      static_cast<size_t>(std::max<int64_t>(bytes, 0)));
+}
+
 // static
 gin::Handle<NativeImage> NativeImage::CreateFromDataURL(v8::Isolate* isolate,
                                                         const GURL& url) {
@@ -588,7 +958,9 @@ gin::ObjectTemplateBuilder NativeImage::GetObjectTemplateBuilder(
   return gin::ObjectTemplateBuilder(isolate, GetTypeName(),
                                     constructor->InstanceTemplate())
       .SetMethod("toPNG", &NativeImage::ToPNG)
+      .SetMethod("toPNGAsync", &NativeImage::ToPNGAsync)
       .SetMethod("toJPEG", &NativeImage::ToJPEG)
+      .SetMethod("toJPEGAsync", &NativeImage::ToJPEGAsync)
       .SetMethod("toBitmap", &NativeImage::ToBitmap)
       .SetMethod("getBitmap", &NativeImage::GetBitmap)
       .SetMethod("getScaleFactors", &NativeImage::GetScaleFactors)
@@ -601,7 +973,9 @@ gin::ObjectTemplateBuilder NativeImage::GetObjectTemplateBuilder(
       .SetProperty("isMacTemplateImage", &NativeImage::IsTemplateImage,
                    &NativeImage::SetTemplateImage)
       .SetMethod("resize", &NativeImage::Resize)
+      .SetMethod("resizeAsync", &NativeImage::ResizeAsync)
       .SetMethod("crop", &NativeImage::Crop)
+      .SetMethod("cropAsync", &NativeImage::CropAsync)
       .SetMethod("getAspectRatio", &NativeImage::GetAspectRatio)
       .SetMethod("addRepresentation", &NativeImage::AddRepresentation);
 }
@@ -634,7 +1008,13 @@ void Initialize(v8::Local<v8::Object> exports,
   native_image.SetMethod("createFromPath", &NativeImage::CreateFromPath);
   native_image.SetMethod("createFromBitmap", &NativeImage::CreateFromBitmap);
   native_image.SetMethod("createFromBuffer", &NativeImage::CreateFromBuffer);
+  native_image.SetMethod("createFromBufferAsync",
+                         &NativeImage::CreateFromBufferAsync);
   native_image.SetMethod("createFromDataURL", &NativeImage::CreateFromDataURL);
+  native_image.SetMethod("createThumbnailsFromPaths",
+                         &NativeImage::CreateThumbnailsFromPaths);
+  native_image.SetMethod("setThumbnailCacheLimit",
+                         &NativeImage::SetThumbnailCacheLimit);
   native_image.SetMethod("createFromNamedImage",
                          &NativeImage::CreateFromNamedImage);
 #if !defined(OS_LINUX)
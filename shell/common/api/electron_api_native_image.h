@@ -74,6 +74,15 @@ class NativeImage : public gin::Wrappable<NativeImage> {
       gin_helper::ErrorThrower thrower,
       v8::Local<v8::Value> buffer,
       gin::Arguments* args);
+  static v8::Local<v8::Promise> CreateFromBufferAsync(
+      v8::Isolate* isolate,
+      v8::Local<v8::Value> buffer,
+      gin::Arguments* args);
+  static v8::Local<v8::Promise> CreateThumbnailsFromPaths(
+      v8::Isolate* isolate,
+      const std::vector<base::FilePath>& paths,
+      const gfx::Size& size);
+  static void SetThumbnailCacheLimit(int64_t bytes);
   static gin::Handle<NativeImage> CreateFromDataURL(v8::Isolate* isolate,
                                                     const GURL& url);
   static gin::Handle<NativeImage> CreateFromNamedImage(gin::Arguments* args,
@@ -116,6 +125,14 @@ class NativeImage : public gin::Wrappable<NativeImage> {
                                   base::DictionaryValue options);
   gin::Handle<NativeImage> Crop(v8::Isolate* isolate, const gfx::Rect& rect);
   std::string ToDataURL(gin::Arguments* args);
+  // Variants that encode and scale on the thread pool, off snapshots of the
+  // bitmaps.
+  v8::Local<v8::Promise> ToPNGAsync(gin::Arguments* args);
+  v8::Local<v8::Promise> ToJPEGAsync(v8::Isolate* isolate, int quality);
+  v8::Local<v8::Promise> ResizeAsync(gin::Arguments* args,
+                                     base::DictionaryValue options);
+  v8::Local<v8::Promise> CropAsync(v8::Isolate* isolate,
+                                   const gfx::Rect& rect);
   bool IsEmpty();
   gfx::Size GetSize(const absl::optional<float> scale_factor);
   float GetAspectRatio(const absl::optional<float> scale_factor);
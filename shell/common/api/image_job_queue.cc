@@ -0,0 +1,62 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/api/image_job_queue.h"
+
+#include <algorithm>
+
+#include "base/system/sys_info.h"
+#include "base/task/thread_pool.h"
+
+namespace electron {
+
+namespace api {
+
+// static
+ImageJobQueue* ImageJobQueue::GetInstance() {
+  static base::NoDestructor<ImageJobQueue> instance;
+  return instance.get();
+}
+
+ImageJobQueue::ImageJobQueue()
+    : max_running_(std::clamp(base::SysInfo::NumberOfProcessors() / 2, 1, 4)) {
+}
+
+ImageJobQueue::~ImageJobQueue() = default;
+
+void ImageJobQueue::Post(base::OnceClosure job) {
+  base::AutoLock auto_lock(lock_);
+  if (running_ >= max_running_) {
+    pending_.push(std::move(job));
+    return;
+  }
+  ++running_;
+  Start(std::move(job));
+}
+
+void ImageJobQueue::Start(base::OnceClosure job) {
+  // Jobs may read the images from disk.
+  base::ThreadPool::PostTask(
+      FROM_HERE,
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN},
+      base::BindOnce(&ImageJobQueue::Run, base::Unretained(this),
+                     std::move(job)));
+}
+
+void ImageJobQueue::Run(base::OnceClosure job) {
+  std::move(job).Run();
+
+  base::AutoLock auto_lock(lock_);
+  if (pending_.empty()) {
+    --running_;
+    return;
+  }
+  Start(std::move(pending_.front()));
+  pending_.pop();
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,69 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_API_IMAGE_JOB_QUEUE_H_
+#define SHELL_COMMON_API_IMAGE_JOB_QUEUE_H_
+
+#include <utility>
+
+#include "base/bind.h"
+#include "base/callback.h"
+#include "base/containers/queue.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/task/sequenced_task_runner.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+namespace electron {
+
+namespace api {
+
+// Runs the image decoding, encoding and scaling jobs of NativeImage on the
+// thread pool, a few at a time so that a burst of calls does not take every
+// worker.
+class ImageJobQueue {
+ public:
+  static ImageJobQueue* GetInstance();
+
+  // disable copy
+  ImageJobQueue(const ImageJobQueue&) = delete;
+  ImageJobQueue& operator=(const ImageJobQueue&) = delete;
+
+  // Runs |job| on the thread pool, then |reply| with its result on the
+  // current sequence.
+  template <typename T>
+  void PostJobAndReply(base::OnceCallback<T()> job,
+                       base::OnceCallback<void(T)> reply) {
+    Post(base::BindOnce(
+        [](base::OnceCallback<T()> job, base::OnceCallback<void(T)> reply,
+           scoped_refptr<base::SequencedTaskRunner> reply_runner) {
+          T result = std::move(job).Run();
+          reply_runner->PostTask(
+              FROM_HERE, base::BindOnce(std::move(reply), std::move(result)));
+        },
+        std::move(job), std::move(reply),
+        base::SequencedTaskRunnerHandle::Get()));
+  }
+
+ private:
+  friend class base::NoDestructor<ImageJobQueue>;
+
+  ImageJobQueue();
+  ~ImageJobQueue();
+
+  void Post(base::OnceClosure job);
+  void Start(base::OnceClosure job);
+  void Run(base::OnceClosure job);
+
+  base::Lock lock_;
+  const int max_running_;
+  int running_ = 0;
+  base::queue<base::OnceClosure> pending_;
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_API_IMAGE_JOB_QUEUE_H_
@@ -0,0 +1,244 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/api/thumbnail_service.h"
+
+#include <setjmp.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "base/barrier_closure.h"
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "shell/common/api/image_job_queue.h"
+#include "shell/common/asar/asar_util.h"
+#include "skia/ext/image_operations.h"
+#include "ui/gfx/codec/png_codec.h"
+
+extern "C" {
+#if defined(USE_SYSTEM_LIBJPEG)
+#include <jpeglib.h>
+#else
+#include "third_party/libjpeg_turbo/jpeglib.h"
+#endif
+}
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+constexpr size_t kDefaultCacheLimit = 64 * 1024 * 1024;
+
+// Scales |size| down to fit in |bounds|, keeping its aspect ratio.
+gfx::Size GetThumbnailSize(const gfx::Size& size, const gfx::Size& bounds) {
+  if (size.width() <= bounds.width() && size.height() <= bounds.height())
+    return size;
+  float scale = std::min(static_cast<float>(bounds.width()) / size.width(),
+                         static_cast<float>(bounds.height()) / size.height());
+  return gfx::Size(std::max(1, static_cast<int>(size.width() * scale)),
+                   std::max(1, static_cast<int>(size.height() * scale)));
+}
+
+struct JPEGErrorManager {
+  jpeg_error_mgr pub;
+  jmp_buf setjmp_buffer;
+};
+
+void OnJPEGError(j_common_ptr cinfo) {
+  auto* manager = reinterpret_cast<JPEGErrorManager*>(cinfo->err);
+  longjmp(manager->setjmp_buffer, 1);
+}
+
+// Decodes with the DCT scaling of libjpeg, at the smallest of 1/8, 1/4, 1/2
+// and 1 that still covers the thumbnail, which skips most of the work of
+// decoding large photos.
+bool DecodeJPEG(const std::string& data,
+                const gfx::Size& size,
+                SkBitmap* bitmap) {
+  jpeg_decompress_struct cinfo;
+  JPEGErrorManager error_manager;
+  cinfo.err = jpeg_std_error(&error_manager.pub);
+  error_manager.pub.error_exit = OnJPEGError;
+  // Nothing with a destructor may be created past this point.
+  if (setjmp(error_manager.setjmp_buffer)) {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo,
+               reinterpret_cast<unsigned char*>(const_cast<char*>(data.data())),
+               data.size());
+  if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+
+  gfx::Size image_size(cinfo.image_width, cinfo.image_height);
+  gfx::Size thumbnail_size = GetThumbnailSize(image_size, size);
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = 1;
+  for (unsigned int denom = 8; denom > 1; denom /= 2) {
+    if ((cinfo.image_width + denom - 1) / denom >=
+            static_cast<unsigned int>(thumbnail_size.width()) &&
+        (cinfo.image_height + denom - 1) / denom >=
+            static_cast<unsigned int>(thumbnail_size.height())) {
+      cinfo.scale_denom = denom;
+      break;
+    }
+  }
+  cinfo.out_color_space = kN32_SkColorType == kRGBA_8888_SkColorType
+                              ? JCS_EXT_RGBA
+                              : JCS_EXT_BGRA;
+  cinfo.dct_method = JDCT_IFAST;
+
+  jpeg_start_decompress(&cinfo);
+  if (!bitmap->tryAllocN32Pixels(cinfo.output_width, cinfo.output_height,
+                                 true)) {
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  while (cinfo.output_scanline < cinfo.output_height) {
+    JSAMPROW row =
+        static_cast<JSAMPROW>(bitmap->getAddr(0, cinfo.output_scanline));
+    jpeg_read_scanlines(&cinfo, &row, 1);
+  }
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  return true;
+}
+
+}  // namespace
+
+// static
+ThumbnailService* ThumbnailService::GetInstance() {
+  static base::NoDestructor<ThumbnailService> instance;
+  return instance.get();
+}
+
+ThumbnailService::ThumbnailService()
+    : cache_(base::MRUCache<Key, SkBitmap>::NO_AUTO_EVICT),
+      cache_limit_(kDefaultCacheLimit) {}
+
+ThumbnailService::~ThumbnailService() = default;
+
+void ThumbnailService::CreateThumbnails(
+    const std::vector<base::FilePath>& paths,
+    const gfx::Size& size,
+    ThumbnailsCallback callback) {
+  // The replies run on this sequence, so they fill the results in turn.
+  auto thumbnails = std::make_unique<std::vector<SkBitmap>>(paths.size());
+  std::vector<SkBitmap>* results = thumbnails.get();
+  base::RepeatingClosure done = base::BarrierClosure(
+      paths.size(),
+      base::BindOnce(
+          [](std::unique_ptr<std::vector<SkBitmap>> thumbnails,
+             ThumbnailsCallback callback) {
+            std::move(callback).Run(std::move(*thumbnails));
+          },
+          std::move(thumbnails), std::move(callback)));
+
+  for (size_t i = 0; i < paths.size(); ++i) {
+    ImageJobQueue::GetInstance()->PostJobAndReply(
+        base::BindOnce(&ThumbnailService::CreateThumbnail,
+                       base::Unretained(this), paths[i], size),
+        base::BindOnce(
+            [](std::vector<SkBitmap>* results, size_t index,
+               base::RepeatingClosure done, SkBitmap thumbnail) {
+              (*results)[index] = std::move(thumbnail);
+              done.Run();
+            },
+            results, i, done));
+  }
+}
+
+void ThumbnailService::SetCacheLimit(size_t bytes) {
+  base::AutoLock auto_lock(lock_);
+  cache_limit_ = bytes;
+  EvictLocked();
+}
+
+// static
+SkBitmap ThumbnailService::DecodeThumbnail(const std::string& data,
+                                           const gfx::Size& size) {
+  SkBitmap bitmap;
+  if (size.IsEmpty())
+    return bitmap;
+  if (!DecodeJPEG(data, size, &bitmap)) {
+    bitmap.reset();
+    if (!gfx::PNGCodec::Decode(
+            reinterpret_cast<const unsigned char*>(data.data()), data.size(),
+            &bitmap))
+      return SkBitmap();
+  }
+
+  gfx::Size bitmap_size(bitmap.width(), bitmap.height());
+  gfx::Size thumbnail_size = GetThumbnailSize(bitmap_size, size);
+  if (thumbnail_size == bitmap_size)
+    return bitmap;
+  return skia::ImageOperations::Resize(
+      bitmap, skia::ImageOperations::RESIZE_GOOD, thumbnail_size.width(),
+      thumbnail_size.height());
+}
+
+SkBitmap ThumbnailService::CreateThumbnail(const base::FilePath& path,
+                                           const gfx::Size& size) {
+  // Files in asar archives take the modification time of the archive.
+  base::FilePath file_path = path;
+  base::FilePath asar_path, relative_path;
+  if (asar::GetAsarArchivePath(path, &asar_path, &relative_path))
+    file_path = asar_path;
+  base::File::Info info;
+  if (size.IsEmpty() || !base::GetFileInfo(file_path, &info))
+    return SkBitmap();
+
+  Key key(path, info.last_modified, size.width(), size.height());
+  {
+    base::AutoLock auto_lock(lock_);
+    auto it = cache_.Get(key);
+    if (it != cache_.end())
+      return it->second;
+  }
+
+  std::string data;
+  if (!asar::ReadFileToString(path, &data))
+    return SkBitmap();
+  SkBitmap thumbnail = DecodeThumbnail(data, size);
+  if (thumbnail.isNull())
+    return thumbnail;
+  // The cache shares the pixels with the images it hands out.
+  thumbnail.setImmutable();
+
+  base::AutoLock auto_lock(lock_);
+  size_t bytes = thumbnail.computeByteSize();
+  if (bytes <= cache_limit_) {
+    auto it = cache_.Peek(key);
+    if (it != cache_.end()) {
+      cache_bytes_ -= it->second.computeByteSize();
+      cache_.Erase(it);
+    }
+    cache_.Put(key, thumbnail);
+    cache_bytes_ += bytes;
+    EvictLocked();
+  }
+  return thumbnail;
+}
+
+void ThumbnailService::EvictLocked() {
+  while (cache_bytes_ > cache_limit_ && !cache_.empty()) {
+    auto it = cache_.rbegin();
+    cache_bytes_ -= it->second.computeByteSize();
+    cache_.Erase(it);
+  }
+}
+
+}  // namespace api
+
+}  // namespace electron
@@ -0,0 +1,76 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_API_THUMBNAIL_SERVICE_H_
+#define SHELL_COMMON_API_THUMBNAIL_SERVICE_H_
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/no_destructor.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "base/time/time.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/size.h"
+
+namespace electron {
+
+namespace api {
+
+// Creates thumbnails of image files on the thread pool. JPEG files are
+// decoded straight to a smaller scale. The recent thumbnails are kept in an
+// LRU cache bounded in memory, keyed by path, modification time and size.
+class ThumbnailService {
+ public:
+  // Gets a thumbnail per path, null when the file could not be decoded.
+  using ThumbnailsCallback = base::OnceCallback<void(std::vector<SkBitmap>)>;
+
+  static ThumbnailService* GetInstance();
+
+  // disable copy
+  ThumbnailService(const ThumbnailService&) = delete;
+  ThumbnailService& operator=(const ThumbnailService&) = delete;
+
+  // The thumbnails fit in |size| and keep the aspect ratio of the images.
+  // |callback| runs on the calling sequence.
+  void CreateThumbnails(const std::vector<base::FilePath>& paths,
+                        const gfx::Size& size,
+                        ThumbnailsCallback callback);
+
+  // The memory the cache may use, in bytes. Zero disables it.
+  void SetCacheLimit(size_t bytes);
+
+  // Decodes |data| and scales it down to fit in |size|. Exposed for testing.
+  static SkBitmap DecodeThumbnail(const std::string& data,
+                                  const gfx::Size& size);
+
+ private:
+  friend class base::NoDestructor<ThumbnailService>;
+
+  using Key = std::tuple<base::FilePath, base::Time, int, int>;
+
+  ThumbnailService();
+  ~ThumbnailService();
+
+  // Runs on the thread pool.
+  SkBitmap CreateThumbnail(const base::FilePath& path, const gfx::Size& size);
+
+  void EvictLocked() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  base::Lock lock_;
+  base::MRUCache<Key, SkBitmap> cache_ GUARDED_BY(lock_);
+  size_t cache_bytes_ GUARDED_BY(lock_) = 0;
+  size_t cache_limit_ GUARDED_BY(lock_);
+};
+
+}  // namespace api
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_API_THUMBNAIL_SERVICE_H_
@@ -0,0 +1,80 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/api/thumbnail_service.h"
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+
+namespace electron {
+
+namespace api {
+
+namespace {
+
+SkBitmap CreateBitmap(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height, true);
+  bitmap.eraseARGB(0xff, 0x20, 0x80, 0xe0);
+  return bitmap;
+}
+
+std::string EncodeJPEG(const SkBitmap& bitmap) {
+  std::vector<unsigned char> encoded;
+  EXPECT_TRUE(gfx::JPEGCodec::Encode(bitmap, 90, &encoded));
+  return std::string(encoded.begin(), encoded.end());
+}
+
+std::string EncodePNG(const SkBitmap& bitmap) {
+  std::vector<unsigned char> encoded;
+  EXPECT_TRUE(gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded));
+  return std::string(encoded.begin(), encoded.end());
+}
+
+}  // namespace
+
+TEST(ThumbnailServiceTest, ScalesJPEGDownToFit) {
+  std::string jpeg = EncodeJPEG(CreateBitmap(1600, 1200));
+  SkBitmap thumbnail =
+      ThumbnailService::DecodeThumbnail(jpeg, gfx::Size(100, 100));
+  EXPECT_EQ(100, thumbnail.width());
+  EXPECT_EQ(75, thumbnail.height());
+  // Decoding keeps the colors.
+  SkColor color = thumbnail.getColor(50, 37);
+  EXPECT_NEAR(0x20, static_cast<int>(SkColorGetR(color)), 8);
+  EXPECT_NEAR(0xe0, static_cast<int>(SkColorGetB(color)), 8);
+}
+
+TEST(ThumbnailServiceTest, ScalesPNGDownToFit) {
+  std::string png = EncodePNG(CreateBitmap(300, 600));
+  SkBitmap thumbnail =
+      ThumbnailService::DecodeThumbnail(png, gfx::Size(100, 100));
+  EXPECT_EQ(50, thumbnail.width());
+  EXPECT_EQ(100, thumbnail.height());
+}
+
+TEST(ThumbnailServiceTest, KeepsSmallImages) {
+  std::string jpeg = EncodeJPEG(CreateBitmap(40, 30));
+  SkBitmap thumbnail =
+      ThumbnailService::DecodeThumbnail(jpeg, gfx::Size(100, 100));
+  EXPECT_EQ(40, thumbnail.width());
+  EXPECT_EQ(30, thumbnail.height());
+}
+
+TEST(ThumbnailServiceTest, FailsOnInvalidData) {
+  EXPECT_TRUE(
+      ThumbnailService::DecodeThumbnail("not an image", gfx::Size(100, 100))
+          .isNull());
+  EXPECT_TRUE(ThumbnailService::DecodeThumbnail(
+                  EncodePNG(CreateBitmap(10, 10)), gfx::Size())
+                  .isNull());
+}
+
+}  // namespace api
+
+}  // namespace electron
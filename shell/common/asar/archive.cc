@@ -4,23 +4,30 @@
 
 #include "shell/common/asar/archive.h"
 
+#include <atomic>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/check.h"
+#include "base/environment.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/hash/hash.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
+#include "base/no_destructor.h"
 #include "base/pickle.h"
-#include "base/strings/string_number_conversions.h"
 #include "base/task/post_task.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/values.h"
 #include "electron/fuses.h"
+#include "shell/common/asar/archive_index.h"
 #include "shell/common/asar/asar_util.h"
 #include "shell/common/asar/scoped_temporary_file.h"
+#include "third_party/crc32c/src/include/crc32c/crc32c.h"
 
 #if defined(OS_WIN)
 #include <io.h>
@@ -30,127 +37,197 @@ namespace asar {
 
 namespace {
 
-#if defined(OS_WIN)
-const char kSeparators[] = "\\/";
-#else
-const char kSeparators[] = "/";
-#endif
+// Header of the precomputed index sidecar ("app.asar.idx"), which is followed
+// by the serialized ArchiveIndex.
+struct IndexFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  // Size and hash of the pickled JSON header the index was built from, used
+  // to detect a stale sidecar.
+  uint32_t archive_header_size;
+  uint32_t archive_header_hash;
+  // Size and CRC32C of the serialized index, which detect a sidecar that was
+  // corrupted or only partly written. ArchiveIndex bounds-checks every
+  // reference of an index loaded from disk too, but a damaged index that
+  // stays in bounds would serve wrong offsets, sizes or link targets.
+  uint32_t index_size;
+  uint32_t index_checksum;
+};
+static_assert(sizeof(IndexFileHeader) % 8 == 0,
+              "The index must stay 8-byte aligned in the file");
+
+constexpr uint32_t kIndexFileMagic = 0x49524153;  // "SARI"
+constexpr uint32_t kIndexFileVersion = 3;
+
+// Total size of the validated copies of files an archive keeps, enough for
+// the bundles of most apps.
+constexpr size_t kVerifiedFilesLimit = 32 * 1024 * 1024;
+
+base::FilePath GetIndexFilePath(const base::FilePath& archive_path) {
+  return archive_path.AddExtension(FILE_PATH_LITERAL("idx"));
+}
 
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  const std::string* link = dir->FindStringKey("link");
-  if (link != nullptr) {
-    const base::DictionaryValue* linked_node = nullptr;
-    if (!GetNodeFromPath(*link, root, &linked_node))
-      return false;
-    dir = linked_node;
+// Checks that |contents|, laid out as an IndexFileHeader followed by the
+// index, was built from |archive_header|, and sets |index_size|. The checksum
+// of the index is verified when |check_index| is set.
+bool CheckIndexFile(const base::FilePath& archive_path,
+                    base::span<const uint8_t> contents,
+                    base::span<const uint8_t> archive_header,
+                    bool check_index,
+                    uint32_t* index_size) {
+  if (contents.size() < sizeof(IndexFileHeader))
+    return false;
+
+  IndexFileHeader header;
+  memcpy(&header, contents.data(), sizeof(header));
+  if (header.magic != kIndexFileMagic || header.version != kIndexFileVersion ||
+      header.archive_header_size != archive_header.size() ||
+      header.index_size > contents.size() - sizeof(header)) {
+    LOG(WARNING) << "Ignoring outdated asar index for " << archive_path.value();
+    return false;
   }
 
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
-}
+  if (header.archive_header_hash != base::PersistentHash(archive_header)) {
+    LOG(WARNING) << "Ignoring stale asar index for " << archive_path.value();
+    return false;
+  }
 
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  if (name.empty()) {
-    *out = root;
-    return true;
+  if (check_index &&
+      header.index_checksum !=
+          crc32c::Crc32c(contents.data() + sizeof(header), header.index_size)) {
+    LOG(WARNING) << "Ignoring corrupted asar index for "
+                 << archive_path.value();
+    return false;
   }
 
-  const base::DictionaryValue* files = nullptr;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
+  *index_size = header.index_size;
+  return true;
 }
 
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path.empty()) {
-    *out = root;
-    return true;
-  }
+// Maps the sidecar of |archive_path| and attaches to it, provided it was built
+// from |archive_header|. Returns null when it is missing, stale or corrupted.
+std::unique_ptr<ArchiveIndex> LoadIndexFile(
+    const base::FilePath& archive_path,
+    base::span<const uint8_t> archive_header) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::File file(GetIndexFilePath(archive_path),
+                  base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return nullptr;
+
+  auto mapping = std::make_unique<base::MemoryMappedFile>();
+  if (!mapping->Initialize(std::move(file)))
+    return nullptr;
+
+  uint32_t index_size;
+  if (!CheckIndexFile(archive_path,
+                      base::make_span(mapping->data(), mapping->length()),
+                      archive_header, true, &index_size))
+    return nullptr;
+
+  return ArchiveIndex::CreateFromMapping(std::move(mapping),
+                                         sizeof(IndexFileHeader), index_size);
+}
 
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = nullptr;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
+Archive::SharedIndexProvider& GetSharedIndexProvider() {
+  static base::NoDestructor<Archive::SharedIndexProvider> provider;
+  return *provider;
+}
 
-    dir = child;
-    path.erase(0, delimiter_position + 1);
-  }
+std::atomic<size_t> g_shared_index_bytes{0};
+
+// Attaches to the index of |archive_path| shared by the browser process,
+// provided it was built from |archive_header|. Returns null when no index is
+// shared for it.
+std::unique_ptr<ArchiveIndex> LoadSharedIndex(
+    const base::FilePath& archive_path,
+    base::span<const uint8_t> archive_header) {
+  const Archive::SharedIndexProvider& provider = GetSharedIndexProvider();
+  if (!provider)
+    return nullptr;
+
+  base::ReadOnlySharedMemoryRegion region = provider.Run(archive_path);
+  if (!region.IsValid())
+    return nullptr;
+
+  base::ReadOnlySharedMemoryMapping mapping = region.Map();
+  if (!mapping.IsValid())
+    return nullptr;
+
+  // The region was serialized by the browser process from the index in its
+  // memory, so it is not checksummed again.
+  uint32_t index_size;
+  if (!CheckIndexFile(archive_path, mapping.GetMemoryAsSpan<uint8_t>(),
+                      archive_header, false, &index_size))
+    return nullptr;
+
+  auto index = ArchiveIndex::CreateFromSharedMemory(
+      std::move(mapping), sizeof(IndexFileHeader), index_size);
+  if (!index)
+    return nullptr;
+
+  // Each archive a renderer attaches to spares it a private copy of the index.
+  g_shared_index_bytes += index->memory_usage();
+  return index;
+}
 
-  return GetChildNode(root, path, dir, out);
+// Builds the contents of an index file for |index_data|.
+std::vector<uint8_t> SerializeIndexFile(
+    base::span<const uint8_t> archive_header,
+    base::span<const uint8_t> index_data) {
+  IndexFileHeader header = {};
+  header.magic = kIndexFileMagic;
+  header.version = kIndexFileVersion;
+  header.archive_header_size = static_cast<uint32_t>(archive_header.size());
+  header.archive_header_hash = base::PersistentHash(archive_header);
+  header.index_size = static_cast<uint32_t>(index_data.size());
+  header.index_checksum = crc32c::Crc32c(index_data.data(), index_data.size());
+
+  std::vector<uint8_t> contents(sizeof(header) + index_data.size());
+  memcpy(contents.data(), &header, sizeof(header));
+  memcpy(contents.data() + sizeof(header), index_data.data(),
+         index_data.size());
+  return contents;
 }
 
-bool FillFileInfoWithNode(Archive::FileInfo* info,
-                          uint32_t header_size,
-                          bool load_integrity,
-                          const base::DictionaryValue* node) {
-  int size;
-  if (!node->GetInteger("size", &size))
+bool FillFileInfoWithEntry(Archive::FileInfo* info,
+                           uint32_t header_size,
+                           bool load_integrity,
+                           bool require_integrity,
+                           const ArchiveIndex& index,
+                           const ArchiveIndex::Entry& entry) {
+  if (entry.type != ArchiveIndex::EntryType::kFile)
     return false;
-  info->size = static_cast<uint32_t>(size);
+  info->size = entry.size;
 
-  if (node->GetBoolean("unpacked", &info->unpacked) && info->unpacked)
+  info->unpacked = (entry.flags & ArchiveIndex::kUnpacked) != 0;
+  if (info->unpacked)
     return true;
 
-  std::string offset;
-  if (!node->GetString("offset", &offset))
-    return false;
-  if (!base::StringToUint64(offset, &info->offset))
-    return false;
-  info->offset += header_size;
+  info->offset = entry.offset + header_size;
+  info->executable = (entry.flags & ArchiveIndex::kExecutable) != 0;
 
-  node->GetBoolean("executable", &info->executable);
+  if (!load_integrity)
+    return true;
 
-#if defined(OS_MAC)
-  if (load_integrity &&
-      electron::fuses::IsEmbeddedAsarIntegrityValidationEnabled()) {
-    const base::DictionaryValue* integrity;
-    if (node->GetDictionary("integrity", &integrity)) {
-      IntegrityPayload integrity_payload;
-      std::string algorithm;
-      const base::ListValue* blocks;
-      int block_size;
-      if (integrity->GetString("algorithm", &algorithm) &&
-          integrity->GetString("hash", &integrity_payload.hash) &&
-          integrity->GetInteger("blockSize", &block_size) &&
-          integrity->GetList("blocks", &blocks) && block_size > 0) {
-        integrity_payload.block_size = static_cast<uint32_t>(block_size);
-        for (size_t i = 0; i < blocks->GetList().size(); i++) {
-          std::string block;
-          if (!blocks->GetString(i, &block)) {
-            LOG(FATAL)
-                << "Invalid block integrity value for file in ASAR archive";
-          }
-          integrity_payload.blocks.push_back(block);
-        }
-        if (algorithm == "SHA256") {
-          integrity_payload.algorithm = HashAlgorithm::SHA256;
-          info->integrity = std::move(integrity_payload);
-        }
-      }
-    }
+  if (entry.flags & ArchiveIndex::kIntegrityMissing) {
+    // Validation that was only asked for by ELECTRON_ASAR_VALIDATE_INTEGRITY
+    // skips the archives built without integrity.
+    if (!require_integrity)
+      return true;
+    LOG(FATAL) << "Failed to read integrity for file in ASAR archive";
+    return false;
+  }
 
-    if (!info->integrity.has_value()) {
-      LOG(FATAL) << "Failed to read integrity for file in ASAR archive";
-      return false;
-    }
+  if (entry.flags & ArchiveIndex::kHasIntegrity) {
+    IntegrityPayload integrity_payload;
+    integrity_payload.algorithm = static_cast<HashAlgorithm>(entry.algorithm);
+    integrity_payload.hash = std::string(index.GetString(entry.integrity_hash));
+    integrity_payload.block_size = entry.block_size;
+    for (const auto& block : index.GetBlocks(entry))
+      integrity_payload.blocks.emplace_back(index.GetString(block));
+    info->integrity = std::move(integrity_payload);
   }
-#endif
 
   return true;
 }
@@ -167,7 +244,11 @@ Archive::FileInfo::FileInfo()
 Archive::FileInfo::~FileInfo() = default;
 
 Archive::Archive(const base::FilePath& path)
-    : initialized_(false), path_(path), file_(base::File::FILE_OK) {
+    : initialized_(false),
+      path_(path),
+      file_(base::File::FILE_OK),
+      verified_files_(VerifiedFiles::NO_AUTO_EVICT),
+      verified_files_limit_(kVerifiedFilesLimit) {
   base::ThreadRestrictions::ScopedAllowIO allow_io;
   file_.Initialize(path_, base::File::FLAG_OPEN | base::File::FLAG_READ);
 #if defined(OS_WIN)
@@ -265,18 +346,66 @@ bool Archive::Init() {
   }
 #endif
 
+  header_size_ = 8 + size;
+  base::span<const uint8_t> archive_header =
+      base::as_bytes(base::make_span(buf));
+
+  // Renderers attach to the index the browser process already built. The
+  // browser is trusted, so unlike the sidecar it is used even when the header
+  // was validated.
+  index_ = LoadSharedIndex(path_, archive_header);
+
+  // A precomputed index lets us skip parsing the JSON header. The sidecar is
+  // not covered by the header integrity, so it is ignored when the header had
+  // to be validated.
+  if (!index_ && !header_validated_)
+    index_ = LoadIndexFile(path_, archive_header);
+
+  if (index_) {
+    InitIntegrityValidation();
+    return true;
+  }
+
   absl::optional<base::Value> value = base::JSONReader::Read(header);
   if (!value || !value->is_dict()) {
     LOG(ERROR) << "Failed to parse header";
     return false;
   }
 
-  header_size_ = 8 + size;
-  header_ = base::DictionaryValue::From(
-      base::Value::ToUniquePtrValue(std::move(*value)));
+  // Only the flattened index is kept, the parsed tree is dropped here.
+  index_ = ArchiveIndex::Create(*value);
+  if (!index_) {
+    LOG(ERROR) << "Failed to index header";
+    return false;
+  }
+
+  InitIntegrityValidation();
   return true;
 }
 
+// static
+void Archive::SetSharedIndexProvider(SharedIndexProvider provider) {
+  GetSharedIndexProvider() = std::move(provider);
+}
+
+// static
+size_t Archive::GetSharedIndexBytes() {
+  return g_shared_index_bytes;
+}
+
+void Archive::InitIntegrityValidation() {
+#if defined(OS_MAC)
+  require_integrity_ =
+      header_validated_ &&
+      electron::fuses::IsEmbeddedAsarIntegrityValidationEnabled();
+#endif
+  // Lets the validation be exercised on every platform, the header itself is
+  // only validated on macOS.
+  validate_integrity_ =
+      require_integrity_ ||
+      base::Environment::Create()->HasVar("ELECTRON_ASAR_VALIDATE_INTEGRITY");
+}
+
 #if !defined(OS_MAC)
 absl::optional<IntegrityPayload> Archive::HeaderIntegrity() const {
   return absl::nullopt;
@@ -288,76 +417,78 @@ absl::optional<base::FilePath> Archive::RelativePath() const {
 #endif
 
 bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) const {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  const ArchiveIndex::Entry* entry = index_->Find(path.AsUTF8Unsafe());
+  if (!entry)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
+  if (entry->type == ArchiveIndex::EntryType::kLink)
+    return GetFileInfo(
+        base::FilePath::FromUTF8Unsafe(index_->GetString(entry->link)), info);
 
-  return FillFileInfoWithNode(info, header_size_, header_validated_, node);
+  return FillFileInfoWithEntry(info, header_size_, validate_integrity_,
+                               require_integrity_, *index_, *entry);
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) const {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  const ArchiveIndex::Entry* entry = index_->Find(path.AsUTF8Unsafe());
+  if (!entry)
     return false;
 
-  if (node->FindKey("link")) {
+  if (entry->type == ArchiveIndex::EntryType::kLink) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->FindKey("files")) {
+  if (entry->type == ArchiveIndex::EntryType::kDirectory) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, header_validated_, node);
+  return FillFileInfoWithEntry(stats, header_size_, validate_integrity_,
+                               require_integrity_, *index_, *entry);
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* files) const {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  const ArchiveIndex::Entry* entry = index_->Find(path.AsUTF8Unsafe());
+  if (!entry)
     return false;
 
-  const base::DictionaryValue* files_node;
-  if (!GetFilesNode(header_.get(), node, &files_node))
+  entry = index_->ResolveLink(entry);
+  if (!entry || entry->type != ArchiveIndex::EntryType::kDirectory)
     return false;
 
-  base::DictionaryValue::Iterator iter(*files_node);
-  while (!iter.IsAtEnd()) {
-    files->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
+  base::span<const uint32_t> children = index_->GetChildren(*entry);
+  files->reserve(files->size() + children.size());
+  for (uint32_t child : children) {
+    files->push_back(base::FilePath::FromUTF8Unsafe(
+        index_->GetName(index_->GetEntry(child))));
   }
   return true;
 }
 
 bool Archive::Realpath(const base::FilePath& path,
                        base::FilePath* realpath) const {
-  if (!header_)
+  if (!index_)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  const ArchiveIndex::Entry* entry = index_->Find(path.AsUTF8Unsafe());
+  if (!entry)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  if (entry->type == ArchiveIndex::EntryType::kLink) {
+    *realpath = base::FilePath::FromUTF8Unsafe(index_->GetString(entry->link));
     return true;
   }
 
@@ -366,7 +497,7 @@ bool Archive::Realpath(const base::FilePath& path,
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
-  if (!header_)
+  if (!index_)
     return false;
 
   base::AutoLock auto_lock(external_files_lock_);
@@ -404,6 +535,128 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
   return true;
 }
 
+scoped_refptr<base::RefCountedMemory> Archive::ReadFileBytes(
+    const base::FilePath& path,
+    bool* mapped) const {
+  if (mapped)
+    *mapped = false;
+  FileInfo info;
+  if (!GetFileInfo(path, &info) || info.unpacked)
+    return nullptr;
+
+  if (info.integrity.has_value())
+    return ReadVerifiedFile(info);
+
+  base::span<const uint8_t> data = GetMappedData();
+  if (info.offset + info.size > data.size())
+    return nullptr;
+
+  if (mapped)
+    *mapped = true;
+  return base::MakeRefCounted<base::RefCountedStaticMemory>(
+      data.data() + info.offset, info.size);
+}
+
+scoped_refptr<base::RefCountedMemory> Archive::ReadVerifiedFile(
+    const FileInfo& info) const {
+  {
+    base::AutoLock auto_lock(verified_files_lock_);
+    auto it = verified_files_.Get(info.offset);
+    if (it != verified_files_.end())
+      return it->second;
+  }
+
+  base::span<const uint8_t> data = GetMappedData();
+  if (info.offset + info.size > data.size())
+    return nullptr;
+
+  // The bytes are copied before being validated, so that the bytes handed out
+  // are the validated ones whatever happens to the file on disk.
+  base::span<const uint8_t> file_data = data.subspan(info.offset, info.size);
+  std::vector<uint8_t> contents(file_data.begin(), file_data.end());
+  ValidateIntegrityOrDie(contents, info.integrity.value());
+  scoped_refptr<base::RefCountedBytes> verified =
+      base::RefCountedBytes::TakeVector(&contents);
+
+  base::AutoLock auto_lock(verified_files_lock_);
+  // Files larger than the limit are not kept, and another thread may have
+  // kept its copy meanwhile.
+  if (info.size <= verified_files_limit_ &&
+      verified_files_.Peek(info.offset) == verified_files_.end()) {
+    verified_files_.Put(info.offset, verified);
+    verified_files_bytes_ += info.size;
+    EvictVerifiedFilesLocked();
+  }
+  return verified;
+}
+
+void Archive::SetVerifiedFilesLimitForTesting(size_t bytes) {
+  base::AutoLock auto_lock(verified_files_lock_);
+  verified_files_limit_ = bytes;
+  EvictVerifiedFilesLocked();
+}
+
+void Archive::EvictVerifiedFilesLocked() const {
+  while (verified_files_bytes_ > verified_files_limit_ &&
+         !verified_files_.empty()) {
+    auto it = verified_files_.rbegin();
+    verified_files_bytes_ -= it->second->size();
+    verified_files_.Erase(it);
+  }
+}
+
+base::span<const uint8_t> Archive::GetMappedData() const {
+  base::AutoLock auto_lock(mapping_lock_);
+  if (!mapping_attempted_) {
+    mapping_attempted_ = true;
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    auto mapping = std::make_unique<base::MemoryMappedFile>();
+    if (file_.IsValid() && mapping->Initialize(file_.Duplicate()))
+      mapping_ = std::move(mapping);
+    else
+      LOG(WARNING) << "Failed to map " << path_.value();
+  }
+
+  if (!mapping_)
+    return base::span<const uint8_t>();
+  return base::make_span(mapping_->data(), mapping_->length());
+}
+
+bool Archive::ReadArchiveHeader(std::vector<uint8_t>* archive_header) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  archive_header->resize(header_size_ - 8);
+  return file_.ReadAndCheck(8, *archive_header);
+}
+
+bool Archive::WriteIndexFile(const base::FilePath& path) {
+  std::vector<uint8_t> archive_header;
+  if (!index_ || !ReadArchiveHeader(&archive_header))
+    return false;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  return base::WriteFile(path.empty() ? GetIndexFilePath(path_) : path,
+                         SerializeIndexFile(archive_header, index_->data()));
+}
+
+base::ReadOnlySharedMemoryRegion Archive::ShareIndex() {
+  base::AutoLock auto_lock(shared_index_lock_);
+  if (!shared_index_.IsValid()) {
+    std::vector<uint8_t> archive_header;
+    if (!index_ || !ReadArchiveHeader(&archive_header))
+      return base::ReadOnlySharedMemoryRegion();
+
+    std::vector<uint8_t> contents =
+        SerializeIndexFile(archive_header, index_->data());
+    base::MappedReadOnlyRegion shared =
+        base::ReadOnlySharedMemoryRegion::Create(contents.size());
+    if (!shared.IsValid())
+      return base::ReadOnlySharedMemoryRegion();
+    memcpy(shared.mapping.memory(), contents.data(), contents.size());
+    shared_index_ = std::move(shared.region);
+  }
+  return shared_index_.Duplicate();
+}
+
 int Archive::GetUnsafeFD() const {
   return fd_;
 }
@@ -10,17 +10,23 @@
 #include <unordered_map>
 #include <vector>
 
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/containers/span.h"
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/synchronization/lock.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 
 namespace base {
-class DictionaryValue;
+class MemoryMappedFile;
 }
 
 namespace asar {
 
+class ArchiveIndex;
 class ScopedTemporaryFile;
 
 enum HashAlgorithm {
@@ -59,6 +65,12 @@ class Archive {
     bool is_link;
   };
 
+  // Returns the serialized index of the archive at a path as built by another
+  // process, or an invalid region when it is not available.
+  using SharedIndexProvider =
+      base::RepeatingCallback<base::ReadOnlySharedMemoryRegion(
+          const base::FilePath&)>;
+
   explicit Archive(const base::FilePath& path);
   virtual ~Archive();
 
@@ -69,6 +81,13 @@ class Archive {
   // Read and parse the header.
   bool Init();
 
+  // Lets Init() attach to indices shared by the browser process instead of
+  // parsing the header. Must be set before any archive is opened.
+  static void SetSharedIndexProvider(SharedIndexProvider provider);
+
+  // Bytes of index this process attached to instead of building its own.
+  static size_t GetSharedIndexBytes();
+
   absl::optional<IntegrityPayload> HeaderIntegrity() const;
   absl::optional<base::FilePath> RelativePath() const;
 
@@ -89,6 +108,38 @@ class Archive {
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
+  // Returns the content of a packed file, or null for unpacked files or when
+  // the archive could not be mapped; callers should then read and validate
+  // the file.
+  //
+  // When its integrity is not validated, the content points straight into
+  // the memory mapping of the archive and |*mapped| is set. It stays valid
+  // for the lifetime of the Archive, but it follows changes made to the
+  // archive on disk, and reading it raises SIGBUS once the archive is
+  // truncated. Callers should copy it rather than keep it around.
+  //
+  // Otherwise the file is copied out of the mapping and the copy is
+  // validated, so the bytes returned are the validated ones whatever happens
+  // to the archive afterwards. The copies of the most recently read files are
+  // kept, up to a total size, so hot files are only validated once.
+  scoped_refptr<base::RefCountedMemory> ReadFileBytes(
+      const base::FilePath& path,
+      bool* mapped) const;
+
+  // Returns the memory mapping of the whole archive, mapping it on first use.
+  // Returns an empty span if the archive could not be mapped.
+  base::span<const uint8_t> GetMappedData() const;
+
+  // Writes the precomputed index of the archive to |path|, which defaults to
+  // the "<archive>.idx" sidecar that Init() looks for. Archives with such a
+  // sidecar open without parsing their JSON header.
+  bool WriteIndexFile(const base::FilePath& path);
+
+  // Returns a read-only copy of the index for other processes to attach to,
+  // in the same format as the sidecar. The region is created on first use and
+  // shared by all callers. Returns an invalid region on failure.
+  base::ReadOnlySharedMemoryRegion ShareIndex();
+
   // Returns the file's fd.
   // Using this fd will not validate the integrity of any files
   // you read out of the ASAR manually.  Callers are responsible
@@ -97,14 +148,51 @@ class Archive {
 
   base::FilePath path() const { return path_; }
 
+  // Caps the total size of the validated copies kept by ReadFileBytes().
+  void SetVerifiedFilesLimitForTesting(size_t bytes);
+
  private:
+  using VerifiedFiles =
+      base::HashingMRUCache<uint64_t, scoped_refptr<base::RefCountedBytes>>;
+
+  // Decides whether file integrity is validated, once the index is loaded.
+  void InitIntegrityValidation();
+
+  // Returns the validated copy of a packed file, see ReadFileBytes().
+  scoped_refptr<base::RefCountedMemory> ReadVerifiedFile(
+      const FileInfo& info) const;
+  void EvictVerifiedFilesLocked() const;
+
+  // Reads the pickled JSON header the index was built from.
+  bool ReadArchiveHeader(std::vector<uint8_t>* archive_header);
+
   bool initialized_;
   bool header_validated_ = false;
+  // Whether the integrity of the files is validated when reading them, and
+  // whether files without integrity are fatal rather than skipped.
+  bool validate_integrity_ = false;
+  bool require_integrity_ = false;
   const base::FilePath path_;
   base::File file_;
   int fd_ = -1;
   uint32_t header_size_ = 0;
-  std::unique_ptr<base::DictionaryValue> header_;
+  std::unique_ptr<ArchiveIndex> index_;
+
+  // Lazily created read-only mapping of the whole archive.
+  mutable base::Lock mapping_lock_;
+  mutable bool mapping_attempted_ = false;
+  mutable std::unique_ptr<base::MemoryMappedFile> mapping_;
+
+  // Validated copies of the most recently read files, by offset. Copies that
+  // are evicted stay alive as long as a caller references them.
+  mutable base::Lock verified_files_lock_;
+  mutable VerifiedFiles verified_files_;
+  mutable size_t verified_files_bytes_ = 0;
+  size_t verified_files_limit_;
+
+  // Index handed to other processes, see ShareIndex().
+  base::Lock shared_index_lock_;
+  base::ReadOnlySharedMemoryRegion shared_index_;
 
   // Cached external temporary files.
   base::Lock external_files_lock_;
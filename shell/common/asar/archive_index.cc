@@ -0,0 +1,436 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/archive_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "shell/common/asar/archive.h"
+
+namespace asar {
+
+namespace {
+
+// The index is stored as one blob with the following layout, every table
+// being naturally aligned:
+//
+//   BlobHeader
+//   Entry      entries[entry_count]
+//   uint32_t   sorted[entry_count]
+//   uint32_t   children[children_count]
+//   StringRef  blocks[block_count]
+//   char       strings[strings_size]
+struct BlobHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entry_count;
+  uint32_t children_count;
+  uint32_t block_count;
+  uint32_t strings_size;
+};
+static_assert(sizeof(BlobHeader) % 8 == 0, "Header must keep alignment");
+
+constexpr uint32_t kBlobMagic = 0x58444941;  // "AIDX"
+constexpr uint32_t kBlobVersion = 2;
+
+using Entry = ArchiveIndex::Entry;
+using EntryType = ArchiveIndex::EntryType;
+using StringRef = ArchiveIndex::StringRef;
+
+// Separators of the paths being looked up. The paths of the index use "/".
+#if defined(OS_WIN)
+constexpr char kSeparators[] = "/\\";
+#else
+constexpr char kSeparators[] = "/";
+#endif
+
+// Compares a path of the index with a path being looked up, as if the
+// separators of the latter were "/", without copying it.
+int ComparePath(base::StringPiece index_path, base::StringPiece path) {
+#if defined(OS_WIN)
+  size_t length = std::min(index_path.size(), path.size());
+  for (size_t i = 0; i < length; ++i) {
+    unsigned char a = index_path[i];
+    unsigned char b = path[i] == '\\' ? '/' : path[i];
+    if (a != b)
+      return a < b ? -1 : 1;
+  }
+  if (index_path.size() == path.size())
+    return 0;
+  return index_path.size() < path.size() ? -1 : 1;
+#else
+  return index_path.compare(path);
+#endif
+}
+
+class Builder {
+ public:
+  Builder() = default;
+
+  void Build(const base::Value& root) {
+    AddEntry(&root, base::StringPiece());
+    // Breadth-first so that the children of a directory are contiguous.
+    for (size_t i = 0; i < nodes_.size(); ++i)
+      FillEntry(static_cast<uint32_t>(i));
+  }
+
+  std::vector<uint64_t> Pack() const {
+    std::vector<uint32_t> sorted(entries_.size());
+    for (uint32_t i = 0; i < sorted.size(); ++i)
+      sorted[i] = i;
+    std::sort(sorted.begin(), sorted.end(), [this](uint32_t a, uint32_t b) {
+      return GetString(entries_[a].path) < GetString(entries_[b].path);
+    });
+
+    BlobHeader header = {};
+    header.magic = kBlobMagic;
+    header.version = kBlobVersion;
+    header.entry_count = static_cast<uint32_t>(entries_.size());
+    header.children_count = static_cast<uint32_t>(children_.size());
+    header.block_count = static_cast<uint32_t>(blocks_.size());
+    header.strings_size = static_cast<uint32_t>(strings_.size());
+
+    size_t size = sizeof(header) + entries_.size() * sizeof(Entry) +
+                  sorted.size() * sizeof(uint32_t) +
+                  children_.size() * sizeof(uint32_t) +
+                  blocks_.size() * sizeof(StringRef) + strings_.size();
+    std::vector<uint64_t> storage((size + 7) / 8);
+    char* out = reinterpret_cast<char*>(storage.data());
+    out = Append(out, &header, sizeof(header));
+    out = Append(out, entries_.data(), entries_.size() * sizeof(Entry));
+    out = Append(out, sorted.data(), sorted.size() * sizeof(uint32_t));
+    out = Append(out, children_.data(), children_.size() * sizeof(uint32_t));
+    out = Append(out, blocks_.data(), blocks_.size() * sizeof(StringRef));
+    Append(out, strings_.data(), strings_.size());
+    return storage;
+  }
+
+ private:
+  static char* Append(char* out, const void* data, size_t size) {
+    if (size)
+      memcpy(out, data, size);
+    return out + size;
+  }
+
+  base::StringPiece GetString(StringRef ref) const {
+    return base::StringPiece(strings_).substr(ref.offset, ref.length);
+  }
+
+  StringRef AddString(base::StringPiece str) {
+    StringRef ref = {static_cast<uint32_t>(strings_.size()),
+                     static_cast<uint32_t>(str.size())};
+    strings_.append(str.data(), str.size());
+    return ref;
+  }
+
+  uint32_t AddEntry(const base::Value* node, base::StringPiece path) {
+    Entry entry = {};
+    entry.path = AddString(path);
+    entries_.push_back(entry);
+    nodes_.push_back(node);
+    return static_cast<uint32_t>(entries_.size() - 1);
+  }
+
+  void FillEntry(uint32_t index) {
+    const base::Value* node = nodes_[index];
+    // Copy the path since |strings_| may grow below.
+    const std::string path(GetString(entries_[index].path));
+
+    const std::string* link = node->FindStringKey("link");
+    if (link) {
+      entries_[index].type = EntryType::kLink;
+      entries_[index].link = AddString(*link);
+      return;
+    }
+
+    const base::Value* files = node->FindDictKey("files");
+    if (files) {
+      uint32_t children_begin = static_cast<uint32_t>(children_.size());
+      for (const auto it : files->DictItems()) {
+        if (!it.second.is_dict())
+          continue;
+        std::string child_path =
+            path.empty() ? it.first : path + "/" + it.first;
+        children_.push_back(AddEntry(&it.second, child_path));
+      }
+      Entry& entry = entries_[index];
+      entry.type = EntryType::kDirectory;
+      entry.children_begin = children_begin;
+      entry.children_count =
+          static_cast<uint32_t>(children_.size()) - children_begin;
+      return;
+    }
+
+    FillFileEntry(node, &entries_[index]);
+  }
+
+  void FillFileEntry(const base::Value* node, Entry* entry) {
+    entry->type = EntryType::kInvalid;
+
+    absl::optional<int> size = node->FindIntKey("size");
+    if (!size)
+      return;
+    entry->size = static_cast<uint32_t>(*size);
+
+    if (node->FindBoolKey("unpacked").value_or(false)) {
+      entry->type = EntryType::kFile;
+      entry->flags |= ArchiveIndex::kUnpacked;
+      return;
+    }
+
+    const std::string* offset = node->FindStringKey("offset");
+    if (!offset || !base::StringToUint64(*offset, &entry->offset))
+      return;
+
+    entry->type = EntryType::kFile;
+    if (node->FindBoolKey("executable").value_or(false))
+      entry->flags |= ArchiveIndex::kExecutable;
+
+    if (FillIntegrity(node->FindDictKey("integrity"), entry))
+      entry->flags |= ArchiveIndex::kHasIntegrity;
+    else
+      entry->flags |= ArchiveIndex::kIntegrityMissing;
+  }
+
+  bool FillIntegrity(const base::Value* integrity, Entry* entry) {
+    if (!integrity)
+      return false;
+
+    const std::string* algorithm = integrity->FindStringKey("algorithm");
+    const std::string* hash = integrity->FindStringKey("hash");
+    absl::optional<int> block_size = integrity->FindIntKey("blockSize");
+    const base::Value* blocks = integrity->FindListKey("blocks");
+    if (!algorithm || !hash || !block_size || !blocks || *block_size <= 0)
+      return false;
+
+    if (*algorithm != "SHA256")
+      return false;
+
+    uint32_t blocks_begin = static_cast<uint32_t>(blocks_.size());
+    for (const auto& block : blocks->GetList()) {
+      if (!block.is_string()) {
+        blocks_.resize(blocks_begin);
+        return false;
+      }
+      blocks_.push_back(AddString(block.GetString()));
+    }
+
+    entry->algorithm = static_cast<uint8_t>(HashAlgorithm::SHA256);
+    entry->integrity_hash = AddString(*hash);
+    entry->block_size = static_cast<uint32_t>(*block_size);
+    entry->blocks_begin = blocks_begin;
+    entry->blocks_count = static_cast<uint32_t>(blocks_.size()) - blocks_begin;
+    return true;
+  }
+
+  std::vector<Entry> entries_;
+  std::vector<const base::Value*> nodes_;
+  std::vector<uint32_t> children_;
+  std::vector<StringRef> blocks_;
+  std::string strings_;
+};
+
+bool InRange(uint32_t begin, uint32_t count, size_t size) {
+  return begin <= size && count <= size - begin;
+}
+
+// Stands for the entries an index loaded from disk references out of bounds.
+constexpr Entry kMissingEntry = {{0, 0}, {0, 0}, 0, 0, 0, 0, 0, 0, 0,
+                                 {0, 0}, EntryType::kInvalid, 0, 0, {}};
+
+}  // namespace
+
+ArchiveIndex::ArchiveIndex() = default;
+
+ArchiveIndex::~ArchiveIndex() = default;
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::Create(const base::Value& header) {
+  if (!header.is_dict())
+    return nullptr;
+
+  Builder builder;
+  builder.Build(header);
+
+  std::unique_ptr<ArchiveIndex> index(new ArchiveIndex);
+  index->storage_ = builder.Pack();
+  if (!index->Attach(base::as_bytes(base::make_span(index->storage_))))
+    return nullptr;
+  return index;
+}
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::CreateFromMapping(
+    std::unique_ptr<base::MemoryMappedFile> mapping,
+    size_t offset,
+    size_t size) {
+  if (!mapping || offset > mapping->length() ||
+      size > mapping->length() - offset)
+    return nullptr;
+
+  std::unique_ptr<ArchiveIndex> index(new ArchiveIndex);
+  base::span<const uint8_t> data =
+      base::make_span(mapping->data() + offset, size);
+  index->mapping_ = std::move(mapping);
+  if (!index->Attach(data))
+    return nullptr;
+  return index;
+}
+
+// static
+std::unique_ptr<ArchiveIndex> ArchiveIndex::CreateFromSharedMemory(
+    base::ReadOnlySharedMemoryMapping mapping,
+    size_t offset,
+    size_t size) {
+  if (!mapping.IsValid() || offset > mapping.size() ||
+      size > mapping.size() - offset)
+    return nullptr;
+
+  std::unique_ptr<ArchiveIndex> index(new ArchiveIndex);
+  base::span<const uint8_t> data =
+      mapping.GetMemoryAsSpan<uint8_t>().subspan(offset, size);
+  index->shared_mapping_ = std::move(mapping);
+  if (!index->Attach(data))
+    return nullptr;
+  return index;
+}
+
+bool ArchiveIndex::Attach(base::span<const uint8_t> data) {
+  if (data.size() < sizeof(BlobHeader) ||
+      reinterpret_cast<uintptr_t>(data.data()) % alignof(Entry) != 0)
+    return false;
+
+  BlobHeader header;
+  memcpy(&header, data.data(), sizeof(header));
+  if (header.magic != kBlobMagic || header.version != kBlobVersion ||
+      header.entry_count == 0)
+    return false;
+
+  uint64_t needed = sizeof(header) +
+                    uint64_t{header.entry_count} * sizeof(Entry) +
+                    uint64_t{header.entry_count} * sizeof(uint32_t) +
+                    uint64_t{header.children_count} * sizeof(uint32_t) +
+                    uint64_t{header.block_count} * sizeof(StringRef) +
+                    header.strings_size;
+  if (needed > data.size())
+    return false;
+
+  const char* cursor = reinterpret_cast<const char*>(data.data());
+  cursor += sizeof(header);
+  entries_ = base::make_span(reinterpret_cast<const Entry*>(cursor),
+                             header.entry_count);
+  cursor += header.entry_count * sizeof(Entry);
+  sorted_ = base::make_span(reinterpret_cast<const uint32_t*>(cursor),
+                            header.entry_count);
+  cursor += header.entry_count * sizeof(uint32_t);
+  children_ = base::make_span(reinterpret_cast<const uint32_t*>(cursor),
+                              header.children_count);
+  cursor += header.children_count * sizeof(uint32_t);
+  blocks_ = base::make_span(reinterpret_cast<const StringRef*>(cursor),
+                            header.block_count);
+  cursor += header.block_count * sizeof(StringRef);
+  strings_ = base::StringPiece(cursor, header.strings_size);
+  data_ = data.first(needed);
+
+  // Only the root is checked here so that attaching does not depend on the
+  // size of the index, the other references are checked when they are used.
+  return entries_[0].type == EntryType::kDirectory &&
+         InRange(entries_[0].children_begin, entries_[0].children_count,
+                 children_.size());
+}
+
+base::StringPiece ArchiveIndex::GetString(StringRef ref) const {
+  if (!InRange(ref.offset, ref.length, strings_.size()))
+    return base::StringPiece();
+  return strings_.substr(ref.offset, ref.length);
+}
+
+base::StringPiece ArchiveIndex::GetName(const Entry& entry) const {
+  base::StringPiece path = GetString(entry.path);
+  size_t pos = path.rfind('/');
+  return pos == base::StringPiece::npos ? path : path.substr(pos + 1);
+}
+
+base::span<const uint32_t> ArchiveIndex::GetChildren(const Entry& entry) const {
+  if (!InRange(entry.children_begin, entry.children_count, children_.size()))
+    return base::span<const uint32_t>();
+  return children_.subspan(entry.children_begin, entry.children_count);
+}
+
+base::span<const ArchiveIndex::StringRef> ArchiveIndex::GetBlocks(
+    const Entry& entry) const {
+  if (!InRange(entry.blocks_begin, entry.blocks_count, blocks_.size()))
+    return base::span<const StringRef>();
+  return blocks_.subspan(entry.blocks_begin, entry.blocks_count);
+}
+
+const ArchiveIndex::Entry& ArchiveIndex::GetEntry(uint32_t index) const {
+  return index < entries_.size() ? entries_[index] : kMissingEntry;
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::Find(base::StringPiece path) const {
+  // Fast path: the path names a node of the tree without going through any
+  // link or empty component.
+  const Entry* entry = FindExact(path);
+  if (entry)
+    return entry;
+
+  // Walk the path component by component, following linked directories.
+  const Entry* dir = root();
+  while (true) {
+    size_t pos = path.find_first_of(kSeparators);
+    base::StringPiece name = path.substr(0, pos);
+    const Entry* child = name.empty() ? root() : FindChild(dir, name);
+    if (!child || pos == base::StringPiece::npos)
+      return child;
+    dir = child;
+    path.remove_prefix(pos + 1);
+  }
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::ResolveLink(
+    const Entry* entry) const {
+  if (entry->type != EntryType::kLink)
+    return entry;
+  return Find(GetString(entry->link));
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::FindExact(
+    base::StringPiece path) const {
+  auto it = std::lower_bound(
+      sorted_.begin(), sorted_.end(), path,
+      [this](uint32_t index, base::StringPiece path) {
+        return ComparePath(GetString(GetEntry(index).path), path) < 0;
+      });
+  if (it == sorted_.end() || *it >= entries_.size() ||
+      ComparePath(GetString(entries_[*it].path), path) != 0)
+    return nullptr;
+  return &entries_[*it];
+}
+
+const ArchiveIndex::Entry* ArchiveIndex::FindChild(
+    const Entry* dir,
+    base::StringPiece name) const {
+  dir = ResolveLink(dir);
+  if (!dir || dir->type != EntryType::kDirectory)
+    return nullptr;
+
+  base::span<const uint32_t> children = GetChildren(*dir);
+  auto it = std::lower_bound(children.begin(), children.end(), name,
+                             [this](uint32_t index, base::StringPiece name) {
+                               return GetName(GetEntry(index)) < name;
+                             });
+  if (it == children.end() || *it >= entries_.size() ||
+      GetName(entries_[*it]) != name)
+    return nullptr;
+  return &entries_[*it];
+}
+
+}  // namespace asar
@@ -0,0 +1,157 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
+#define SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class MemoryMappedFile;
+class Value;
+}
+
+namespace asar {
+
+// A flat, read-only index of an asar header.
+//
+// The JSON header is walked once and flattened into a single contiguous blob
+// made of POD records: a table of entries, a table of entry indices sorted by
+// path for binary search, a table of children per directory, and a pool
+// holding every string. Lookups never allocate and never touch base::Value.
+class ArchiveIndex {
+ public:
+  struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  enum class EntryType : uint8_t {
+    kFile,
+    kDirectory,
+    kLink,
+    // A file node which lacks the fields required to read it.
+    kInvalid,
+  };
+
+  enum EntryFlags : uint8_t {
+    kUnpacked = 1 << 0,
+    kExecutable = 1 << 1,
+    kHasIntegrity = 1 << 2,
+    // A packed file without a valid integrity payload.
+    kIntegrityMissing = 1 << 3,
+  };
+
+  struct Entry {
+    // Full path of the entry relative to the archive root, using "/".
+    StringRef path;
+    // Target of a link, relative to the archive root.
+    StringRef link;
+    // Offset of the file content, relative to the end of the header.
+    uint64_t offset;
+    uint32_t size;
+    // Range in the children table, sorted by name.
+    uint32_t children_begin;
+    uint32_t children_count;
+    // Range in the integrity blocks table.
+    uint32_t blocks_begin;
+    uint32_t blocks_count;
+    uint32_t block_size;
+    StringRef integrity_hash;
+    EntryType type;
+    uint8_t flags;
+    // Matches asar::HashAlgorithm.
+    uint8_t algorithm;
+    uint8_t padding[5];
+  };
+  static_assert(std::is_trivially_copyable<Entry>::value,
+                "Entries must be POD so the index can be copied as bytes");
+  static_assert(sizeof(Entry) % 8 == 0, "Entries must stay 8-byte aligned");
+
+  ~ArchiveIndex();
+
+  // disable copy
+  ArchiveIndex(const ArchiveIndex&) = delete;
+  ArchiveIndex& operator=(const ArchiveIndex&) = delete;
+
+  // Flattens the parsed JSON |header|, including the per-file integrity
+  // payloads when present.
+  static std::unique_ptr<ArchiveIndex> Create(const base::Value& header);
+
+  // Attaches to the serialized index stored in |mapping| at |offset|, as
+  // returned by data(), without copying it. Only the layout of the tables is
+  // checked here, in constant time. Since the mapping comes from disk, the
+  // references between tables are bounds-checked by the accessors instead:
+  // out of bounds strings and tables read as empty, and out of bounds entries
+  // as kInvalid ones. Returns null if the layout is malformed.
+  static std::unique_ptr<ArchiveIndex> CreateFromMapping(
+      std::unique_ptr<base::MemoryMappedFile> mapping,
+      size_t offset,
+      size_t size);
+
+  // Same as CreateFromMapping() for an index another process serialized into
+  // shared memory, which lets every process share a single copy of it.
+  static std::unique_ptr<ArchiveIndex> CreateFromSharedMemory(
+      base::ReadOnlySharedMemoryMapping mapping,
+      size_t offset,
+      size_t size);
+
+  // Returns the entry of |path|, resolving linked intermediate directories
+  // the same way the JSON tree walk did. Returns null when not found.
+  const Entry* Find(base::StringPiece path) const;
+
+  // Returns the entry |entry| links to, or |entry| when it is not a link.
+  const Entry* ResolveLink(const Entry* entry) const;
+
+  const Entry* root() const { return &entries_[0]; }
+  base::StringPiece GetString(StringRef ref) const;
+  base::StringPiece GetName(const Entry& entry) const;
+  base::span<const uint32_t> GetChildren(const Entry& entry) const;
+  base::span<const StringRef> GetBlocks(const Entry& entry) const;
+  const Entry& GetEntry(uint32_t index) const;
+
+  size_t entry_count() const { return entries_.size(); }
+  // Number of integrity blocks of all the files.
+  size_t block_count() const { return blocks_.size(); }
+  // Bytes held by the index.
+  size_t memory_usage() const { return data_.size(); }
+  // Whether the index lives in memory shared with other processes.
+  bool is_shared() const { return shared_mapping_.IsValid(); }
+
+  // The serialized form of the index.
+  base::span<const uint8_t> data() const { return data_; }
+
+ private:
+  ArchiveIndex();
+
+  // Points the tables at |data|; returns false if it is malformed.
+  bool Attach(base::span<const uint8_t> data);
+
+  const Entry* FindExact(base::StringPiece path) const;
+  const Entry* FindChild(const Entry* dir, base::StringPiece name) const;
+
+  // All tables live in |data_|, see archive_index.cc for the layout. It is
+  // backed by |storage_|, |mapping_| or |shared_mapping_|.
+  std::vector<uint64_t> storage_;
+  std::unique_ptr<base::MemoryMappedFile> mapping_;
+  base::ReadOnlySharedMemoryMapping shared_mapping_;
+  base::span<const uint8_t> data_;
+
+  base::span<const Entry> entries_;
+  base::span<const uint32_t> sorted_;
+  base::span<const uint32_t> children_;
+  base::span<const StringRef> blocks_;
+  base::StringPiece strings_;
+};
+
+}  // namespace asar
+
+#endif  // SHELL_COMMON_ASAR_ARCHIVE_INDEX_H_
@@ -0,0 +1,224 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/archive_index.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace asar {
+
+namespace {
+
+const char kHeader[] = R"({
+  "files": {
+    "dir": {
+      "files": {
+        "b.js": { "size": 2, "offset": "10" },
+        "a.js": { "size": 1, "offset": "0", "executable": true },
+        "sub": { "files": { "c.txt": { "size": 3, "offset": "20" } } }
+      }
+    },
+    "dir-link": { "link": "dir" },
+    "unpacked.node": { "size": 4, "unpacked": true },
+    "broken": { "offset": "4" }
+  }
+})";
+
+std::unique_ptr<ArchiveIndex> CreateIndex(const std::string& json) {
+  absl::optional<base::Value> value = base::JSONReader::Read(json);
+  CHECK(value);
+  return ArchiveIndex::Create(*value);
+}
+
+// Generates a header with |dirs| directories of |files| files each.
+base::Value CreateLargeHeader(int dirs, int files) {
+  base::Value root(base::Value::Type::DICTIONARY);
+  base::Value* root_files =
+      root.SetKey("files", base::Value(base::Value::Type::DICTIONARY));
+  for (int d = 0; d < dirs; ++d) {
+    base::Value dir(base::Value::Type::DICTIONARY);
+    base::Value* dir_files =
+        dir.SetKey("files", base::Value(base::Value::Type::DICTIONARY));
+    for (int f = 0; f < files; ++f) {
+      base::Value file(base::Value::Type::DICTIONARY);
+      file.SetIntKey("size", f);
+      file.SetStringKey("offset", base::NumberToString(d * files + f));
+      dir_files->SetKey(base::StringPrintf("module_%d.js", f), std::move(file));
+    }
+    root_files->SetKey(base::StringPrintf("node_modules_%d", d),
+                       std::move(dir));
+  }
+  return root;
+}
+
+// The lookup the index replaces: one dictionary lookup per path component.
+const base::Value* FindInTree(const base::Value& root,
+                              const std::string& path) {
+  const base::Value* node = &root;
+  for (const auto& name : base::SplitStringPiece(
+           path, "/", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    const base::Value* files = node->FindDictKey("files");
+    if (!files)
+      return nullptr;
+    node = files->FindDictKey(name);
+    if (!node)
+      return nullptr;
+  }
+  return node;
+}
+
+}  // namespace
+
+TEST(ArchiveIndexTest, FindsEntries) {
+  auto index = CreateIndex(kHeader);
+  ASSERT_TRUE(index);
+
+  const ArchiveIndex::Entry* root = index->Find("");
+  ASSERT_TRUE(root);
+  EXPECT_EQ(ArchiveIndex::EntryType::kDirectory, root->type);
+
+  const ArchiveIndex::Entry* a = index->Find("dir/a.js");
+  ASSERT_TRUE(a);
+  EXPECT_EQ(ArchiveIndex::EntryType::kFile, a->type);
+  EXPECT_EQ(1u, a->size);
+  EXPECT_EQ(0u, a->offset);
+  EXPECT_TRUE(a->flags & ArchiveIndex::kExecutable);
+
+  const ArchiveIndex::Entry* c = index->Find("dir/sub/c.txt");
+  ASSERT_TRUE(c);
+  EXPECT_EQ(20u, c->offset);
+
+  const ArchiveIndex::Entry* unpacked = index->Find("unpacked.node");
+  ASSERT_TRUE(unpacked);
+  EXPECT_TRUE(unpacked->flags & ArchiveIndex::kUnpacked);
+
+  const ArchiveIndex::Entry* broken = index->Find("broken");
+  ASSERT_TRUE(broken);
+  EXPECT_EQ(ArchiveIndex::EntryType::kInvalid, broken->type);
+
+  EXPECT_FALSE(index->Find("dir/missing.js"));
+  EXPECT_FALSE(index->Find("dir/a.js/nested"));
+}
+
+TEST(ArchiveIndexTest, FollowsLinkedDirectories) {
+  auto index = CreateIndex(kHeader);
+  ASSERT_TRUE(index);
+
+  const ArchiveIndex::Entry* link = index->Find("dir-link");
+  ASSERT_TRUE(link);
+  EXPECT_EQ(ArchiveIndex::EntryType::kLink, link->type);
+  EXPECT_EQ("dir", index->GetString(link->link));
+  EXPECT_EQ(index->Find("dir"), index->ResolveLink(link));
+
+  EXPECT_EQ(index->Find("dir/sub/c.txt"), index->Find("dir-link/sub/c.txt"));
+}
+
+#if defined(OS_WIN)
+TEST(ArchiveIndexTest, FindsEntriesWithBackslashes) {
+  auto index = CreateIndex(kHeader);
+  ASSERT_TRUE(index);
+
+  EXPECT_EQ(index->Find("dir/sub/c.txt"), index->Find("dir\\sub\\c.txt"));
+  EXPECT_EQ(index->Find("dir/sub/c.txt"), index->Find("dir-link\\sub/c.txt"));
+  EXPECT_FALSE(index->Find("dir\\missing.js"));
+}
+#endif
+
+TEST(ArchiveIndexTest, ListsChildrenInOrder) {
+  auto index = CreateIndex(kHeader);
+  ASSERT_TRUE(index);
+
+  const ArchiveIndex::Entry* dir = index->Find("dir");
+  ASSERT_TRUE(dir);
+  std::vector<std::string> names;
+  for (uint32_t child : index->GetChildren(*dir))
+    names.emplace_back(index->GetName(index->GetEntry(child)));
+  EXPECT_EQ((std::vector<std::string>{"a.js", "b.js", "sub"}), names);
+}
+
+TEST(ArchiveIndexTest, ToleratesCorruptedIndexFiles) {
+  auto index = CreateIndex(kHeader);
+  ASSERT_TRUE(index);
+
+  // Every entry but the root references data out of bounds. The entries
+  // follow the 24 bytes header of the blob.
+  std::vector<uint8_t> data(index->data().begin(), index->data().end());
+  memset(data.data() + 24 + sizeof(ArchiveIndex::Entry), 0xff,
+         (index->entry_count() - 1) * sizeof(ArchiveIndex::Entry));
+
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = temp_dir.GetPath().AppendASCII("app.asar.idx");
+  ASSERT_TRUE(base::WriteFile(path, data));
+  auto mapping = std::make_unique<base::MemoryMappedFile>();
+  ASSERT_TRUE(mapping->Initialize(path));
+
+  auto corrupted = ArchiveIndex::CreateFromMapping(std::move(mapping), 0,
+                                                   data.size());
+  ASSERT_TRUE(corrupted);
+  EXPECT_FALSE(corrupted->Find("dir/a.js"));
+  for (uint32_t child : corrupted->GetChildren(*corrupted->root())) {
+    const ArchiveIndex::Entry& entry = corrupted->GetEntry(child);
+    EXPECT_TRUE(corrupted->GetName(entry).empty());
+    EXPECT_TRUE(corrupted->GetChildren(entry).empty());
+    EXPECT_TRUE(corrupted->GetBlocks(entry).empty());
+  }
+}
+
+TEST(ArchiveIndexTest, LookupPerformance) {
+  constexpr int kDirs = 600;
+  constexpr int kFiles = 100;
+  constexpr int kIterations = 5;
+  base::Value header = CreateLargeHeader(kDirs, kFiles);
+  auto index = ArchiveIndex::Create(header);
+  ASSERT_TRUE(index);
+  EXPECT_EQ(1u + kDirs + kDirs * kFiles, index->entry_count());
+
+  std::vector<std::string> paths;
+  for (int d = 0; d < kDirs; ++d) {
+    for (int f = 0; f < kFiles; f += 7)
+      paths.push_back(base::StringPrintf("node_modules_%d/module_%d.js", d, f));
+  }
+
+  base::ElapsedTimer tree_timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const auto& path : paths)
+      ASSERT_TRUE(FindInTree(header, path));
+  }
+  base::TimeDelta tree_time = tree_timer.Elapsed();
+
+  base::ElapsedTimer index_timer;
+  for (int i = 0; i < kIterations; ++i) {
+    for (const auto& path : paths)
+      ASSERT_TRUE(index->Find(path));
+  }
+  base::TimeDelta index_time = index_timer.Elapsed();
+
+  const double lookups = kIterations * paths.size();
+  perf_test::PerfResultReporter reporter("ArchiveIndex", "60k_entries");
+  reporter.RegisterImportantMetric("_tree_lookup", "ns");
+  reporter.RegisterImportantMetric("_index_lookup", "ns");
+  reporter.RegisterImportantMetric("_tree_memory", "bytes");
+  reporter.RegisterImportantMetric("_index_memory", "bytes");
+  reporter.AddResult("_tree_lookup", tree_time.InNanoseconds() / lookups);
+  reporter.AddResult("_index_lookup", index_time.InNanoseconds() / lookups);
+  reporter.AddResult("_tree_memory", header.EstimateMemoryUsage());
+  reporter.AddResult("_index_memory", index->memory_usage());
+}
+
+}  // namespace asar
@@ -0,0 +1,310 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/archive.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_writer.h"
+#include "base/pickle.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/scoped_environment_variable_override.h"
+#include "base/timer/elapsed_timer.h"
+#include "base/values.h"
+#include "crypto/sha2.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace asar {
+
+namespace {
+
+// Writes an archive made of the JSON header |root| followed by |content|.
+base::FilePath WriteArchiveFile(const base::FilePath& dir,
+                                const std::string& name,
+                                const base::Value& root,
+                                const std::string& content) {
+  std::string json;
+  CHECK(base::JSONWriter::Write(root, &json));
+  base::Pickle header;
+  header.WriteString(json);
+  base::Pickle header_size;
+  header_size.WriteUInt32(header.size());
+
+  std::string data(static_cast<const char*>(header_size.data()),
+                   header_size.size());
+  data.append(static_cast<const char*>(header.data()), header.size());
+  data.append(content);
+
+  base::FilePath path = dir.AppendASCII(name);
+  CHECK(base::WriteFile(path, data));
+  return path;
+}
+
+// Writes an archive of |dirs| directories of |files| one-byte files each.
+base::FilePath WriteArchive(const base::FilePath& dir,
+                            const std::string& name,
+                            int dirs,
+                            int files) {
+  base::Value root(base::Value::Type::DICTIONARY);
+  base::Value* root_files =
+      root.SetKey("files", base::Value(base::Value::Type::DICTIONARY));
+  std::string content;
+  for (int d = 0; d < dirs; ++d) {
+    base::Value node(base::Value::Type::DICTIONARY);
+    base::Value* node_files =
+        node.SetKey("files", base::Value(base::Value::Type::DICTIONARY));
+    for (int f = 0; f < files; ++f) {
+      base::Value file(base::Value::Type::DICTIONARY);
+      file.SetIntKey("size", 1);
+      file.SetStringKey("offset", base::NumberToString(content.size()));
+      node_files->SetKey(base::StringPrintf("module_%d.js", f),
+                         std::move(file));
+      content.push_back('a' + f % 26);
+    }
+    root_files->SetKey(base::StringPrintf("node_modules_%d", d),
+                       std::move(node));
+  }
+  return WriteArchiveFile(dir, name, root, content);
+}
+
+// Writes an archive of files named "file_<n>" holding |contents|, with the
+// integrity of each.
+base::FilePath WriteArchiveWithIntegrity(
+    const base::FilePath& dir,
+    const std::string& name,
+    const std::vector<std::string>& contents) {
+  base::Value root(base::Value::Type::DICTIONARY);
+  base::Value* root_files =
+      root.SetKey("files", base::Value(base::Value::Type::DICTIONARY));
+  std::string content;
+  for (size_t i = 0; i < contents.size(); ++i) {
+    std::string digest = crypto::SHA256HashString(contents[i]);
+    std::string hash =
+        base::ToLowerASCII(base::HexEncode(digest.data(), digest.size()));
+    base::Value blocks(base::Value::Type::LIST);
+    blocks.Append(hash);
+    base::Value integrity(base::Value::Type::DICTIONARY);
+    integrity.SetStringKey("algorithm", "SHA256");
+    integrity.SetStringKey("hash", hash);
+    integrity.SetIntKey("blockSize", static_cast<int>(contents[i].size()));
+    integrity.SetKey("blocks", std::move(blocks));
+
+    base::Value file(base::Value::Type::DICTIONARY);
+    file.SetIntKey("size", static_cast<int>(contents[i].size()));
+    file.SetStringKey("offset", base::NumberToString(content.size()));
+    file.SetKey("integrity", std::move(integrity));
+    root_files->SetKey(base::StringPrintf("file_%zu", i), std::move(file));
+    content.append(contents[i]);
+  }
+  return WriteArchiveFile(dir, name, root, content);
+}
+
+}  // namespace
+
+TEST(ArchiveTest, UsesIndexFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = WriteArchive(temp_dir.GetPath(), "app.asar", 3, 30);
+
+  {
+    Archive archive(path);
+    ASSERT_TRUE(archive.Init());
+    ASSERT_TRUE(archive.WriteIndexFile(base::FilePath()));
+  }
+  ASSERT_TRUE(base::PathExists(path.AddExtension(FILE_PATH_LITERAL("idx"))));
+
+  Archive archive(path);
+  ASSERT_TRUE(archive.Init());
+  Archive::FileInfo info;
+  ASSERT_TRUE(archive.GetFileInfo(
+      base::FilePath(FILE_PATH_LITERAL("node_modules_1/module_2.js")), &info));
+  EXPECT_EQ(1u, info.size);
+  std::vector<base::FilePath> files;
+  ASSERT_TRUE(
+      archive.Readdir(base::FilePath(FILE_PATH_LITERAL("node_modules_2")),
+                      &files));
+  EXPECT_EQ(30u, files.size());
+}
+
+TEST(ArchiveTest, IgnoresStaleIndexFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = WriteArchive(temp_dir.GetPath(), "app.asar", 1, 5);
+  {
+    Archive archive(path);
+    ASSERT_TRUE(archive.Init());
+    ASSERT_TRUE(archive.WriteIndexFile(base::FilePath()));
+  }
+
+  // Rewrite the archive with different content, keeping the stale sidecar.
+  WriteArchive(temp_dir.GetPath(), "app.asar", 1, 6);
+  Archive archive(path);
+  ASSERT_TRUE(archive.Init());
+  Archive::FileInfo info;
+  EXPECT_TRUE(archive.GetFileInfo(
+      base::FilePath(FILE_PATH_LITERAL("node_modules_0/module_5.js")), &info));
+}
+
+TEST(ArchiveTest, IgnoresCorruptedIndexFile) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = WriteArchive(temp_dir.GetPath(), "app.asar", 1, 5);
+  {
+    Archive archive(path);
+    ASSERT_TRUE(archive.Init());
+    ASSERT_TRUE(archive.WriteIndexFile(base::FilePath()));
+  }
+
+  // Damage a path in the sidecar, which stays within the bounds of the
+  // index.
+  base::FilePath index_path = path.AddExtension(FILE_PATH_LITERAL("idx"));
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(index_path, &contents));
+  size_t pos = contents.find("node_modules_0/module_3.js");
+  ASSERT_NE(std::string::npos, pos);
+  contents[pos + strlen("node_modules_0/module_")] = '9';
+  ASSERT_TRUE(base::WriteFile(index_path, contents));
+
+  // The archive falls back to its JSON header.
+  Archive archive(path);
+  ASSERT_TRUE(archive.Init());
+  Archive::FileInfo info;
+  EXPECT_TRUE(archive.GetFileInfo(
+      base::FilePath(FILE_PATH_LITERAL("node_modules_0/module_3.js")), &info));
+}
+
+TEST(ArchiveTest, AttachesToSharedIndex) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath path = WriteArchive(temp_dir.GetPath(), "app.asar", 2, 10);
+  base::FilePath other_path =
+      WriteArchive(temp_dir.GetPath(), "other.asar", 2, 11);
+
+  // Plays the browser process, which shares the index of |path| only.
+  Archive browser_archive(path);
+  ASSERT_TRUE(browser_archive.Init());
+  base::ReadOnlySharedMemoryRegion region = browser_archive.ShareIndex();
+  ASSERT_TRUE(region.IsValid());
+  Archive::SetSharedIndexProvider(base::BindRepeating(
+      [](const base::ReadOnlySharedMemoryRegion* region,
+         const base::FilePath& path) { return region->Duplicate(); },
+      &region));
+
+  size_t shared_bytes = Archive::GetSharedIndexBytes();
+  {
+    Archive archive(path);
+    ASSERT_TRUE(archive.Init());
+    Archive::FileInfo info;
+    EXPECT_TRUE(archive.GetFileInfo(
+        base::FilePath(FILE_PATH_LITERAL("node_modules_1/module_9.js")),
+        &info));
+    EXPECT_GT(Archive::GetSharedIndexBytes(), shared_bytes);
+  }
+
+  // The index shared for another archive is rejected.
+  shared_bytes = Archive::GetSharedIndexBytes();
+  {
+    Archive archive(other_path);
+    ASSERT_TRUE(archive.Init());
+    Archive::FileInfo info;
+    EXPECT_TRUE(archive.GetFileInfo(
+        base::FilePath(FILE_PATH_LITERAL("node_modules_1/module_10.js")),
+        &info));
+    EXPECT_EQ(shared_bytes, Archive::GetSharedIndexBytes());
+  }
+
+  Archive::SetSharedIndexProvider(Archive::SharedIndexProvider());
+}
+
+TEST(ArchiveTest, KeepsBoundedValidatedCopies) {
+  base::test::ScopedEnvironmentVariableOverride validate_integrity(
+      "ELECTRON_ASAR_VALIDATE_INTEGRITY", "1");
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const std::string content_0(1000, 'a');
+  const std::string content_1(1000, 'b');
+  base::FilePath path = WriteArchiveWithIntegrity(
+      temp_dir.GetPath(), "app.asar", {content_0, content_1});
+  const base::FilePath file_0(FILE_PATH_LITERAL("file_0"));
+  const base::FilePath file_1(FILE_PATH_LITERAL("file_1"));
+
+  Archive archive(path);
+  ASSERT_TRUE(archive.Init());
+  archive.SetVerifiedFilesLimitForTesting(1500);
+
+  bool mapped = true;
+  scoped_refptr<base::RefCountedMemory> bytes_0 =
+      archive.ReadFileBytes(file_0, &mapped);
+  ASSERT_TRUE(bytes_0);
+  EXPECT_FALSE(mapped);
+  EXPECT_EQ(content_0, std::string(bytes_0->front_as<char>(), bytes_0->size()));
+  // The validated copy is kept while it fits.
+  EXPECT_EQ(bytes_0, archive.ReadFileBytes(file_0, nullptr));
+
+  // Only one of the files fits, so reading the other evicts it. The copy
+  // handed out stays valid.
+  scoped_refptr<base::RefCountedMemory> bytes_1 =
+      archive.ReadFileBytes(file_1, nullptr);
+  ASSERT_TRUE(bytes_1);
+  EXPECT_EQ(content_1, std::string(bytes_1->front_as<char>(), bytes_1->size()));
+  EXPECT_NE(bytes_0, archive.ReadFileBytes(file_0, nullptr));
+  EXPECT_EQ(content_0, std::string(bytes_0->front_as<char>(), bytes_0->size()));
+}
+
+TEST(ArchiveTest, InitPerformance) {
+  struct {
+    const char* story;
+    int dirs;
+    int files;
+  } cases[] = {
+      {"small", 10, 10},
+      {"medium", 100, 50},
+      {"huge", 600, 100},
+  };
+
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  for (const auto& c : cases) {
+    base::FilePath json_path = WriteArchive(
+        temp_dir.GetPath(), std::string(c.story) + ".asar", c.dirs, c.files);
+    base::FilePath indexed_path =
+        WriteArchive(temp_dir.GetPath(), std::string(c.story) + "_idx.asar",
+                     c.dirs, c.files);
+    {
+      Archive archive(indexed_path);
+      ASSERT_TRUE(archive.Init());
+      ASSERT_TRUE(archive.WriteIndexFile(base::FilePath()));
+    }
+
+    base::ElapsedTimer json_timer;
+    {
+      Archive archive(json_path);
+      ASSERT_TRUE(archive.Init());
+    }
+    base::TimeDelta json_time = json_timer.Elapsed();
+
+    base::ElapsedTimer indexed_timer;
+    {
+      Archive archive(indexed_path);
+      ASSERT_TRUE(archive.Init());
+    }
+    base::TimeDelta indexed_time = indexed_timer.Elapsed();
+
+    perf_test::PerfResultReporter reporter("ArchiveInit", c.story);
+    reporter.RegisterImportantMetric("_json", "us");
+    reporter.RegisterImportantMetric("_index_file", "us");
+    reporter.AddResult("_json", json_time);
+    reporter.AddResult("_index_file", indexed_time);
+  }
+}
+
+}  // namespace asar
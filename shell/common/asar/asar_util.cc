@@ -4,14 +4,17 @@
 
 #include "shell/common/asar/asar_util.h"
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <utility>
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/hash/hash.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/no_destructor.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
@@ -22,6 +25,7 @@
 #include "crypto/secure_hash.h"
 #include "crypto/sha2.h"
 #include "shell/common/asar/archive.h"
+#include "shell/common/asar/integrity_verifier.h"
 
 namespace asar {
 
@@ -31,20 +35,59 @@ typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
 
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
-bool IsDirectoryCached(const base::FilePath& path) {
-  static base::NoDestructor<std::map<base::FilePath, bool>>
-      s_is_directory_cache;
-  static base::NoDestructor<base::Lock> lock;
-
-  base::AutoLock auto_lock(*lock);
-  auto& is_directory_cache = *s_is_directory_cache;
+// Remembers whether the paths ending in ".asar" that GetAsarArchivePath()
+// walks through are directories. Module resolution asks about the same few
+// paths thousands of times during startup, from several threads.
+//
+// This is a fixed-size, direct-mapped table where each slot is one atomic
+// word holding 62 bits of the hash of a path plus whether it is a directory.
+// Lookups and insertions never take a lock, and a colliding insertion just
+// replaces the slot so the memory used is bounded. Two paths would have to
+// share all 62 bits of their hash for a lookup to be wrong.
+class DirectoryCache {
+ public:
+  DirectoryCache() {
+    for (auto& slot : slots_)
+      slot.store(0, std::memory_order_relaxed);
+  }
 
-  auto it = is_directory_cache.find(path);
-  if (it != is_directory_cache.end()) {
-    return it->second;
+  // disable copy
+  DirectoryCache(const DirectoryCache&) = delete;
+  DirectoryCache& operator=(const DirectoryCache&) = delete;
+
+  bool IsDirectory(const base::FilePath& path) {
+    base::span<const uint8_t> bytes = base::as_bytes(
+        base::make_span(path.value().data(), path.value().size()));
+    uint64_t hash = (uint64_t{base::PersistentHash(bytes)} << 32) |
+                    static_cast<uint32_t>(base::FastHash(bytes));
+    uint64_t tag = (hash & ~uint64_t{3}) | kOccupied;
+    std::atomic<uint64_t>& slot = slots_[(hash >> 32) % kSlotCount];
+
+    uint64_t value = slot.load(std::memory_order_relaxed);
+    if ((value & ~kIsDirectory) == tag)
+      return value & kIsDirectory;
+
+    bool is_directory;
+    {
+      base::ThreadRestrictions::ScopedAllowIO allow_io;
+      is_directory = base::DirectoryExists(path);
+    }
+    slot.store(tag | (is_directory ? kIsDirectory : 0),
+               std::memory_order_relaxed);
+    return is_directory;
   }
-  base::ThreadRestrictions::ScopedAllowIO allow_io;
-  return is_directory_cache[path] = base::DirectoryExists(path);
+
+ private:
+  static constexpr size_t kSlotCount = 4096;
+  static constexpr uint64_t kIsDirectory = 1;
+  static constexpr uint64_t kOccupied = 2;
+
+  std::atomic<uint64_t> slots_[kSlotCount];
+};
+
+bool IsDirectoryCached(const base::FilePath& path) {
+  static base::NoDestructor<DirectoryCache> s_is_directory_cache;
+  return s_is_directory_cache->IsDirectory(path);
 }
 
 }  // namespace
@@ -60,23 +103,29 @@ base::Lock& GetArchiveCacheLock() {
 }
 
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  base::AutoLock auto_lock(GetArchiveCacheLock());
-  ArchiveMap& map = GetArchiveCache();
-
   // if we have it, return it
-  const auto lower = map.lower_bound(path);
-  if (lower != std::end(map) && !map.key_comp()(path, lower->first))
-    return lower->second;
+  if (std::shared_ptr<Archive> archive = GetCachedAsarArchive(path))
+    return archive;
 
-  // if we can create it, return it
+  // Init() can block on a sync IPC to the browser for the shared index, so it
+  // runs without the lock; when two threads race, the first archive cached
+  // wins.
   auto archive = std::make_shared<Archive>(path);
-  if (archive->Init()) {
-    base::TryEmplace(map, lower, path, archive);
-    return archive;
+  if (!archive->Init()) {
+    // didn't have it, couldn't create it
+    return nullptr;
   }
 
-  // didn't have it, couldn't create it
-  return nullptr;
+  base::AutoLock auto_lock(GetArchiveCacheLock());
+  return GetArchiveCache().emplace(path, std::move(archive)).first->second;
+}
+
+std::shared_ptr<Archive> GetCachedAsarArchive(const base::FilePath& path) {
+  base::AutoLock auto_lock(GetArchiveCacheLock());
+  ArchiveMap& map = GetArchiveCache();
+
+  auto it = map.find(path);
+  return it != map.end() ? it->second : nullptr;
 }
 
 void ClearArchives() {
@@ -130,6 +179,13 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
     return base::ReadFileToString(real_path, contents);
   }
 
+  scoped_refptr<base::RefCountedMemory> bytes =
+      archive->ReadFileBytes(relative_path, nullptr);
+  if (bytes) {
+    contents->assign(bytes->front_as<char>(), bytes->size());
+    return true;
+  }
+
   base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
   if (!src.IsValid())
     return false;
@@ -142,7 +198,7 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
   }
 
   if (info.integrity.has_value()) {
-    ValidateIntegrityOrDie(contents->data(), contents->size(),
+    ValidateIntegrityOrDie(base::as_bytes(base::make_span(*contents)),
                            info.integrity.value());
   }
 
@@ -169,4 +225,19 @@ void ValidateIntegrityOrDie(const char* data,
   }
 }
 
+void ValidateIntegrityOrDie(base::span<const uint8_t> data,
+                            const IntegrityPayload& integrity) {
+  if (integrity.blocks.empty() || integrity.block_size == 0) {
+    ValidateIntegrityOrDie(reinterpret_cast<const char*>(data.data()),
+                           data.size(), integrity);
+    return;
+  }
+
+  if (integrity.algorithm != HashAlgorithm::SHA256 ||
+      !IntegrityVerifier::VerifyFile(integrity, data)) {
+    LOG(FATAL) << "Integrity check failed for asar archive ("
+               << integrity.hash << ")";
+  }
+}
+
 }  // namespace asar
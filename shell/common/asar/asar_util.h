@@ -8,6 +8,8 @@
 #include <memory>
 #include <string>
 
+#include "base/containers/span.h"
+
 namespace base {
 class FilePath;
 }
@@ -20,6 +22,9 @@ struct IntegrityPayload;
 // Gets or creates and caches a new Archive from the path.
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
+// Gets the Archive of the path if it was already opened, without opening it.
+std::shared_ptr<Archive> GetCachedAsarArchive(const base::FilePath& path);
+
 // Destroy cached Archive objects.
 void ClearArchives();
 
@@ -36,6 +41,11 @@ void ValidateIntegrityOrDie(const char* data,
                             size_t size,
                             const IntegrityPayload& integrity);
 
+// Same as above, but also checks the whole content of a file block by block,
+// hashing large files in parallel.
+void ValidateIntegrityOrDie(base::span<const uint8_t> data,
+                            const IntegrityPayload& integrity);
+
 }  // namespace asar
 
 #endif  // SHELL_COMMON_ASAR_ASAR_UTIL_H_
@@ -0,0 +1,101 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/asar_util.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace asar {
+
+namespace {
+
+class SplitPathsDelegate : public base::DelegateSimpleThread::Delegate {
+ public:
+  SplitPathsDelegate(const std::vector<base::FilePath>* archives,
+                     std::atomic<int>* failures)
+      : archives_(archives), failures_(failures) {}
+
+  // base::DelegateSimpleThread::Delegate:
+  void Run() override {
+    for (int round = 0; round < 100; ++round) {
+      for (size_t i = 0; i < archives_->size(); ++i) {
+        base::FilePath asar_path, relative_path;
+        bool is_archive =
+            GetAsarArchivePath((*archives_)[i].AppendASCII("index.js"),
+                               &asar_path, &relative_path);
+        // Even paths are archives, odd ones directories.
+        if (is_archive != (i % 2 == 0))
+          ++*failures_;
+      }
+    }
+  }
+
+ private:
+  const std::vector<base::FilePath>* archives_;
+  std::atomic<int>* failures_;
+};
+
+}  // namespace
+
+TEST(AsarUtilTest, SplitsArchivePaths) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath archive = temp_dir.GetPath().AppendASCII("app.asar");
+  ASSERT_TRUE(base::WriteFile(archive, "not really an archive"));
+  base::FilePath directory = temp_dir.GetPath().AppendASCII("dir.asar");
+  ASSERT_TRUE(base::CreateDirectory(directory));
+
+  // Asked twice so the cached answers are checked too.
+  for (int i = 0; i < 2; ++i) {
+    base::FilePath asar_path, relative_path;
+    ASSERT_TRUE(
+        GetAsarArchivePath(archive.AppendASCII("lib").AppendASCII("index.js"),
+                           &asar_path, &relative_path));
+    EXPECT_EQ(archive, asar_path);
+    EXPECT_EQ(base::FilePath().AppendASCII("lib").AppendASCII("index.js"),
+              relative_path);
+
+    EXPECT_FALSE(GetAsarArchivePath(directory.AppendASCII("index.js"),
+                                    &asar_path, &relative_path));
+  }
+}
+
+TEST(AsarUtilTest, SplitsArchivePathsFromManyThreads) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  std::vector<base::FilePath> archives;
+  for (int i = 0; i < 64; ++i) {
+    bool is_directory = i % 2;
+    base::FilePath path =
+        temp_dir.GetPath().AppendASCII(base::StringPrintf("%d.asar", i));
+    if (is_directory)
+      ASSERT_TRUE(base::CreateDirectory(path));
+    else
+      ASSERT_TRUE(base::WriteFile(path, ""));
+    archives.push_back(path);
+  }
+
+  std::atomic<int> failures{0};
+  SplitPathsDelegate delegate(&archives, &failures);
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::make_unique<base::DelegateSimpleThread>(
+        &delegate, base::StringPrintf("split_%d", i)));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Join();
+
+  EXPECT_EQ(0, failures);
+}
+
+}  // namespace asar
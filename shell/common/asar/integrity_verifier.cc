@@ -0,0 +1,152 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/integrity_verifier.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/task/post_job.h"
+#include "base/task/thread_pool/thread_pool_instance.h"
+#include "crypto/sha2.h"
+#include "shell/common/asar/archive.h"
+
+namespace asar {
+
+namespace {
+
+// Blocks of a file are shared between the workers of a job, each taking the
+// next block until none is left. The calling thread joins the job, so the
+// verification completes even if no worker gets to run.
+class ParallelVerification
+    : public base::RefCountedThreadSafe<ParallelVerification> {
+ public:
+  ParallelVerification(const IntegrityPayload* integrity,
+                       size_t first_block,
+                       size_t block_count,
+                       base::span<const uint8_t> data)
+      : integrity_(integrity),
+        first_block_(first_block),
+        block_count_(block_count),
+        data_(data) {}
+
+  // disable copy
+  ParallelVerification(const ParallelVerification&) = delete;
+  ParallelVerification& operator=(const ParallelVerification&) = delete;
+
+  // Starts verifying the blocks on the thread pool. Join() must be called
+  // before |integrity_| or |data_| go away.
+  void Start() {
+    if (!base::ThreadPoolInstance::Get())
+      return;
+    job_handle_ = base::PostJob(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::BindRepeating(&ParallelVerification::Run, this),
+        base::BindRepeating(&ParallelVerification::GetMaxConcurrency, this));
+  }
+
+  // Verifies the blocks left on the calling thread, and waits for the
+  // workers to be done with theirs. Returns whether all the blocks match.
+  bool Join() {
+    if (job_handle_)
+      job_handle_.Join();
+    else
+      Run(nullptr);
+    return !failed_;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<ParallelVerification>;
+  ~ParallelVerification() = default;
+
+  void Run(base::JobDelegate* delegate) {
+    while (!failed_ && !(delegate && delegate->ShouldYield())) {
+      size_t i = next_.fetch_add(1);
+      if (i >= block_count_)
+        return;
+
+      size_t block_size = integrity_->block_size;
+      size_t offset = i * block_size;
+      base::span<const uint8_t> chunk = data_.subspan(
+          offset, std::min(block_size, data_.size() - offset));
+      if (!IntegrityVerifier::VerifyBlock(
+              chunk, integrity_->blocks[first_block_ + i]))
+        failed_ = true;
+    }
+  }
+
+  size_t GetMaxConcurrency(size_t worker_count) const {
+    size_t next = next_.load();
+    if (failed_ || next >= block_count_)
+      return 0;
+    return block_count_ - next;
+  }
+
+  const IntegrityPayload* integrity_;
+  const size_t first_block_;
+  const size_t block_count_;
+  const base::span<const uint8_t> data_;
+  std::atomic<size_t> next_{0};
+  std::atomic<bool> failed_{false};
+  base::JobHandle job_handle_;
+};
+
+// Gets the number of blocks covering |data| from |first_block|. Returns false
+// if they are not all in |integrity|.
+bool GetBlockCount(const IntegrityPayload& integrity,
+                   size_t first_block,
+                   base::span<const uint8_t> data,
+                   size_t* block_count) {
+  if (integrity.block_size == 0)
+    return false;
+  *block_count =
+      (data.size() + integrity.block_size - 1) / integrity.block_size;
+  return first_block + *block_count <= integrity.blocks.size();
+}
+
+}  // namespace
+
+// static
+bool IntegrityVerifier::Verify(const IntegrityPayload& integrity,
+                               size_t first_block,
+                               base::span<const uint8_t> data) {
+  size_t block_count;
+  if (!GetBlockCount(integrity, first_block, data, &block_count))
+    return false;
+
+  auto verification = base::MakeRefCounted<ParallelVerification>(
+      &integrity, first_block, block_count, data);
+  if (block_count > 1)
+    verification->Start();
+  return verification->Join();
+}
+
+// static
+bool IntegrityVerifier::VerifyFile(const IntegrityPayload& integrity,
+                                   base::span<const uint8_t> data) {
+  size_t block_count;
+  if (!GetBlockCount(integrity, 0, data, &block_count))
+    return false;
+
+  auto verification = base::MakeRefCounted<ParallelVerification>(
+      &integrity, 0, block_count, data);
+  verification->Start();
+  bool hash_matches = VerifyBlock(data, integrity.hash);
+  return verification->Join() && hash_matches;
+}
+
+// static
+bool IntegrityVerifier::VerifyBlock(base::span<const uint8_t> data,
+                                    const std::string& expected_hash) {
+  auto hash = crypto::SHA256Hash(data);
+  return base::EqualsCaseInsensitiveASCII(
+      base::HexEncode(hash.data(), hash.size()), expected_hash);
+}
+
+}  // namespace asar
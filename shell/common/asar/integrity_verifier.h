@@ -0,0 +1,47 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_ASAR_INTEGRITY_VERIFIER_H_
+#define SHELL_COMMON_ASAR_INTEGRITY_VERIFIER_H_
+
+#include <string>
+
+#include "base/containers/span.h"
+
+namespace asar {
+
+struct IntegrityPayload;
+
+// Verifies the content of files in an archive against the hashes of their
+// integrity payload. The blocks of large files are hashed by a job on the
+// thread pool, which the calling thread joins rather than waiting on it.
+//
+// The verifier keeps no state, so that callers hash the very bytes they hand
+// out. Archive keeps a bounded cache of the validated copies of the files it
+// reads, see Archive::ReadFileBytes().
+class IntegrityVerifier {
+ public:
+  IntegrityVerifier() = delete;
+
+  // Verifies |data|, which must start on the block |first_block| of the file
+  // described by |integrity| and end on a block boundary or at the end of
+  // the file. Returns false if any block does not match its hash.
+  static bool Verify(const IntegrityPayload& integrity,
+                     size_t first_block,
+                     base::span<const uint8_t> data);
+
+  // Verifies the whole content of the file described by |integrity| against
+  // both its block hashes and its file hash. The file hash is computed on the
+  // calling thread while the blocks are hashed on the thread pool.
+  static bool VerifyFile(const IntegrityPayload& integrity,
+                         base::span<const uint8_t> data);
+
+  // Hashes |data| and compares it with |expected_hash|.
+  static bool VerifyBlock(base::span<const uint8_t> data,
+                          const std::string& expected_hash);
+};
+
+}  // namespace asar
+
+#endif  // SHELL_COMMON_ASAR_INTEGRITY_VERIFIER_H_
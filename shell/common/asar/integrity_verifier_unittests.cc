@@ -0,0 +1,127 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/asar/integrity_verifier.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/timer/elapsed_timer.h"
+#include "crypto/sha2.h"
+#include "shell/common/asar/archive.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace asar {
+
+namespace {
+
+std::string HashBlock(base::span<const uint8_t> data) {
+  auto hash = crypto::SHA256Hash(data);
+  return base::HexEncode(hash.data(), hash.size());
+}
+
+// Builds the integrity payload of |data| split in |block_size| blocks.
+IntegrityPayload CreateIntegrity(const std::vector<uint8_t>& data,
+                                 uint32_t block_size) {
+  IntegrityPayload integrity;
+  integrity.algorithm = HashAlgorithm::SHA256;
+  integrity.hash = HashBlock(data);
+  integrity.block_size = block_size;
+  for (size_t offset = 0; offset < data.size(); offset += block_size) {
+    integrity.blocks.push_back(HashBlock(base::make_span(data).subspan(
+        offset, std::min<size_t>(block_size, data.size() - offset))));
+  }
+  return integrity;
+}
+
+std::vector<uint8_t> CreateData(size_t size) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; ++i)
+    data[i] = static_cast<uint8_t>(i * 31 + i / 7);
+  return data;
+}
+
+}  // namespace
+
+class IntegrityVerifierTest : public testing::Test {
+ protected:
+  base::test::TaskEnvironment task_environment_;
+};
+
+TEST_F(IntegrityVerifierTest, VerifiesBlocks) {
+  std::vector<uint8_t> data = CreateData(10 * 1024 + 17);
+  IntegrityPayload integrity = CreateIntegrity(data, 1024);
+  ASSERT_EQ(11u, integrity.blocks.size());
+
+  EXPECT_TRUE(IntegrityVerifier::Verify(integrity, 0, data));
+  EXPECT_TRUE(IntegrityVerifier::VerifyFile(integrity, data));
+}
+
+TEST_F(IntegrityVerifierTest, VerifiesFromBlock) {
+  std::vector<uint8_t> data = CreateData(4 * 1024);
+  IntegrityPayload integrity = CreateIntegrity(data, 1024);
+
+  EXPECT_TRUE(IntegrityVerifier::Verify(integrity, 2,
+                                        base::make_span(data).subspan(2048)));
+  EXPECT_FALSE(IntegrityVerifier::Verify(integrity, 1,
+                                         base::make_span(data).subspan(2048)));
+}
+
+TEST_F(IntegrityVerifierTest, RejectsCorruptedBlock) {
+  std::vector<uint8_t> data = CreateData(8 * 1024);
+  IntegrityPayload integrity = CreateIntegrity(data, 1024);
+  EXPECT_TRUE(IntegrityVerifier::Verify(integrity, 0, data));
+
+  // Nothing is remembered, so a block changed after a successful check fails
+  // the next one.
+  data[5 * 1024 + 3] ^= 0xff;
+  EXPECT_FALSE(IntegrityVerifier::Verify(integrity, 0, data));
+  EXPECT_FALSE(IntegrityVerifier::VerifyFile(integrity, data));
+}
+
+TEST_F(IntegrityVerifierTest, ChecksFileHash) {
+  std::vector<uint8_t> data = CreateData(4 * 1024);
+  IntegrityPayload integrity = CreateIntegrity(data, 1024);
+
+  // The blocks still match, but not the hash of the file.
+  integrity.hash = HashBlock(base::make_span(data).first(1024));
+  EXPECT_TRUE(IntegrityVerifier::Verify(integrity, 0, data));
+  EXPECT_FALSE(IntegrityVerifier::VerifyFile(integrity, data));
+}
+
+TEST_F(IntegrityVerifierTest, VerifyPerformance) {
+  constexpr uint32_t kBlockSize = 4 * 1024 * 1024;
+  std::vector<uint8_t> data = CreateData(16 * kBlockSize);
+  IntegrityPayload integrity = CreateIntegrity(data, kBlockSize);
+
+  base::ElapsedTimer serial_timer;
+  for (size_t i = 0; i < integrity.blocks.size(); ++i) {
+    ASSERT_TRUE(IntegrityVerifier::VerifyBlock(
+        base::make_span(data).subspan(i * kBlockSize, kBlockSize),
+        integrity.blocks[i]));
+  }
+  base::TimeDelta serial_time = serial_timer.Elapsed();
+
+  base::ElapsedTimer parallel_timer;
+  ASSERT_TRUE(IntegrityVerifier::Verify(integrity, 0, data));
+  base::TimeDelta parallel_time = parallel_timer.Elapsed();
+
+  base::ElapsedTimer file_timer;
+  ASSERT_TRUE(IntegrityVerifier::VerifyFile(integrity, data));
+  base::TimeDelta file_time = file_timer.Elapsed();
+
+  perf_test::PerfResultReporter reporter("IntegrityVerifier", "64MB");
+  reporter.RegisterImportantMetric("_serial", "us");
+  reporter.RegisterImportantMetric("_parallel", "us");
+  reporter.RegisterImportantMetric("_file", "us");
+  reporter.AddResult("_serial", serial_time);
+  reporter.AddResult("_parallel", parallel_time);
+  reporter.AddResult("_file", file_time);
+}
+
+}  // namespace asar
@@ -0,0 +1,121 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/pixel_kernels.h"
+
+#include <vector>
+
+#include "third_party/libyuv/include/libyuv/convert_argb.h"
+#include "third_party/libyuv/include/libyuv/convert_from_argb.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
+// libyuv names 32-bit formats after little endian words, so its ARGB is BGRA
+// in memory and its ABGR is RGBA. Its row functions pick their SIMD variant
+// from the CPU features it detects on first use.
+
+namespace electron {
+
+namespace pixels {
+
+namespace {
+
+constexpr bool kN32IsBGRA = kN32_SkColorType == kBGRA_8888_SkColorType;
+
+bool IsN32Premul(const SkPixmap& pixmap) {
+  return pixmap.colorType() == kN32_SkColorType &&
+         (pixmap.alphaType() == kPremul_SkAlphaType ||
+          pixmap.alphaType() == kOpaque_SkAlphaType);
+}
+
+// Copies 32-bit pixels, swapping red and blue when |swap_rb|.
+void CopyPixels(const uint8_t* src,
+                int src_stride,
+                uint8_t* dst,
+                int dst_stride,
+                int width,
+                int height,
+                bool swap_rb) {
+  if (swap_rb)
+    libyuv::ARGBToABGR(src, src_stride, dst, dst_stride, width, height);
+  else
+    libyuv::ARGBCopy(src, src_stride, dst, dst_stride, width, height);
+}
+
+}  // namespace
+
+int GetBytesPerPixel(Format format) {
+  return format == Format::kGray ? 1 : 4;
+}
+
+bool ConvertFromN32(const SkPixmap& src,
+                    Format format,
+                    bool premultiplied,
+                    uint8_t* dst,
+                    size_t dst_row_bytes) {
+  if (!IsN32Premul(src))
+    return false;
+
+  const auto* src_pixels = static_cast<const uint8_t*>(src.addr());
+  int src_stride = static_cast<int>(src.rowBytes());
+  int dst_stride = static_cast<int>(dst_row_bytes);
+  int width = src.width();
+  int height = src.height();
+
+  if (format == Format::kGray) {
+    if (kN32IsBGRA) {
+      libyuv::ARGBToJ400(src_pixels, src_stride, dst, dst_stride, width,
+                         height);
+      return true;
+    }
+    // Swizzled one row at a time, to keep the copy in cache.
+    std::vector<uint8_t> row(static_cast<size_t>(width) * 4);
+    for (int y = 0; y < height; ++y) {
+      libyuv::ABGRToARGB(src_pixels + y * src_stride, 0, row.data(), 0, width,
+                         1);
+      libyuv::ARGBToJ400(row.data(), 0, dst + y * dst_row_bytes, 0, width, 1);
+    }
+    return true;
+  }
+
+  bool swap_rb = (format == Format::kRGBA) == kN32IsBGRA;
+  CopyPixels(src_pixels, src_stride, dst, dst_stride, width, height, swap_rb);
+  // The alpha channel is last in both orders, so this works on either.
+  if (!premultiplied && src.alphaType() != kOpaque_SkAlphaType)
+    libyuv::ARGBUnattenuate(dst, dst_stride, dst, dst_stride, width, height);
+  return true;
+}
+
+bool ConvertToN32(const uint8_t* src,
+                  size_t src_row_bytes,
+                  Format format,
+                  bool premultiplied,
+                  const SkPixmap& dst) {
+  if (!IsN32Premul(dst))
+    return false;
+
+  auto* dst_pixels = static_cast<uint8_t*>(dst.writable_addr());
+  int src_stride = static_cast<int>(src_row_bytes);
+  int dst_stride = static_cast<int>(dst.rowBytes());
+  int width = dst.width();
+  int height = dst.height();
+
+  if (format == Format::kGray) {
+    // Red and blue are equal, so the order does not matter.
+    libyuv::J400ToARGB(src, src_stride, dst_pixels, dst_stride, width, height);
+    return true;
+  }
+
+  bool swap_rb = (format == Format::kRGBA) == kN32IsBGRA;
+  CopyPixels(src, src_stride, dst_pixels, dst_stride, width, height, swap_rb);
+  if (!premultiplied) {
+    libyuv::ARGBAttenuate(dst_pixels, dst_stride, dst_pixels, dst_stride,
+                          width, height);
+  }
+  return true;
+}
+
+}  // namespace pixels
+
+}  // namespace electron
@@ -0,0 +1,45 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_PIXEL_KERNELS_H_
+#define SHELL_COMMON_PIXEL_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+class SkPixmap;
+
+namespace electron {
+
+namespace pixels {
+
+// The layouts of pixels given to and taken from JavaScript, in memory order.
+enum class Format { kBGRA, kRGBA, kGray };
+
+// Returns the bytes per pixel of |format|.
+int GetBytesPerPixel(Format format);
+
+// Converts premultiplied N32 pixels to |format|, unpremultiplying them unless
+// |premultiplied|. Gray is the luma of the premultiplied colors. The kernels
+// are vectorized, with SSE2, AVX2 or NEON picked at runtime and a scalar
+// fallback. Returns false if |src| is not N32 premultiplied.
+bool ConvertFromN32(const SkPixmap& src,
+                    Format format,
+                    bool premultiplied,
+                    uint8_t* dst,
+                    size_t dst_row_bytes);
+
+// The reverse of ConvertFromN32, into premultiplied N32 pixels. Gray pixels
+// are opaque.
+bool ConvertToN32(const uint8_t* src,
+                  size_t src_row_bytes,
+                  Format format,
+                  bool premultiplied,
+                  const SkPixmap& dst);
+
+}  // namespace pixels
+
+}  // namespace electron
+
+#endif  // SHELL_COMMON_PIXEL_KERNELS_H_
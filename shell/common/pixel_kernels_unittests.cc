@@ -0,0 +1,129 @@
+// Copyright (c) 2021 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "shell/common/pixel_kernels.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkColor.h"
+#include "third_party/skia/include/core/SkColorPriv.h"
+#include "third_party/skia/include/core/SkUnPreMultiply.h"
+
+namespace electron {
+
+namespace pixels {
+
+namespace {
+
+// Odd sizes exercise the scalar tails of the vector kernels.
+constexpr int kWidth = 37;
+constexpr int kHeight = 5;
+
+SkBitmap CreateBitmap() {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kWidth, kHeight);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      U8CPU alpha = (x * 7 + y * 31) & 0xff;
+      *bitmap.getAddr32(x, y) =
+          SkPreMultiplyARGB(alpha, x * 5, 255 - x, y * 50);
+    }
+  }
+  return bitmap;
+}
+
+}  // namespace
+
+TEST(PixelKernelsTest, ConvertsToRGBAAndBGRA) {
+  SkBitmap bitmap = CreateBitmap();
+  std::vector<uint8_t> rgba(kWidth * kHeight * 4);
+  std::vector<uint8_t> bgra(kWidth * kHeight * 4);
+  ASSERT_TRUE(ConvertFromN32(bitmap.pixmap(), Format::kRGBA, true,
+                             rgba.data(), kWidth * 4));
+  ASSERT_TRUE(ConvertFromN32(bitmap.pixmap(), Format::kBGRA, true,
+                             bgra.data(), kWidth * 4));
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      SkPMColor color = *bitmap.getAddr32(x, y);
+      const uint8_t* p = &rgba[(y * kWidth + x) * 4];
+      EXPECT_EQ(SkGetPackedR32(color), p[0]);
+      EXPECT_EQ(SkGetPackedG32(color), p[1]);
+      EXPECT_EQ(SkGetPackedB32(color), p[2]);
+      EXPECT_EQ(SkGetPackedA32(color), p[3]);
+      const uint8_t* q = &bgra[(y * kWidth + x) * 4];
+      EXPECT_EQ(p[0], q[2]);
+      EXPECT_EQ(p[2], q[0]);
+    }
+  }
+}
+
+TEST(PixelKernelsTest, Unpremultiplies) {
+  SkBitmap bitmap = CreateBitmap();
+  std::vector<uint8_t> rgba(kWidth * kHeight * 4);
+  ASSERT_TRUE(ConvertFromN32(bitmap.pixmap(), Format::kRGBA, false,
+                             rgba.data(), kWidth * 4));
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      SkColor color = SkUnPreMultiply::PMColorToColor(*bitmap.getAddr32(x, y));
+      const uint8_t* p = &rgba[(y * kWidth + x) * 4];
+      // The kernels round differently from Skia.
+      EXPECT_NEAR(SkColorGetR(color), p[0], 2);
+      EXPECT_NEAR(SkColorGetG(color), p[1], 2);
+      EXPECT_NEAR(SkColorGetB(color), p[2], 2);
+      EXPECT_EQ(SkColorGetA(color), p[3]);
+    }
+  }
+}
+
+TEST(PixelKernelsTest, RoundTrips) {
+  SkBitmap bitmap = CreateBitmap();
+  for (Format format : {Format::kRGBA, Format::kBGRA}) {
+    std::vector<uint8_t> pixels(kWidth * kHeight * 4);
+    ASSERT_TRUE(ConvertFromN32(bitmap.pixmap(), format, true, pixels.data(),
+                               kWidth * 4));
+    SkBitmap result;
+    result.allocN32Pixels(kWidth, kHeight);
+    ASSERT_TRUE(
+        ConvertToN32(pixels.data(), kWidth * 4, format, true, result.pixmap()));
+    for (int y = 0; y < kHeight; ++y) {
+      for (int x = 0; x < kWidth; ++x)
+        EXPECT_EQ(*bitmap.getAddr32(x, y), *result.getAddr32(x, y));
+    }
+  }
+}
+
+TEST(PixelKernelsTest, ConvertsToGray) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kWidth, kHeight, true);
+  bitmap.eraseColor(SK_ColorWHITE);
+  *bitmap.getAddr32(0, 0) = SkPreMultiplyColor(SK_ColorBLACK);
+  std::vector<uint8_t> gray(kWidth * kHeight);
+  ASSERT_TRUE(ConvertFromN32(bitmap.pixmap(), Format::kGray, true,
+                             gray.data(), kWidth));
+  EXPECT_EQ(0, gray[0]);
+  EXPECT_EQ(255, gray[1]);
+  EXPECT_EQ(255, gray.back());
+
+  SkBitmap result;
+  result.allocN32Pixels(kWidth, kHeight);
+  ASSERT_TRUE(
+      ConvertToN32(gray.data(), kWidth, Format::kGray, true, result.pixmap()));
+  EXPECT_EQ(SkPreMultiplyColor(SK_ColorBLACK), *result.getAddr32(0, 0));
+  EXPECT_EQ(SkPreMultiplyColor(SK_ColorWHITE), *result.getAddr32(1, 0));
+}
+
+TEST(PixelKernelsTest, RejectsOtherColorTypes) {
+  SkBitmap bitmap;
+  bitmap.allocPixels(SkImageInfo::MakeA8(4, 4));
+  std::vector<uint8_t> pixels(4 * 4 * 4);
+  EXPECT_FALSE(ConvertFromN32(bitmap.pixmap(), Format::kRGBA, true,
+                              pixels.data(), 16));
+}
+
+}  // namespace pixels
+
+}  // namespace electron
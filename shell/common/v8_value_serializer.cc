@@ -4,9 +4,18 @@
 
 #include "shell/common/v8_value_serializer.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "base/hash/hash.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/no_destructor.h"
+#include "base/numerics/safe_conversions.h"
+#include "base/threading/thread_local.h"
 #include "gin/converter.h"
 #include "shell/common/api/electron_api_native_image.h"
 #include "shell/common/gin_helper/microtasks_scope.h"
@@ -18,21 +27,233 @@
 namespace electron {
 
 namespace {
-enum SerializationTag { kNativeImageTag = 'i', kVersionTag = 0xFF };
+
+enum SerializationTag {
+  kNativeImageTag = 'i',
+  kArrayBufferViewTag = 'v',
+  kVersionTag = 0xFF
+};
+
+// The types of the ArrayBuffer views written by the delegate.
+enum class ArrayBufferViewType : uint32_t {
+  kUint8Array,
+  kInt8Array,
+  kUint8ClampedArray,
+  kUint16Array,
+  kInt16Array,
+  kUint32Array,
+  kInt32Array,
+  kFloat32Array,
+  kFloat64Array,
+  kBigUint64Array,
+  kBigInt64Array,
+  kDataView,
+  kLast = kDataView,
+};
+
+// Views from this size on are worth the cost of a shared memory region over
+// being copied inline, which happens several times on the way.
+constexpr size_t kSharedBufferThreshold = 1024 * 1024;
+
+// The limits of the shared memory regions of a message. Views beyond them are
+// copied inline.
+constexpr size_t kMaxSharedBufferCount = 64;
+constexpr uint64_t kMaxSharedBuffersSize = 512 * 1024 * 1024;
+
+bool GetArrayBufferViewType(v8::Local<v8::ArrayBufferView> view,
+                            ArrayBufferViewType* type) {
+  if (view->IsUint8Array())
+    *type = ArrayBufferViewType::kUint8Array;
+  else if (view->IsInt8Array())
+    *type = ArrayBufferViewType::kInt8Array;
+  else if (view->IsUint8ClampedArray())
+    *type = ArrayBufferViewType::kUint8ClampedArray;
+  else if (view->IsUint16Array())
+    *type = ArrayBufferViewType::kUint16Array;
+  else if (view->IsInt16Array())
+    *type = ArrayBufferViewType::kInt16Array;
+  else if (view->IsUint32Array())
+    *type = ArrayBufferViewType::kUint32Array;
+  else if (view->IsInt32Array())
+    *type = ArrayBufferViewType::kInt32Array;
+  else if (view->IsFloat32Array())
+    *type = ArrayBufferViewType::kFloat32Array;
+  else if (view->IsFloat64Array())
+    *type = ArrayBufferViewType::kFloat64Array;
+  else if (view->IsBigUint64Array())
+    *type = ArrayBufferViewType::kBigUint64Array;
+  else if (view->IsBigInt64Array())
+    *type = ArrayBufferViewType::kBigInt64Array;
+  else if (view->IsDataView())
+    *type = ArrayBufferViewType::kDataView;
+  else
+    return false;
+  return true;
+}
+
+// Returns a view of |type| over the whole of |buffer|, or an empty handle when
+// the size of the buffer does not fit the type.
+v8::Local<v8::ArrayBufferView> NewArrayBufferView(
+    ArrayBufferViewType type,
+    v8::Local<v8::ArrayBuffer> buffer) {
+  size_t size = buffer->ByteLength();
+  switch (type) {
+    case ArrayBufferViewType::kUint8Array:
+      return v8::Uint8Array::New(buffer, 0, size);
+    case ArrayBufferViewType::kInt8Array:
+      return v8::Int8Array::New(buffer, 0, size);
+    case ArrayBufferViewType::kUint8ClampedArray:
+      return v8::Uint8ClampedArray::New(buffer, 0, size);
+    case ArrayBufferViewType::kDataView:
+      return v8::DataView::New(buffer, 0, size);
+    case ArrayBufferViewType::kUint16Array:
+    case ArrayBufferViewType::kInt16Array:
+      if (size % 2)
+        return v8::Local<v8::ArrayBufferView>();
+      if (type == ArrayBufferViewType::kUint16Array)
+        return v8::Uint16Array::New(buffer, 0, size / 2);
+      return v8::Int16Array::New(buffer, 0, size / 2);
+    case ArrayBufferViewType::kUint32Array:
+    case ArrayBufferViewType::kInt32Array:
+    case ArrayBufferViewType::kFloat32Array:
+      if (size % 4)
+        return v8::Local<v8::ArrayBufferView>();
+      if (type == ArrayBufferViewType::kUint32Array)
+        return v8::Uint32Array::New(buffer, 0, size / 4);
+      if (type == ArrayBufferViewType::kInt32Array)
+        return v8::Int32Array::New(buffer, 0, size / 4);
+      return v8::Float32Array::New(buffer, 0, size / 4);
+    case ArrayBufferViewType::kFloat64Array:
+    case ArrayBufferViewType::kBigUint64Array:
+    case ArrayBufferViewType::kBigInt64Array:
+      if (size % 8)
+        return v8::Local<v8::ArrayBufferView>();
+      if (type == ArrayBufferViewType::kFloat64Array)
+        return v8::Float64Array::New(buffer, 0, size / 8);
+      if (type == ArrayBufferViewType::kBigUint64Array)
+        return v8::BigUint64Array::New(buffer, 0, size / 8);
+      return v8::BigInt64Array::New(buffer, 0, size / 8);
+  }
+  return v8::Local<v8::ArrayBufferView>();
+}
+
+// Thread-local buffers for serialized messages. Messages up to
+// kMaxPooledBufferSize are built in a pooled buffer and copied out at their
+// exact size, instead of each growing a new buffer by doubling it. Larger
+// ones get a buffer sized from the recent messages of their channel or from
+// the shape of their value, and are handed over without a copy.
+class SerializationBufferPool {
+ public:
+  static SerializationBufferPool* Get() {
+    static base::NoDestructor<
+        base::ThreadLocalOwnedPointer<SerializationBufferPool>>
+        pools;
+    if (!pools->Get())
+      pools->Set(std::make_unique<SerializationBufferPool>());
+    return pools->Get();
+  }
+
+  static constexpr size_t kMaxPooledBufferSize = 1024 * 1024;
+
+  SerializationBufferPool() = default;
+
+  // disable copy
+  SerializationBufferPool(const SerializationBufferPool&) = delete;
+  SerializationBufferPool& operator=(const SerializationBufferPool&) = delete;
+
+  // The returned buffer has as many bytes as it can hold, so that it does not
+  // have to be cleared.
+  std::vector<uint8_t> Acquire(size_t size_hint) {
+    std::vector<uint8_t> buffer;
+    if (size_hint <= kMaxPooledBufferSize && !buffers_.empty()) {
+      buffer = std::move(buffers_.back());
+      buffers_.pop_back();
+    }
+    if (buffer.size() < size_hint)
+      buffer.resize(size_hint + size_hint / 8);
+    return buffer;
+  }
+
+  void Recycle(std::vector<uint8_t> buffer) {
+    // Buffers are reentrant only through getters, so a few are enough.
+    if (buffer.size() <= kMaxPooledBufferSize && buffers_.size() < 4)
+      buffers_.push_back(std::move(buffer));
+  }
+
+  // Sizes are remembered per channel in a small direct-mapped table. The
+  // hint decays, so that a single large message is soon forgotten.
+  size_t GetSizeHint(uint32_t channel_hash) const {
+    const SizeHint& hint = size_hints_[channel_hash % size_hints_.size()];
+    return hint.channel_hash == channel_hash ? hint.size : 0;
+  }
+
+  void RecordSize(uint32_t channel_hash, size_t size) {
+    SizeHint& hint = size_hints_[channel_hash % size_hints_.size()];
+    if (hint.channel_hash != channel_hash)
+      hint = {channel_hash, 0};
+    hint.size = std::max(size, hint.size - hint.size / 4);
+  }
+
+ private:
+  struct SizeHint {
+    uint32_t channel_hash = 0;
+    size_t size = 0;
+  };
+
+  std::vector<std::vector<uint8_t>> buffers_;
+  std::array<SizeHint, 64> size_hints_;
+};
+
+// Estimates the size of |value| once serialized from its shape alone, so that
+// no JavaScript runs: a plain string takes its bytes, and an array at least a
+// tag and a byte for each element, as dense arrays of primitives do. Other
+// values rely on the size hint of their channel.
+size_t EstimateSerializedSize(v8::Local<v8::Value> value) {
+  // The envelope, the header and the tag and length of the value.
+  constexpr size_t kOverhead = 16;
+  if (value->IsString()) {
+    v8::Local<v8::String> string = value.As<v8::String>();
+    return kOverhead + string->Length() * (string->IsOneByte() ? 1 : 2);
+  }
+  if (value->IsArray())
+    return kOverhead + value.As<v8::Array>()->Length() * size_t{2};
+  return 0;
+}
+
 }  // namespace
 
 class V8Serializer : public v8::ValueSerializer::Delegate {
  public:
-  explicit V8Serializer(v8::Isolate* isolate)
-      : isolate_(isolate), serializer_(isolate, this) {}
-  ~V8Serializer() override = default;
+  // |channel_hash| identifies the IPC channel of the message, 0 if none.
+  explicit V8Serializer(v8::Isolate* isolate, uint32_t channel_hash = 0)
+      : isolate_(isolate),
+        channel_hash_(channel_hash),
+        pool_(SerializationBufferPool::Get()),
+        serializer_(isolate, this) {}
+  ~V8Serializer() override {
+    if (!data_.empty())
+      pool_->Recycle(std::move(data_));
+  }
 
-  bool Serialize(v8::Local<v8::Value> value, blink::CloneableMessage* out) {
+  bool Serialize(
+      v8::Local<v8::Value> value,
+      blink::CloneableMessage* out,
+      std::vector<base::ReadOnlySharedMemoryRegion>* shared_buffers = nullptr) {
     gin_helper::MicrotasksScope microtasks_scope(
         isolate_, v8::MicrotasksScope::kDoNotRunMicrotasks);
+    size_t size_hint = EstimateSerializedSize(value);
+    if (channel_hash_)
+      size_hint = std::max(size_hint, pool_->GetSizeHint(channel_hash_));
+    data_ = pool_->Acquire(size_hint);
     WriteBlinkEnvelope(19);
 
     serializer_.WriteHeader();
+    if (shared_buffers) {
+      // Views are handed to WriteHostObject as the value is written, which
+      // moves the large ones to |shared_buffers|.
+      shared_buffers_ = shared_buffers;
+      serializer_.SetTreatArrayBufferViewsAsHostObjects(true);
+    }
     bool wrote_value;
     if (!serializer_.WriteValue(isolate_->GetCurrentContext(), value)
              .To(&wrote_value)) {
@@ -44,8 +265,16 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
 
     std::pair<uint8_t*, size_t> buffer = serializer_.Release();
     DCHECK_EQ(buffer.first, data_.data());
-    out->encoded_message = base::make_span(buffer.first, buffer.second);
-    out->owned_encoded_message = std::move(data_);
+    if (channel_hash_)
+      pool_->RecordSize(channel_hash_, buffer.second);
+    if (buffer.second > SerializationBufferPool::kMaxPooledBufferSize) {
+      data_.resize(buffer.second);
+      out->owned_encoded_message = std::move(data_);
+    } else {
+      out->owned_encoded_message.assign(buffer.first,
+                                        buffer.first + buffer.second);
+    }
+    out->encoded_message = out->owned_encoded_message;
 
     return true;
   }
@@ -54,19 +283,24 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
   void* ReallocateBufferMemory(void* old_buffer,
                                size_t size,
                                size_t* actual_size) override {
-    DCHECK_EQ(old_buffer, data_.data());
-    data_.resize(size);
-    *actual_size = data_.capacity();
+    DCHECK(!old_buffer || old_buffer == data_.data());
+    if (size > data_.size()) {
+      data_.resize(size);
+      data_.resize(data_.capacity());
+    }
+    *actual_size = data_.size();
     return data_.data();
   }
 
   void FreeBufferMemory(void* buffer) override {
-    DCHECK_EQ(buffer, data_.data());
-    data_ = {};
+    // |data_| goes back to the pool with the serializer.
   }
 
   v8::Maybe<bool> WriteHostObject(v8::Isolate* isolate,
                                   v8::Local<v8::Object> object) override {
+    if (object->IsArrayBufferView())
+      return WriteArrayBufferView(object.As<v8::ArrayBufferView>());
+
     api::NativeImage* native_image;
     if (gin::ConvertFromV8(isolate, object, &native_image)) {
       // Serialize the NativeImage
@@ -93,6 +327,52 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
   }
 
  private:
+  // Writes |view| with its own copy of its contents, so views of a same
+  // buffer do not share it once deserialized. Large contents go to a shared
+  // memory region while the limits of the message allow it.
+  v8::Maybe<bool> WriteArrayBufferView(v8::Local<v8::ArrayBufferView> view) {
+    DCHECK(shared_buffers_);
+    ArrayBufferViewType type;
+    if (!GetArrayBufferViewType(view, &type) ||
+        (view->HasBuffer() && view->Buffer()->IsSharedArrayBuffer())) {
+      // Throws an exception.
+      return v8::ValueSerializer::Delegate::WriteHostObject(isolate_, view);
+    }
+
+    size_t size = view->ByteLength();
+    WriteTag(kArrayBufferViewTag);
+    serializer_.WriteUint32(static_cast<uint32_t>(type));
+    serializer_.WriteUint64(size);
+    if (size >= kSharedBufferThreshold &&
+        shared_buffers_->size() < kMaxSharedBufferCount &&
+        size <= kMaxSharedBuffersSize - shared_buffers_size_) {
+      base::MappedReadOnlyRegion shared =
+          base::ReadOnlySharedMemoryRegion::Create(size);
+      if (shared.IsValid()) {
+        view->CopyContents(shared.mapping.memory(), size);
+        shared_buffers_size_ += size;
+        shared_buffers_->push_back(std::move(shared.region));
+        // The index of the region, from 1.
+        serializer_.WriteUint32(shared_buffers_->size());
+        return v8::Just(true);
+      }
+    }
+
+    // The contents follow inline.
+    serializer_.WriteUint32(0);
+    if (view->HasBuffer()) {
+      const auto* data = static_cast<const uint8_t*>(
+          view->Buffer()->GetBackingStore()->Data());
+      serializer_.WriteRawBytes(data + view->ByteOffset(), size);
+    } else {
+      // The contents of small views are not in a buffer of their own yet.
+      std::vector<uint8_t> contents(size);
+      view->CopyContents(contents.data(), size);
+      serializer_.WriteRawBytes(contents.data(), size);
+    }
+    return v8::Just(true);
+  }
+
   void WriteTag(SerializationTag tag) { serializer_.WriteRawBytes(&tag, 1); }
 
   void WriteBlinkEnvelope(uint32_t blink_version) {
@@ -103,7 +383,11 @@ class V8Serializer : public v8::ValueSerializer::Delegate {
   }
 
   v8::Isolate* isolate_;
+  uint32_t channel_hash_;
+  SerializationBufferPool* pool_;
   std::vector<uint8_t> data_;
+  std::vector<base::ReadOnlySharedMemoryRegion>* shared_buffers_ = nullptr;
+  uint64_t shared_buffers_size_ = 0;
   v8::ValueSerializer serializer_;
 };
 
@@ -114,6 +398,12 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
         deserializer_(isolate, data.data(), data.size(), this) {}
   V8Deserializer(v8::Isolate* isolate, const blink::CloneableMessage& message)
       : V8Deserializer(isolate, message.encoded_message) {}
+  V8Deserializer(v8::Isolate* isolate,
+                 const blink::CloneableMessage& message,
+                 std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers)
+      : V8Deserializer(isolate, message.encoded_message) {
+    shared_buffers_ = std::move(shared_buffers);
+  }
 
   v8::Local<v8::Value> Deserialize() {
     v8::EscapableHandleScope scope(isolate_);
@@ -142,12 +432,54 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
         if (api::NativeImage* native_image = ReadNativeImage(isolate))
           return native_image->GetWrapper(isolate);
         break;
+      case kArrayBufferViewTag: {
+        v8::Local<v8::ArrayBufferView> view = ReadArrayBufferView();
+        if (!view.IsEmpty())
+          return view;
+        break;
+      }
     }
     // Throws an exception.
     return v8::ValueDeserializer::Delegate::ReadHostObject(isolate);
   }
 
  private:
+  // Reads a view written by WriteArrayBufferView into a buffer of its own.
+  // The contents of shared regions are copied as well, since the sender may
+  // still write to them, and each region is only read once.
+  v8::Local<v8::ArrayBufferView> ReadArrayBufferView() {
+    uint32_t type = 0;
+    uint64_t written_size = 0;
+    uint32_t shared_index = 0;
+    if (!deserializer_.ReadUint32(&type) ||
+        type > static_cast<uint32_t>(ArrayBufferViewType::kLast) ||
+        !deserializer_.ReadUint64(&written_size) ||
+        !base::IsValueInRangeForNumericType<size_t>(written_size) ||
+        !deserializer_.ReadUint32(&shared_index))
+      return v8::Local<v8::ArrayBufferView>();
+    size_t size = static_cast<size_t>(written_size);
+
+    const void* data = nullptr;
+    base::ReadOnlySharedMemoryMapping mapping;
+    if (shared_index == 0) {
+      if (!deserializer_.ReadRawBytes(size, &data))
+        return v8::Local<v8::ArrayBufferView>();
+    } else {
+      if (shared_index > shared_buffers_.size())
+        return v8::Local<v8::ArrayBufferView>();
+      base::ReadOnlySharedMemoryRegion region =
+          std::move(shared_buffers_[shared_index - 1]);
+      mapping = region.Map();
+      if (!mapping.IsValid() || mapping.size() < size)
+        return v8::Local<v8::ArrayBufferView>();
+      data = mapping.memory();
+    }
+
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate_, size);
+    memcpy(buffer->GetBackingStore()->Data(), data, size);
+    return NewArrayBufferView(static_cast<ArrayBufferViewType>(type), buffer);
+  }
+
   bool ReadTag(uint8_t* tag) {
     const void* tag_bytes = nullptr;
     if (!deserializer_.ReadRawBytes(1, &tag_bytes))
@@ -194,6 +526,7 @@ class V8Deserializer : public v8::ValueDeserializer::Delegate {
 
   v8::Isolate* isolate_;
   v8::ValueDeserializer deserializer_;
+  std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers_;
 };
 
 bool SerializeV8Value(v8::Isolate* isolate,
@@ -207,6 +540,38 @@ v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
   return V8Deserializer(isolate, in).Deserialize();
 }
 
+bool SerializeV8Value(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> value,
+    blink::CloneableMessage* out,
+    base::StringPiece channel,
+    std::vector<base::ReadOnlySharedMemoryRegion>* shared_buffers) {
+  return V8Serializer(isolate, base::PersistentHash(channel))
+      .Serialize(value, out, shared_buffers);
+}
+
+v8::Local<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate,
+    const blink::CloneableMessage& in,
+    std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers) {
+  return V8Deserializer(isolate, in, std::move(shared_buffers)).Deserialize();
+}
+
+bool AreSharedBuffersWithinLimits(
+    const std::vector<base::ReadOnlySharedMemoryRegion>& shared_buffers) {
+  if (shared_buffers.size() > kMaxSharedBufferCount)
+    return false;
+  uint64_t size = 0;
+  for (const auto& region : shared_buffers) {
+    if (!region.IsValid())
+      return false;
+    size += region.GetSize();
+    if (size > kMaxSharedBuffersSize)
+      return false;
+  }
+  return true;
+}
+
 v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
                                         base::span<const uint8_t> data) {
   return V8Deserializer(isolate, data).Deserialize();
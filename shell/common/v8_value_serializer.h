@@ -5,7 +5,11 @@
 #ifndef SHELL_COMMON_V8_VALUE_SERIALIZER_H_
 #define SHELL_COMMON_V8_VALUE_SERIALIZER_H_
 
+#include <vector>
+
 #include "base/containers/span.h"
+#include "base/memory/read_only_shared_memory_region.h"
+#include "base/strings/string_piece.h"
 
 namespace v8 {
 class Isolate;
@@ -25,6 +29,31 @@ bool SerializeV8Value(v8::Isolate* isolate,
                       blink::CloneableMessage* out);
 v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
                                         const blink::CloneableMessage& in);
+
+// Same as above, for the arguments of an IPC message on |channel|, whose
+// buffer is sized from the recent messages of the channel. When
+// |shared_buffers| is given, the contents of large ArrayBuffer views, such as
+// Buffers and typed arrays, are copied to read-only shared memory regions
+// instead of into the message, as long as the regions stay within the limits
+// of a message. The regions have to be sent alongside the message. The
+// receiver copies the views out of them, so that the sender can not change
+// them once received.
+bool SerializeV8Value(
+    v8::Isolate* isolate,
+    v8::Local<v8::Value> value,
+    blink::CloneableMessage* out,
+    base::StringPiece channel,
+    std::vector<base::ReadOnlySharedMemoryRegion>* shared_buffers = nullptr);
+v8::Local<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate,
+    const blink::CloneableMessage& in,
+    std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers);
+
+// Returns whether |shared_buffers| are within the limits of a message, which
+// the receiver checks before deserializing it.
+bool AreSharedBuffersWithinLimits(
+    const std::vector<base::ReadOnlySharedMemoryRegion>& shared_buffers);
+
 v8::Local<v8::Value> DeserializeV8Value(v8::Isolate* isolate,
                                         base::span<const uint8_t> data);
 
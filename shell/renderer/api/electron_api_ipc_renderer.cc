@@ -3,8 +3,11 @@
 // found in the LICENSE file.
 
 #include <string>
+#include <vector>
 
+#include "base/memory/weak_ptr.h"
 #include "base/task/post_task.h"
+#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/values.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
@@ -63,13 +66,18 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
         electron_browser_remote_.BindNewPipeAndPassReceiver());
   }
 
-  void OnDestruct() override { electron_browser_remote_.reset(); }
+  void OnDestruct() override {
+    FlushBatch();
+    electron_browser_remote_.reset();
+  }
 
   void WillReleaseScriptContext(v8::Local<v8::Context> context,
                                 int32_t world_id) override {
     if (weak_context_.IsEmpty() ||
-        weak_context_.Get(context->GetIsolate()) == context)
+        weak_context_.Get(context->GetIsolate()) == context) {
+      FlushBatch();
       electron_browser_remote_.reset();
+    }
   }
 
   // gin::Wrappable:
@@ -77,6 +85,7 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       v8::Isolate* isolate) override {
     return gin::Wrappable<IPCRenderer>::GetObjectTemplateBuilder(isolate)
         .SetMethod("send", &IPCRenderer::SendMessage)
+        .SetMethod("sendBatched", &IPCRenderer::SendBatched)
         .SetMethod("sendSync", &IPCRenderer::SendSync)
         .SetMethod("sendTo", &IPCRenderer::SendTo)
         .SetMethod("sendToHost", &IPCRenderer::SendToHost)
@@ -96,13 +105,47 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       thrower.ThrowError(kIPCMethodCalledAfterContextReleasedError);
       return;
     }
+    FlushBatch();
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    if (!electron::SerializeV8Value(isolate, arguments, &message, channel)) {
       return;
     }
     electron_browser_remote_->Message(internal, channel, std::move(message));
   }
 
+  // Queues the message, to be sent with the others of the current task in a
+  // single call. Messages sent by other means flush the queue first, so that
+  // ordering is kept.
+  void SendBatched(v8::Isolate* isolate,
+                   gin_helper::ErrorThrower thrower,
+                   const std::string& channel,
+                   v8::Local<v8::Value> arguments) {
+    if (!electron_browser_remote_) {
+      thrower.ThrowError(kIPCMethodCalledAfterContextReleasedError);
+      return;
+    }
+    blink::CloneableMessage message;
+    if (!electron::SerializeV8Value(isolate, arguments, &message, channel)) {
+      return;
+    }
+    if (pending_batch_.empty()) {
+      base::SequencedTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(&IPCRenderer::FlushBatch,
+                                    weak_factory_.GetWeakPtr()));
+    }
+    pending_batch_.push_back(
+        electron::mojom::BatchedMessage::New(channel, std::move(message)));
+  }
+
+  void FlushBatch() {
+    if (pending_batch_.empty())
+      return;
+    std::vector<electron::mojom::BatchedMessagePtr> batch;
+    batch.swap(pending_batch_);
+    if (electron_browser_remote_)
+      electron_browser_remote_->MessageBatch(std::move(batch));
+  }
+
   v8::Local<v8::Promise> Invoke(v8::Isolate* isolate,
                                 gin_helper::ErrorThrower thrower,
                                 bool internal,
@@ -112,15 +155,18 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       thrower.ThrowError(kIPCMethodCalledAfterContextReleasedError);
       return v8::Local<v8::Promise>();
     }
+    FlushBatch();
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    std::vector<base::ReadOnlySharedMemoryRegion> shared_buffers;
+    if (!electron::SerializeV8Value(isolate, arguments, &message, channel,
+                                    &shared_buffers)) {
       return v8::Local<v8::Promise>();
     }
     gin_helper::Promise<blink::CloneableMessage> p(isolate);
     auto handle = p.GetHandle();
 
     electron_browser_remote_->Invoke(
-        internal, channel, std::move(message),
+        internal, channel, std::move(message), std::move(shared_buffers),
         base::BindOnce(
             [](gin_helper::Promise<blink::CloneableMessage> p,
                blink::CloneableMessage result) { p.Resolve(result); },
@@ -138,6 +184,7 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       thrower.ThrowError(kIPCMethodCalledAfterContextReleasedError);
       return;
     }
+    FlushBatch();
     blink::TransferableMessage transferable_message;
     if (!electron::SerializeV8Value(isolate, message_value,
                                     &transferable_message)) {
@@ -179,8 +226,9 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       thrower.ThrowError(kIPCMethodCalledAfterContextReleasedError);
       return;
     }
+    FlushBatch();
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    if (!electron::SerializeV8Value(isolate, arguments, &message, channel)) {
       return;
     }
     electron_browser_remote_->MessageTo(web_contents_id, channel,
@@ -195,8 +243,9 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       thrower.ThrowError(kIPCMethodCalledAfterContextReleasedError);
       return;
     }
+    FlushBatch();
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    if (!electron::SerializeV8Value(isolate, arguments, &message, channel)) {
       return;
     }
     electron_browser_remote_->MessageHost(channel, std::move(message));
@@ -211,8 +260,9 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
       thrower.ThrowError(kIPCMethodCalledAfterContextReleasedError);
       return v8::Local<v8::Value>();
     }
+    FlushBatch();
     blink::CloneableMessage message;
-    if (!electron::SerializeV8Value(isolate, arguments, &message)) {
+    if (!electron::SerializeV8Value(isolate, arguments, &message, channel)) {
       return v8::Local<v8::Value>();
     }
 
@@ -224,6 +274,9 @@ class IPCRenderer : public gin::Wrappable<IPCRenderer>,
 
   v8::Global<v8::Context> weak_context_;
   mojo::Remote<electron::mojom::ElectronBrowser> electron_browser_remote_;
+  std::vector<electron::mojom::BatchedMessagePtr> pending_batch_;
+
+  base::WeakPtrFactory<IPCRenderer> weak_factory_{this};
 };
 
 gin::WrapperInfo IPCRenderer::kWrapperInfo = {gin::kEmbedderNativeGin};
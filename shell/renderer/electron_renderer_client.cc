@@ -5,12 +5,19 @@
 #include "shell/renderer/electron_renderer_client.h"
 
 #include <string>
+#include <utility>
 
+#include "base/bind.h"
 #include "base/command_line.h"
+#include "base/task/thread_pool.h"
 #include "content/public/renderer/render_frame.h"
+#include "content/public/renderer/render_thread.h"
 #include "electron/buildflags/buildflags.h"
+#include "electron/shell/common/api/api.mojom.h"
+#include "mojo/public/cpp/bindings/shared_remote.h"
 #include "net/http/http_request_headers.h"
 #include "shell/common/api/electron_bindings.h"
+#include "shell/common/asar/archive.h"
 #include "shell/common/gin_helper/dictionary.h"
 #include "shell/common/gin_helper/event_emitter_caller.h"
 #include "shell/common/node_bindings.h"
@@ -31,6 +38,16 @@ bool IsDevToolsExtension(content::RenderFrame* render_frame) {
       .SchemeIs("chrome-extension");
 }
 
+// Asks the browser process for the index of an asar archive it has opened.
+// The remote is shared so archives can be opened from any thread.
+base::ReadOnlySharedMemoryRegion GetSharedAsarIndex(
+    mojo::SharedRemote<mojom::ElectronAsarHost> asar_host,
+    const base::FilePath& path) {
+  base::ReadOnlySharedMemoryRegion region;
+  asar_host->GetArchiveIndex(path, &region);
+  return region;
+}
+
 }  // namespace
 
 ElectronRendererClient::ElectronRendererClient()
@@ -41,6 +58,21 @@ ElectronRendererClient::ElectronRendererClient()
 
 ElectronRendererClient::~ElectronRendererClient() = default;
 
+void ElectronRendererClient::RenderThreadStarted() {
+  // Attach to the asar indices built by the browser process instead of
+  // parsing the same headers again in every renderer.
+  mojo::PendingRemote<mojom::ElectronAsarHost> asar_host;
+  content::RenderThread::Get()->BindHostReceiver(
+      asar_host.InitWithNewPipeAndPassReceiver());
+  asar::Archive::SetSharedIndexProvider(base::BindRepeating(
+      &GetSharedAsarIndex,
+      mojo::SharedRemote<mojom::ElectronAsarHost>(
+          std::move(asar_host), base::ThreadPool::CreateSequencedTaskRunner(
+                                    {base::TaskPriority::USER_BLOCKING}))));
+
+  RendererClientBase::RenderThreadStarted();
+}
+
 void ElectronRendererClient::RenderFrameCreated(
     content::RenderFrame* render_frame) {
   new ElectronRenderFrameObserver(render_frame, this);
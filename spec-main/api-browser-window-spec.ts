@@ -3321,6 +3321,84 @@ describe('BrowserWindow module', () => {
         // upstream native_mate's implementation to gin.
       }).to.throw('Error processing argument at index 1, conversion failure from ');
     });
+
+    it('throws error when the pixel format is unknown', () => {
+      const w = new BrowserWindow({ show: false });
+      expect(() => {
+        w.webContents.beginFrameSubscription({ format: 'rgb565' as any }, () => {});
+      }).to.throw('Invalid pixel format');
+    });
+
+    it('shares frames between several subscriptions', async () => {
+      const w = new BrowserWindow({ show: false });
+      await w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'));
+      const nextFrame = (options: any) => new Promise<any>((resolve) => {
+        const id = w.webContents.beginFrameSubscription(options, (frame, dirtyRect) => {
+          // Chromium sometimes sends a 0x0 frame at the beginning.
+          if (frame.isEmpty && frame.isEmpty()) return;
+          w.webContents.endFrameSubscription(id);
+          resolve({ frame, dirtyRect });
+        });
+      });
+      const [argb, thumbnail, i420, nv12] = await Promise.all([
+        nextFrame({}),
+        nextFrame({ size: { width: 64, height: 64 } }),
+        nextFrame({ format: 'i420', size: { width: 64, height: 64 }, frameRate: 5 }),
+        nextFrame({ format: 'nv12', size: { width: 64, height: 64 } })
+      ]);
+      expect(argb.frame.constructor.name).to.equal('NativeImage');
+      const size = thumbnail.frame.getSize();
+      expect(Math.max(size.width, size.height)).to.be.at.most(64);
+      for (const { frame } of [i420, nv12]) {
+        expect(frame.size).to.deep.equal(size);
+        const chroma = Math.ceil(size.width / 2) * Math.ceil(size.height / 2);
+        expect(frame.data.length).to.equal(size.width * size.height + 2 * chroma);
+      }
+      expect(i420.frame.format).to.equal('i420');
+      expect(nv12.frame.format).to.equal('nv12');
+    });
+  });
+
+  describe('startRecording method', () => {
+    afterEach(closeAllWindows);
+
+    it('streams an IVF video of the page', async () => {
+      const w = new BrowserWindow({ show: false });
+      await w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'));
+      const stream = w.webContents.startRecording({ codec: 'vp9', size: { width: 64, height: 64 } });
+      const chunks: Buffer[] = [];
+      stream.on('data', (chunk: Buffer) => chunks.push(chunk));
+      const [, details] = await emittedOnce(w.webContents, 'recorded-frame');
+      expect(details.encodeTime).to.be.a('number');
+      const stats = await w.webContents.stopRecording();
+      expect(stats.framesEncoded).to.be.at.least(1);
+      await emittedOnce(stream, 'end');
+      const video = Buffer.concat(chunks);
+      expect(video.toString('ascii', 0, 4)).to.equal('DKIF');
+      expect(video.toString('ascii', 8, 12)).to.equal('VP90');
+    });
+
+    it('writes the video to a file', async () => {
+      const w = new BrowserWindow({ show: false });
+      await w.loadFile(path.join(fixtures, 'api', 'frame-subscriber.html'));
+      const videoPath = path.join(os.tmpdir(), `electron-recording-${process.pid}.ivf`);
+      defer(() => fs.unlinkSync(videoPath));
+      w.webContents.startRecording({ path: videoPath });
+      await emittedOnce(w.webContents, 'recorded-frame');
+      const stats = await w.webContents.stopRecording();
+      const video = fs.readFileSync(videoPath);
+      expect(video.toString('ascii', 0, 4)).to.equal('DKIF');
+      expect(video.readUInt32LE(24)).to.be.at.least(1);
+      expect(stats.framesDropped).to.be.a('number');
+    });
+
+    it('throws when already recording', async () => {
+      const w = new BrowserWindow({ show: false });
+      w.webContents.startRecording();
+      expect(() => w.webContents.startRecording()).to.throw('Already recording');
+      await w.webContents.stopRecording();
+      await expect(w.webContents.stopRecording()).to.eventually.be.rejectedWith('Not recording');
+    });
   });
 
   describe('savePage method', () => {
@@ -4679,6 +4757,125 @@ describe('BrowserWindow module', () => {
         expect(w.webContents.frameRate).to.equal(30);
       });
     });
+
+    describe('frame pacing APIs', () => {
+      it('counts the frames produced', async () => {
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        await emittedOnce(w.webContents, 'paint');
+        const stats = w.webContents.getFrameStats();
+        expect(stats.framesProduced).to.be.at.least(1);
+        expect(stats.framesSkipped).to.equal(0);
+        expect(stats.averageLatency).to.be.at.least(0);
+      });
+
+      it('keeps painting in adaptive mode', async () => {
+        w.webContents.setFramePacing({ adaptive: true, idleFrameRate: 5, idleFrameCount: 2 });
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        await emittedOnce(w.webContents, 'paint');
+        const { framesProduced } = w.webContents.getFrameStats();
+        w.webContents.invalidate();
+        await emittedOnce(w.webContents, 'paint');
+        expect(w.webContents.getFrameStats().framesProduced).to.be.above(framesProduced);
+      });
+
+      it('does not count the frames dropped while all the buffers are lent', async () => {
+        w.webContents.setFrameBufferCount(1);
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [,,, frame] = await emittedOnce(w.webContents, 'paint');
+        const { framesProduced } = w.webContents.getFrameStats();
+        w.webContents.invalidate();
+        await delay(200);
+        expect(w.webContents.getFrameStats().framesProduced).to.equal(framesProduced);
+        frame.release();
+      });
+
+      it('keeps painting when following a vsync', async () => {
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        await emittedOnce(w.webContents, 'paint');
+        for (let i = 0; i < 3; i++) {
+          w.webContents.notifyVSync();
+          await delay(16);
+        }
+        w.webContents.invalidate();
+        await emittedOnce(w.webContents, 'paint');
+      });
+    });
+
+    describe('dirty rects', () => {
+      it('gives the dirty rects of the frame', async () => {
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [, dirty, image, frame] = await emittedOnce(w.webContents, 'paint');
+        expect(frame.size).to.deep.equal(image.getSize());
+        expect(frame.dirtyRects).to.be.an('array').that.is.not.empty();
+        for (const rect of frame.dirtyRects) {
+          expect(rect.x).to.be.at.least(dirty.x);
+          expect(rect.y).to.be.at.least(dirty.y);
+          expect(rect.x + rect.width).to.be.at.most(dirty.x + dirty.width);
+          expect(rect.y + rect.height).to.be.at.most(dirty.y + dirty.height);
+        }
+      });
+
+      it('reads the dirty rects of the image', async () => {
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [,, image, frame] = await emittedOnce(w.webContents, 'paint');
+        for (const rect of frame.dirtyRects) {
+          const bitmap = image.toBitmap({ rect });
+          expect(bitmap.length).to.equal(rect.width * rect.height * 4);
+          expect(bitmap.equals(image.crop(rect).toBitmap())).to.be.true('bitmap matches cropped image');
+        }
+      });
+    });
+
+    describe('frame buffer APIs', () => {
+      it('does not use frame buffers by default', async () => {
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [,,, frame] = await emittedOnce(w.webContents, 'paint');
+        expect(frame.buffer).to.be.undefined();
+        expect(frame.release).to.be.undefined();
+        expect(w.webContents.getFrameBufferCount()).to.equal(0);
+      });
+
+      it('lends frames from the pool', async () => {
+        w.webContents.setFrameBufferCount(2);
+        expect(w.webContents.getFrameBufferCount()).to.equal(2);
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [, , image, frame] = await emittedOnce(w.webContents, 'paint');
+        expect(frame.buffer.length).to.equal(frame.size.width * frame.size.height * 4);
+        // The frame is only copied into the buffer.
+        expect(image.isEmpty()).to.be.true('image is empty');
+        frame.release();
+        // Releasing twice is harmless.
+        frame.release();
+      });
+
+      it('skips frames while all the buffers are lent', async () => {
+        w.webContents.setFrameBufferCount(1);
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        const [,,, frame] = await emittedOnce(w.webContents, 'paint');
+        let painted = false;
+        w.webContents.on('paint', () => { painted = true; });
+        w.webContents.invalidate();
+        await delay(200);
+        expect(painted).to.be.false('painted');
+        frame.release();
+        w.webContents.invalidate();
+        await emittedOnce(w.webContents, 'paint');
+      });
+
+      it('keeps painting while frames are released', async () => {
+        w.webContents.setFrameBufferCount(2);
+        let paint = emittedOnce(w.webContents, 'paint');
+        w.loadFile(path.join(fixtures, 'api', 'offscreen-rendering.html'));
+        for (let i = 0; i < 5; i++) {
+          const [,,, frame] = await paint;
+          expect(frame.buffer.length).to.equal(frame.size.width * frame.size.height * 4);
+          frame.release();
+          paint = emittedOnce(w.webContents, 'paint');
+          w.webContents.invalidate();
+        }
+        await paint;
+      });
+    });
   });
 
   describe('"transparent" option', () => {
@@ -119,6 +119,87 @@ describe('ipc module', () => {
       const [, { error }] = await emittedOnce(ipcMain, 'result');
       expect(error).to.match(/reply was never sent/);
     });
+
+    it('receives large views', async () => {
+      ipcMain.handleOnce('test', (e: IpcMainInvokeEvent, arg: any) => {
+        expect(arg.bytes).to.be.an.instanceOf(Uint8Array);
+        expect(arg.bytes.length).to.equal(4 * 1024 * 1024 - 16);
+        expect(arg.bytes[0]).to.equal(42);
+        expect(arg.bytes[arg.bytes.length - 1]).to.equal(7);
+        expect(arg.floats).to.be.an.instanceOf(Float64Array);
+        expect(arg.floats[1]).to.equal(0.5);
+        expect(arg.buffer).to.be.an.instanceOf(ArrayBuffer);
+        expect(arg.buffer.byteLength).to.equal(4 * 1024 * 1024);
+        // The views are writable.
+        arg.bytes[1] = 1;
+        return arg.bytes.length;
+      });
+      const result = await w.webContents.executeJavaScript(`(async () => {
+        const buffer = new ArrayBuffer(4 * 1024 * 1024);
+        const bytes = new Uint8Array(buffer, 16);
+        bytes[0] = 42;
+        bytes[bytes.length - 1] = 7;
+        const floats = new Float64Array(256 * 1024);
+        floats[1] = 0.5;
+        return require('electron').ipcRenderer.invoke('test', { buffer, bytes, floats });
+      })()`);
+      expect(result).to.equal(4 * 1024 * 1024 - 16);
+    });
+
+    it('reads the arguments once', async () => {
+      ipcMain.handleOnce('test', (e: IpcMainInvokeEvent, arg: any) => arg.bytes.length);
+      const reads = await w.webContents.executeJavaScript(`(async () => {
+        let reads = 0;
+        const arg = {
+          get bytes () {
+            reads++;
+            return new Uint8Array(2 * 1024 * 1024);
+          }
+        };
+        await require('electron').ipcRenderer.invoke('test', arg);
+        return reads;
+      })()`);
+      expect(reads).to.equal(1);
+    });
+
+    it('round-trips arrays of primitives and strings of varying sizes', async () => {
+      ipcMain.handle('test', (e: IpcMainInvokeEvent, ...args: any[]) => args);
+      try {
+        const results = await w.webContents.executeJavaScript(`(async () => {
+          const { ipcRenderer } = require('electron');
+          const sparse = [1, , 3]; // eslint-disable-line no-sparse-arrays
+          const named = [1, 2];
+          named.foo = 'bar';
+          const results = [];
+          results.push(await ipcRenderer.invoke('test', 1, 'a', true, null, undefined, 1.5, -7));
+          results.push(await ipcRenderer.invoke('test', sparse, named));
+          for (const size of [10, 100000, 2000000, 10]) {
+            results.push(await ipcRenderer.invoke('test', 'x'.repeat(size)));
+          }
+          return results.map(result => JSON.stringify(result, (k, v) => v === undefined ? 'undefined' : v) +
+            (Array.isArray(result[0]) ? ' ' + (1 in result[0]) + ' ' + result[1].foo : ''));
+        })()`);
+        expect(results).to.deep.equal([
+          '[1,"a",true,null,"undefined",1.5,-7]',
+          '[[1,"undefined",3],[1,2]] false bar',
+          JSON.stringify(['x'.repeat(10)]),
+          JSON.stringify(['x'.repeat(100000)]),
+          JSON.stringify(['x'.repeat(2000000)]),
+          JSON.stringify(['x'.repeat(10)])
+        ]);
+      } finally {
+        ipcMain.removeHandler('test');
+      }
+    });
+
+    it('replies with large plain strings', async () => {
+      const reply = 'x'.repeat(2000000) + '\u00e9\u4e2d'.repeat(1000000);
+      ipcMain.handleOnce('test', () => reply);
+      const result = await w.webContents.executeJavaScript(`
+        require('electron').ipcRenderer.invoke('test')
+      `);
+      expect(result).to.equal(reply);
+    });
   });
 
   describe('ordering', () => {
@@ -196,6 +277,101 @@ describe('ipc module', () => {
       expect(received).to.have.lengthOf(1000);
       expect(received).to.deep.equal([...received].sort((a, b) => a - b));
     });
+
+    it('between batched send, send, and sendSync is consistent', async () => {
+      const received: number[] = [];
+      ipcMain.on('test-batched', (e, i) => { received.push(i); });
+      ipcMain.on('test-async', (e, i) => { received.push(i); });
+      ipcMain.on('test-sync', (e, i) => { received.push(i); e.returnValue = null; });
+      const done = new Promise<void>(resolve => ipcMain.once('done', () => { resolve(); }));
+      async function rendererStressTest () {
+        const { ipcRenderer } = require('electron');
+        ipcRenderer.setBatched('test-batched', true);
+        for (let i = 0; i < 1000; i++) {
+          switch ((Math.random() * 4) | 0) {
+            case 0:
+            case 1:
+              ipcRenderer.send('test-batched', i);
+              break;
+            case 2:
+              ipcRenderer.send('test-async', i);
+              break;
+            case 3:
+              ipcRenderer.sendSync('test-sync', i);
+              break;
+          }
+          if (i % 100 === 0) await new Promise(resolve => setTimeout(resolve));
+        }
+        ipcRenderer.setBatched('test-batched', false);
+        ipcRenderer.send('done');
+      }
+      try {
+        w.webContents.executeJavaScript(`(${rendererStressTest})()`);
+        await done;
+      } finally {
+        ipcMain.removeAllListeners('test-batched');
+        ipcMain.removeAllListeners('test-async');
+        ipcMain.removeAllListeners('test-sync');
+      }
+      expect(received).to.have.lengthOf(1000);
+      expect(received).to.deep.equal([...received].sort((a, b) => a - b));
+    });
+  });
+
+  describe('batched send', () => {
+    afterEach(closeAllWindows);
+
+    it('delivers the messages of a task in order, with their arguments', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      const fromIpcMain: any[][] = [];
+      const fromWebContents: any[][] = [];
+      const senders = new Set<WebContents>();
+      ipcMain.on('test-batched', (e, ...args) => { fromIpcMain.push(args); senders.add(e.sender); });
+      w.webContents.on('ipc-message', (e, channel, ...args) => {
+        if (channel === 'test-batched') fromWebContents.push(args);
+      });
+      const done = new Promise<void>(resolve => ipcMain.once('done', () => { resolve(); }));
+      try {
+        w.webContents.executeJavaScript(`(${function () {
+          const { ipcRenderer } = require('electron');
+          ipcRenderer.setBatched('test-batched', true);
+          ipcRenderer.send('test-batched', 1, 'one');
+          ipcRenderer.send('test-batched', { two: [2] });
+          ipcRenderer.send('test-batched');
+          ipcRenderer.setBatched('test-batched', false);
+          ipcRenderer.send('done');
+        }})()`);
+        await done;
+      } finally {
+        ipcMain.removeAllListeners('test-batched');
+      }
+      const expected = [[1, 'one'], [{ two: [2] }], []];
+      expect(fromIpcMain).to.deep.equal(expected);
+      expect(fromWebContents).to.deep.equal(expected);
+      expect([...senders]).to.deep.equal([w.webContents]);
+    });
+
+    it('lets the listeners reply to the sender', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadURL('about:blank');
+      ipcMain.on('test-batched', (e, i) => { e.reply('test-reply', i * 2); });
+      try {
+        const replies = await w.webContents.executeJavaScript(`new Promise(resolve => {
+          const { ipcRenderer } = require('electron');
+          const replies = [];
+          ipcRenderer.on('test-reply', (e, value) => {
+            replies.push(value);
+            if (replies.length === 3) resolve(replies);
+          });
+          ipcRenderer.setBatched('test-batched', true);
+          for (let i = 1; i <= 3; i++) ipcRenderer.send('test-batched', i);
+        })`);
+        expect(replies).to.deep.equal([2, 4, 6]);
+      } finally {
+        ipcMain.removeAllListeners('test-batched');
+      }
+    });
   });
 
   describe('MessagePort', () => {
@@ -0,0 +1,41 @@
+import * as path from 'path';
+import { expect } from 'chai';
+import { nativeImage } from 'electron/common';
+
+describe('nativeImage module', () => {
+  const logoPath = path.join(__dirname, '..', 'spec', 'fixtures', 'assets', 'logo.png');
+
+  describe('async codecs in the main process', () => {
+    it('give the same results as the sync methods', async () => {
+      const image = nativeImage.createFromPath(logoPath);
+      expect((await image.toPNGAsync()).equals(image.toPNG())).to.be.true('png');
+      expect((await image.toJPEGAsync(80)).equals(image.toJPEG(80))).to.be.true('jpeg');
+
+      const resized = await image.resizeAsync({ width: 100 });
+      expect(resized.toBitmap().equals(image.resize({ width: 100 }).toBitmap())).to.be.true('resize');
+
+      const rect = { x: 10, y: 20, width: 30, height: 40 };
+      const cropped = await image.cropAsync(rect);
+      expect(cropped.getSize()).to.deep.equal({ width: 30, height: 40 });
+      expect(cropped.toBitmap().equals(image.crop(rect).toBitmap())).to.be.true('crop');
+
+      const decoded = await nativeImage.createFromBufferAsync(image.toPNG());
+      expect(decoded.toBitmap().equals(image.toBitmap())).to.be.true('decode');
+    });
+
+    it('rejects a decode of something other than a buffer', async () => {
+      await expect(nativeImage.createFromBufferAsync('not a buffer' as any)).to.eventually.be.rejectedWith('buffer must be a node Buffer');
+    });
+
+    it('work on the image as it was when called', async () => {
+      const buffer = nativeImage.createFromPath(logoPath).toBitmap();
+      const size = { width: 538, height: 190 };
+      const promise = nativeImage.createFromBufferAsync(buffer, size);
+      const expected = Buffer.from(buffer);
+      // The buffer is copied, so it can be reused right away.
+      buffer.fill(0);
+      const image = await promise;
+      expect(image.toBitmap().equals(expected)).to.be.true('decoded the original buffer');
+    });
+  });
+});
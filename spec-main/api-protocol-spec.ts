@@ -485,6 +485,271 @@ describe('protocol module', () => {
     });
   });
 
+  describe('protocol.createResponseWriter', () => {
+    it('sends the written data as response', async () => {
+      registerStreamProtocol(protocolName, (request, callback) => {
+        const writer = protocol.createResponseWriter();
+        callback({ mimeType: 'text/plain', data: writer });
+        writer.write(text.slice(0, 5));
+        writer.end(Buffer.from(text.slice(5)));
+      });
+      const r = await ajax(protocolName + '://fake-host');
+      expect(r.data).to.equal(text);
+      expect(r.status).to.equal(200);
+    });
+
+    it('can be written to before being sent', async () => {
+      registerStreamProtocol(protocolName, (request, callback) => {
+        const writer = protocol.createResponseWriter();
+        writer.end(text);
+        callback(writer);
+      });
+      const r = await ajax(protocolName + '://fake-host');
+      expect(r.data).to.equal(text);
+    });
+
+    it('signals when the pipe is full', async () => {
+      const chunk = Buffer.alloc(64 * 1024, 'a');
+      const chunks = 32;
+      let fullWrites = 0;
+      registerStreamProtocol(protocolName, (request, callback) => {
+        const writer = protocol.createResponseWriter({ capacity: chunk.length });
+        expect(writer.capacity).to.equal(chunk.length);
+        callback({ mimeType: 'text/plain', data: writer });
+        let written = 0;
+        const writeMore = () => {
+          while (written < chunks) {
+            written++;
+            if (!writer.write(chunk)) {
+              fullWrites++;
+              expect(writer.writableLength).to.be.greaterThan(0);
+              writer.once('drain', writeMore);
+              return;
+            }
+          }
+          writer.end();
+        };
+        writeMore();
+      });
+      const r = await ajax(protocolName + '://fake-host');
+      expect(r.data).to.have.lengthOf(chunk.length * chunks);
+      expect(fullWrites).to.be.greaterThan(0);
+    });
+
+    it('fails the request when destroyed', async () => {
+      registerStreamProtocol(protocolName, (request, callback) => {
+        const writer = protocol.createResponseWriter();
+        callback(writer);
+        writer.write(text);
+        writer.destroy();
+        expect(writer.destroyed).to.be.true('destroyed');
+        expect(writer.write(text)).to.be.false('write');
+      });
+      await expect(ajax(protocolName + '://fake-host')).to.eventually.be.rejected();
+    });
+
+    it('emits close when the request is aborted', async () => {
+      const events = new EventEmitter();
+      registerStreamProtocol(protocolName, (request, callback) => {
+        const writer = protocol.createResponseWriter({ capacity: 16 });
+        writer.on('close', () => events.emit('close'));
+        callback({ mimeType: 'text/plain', data: writer });
+        writer.write(Buffer.alloc(1024));
+        events.emit('respond');
+      });
+
+      const hasRespondedPromise = emittedOnce(events, 'respond');
+      const hasClosedPromise = emittedOnce(events, 'close');
+      ajax(protocolName + '://fake-host');
+      await hasRespondedPromise;
+      await contents.loadFile(path.join(__dirname, 'fixtures', 'pages', 'jquery.html'));
+      await hasClosedPromise;
+    });
+
+    it('can only be used for one response', async () => {
+      const writer = protocol.createResponseWriter();
+      writer.end(text);
+      registerStreamProtocol(protocolName, (request, callback) => callback(writer));
+      const r = await ajax(protocolName + '://fake-host');
+      expect(r.data).to.equal(text);
+      await expect(ajax(protocolName + '://fake-host')).to.eventually.be.rejected();
+    });
+
+    it('rejects invalid capacities', () => {
+      expect(() => protocol.createResponseWriter({ capacity: 0 })).to.throw(/capacity must be between/);
+      expect(() => protocol.createResponseWriter({ capacity: 128 * 1024 * 1024 })).to.throw(/capacity must be between/);
+    });
+  });
+
+  describe('protocol.registerDirectoryProtocol', () => {
+    const standardScheme = (global as any).standardScheme;
+    const pagesPath = path.join(fixturesPath, 'pages');
+    const asarPath = path.join(fixturesPath, 'test.asar', 'a.asar');
+    const normalContent = fs.readFileSync(path.join(pagesPath, 'a.html'), 'utf8');
+    const fileContent = fs.readFileSync(path.join(asarPath, 'file1'), 'utf8');
+
+    afterEach(() => {
+      unregisterProtocol(standardScheme);
+    });
+
+    // The requests are sent from the page, which must be of the same origin.
+    function request (url: string, headers: Record<string, string> = {}) {
+      return contents.executeJavaScript(`new Promise((resolve) => {
+        const xhr = new XMLHttpRequest();
+        xhr.open('GET', ${JSON.stringify(url)});
+        for (const [name, value] of Object.entries(${JSON.stringify(headers)})) {
+          xhr.setRequestHeader(name, value);
+        }
+        xhr.onloadend = () => resolve({
+          status: xhr.status,
+          etag: xhr.getResponseHeader('etag'),
+          data: xhr.responseText
+        });
+        xhr.send();
+      })`);
+    }
+
+    it('serves the files of the mapped directories and archives', async () => {
+      expect(protocol.registerDirectoryProtocol(standardScheme, { pages: pagesPath, asar: asarPath })).to.equal(true);
+      expect(protocol.isProtocolRegistered(standardScheme)).to.equal(true);
+
+      await contents.loadURL(`${standardScheme}://pages/a.html`);
+      const page = await request(`${standardScheme}://pages/a.html`);
+      expect(page.status).to.equal(200);
+      expect(page.data).to.equal(normalContent);
+      await contents.loadURL(`${standardScheme}://asar/file1`);
+      const file = await request(`${standardScheme}://asar/file1`);
+      expect(file.status).to.equal(200);
+      expect(file.data).to.equal(fileContent);
+    });
+
+    it('answers requests with a matching ETag with a 304', async () => {
+      protocol.registerDirectoryProtocol(standardScheme, { asar: asarPath });
+      const url = `${standardScheme}://asar/file1`;
+      await contents.loadURL(url);
+      const first = await request(url);
+      expect(first.etag).to.be.a('string');
+      const second = await request(url, { 'If-None-Match': first.etag });
+      expect(second.status).to.equal(304);
+      const other = await request(url, { 'If-None-Match': '"other"' });
+      expect(other.status).to.equal(200);
+      expect(other.data).to.equal(fileContent);
+    });
+
+    it('supports range requests', async () => {
+      protocol.registerDirectoryProtocol(standardScheme, { pages: pagesPath });
+      await contents.loadURL(`${standardScheme}://pages/a.html`);
+      const r = await request(`${standardScheme}://pages/a.html`, { Range: 'bytes=0-3' });
+      expect(r.data).to.equal(normalContent.substr(0, 4));
+    });
+
+    it('does not serve files outside of the directories', async () => {
+      protocol.registerDirectoryProtocol(standardScheme, { asar: asarPath });
+      await contents.loadURL(`${standardScheme}://asar/file1`);
+      const r = await request(`${standardScheme}://asar/..%2F..%2Fpages%2Fa.html`);
+      expect(r.status).to.not.equal(200);
+    });
+
+    it('fails when the scheme is already registered', () => {
+      expect(registerStringProtocol(standardScheme, (req, cb) => cb(''))).to.equal(true);
+      expect(protocol.registerDirectoryProtocol(standardScheme, { pages: pagesPath })).to.equal(false);
+    });
+
+    it('throws for relative paths', () => {
+      expect(() => protocol.registerDirectoryProtocol(standardScheme, { pages: 'pages' })).to.throw(/absolute paths/);
+    });
+  });
+
+  describe('protocol.enableResponseCache', () => {
+    afterEach(() => {
+      protocol.disableResponseCache(protocolName);
+    });
+
+    it('answers requests for fresh responses without the handler', async () => {
+      let calls = 0;
+      registerBufferProtocol(protocolName, (request, callback) => {
+        calls++;
+        callback({
+          mimeType: 'text/plain',
+          headers: { 'cache-control': 'max-age=3600' },
+          data: Buffer.from(text)
+        });
+      });
+      protocol.enableResponseCache(protocolName);
+      for (let i = 0; i < 3; i++) {
+        const r = await ajax(protocolName + '://fake-host/asset');
+        expect(r.data).to.equal(text);
+      }
+      expect(calls).to.equal(1);
+      const stats = protocol.getResponseCacheStats(protocolName);
+      expect(stats).to.include({ hits: 2, misses: 1, entries: 1 });
+    });
+
+    it('does not cache responses with no-store', async () => {
+      let calls = 0;
+      registerStringProtocol(protocolName, (request, callback) => {
+        calls++;
+        callback({
+          mimeType: 'text/plain',
+          headers: { 'cache-control': 'no-store' },
+          data: text
+        });
+      });
+      protocol.enableResponseCache(protocolName);
+      await ajax(protocolName + '://fake-host/asset');
+      await ajax(protocolName + '://fake-host/asset');
+      expect(calls).to.equal(2);
+      expect(protocol.getResponseCacheStats(protocolName)).to.include({ hits: 0, entries: 0 });
+    });
+
+    it('revalidates stale responses with their ETag', async () => {
+      const validators: (string | undefined)[] = [];
+      registerBufferProtocol(protocolName, (request, callback) => {
+        const validator = request.headers['If-None-Match'];
+        validators.push(validator);
+        if (validator === '"v1"') {
+          callback({ statusCode: 304, headers: { etag: '"v1"' }, data: Buffer.alloc(0) });
+          return;
+        }
+        callback({
+          mimeType: 'text/plain',
+          headers: { 'cache-control': 'no-cache', etag: '"v1"' },
+          data: Buffer.from(text)
+        });
+      });
+      protocol.enableResponseCache(protocolName);
+      const first = await ajax(protocolName + '://fake-host/asset');
+      const second = await ajax(protocolName + '://fake-host/asset');
+      expect(first.data).to.equal(text);
+      expect(second.data).to.equal(text);
+      expect(second.status).to.equal(200);
+      expect(validators).to.deep.equal([undefined, '"v1"']);
+      expect(protocol.getResponseCacheStats(protocolName)).to.include({ revalidations: 1 });
+    });
+
+    it('evicts responses beyond maxSize', async () => {
+      registerBufferProtocol(protocolName, (request, callback) => {
+        callback({
+          mimeType: 'text/plain',
+          headers: { 'cache-control': 'max-age=3600' },
+          data: Buffer.alloc(600, 'a')
+        });
+      });
+      protocol.enableResponseCache(protocolName, { maxSize: 1024 });
+      await ajax(protocolName + '://fake-host/a');
+      await ajax(protocolName + '://fake-host/b');
+      const stats = protocol.getResponseCacheStats(protocolName)!;
+      expect(stats.evictions).to.equal(1);
+      expect(stats.entries).to.equal(1);
+      expect(stats.size).to.be.at.most(1024);
+    });
+
+    it('returns null stats when disabled', () => {
+      expect(protocol.getResponseCacheStats(protocolName)).to.be.null();
+      expect(() => protocol.enableResponseCache(protocolName, { maxSize: 0 })).to.throw(/maxSize must be greater than 0/);
+    });
+  });
+
   describe('protocol.isProtocolRegistered', () => {
     it('returns false when scheme is not registered', () => {
       const result = protocol.isProtocolRegistered('no-exist');
@@ -31,6 +31,31 @@ describe('session module', () => {
     });
   });
 
+  describe('session.fromPartitionAsync(partition, options)', () => {
+    it('resolves with the existing session of the partition', async () => {
+      const ses = session.fromPartition('persist:test-async-existing');
+      expect(await session.fromPartitionAsync('persist:test-async-existing')).to.equal(ses);
+    });
+
+    it('creates sessions that are usable', async () => {
+      const partitions = [...Array(5).keys()].map(i => `persist:test-async-${i}`);
+      const sessions = await Promise.all(partitions.map(p => session.fromPartitionAsync(p)));
+      for (let i = 0; i < sessions.length; i++) {
+        expect(sessions[i]).to.equal(session.fromPartition(partitions[i]));
+        expect(sessions[i].isPersistent()).to.be.true();
+        expect(sessions[i].getUserAgent()).to.be.a('string');
+      }
+    });
+
+    it('returns the same session for concurrent calls', async () => {
+      const [a, b] = await Promise.all([
+        session.fromPartitionAsync('persist:test-async-concurrent'),
+        session.fromPartitionAsync('persist:test-async-concurrent')
+      ]);
+      expect(a).to.equal(b);
+    });
+  });
+
   describe('ses.cookies', () => {
     const name = '0';
     const value = '0';
@@ -181,6 +181,15 @@ describe('webRequest module', () => {
       expect(data).to.equal('/header/received');
     });
 
+    it('keeps changes made through the details object', async () => {
+      ses.webRequest.onBeforeSendHeaders((details, callback) => {
+        details.requestHeaders.Accept = '*/*;test/header';
+        callback({ requestHeaders: details.requestHeaders });
+      });
+      const { data } = await ajax(defaultURL);
+      expect(data).to.equal('/header/received');
+    });
+
     it('can change the request headers on a custom protocol redirect', async () => {
       protocol.registerStringProtocol('custom-scheme', (req, callback) => {
         if (req.url === 'custom-scheme://fake-host/redirect') {
@@ -453,6 +462,33 @@ describe('webRequest module', () => {
       const { data } = await ajax(defaultURL);
       expect(data).to.equal('/');
     });
+
+    it('can batch the details', async () => {
+      const batches: Electron.OnCompletedListenerDetails[][] = [];
+      ses.webRequest.onCompleted({ urls: ['*://*/*'], batched: true }, (batch: any) => {
+        expect(batch).to.be.an('array');
+        batches.push(batch);
+      });
+      await Promise.all([ajax(defaultURL + 'a'), ajax(defaultURL + 'b')]);
+      await new Promise(resolve => setTimeout(resolve, 100));
+      const urls = batches.flat().map(details => details.url).sort();
+      expect(urls).to.deep.equal([defaultURL + 'a', defaultURL + 'b']);
+      expect(batches[0][0].statusCode).to.equal(200);
+    });
+
+    it('only batches the events that end a request stage', () => {
+      expect(() => {
+        ses.webRequest.onBeforeRequest({ urls: ['*://*/*'], batched: true }, (details, callback) => callback({}));
+      }).to.throw(/Only onResponseStarted, onCompleted and onErrorOccurred can be batched/);
+      expect(() => {
+        ses.webRequest.onSendHeaders({ urls: ['*://*/*'], batched: true }, () => {});
+      }).to.throw(/Only onResponseStarted, onCompleted and onErrorOccurred can be batched/);
+      expect(() => {
+        ses.webRequest.onBeforeRedirect({ urls: ['*://*/*'], batched: true }, () => {});
+      }).to.throw(/Only onResponseStarted, onCompleted and onErrorOccurred can be batched/);
+      ses.webRequest.onSendHeaders(null);
+      ses.webRequest.onBeforeRedirect(null);
+    });
   });
 
   describe('webRequest.onErrorOccurred', () => {
@@ -472,6 +508,138 @@ describe('webRequest module', () => {
     });
   });
 
+  describe('lazy details', () => {
+    afterEach(() => {
+      ses.webRequest.onBeforeSendHeaders(null);
+      ses.webRequest.onCompleted(null);
+    });
+
+    it('behaves like plain properties', async () => {
+      let keys: string[] = [];
+      let json: any;
+      let sameObject = false;
+      ses.webRequest.onBeforeSendHeaders((details, callback) => {
+        keys = Object.keys(details);
+        json = JSON.parse(JSON.stringify(details));
+        sameObject = details.requestHeaders === details.requestHeaders;
+        callback({});
+      });
+      await ajax(defaultURL, { headers: { Custom: 'value' } });
+      expect(keys).to.include('requestHeaders');
+      expect(json.requestHeaders.Custom).to.equal('value');
+      expect(sameObject).to.be.true('same object on each read');
+    });
+
+    it('are filled in batched details', async () => {
+      const batches: Electron.OnCompletedListenerDetails[][] = [];
+      ses.webRequest.onCompleted({ urls: ['*://*/*'], batched: true }, (batch: any) => {
+        batches.push(batch);
+      });
+      await ajax(defaultURL);
+      await new Promise(resolve => setTimeout(resolve, 100));
+      const [details] = batches.flat();
+      expect(details.responseHeaders).to.be.an('object');
+      expect(details.responseHeaders!.Custom).to.deep.equal(['Header']);
+    });
+  });
+
+  describe('webRequest.setRules', () => {
+    afterEach(() => {
+      ses.webRequest.setRules([]);
+      ses.webRequest.onBeforeRequest(null);
+      ses.webRequest.onHeadersReceived(null);
+    });
+
+    it('blocks matching requests without calling listeners', async () => {
+      const urls: string[] = [];
+      ses.webRequest.onBeforeRequest((details, callback) => {
+        urls.push(details.url);
+        callback({});
+      });
+      ses.webRequest.setRules([{
+        condition: { urls: [defaultURL + 'blocked/*'] },
+        action: { type: 'block' }
+      }]);
+      await expect(ajax(defaultURL + 'blocked/a')).to.eventually.be.rejectedWith('404');
+      const { data } = await ajax(defaultURL + 'allowed');
+      expect(data).to.equal('/allowed');
+      expect(urls).to.deep.equal([defaultURL + 'allowed']);
+    });
+
+    it('matches resource types and methods', async () => {
+      ses.webRequest.setRules([{
+        condition: { resourceTypes: ['xhr'], methods: ['post'] },
+        action: { type: 'block' }
+      }]);
+      await expect(ajax(defaultURL, { type: 'POST', data: {} })).to.eventually.be.rejectedWith('404');
+      const { data } = await ajax(defaultURL);
+      expect(data).to.equal('/');
+    });
+
+    it('can redirect the request', async () => {
+      ses.webRequest.setRules([{
+        condition: { urls: [defaultURL + 'old'] },
+        action: { type: 'redirect', redirectURL: defaultURL + 'new' }
+      }]);
+      const { data } = await ajax(defaultURL + 'old');
+      expect(data).to.equal('/new');
+    });
+
+    it('can modify the request and response headers', async () => {
+      let called = false;
+      ses.webRequest.onHeadersReceived((details, callback) => {
+        called = true;
+        callback({});
+      });
+      ses.webRequest.setRules([{
+        action: {
+          type: 'modifyHeaders',
+          requestHeaders: [{ header: 'Accept', operation: 'set', value: '*/*;test/header' }],
+          responseHeaders: [{ header: 'Custom', operation: 'set', value: 'Changed' }]
+        }
+      }]);
+      const { data, headers } = await ajax(defaultURL);
+      expect(data).to.equal('/header/received');
+      expect(headers).to.match(/^custom: Changed$/m);
+      expect(called).to.be.false();
+    });
+
+    it('does not apply rules of lower priority than an allow rule', async () => {
+      ses.webRequest.setRules([{
+        action: { type: 'block' }
+      }, {
+        priority: 2,
+        condition: { urls: [defaultURL + 'allowed'] },
+        action: { type: 'allow' }
+      }]);
+      const { data } = await ajax(defaultURL + 'allowed');
+      expect(data).to.equal('/allowed');
+      await expect(ajax(defaultURL)).to.eventually.be.rejectedWith('404');
+    });
+
+    it('calls the listeners for requests an allow rule lets through', async () => {
+      ses.webRequest.setRules([{
+        condition: { urls: [defaultURL + 'allowed'] },
+        action: { type: 'allow' }
+      }]);
+      let called = false;
+      ses.webRequest.onBeforeRequest((details, callback) => {
+        called = true;
+        callback({ cancel: false });
+      });
+      const { data } = await ajax(defaultURL + 'allowed');
+      expect(data).to.equal('/allowed');
+      expect(called).to.be.true('listener called');
+    });
+
+    it('throws on invalid rules', () => {
+      expect(() => ses.webRequest.setRules([{ action: { type: 'unknown' } } as any])).to.throw(/Unknown rule action type/);
+      expect(() => ses.webRequest.setRules([{ action: { type: 'redirect' } }])).to.throw(/redirectURL/);
+      expect(() => ses.webRequest.setRules([{ condition: { urls: ['bad'] }, action: { type: 'block' } }])).to.throw(/Invalid url pattern/);
+      expect(() => ses.webRequest.setRules([{ condition: { resourceTypes: ['nope'] }, action: { type: 'block' } }])).to.throw(/Invalid resource type/);
+    });
+  });
+
   describe('WebSocket connections', () => {
     it('can be proxyed', async () => {
       // Setup server.
@@ -1,4 +1,5 @@
 import { expect } from 'chai';
+import * as fs from 'fs';
 import * as path from 'path';
 import * as url from 'url';
 import { BrowserWindow, ipcMain } from 'electron/main';
@@ -81,6 +82,62 @@ describe('asar package', () => {
     });
   });
 
+  describe('range requests', () => {
+    const readRange = async (w: BrowserWindow, file: string, range: string) => {
+      const fileUrl = url.pathToFileURL(file).href;
+      return w.webContents.executeJavaScript(`new Promise((resolve, reject) => {
+        const xhr = new XMLHttpRequest();
+        xhr.open('GET', ${JSON.stringify(fileUrl)});
+        xhr.setRequestHeader('Range', ${JSON.stringify(range)});
+        xhr.onload = () => resolve({ status: xhr.status, contentRange: xhr.getResponseHeader('Content-Range'), body: xhr.responseText });
+        xhr.onerror = () => reject(new Error('Failed to load ' + ${JSON.stringify(fileUrl)}));
+        xhr.send();
+      })`);
+    };
+
+    it('serves a single range', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { webSecurity: false } });
+      await w.loadFile(path.join(fixtures, 'pages', 'blank.html'));
+      const file = path.join(asarDir, 'a.asar', 'file1');
+      const content = fs.readFileSync(file, 'utf8');
+      const { status, contentRange, body } = await readRange(w, file, 'bytes=1-3');
+      expect(status).to.equal(206);
+      expect(contentRange).to.equal(`bytes 1-3/${content.length}`);
+      expect(body).to.equal(content.slice(1, 4));
+    });
+
+    it('serves multiple ranges as a multipart body', async () => {
+      const w = new BrowserWindow({ show: false, webPreferences: { webSecurity: false } });
+      await w.loadFile(path.join(fixtures, 'pages', 'blank.html'));
+      const file = path.join(asarDir, 'a.asar', 'file1');
+      const content = fs.readFileSync(file, 'utf8');
+      const { status, body } = await readRange(w, file, 'bytes=0-1,3-4');
+      expect(status).to.equal(206);
+      expect(body).to.include(`Content-Range: bytes 0-1/${content.length}\r\n\r\n${content.slice(0, 2)}\r\n`);
+      expect(body).to.include(`Content-Range: bytes 3-4/${content.length}\r\n\r\n${content.slice(3, 5)}\r\n`);
+      expect(body).to.match(/\r\n--\S+--\r\n$/);
+    });
+  });
+
+  describe('shared index', () => {
+    const file = path.join(asarDir, 'a.asar', 'file1');
+    const readFileAndGetSharedBytes = `(() => {
+      const binding = process._linkedBinding('electron_common_asar');
+      const before = binding.getSharedIndexBytes();
+      const content = require('fs').readFileSync(${JSON.stringify(file)}, 'utf8');
+      return { content, shared: binding.getSharedIndexBytes() - before };
+    })()`;
+
+    it('attaches renderers with node integration to the index of the browser', async () => {
+      const content = fs.readFileSync(file, 'utf8');
+      const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+      await w.loadFile(path.join(fixtures, 'pages', 'blank.html'));
+      const result = await w.webContents.executeJavaScript(readFileAndGetSharedBytes);
+      expect(result.content).to.equal(content);
+      expect(result.shared).to.be.greaterThan(0);
+    });
+  });
+
   describe('worker', () => {
     it('Worker can load asar file', async () => {
       const w = new BrowserWindow({ show: false });
@@ -0,0 +1,58 @@
+// Measures the throughput of small ipcRenderer.send messages, one by one and
+// batched, and the main process CPU time each of them costs.
+//
+//   electron spec-main/fixtures/apps/ipc-benchmark --messages=100000
+//
+// Prints one JSON line per mode.
+const { app, BrowserWindow, ipcMain } = require('electron');
+
+const messages = parseInt(app.commandLine.getSwitchValue('messages') || '100000', 10);
+const burst = parseInt(app.commandLine.getSwitchValue('burst') || '100', 10);
+
+function rendererSend (channel, batched, messages, burst) {
+  const { ipcRenderer } = require('electron');
+  ipcRenderer.setBatched(channel, batched);
+  let sent = 0;
+  (function sendBurst () {
+    for (let i = 0; i < burst && sent < messages; i++, sent++) {
+      ipcRenderer.send(channel, { index: sent, value: Math.random() });
+    }
+    if (sent < messages) setTimeout(sendBurst);
+  })();
+}
+
+async function run (w, batched) {
+  const channel = batched ? 'benchmark-batched' : 'benchmark-send';
+  let received = 0;
+  let start, startCpu;
+  const done = new Promise(resolve => {
+    ipcMain.on(channel, () => {
+      if (received === 0) {
+        start = process.hrtime.bigint();
+        startCpu = process.cpuUsage();
+      }
+      if (++received === messages) resolve();
+    });
+  });
+  w.webContents.executeJavaScript(
+    `(${rendererSend})(${JSON.stringify(channel)}, ${batched}, ${messages}, ${burst})`);
+  await done;
+  ipcMain.removeAllListeners(channel);
+
+  const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+  const cpu = process.cpuUsage(startCpu);
+  console.log(JSON.stringify({
+    mode: batched ? 'batched' : 'send',
+    messages,
+    messagesPerSecond: Math.round(messages / seconds),
+    mainProcessCpuMicrosPerMessage: (cpu.user + cpu.system) / messages
+  }));
+}
+
+app.whenReady().then(async () => {
+  const w = new BrowserWindow({ show: false, webPreferences: { nodeIntegration: true, contextIsolation: false } });
+  await w.loadURL('about:blank');
+  await run(w, false);
+  await run(w, true);
+  app.quit();
+});
@@ -0,0 +1,97 @@
+// Measures how long the main thread is blocked while encoding and resizing a
+// large image, with the synchronous NativeImage methods and their async
+// variants.
+//
+//   electron spec-main/fixtures/apps/native-image-benchmark --width=3840 --height=2160
+//
+// Prints one JSON line per operation and mode.
+const { app, nativeImage } = require('electron');
+
+const width = parseInt(app.commandLine.getSwitchValue('width') || '3840', 10);
+const height = parseInt(app.commandLine.getSwitchValue('height') || '2160', 10);
+const count = parseInt(app.commandLine.getSwitchValue('count') || '4', 10);
+
+function createImage () {
+  const buffer = Buffer.alloc(width * height * 4);
+  // Noise with some structure, so that the codecs have work to do.
+  let seed = 1;
+  for (let i = 0; i < buffer.length; i += 4) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    const x = (i / 4) % width;
+    buffer[i] = (x + (seed & 0x1f)) & 0xff;
+    buffer[i + 1] = (seed >> 8) & 0xff;
+    buffer[i + 2] = (x >> 2) & 0xff;
+    buffer[i + 3] = 0xff;
+  }
+  return nativeImage.createFromBitmap(buffer, { width, height });
+}
+
+// Samples the event loop, reporting the longest time it was not turning.
+function monitorEventLoop () {
+  let last = process.hrtime.bigint();
+  let longest = 0n;
+  const timer = setInterval(() => {
+    const now = process.hrtime.bigint();
+    if (now - last > longest) longest = now - last;
+    last = now;
+  }, 1);
+  return () => {
+    clearInterval(timer);
+    return Number(longest) / 1e6;
+  };
+}
+
+const operations = {
+  png: {
+    sync: image => image.toPNG(),
+    async: image => image.toPNGAsync()
+  },
+  jpeg: {
+    sync: image => image.toJPEG(90),
+    async: image => image.toJPEGAsync(90)
+  },
+  resize: {
+    sync: image => image.resize({ width: width / 2 }),
+    async: image => image.resizeAsync({ width: width / 2 })
+  }
+};
+
+async function run (image, name, mode) {
+  const operation = operations[name][mode];
+  const stopMonitor = monitorEventLoop();
+  // Lets the monitor take a first sample.
+  await new Promise(resolve => setTimeout(resolve, 10));
+
+  let blocked = 0;
+  const start = process.hrtime.bigint();
+  const pending = [];
+  for (let i = 0; i < count; i++) {
+    const callStart = process.hrtime.bigint();
+    pending.push(operation(image));
+    blocked += Number(process.hrtime.bigint() - callStart) / 1e6;
+    // Gives the event loop a turn between calls, like a real app would.
+    await new Promise(resolve => setImmediate(resolve));
+  }
+  await Promise.all(pending);
+  const total = Number(process.hrtime.bigint() - start) / 1e6;
+
+  console.log(JSON.stringify({
+    operation: name,
+    mode,
+    width,
+    height,
+    count,
+    totalMs: total,
+    callBlockingMs: blocked,
+    longestEventLoopStallMs: stopMonitor()
+  }));
+}
+
+app.whenReady().then(async () => {
+  const image = createImage();
+  for (const name of Object.keys(operations)) {
+    await run(image, name, 'sync');
+    await run(image, name, 'async');
+  }
+  app.quit();
+});
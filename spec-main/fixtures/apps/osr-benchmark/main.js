@@ -0,0 +1,68 @@
+// Measures the frame rate and CPU usage of offscreen rendering, with the
+// paint event allocating a frame each time and with a pool of frame buffers.
+//
+//   electron spec-main/fixtures/apps/osr-benchmark --width=3840 --height=2160
+//
+// Prints one JSON line per mode.
+const { app, BrowserWindow } = require('electron');
+
+const width = parseInt(app.commandLine.getSwitchValue('width') || '1920', 10);
+const height = parseInt(app.commandLine.getSwitchValue('height') || '1080', 10);
+const seconds = parseFloat(app.commandLine.getSwitchValue('seconds') || '5');
+const frameBuffers = parseInt(app.commandLine.getSwitchValue('frame-buffers') || '3', 10);
+
+const page = `data:text/html,<body style="margin:0"><script>
+  (function frame (time) {
+    document.body.style.background = 'hsl(' + (time / 10 % 360) + ', 50%, 50%)';
+    requestAnimationFrame(frame);
+  })(0);
+</script></body>`;
+
+async function run (frameBufferCount) {
+  const w = new BrowserWindow({
+    width,
+    height,
+    show: false,
+    webPreferences: { offscreen: true, backgroundThrottling: false }
+  });
+  w.webContents.setFrameRate(60);
+  w.webContents.setFrameBufferCount(frameBufferCount);
+
+  let frames = 0;
+  let checksum = 0;
+  w.webContents.on('paint', (event, dirty, image, frame) => {
+    // Reads the pixels the way a consumer would.
+    const pixels = frame.buffer || image.toBitmap();
+    checksum = (checksum + pixels[pixels.length >> 1]) | 0;
+    if (frame.release) frame.release();
+    frames++;
+  });
+  await w.loadURL(page);
+  // Lets the first frames settle.
+  await new Promise(resolve => setTimeout(resolve, 500));
+
+  frames = 0;
+  app.getAppMetrics();
+  const startCpu = process.cpuUsage();
+  await new Promise(resolve => setTimeout(resolve, seconds * 1000));
+  const cpu = process.cpuUsage(startCpu);
+  const totalCpuPercent = app.getAppMetrics()
+    .reduce((total, metric) => total + metric.cpu.percentCPUUsage, 0);
+  w.destroy();
+
+  console.log(JSON.stringify({
+    mode: frameBufferCount ? 'frame-buffers' : 'image',
+    width,
+    height,
+    fps: frames / seconds,
+    mainProcessCpuPercent: (cpu.user + cpu.system) / (seconds * 1e4),
+    totalCpuPercent,
+    checksum
+  }));
+}
+
+app.whenReady().then(async () => {
+  await run(0);
+  await run(frameBuffers);
+  app.quit();
+});
@@ -0,0 +1,91 @@
+// Measures the main process cost of webRequest listeners per request, with
+// no listener, with listeners reading a few fields or all of them, and with
+// batched listeners.
+//
+//   electron spec-main/fixtures/apps/web-request-benchmark --requests=2000
+//
+// Prints one JSON line per mode.
+const { app, BrowserWindow, session } = require('electron');
+const http = require('http');
+
+const requests = parseInt(app.commandLine.getSwitchValue('requests') || '2000', 10);
+
+const modes = {
+  none: () => {},
+  'url only': (webRequest) => {
+    webRequest.onBeforeRequest((details, callback) => callback({}));
+    webRequest.onHeadersReceived((details, callback) => {
+      callback({ cancel: details.url === '' });
+    });
+    webRequest.onCompleted((details) => details.url);
+  },
+  'all fields': (webRequest) => {
+    webRequest.onBeforeRequest((details, callback) => {
+      callback({ cancel: details.uploadData === null });
+    });
+    webRequest.onHeadersReceived((details, callback) => {
+      callback({ responseHeaders: details.responseHeaders });
+    });
+    webRequest.onCompleted((details) => details.responseHeaders);
+  },
+  batched: (webRequest) => {
+    webRequest.onBeforeRequest((details, callback) => callback({}));
+    webRequest.onHeadersReceived((details, callback) => {
+      callback({ cancel: details.url === '' });
+    });
+    webRequest.onCompleted({ urls: ['*://*/*'], batched: true }, (batch) => {
+      batch.forEach(details => details.url);
+    });
+  }
+};
+
+function clearListeners (webRequest) {
+  webRequest.onBeforeRequest(null);
+  webRequest.onHeadersReceived(null);
+  webRequest.onCompleted(null);
+}
+
+async function run (contents, url, mode) {
+  const { webRequest } = session.defaultSession;
+  modes[mode](webRequest);
+
+  const cpuStart = process.cpuUsage();
+  const start = process.hrtime.bigint();
+  // Eight requests in flight at a time, like a page loading its resources.
+  await contents.executeJavaScript(`(async () => {
+    for (let i = 0; i < ${requests}; i += 8) {
+      const count = Math.min(8, ${requests} - i);
+      await Promise.all(Array.from({ length: count }, (_, j) => fetch('${url}' + (i + j))));
+    }
+  })()`);
+  const total = Number(process.hrtime.bigint() - start) / 1e6;
+  const cpu = process.cpuUsage(cpuStart);
+  clearListeners(webRequest);
+
+  console.log(JSON.stringify({
+    mode,
+    requests,
+    totalMs: total,
+    requestsPerSecond: requests / (total / 1000),
+    mainProcessCpuUsPerRequest: (cpu.user + cpu.system) / requests
+  }));
+}
+
+app.whenReady().then(async () => {
+  const server = http.createServer((req, res) => {
+    res.setHeader('Content-Type', 'text/plain');
+    res.setHeader('Cache-Control', 'no-store');
+    res.setHeader('X-Padding', 'x'.repeat(200));
+    res.end('ok');
+  });
+  await new Promise(resolve => server.listen(0, '127.0.0.1', resolve));
+  const url = `http://127.0.0.1:${server.address().port}/`;
+
+  const w = new BrowserWindow({ show: false });
+  await w.loadURL(url);
+  for (const mode of Object.keys(modes)) {
+    await run(w.webContents, url, mode);
+  }
+  server.close();
+  app.quit();
+});
@@ -3,6 +3,8 @@
 const { expect } = require('chai');
 const { nativeImage } = require('electron');
 const { ifdescribe, ifit } = require('./spec-helpers');
+const fs = require('fs');
+const os = require('os');
 const path = require('path');
 
 describe('nativeImage module', () => {
@@ -183,6 +185,65 @@ describe('nativeImage module', () => {
       expect(() => nativeImage.createFromBitmap(Buffer.from([]), {})).to.throw('width is required');
       expect(() => nativeImage.createFromBitmap(Buffer.from([]), { width: 1 })).to.throw('height is required');
       expect(() => nativeImage.createFromBitmap(Buffer.from([]), { width: 1, height: 1 })).to.throw('invalid buffer size');
+      expect(() => nativeImage.createFromBitmap(Buffer.from([]), { width: 1, height: 1, format: 'argb' })).to.throw(/format must be/);
+    });
+
+    it('reads the given format', () => {
+      const rgba = Buffer.from([255, 0, 0, 255, 0, 0, 255, 255]);
+      const image = nativeImage.createFromBitmap(rgba, { width: 2, height: 1, format: 'rgba' });
+      expect(image.toBitmap({ format: 'rgba' }).equals(rgba)).to.be.true();
+      expect([...image.toBitmap({ format: 'bgra' })]).to.deep.equal([0, 0, 255, 255, 255, 0, 0, 255]);
+
+      const gray = nativeImage.createFromBitmap(Buffer.from([0, 255]), { width: 2, height: 1, format: 'gray' });
+      expect([...gray.toBitmap({ format: 'rgba' })]).to.deep.equal([0, 0, 0, 255, 255, 255, 255, 255]);
+    });
+  });
+
+  describe('toBitmap(options)', () => {
+    const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+
+    it('swaps the channels between rgba and bgra', () => {
+      const rgba = image.toBitmap({ format: 'rgba' });
+      const bgra = image.toBitmap({ format: 'bgra' });
+      expect(rgba.length).to.equal(538 * 190 * 4);
+      for (let i = 0; i < rgba.length; i += 4) {
+        if (rgba[i] !== bgra[i + 2] || rgba[i + 2] !== bgra[i] ||
+            rgba[i + 1] !== bgra[i + 1] || rgba[i + 3] !== bgra[i + 3]) {
+          expect.fail(`pixel ${i / 4} differs`);
+        }
+      }
+      // Skia keeps pixels in BGRA order on the desktop platforms.
+      expect(image.toBitmap().equals(bgra)).to.be.true();
+    });
+
+    it('returns one byte per pixel for gray', () => {
+      expect(image.toBitmap({ format: 'gray' }).length).to.equal(538 * 190);
+    });
+
+    it('unpremultiplies the colors', () => {
+      const premultiplied = Buffer.from([64, 32, 0, 128]);
+      const translucent = nativeImage.createFromBitmap(premultiplied, { width: 1, height: 1, format: 'rgba' });
+      const [r, g, b, a] = translucent.toBitmap({ format: 'rgba', premultiplied: false });
+      expect(a).to.equal(128);
+      expect(r).to.be.within(126, 129);
+      expect(g).to.be.within(62, 65);
+      expect(b).to.equal(0);
+    });
+
+    it('writes into the given buffer', () => {
+      const rect = { width: 25, height: 64, x: 30, y: 40 };
+      const memory = new ArrayBuffer(25 * 64 * 4 + 16);
+      const target = Buffer.from(memory, 16);
+      const bitmap = image.toBitmap({ rect, format: 'rgba', buffer: target });
+      expect(bitmap.buffer).to.equal(memory);
+      expect(bitmap.byteOffset).to.equal(16);
+      expect(bitmap.equals(image.crop(rect).toBitmap({ format: 'rgba' }))).to.be.true();
+    });
+
+    it('throws on invalid arguments', () => {
+      expect(() => image.toBitmap({ format: 'argb' })).to.throw(/format must be/);
+      expect(() => image.toBitmap({ buffer: 'pixels' })).to.throw(/buffer must be/);
+      expect(() => image.toBitmap({ buffer: Buffer.alloc(4) })).to.throw('buffer is too small');
     });
   });
 
@@ -236,6 +297,27 @@ describe('nativeImage module', () => {
     });
   });
 
+  describe('createFromBufferAsync(buffer, options)', () => {
+    it('decodes like createFromBuffer()', async () => {
+      const imageA = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+
+      const imageB = await nativeImage.createFromBufferAsync(imageA.toPNG());
+      expect(imageB.getSize()).to.deep.equal({ width: 538, height: 190 });
+      expect(imageA.toBitmap().equals(imageB.toBitmap())).to.be.true();
+
+      const imageC = await nativeImage.createFromBufferAsync(imageA.toBitmap(),
+        { width: 538, height: 190, scaleFactor: 2.0 });
+      expect(imageC.getSize()).to.deep.equal({ width: 269, height: 95 });
+
+      const imageD = await nativeImage.createFromBufferAsync(Buffer.from([1, 2, 3, 4]));
+      expect(imageD.isEmpty()).to.be.true();
+    });
+
+    it('rejects on invalid arguments', async () => {
+      await expect(nativeImage.createFromBufferAsync(null)).to.eventually.be.rejectedWith('buffer must be a node Buffer');
+    });
+  });
+
   describe('createFromDataURL(dataURL)', () => {
     it('returns an empty image from the empty string', () => {
       expect(nativeImage.createFromDataURL('').isEmpty()).to.be.true();
@@ -339,6 +421,32 @@ describe('nativeImage module', () => {
     });
   });
 
+  describe('toPNGAsync()', () => {
+    it('encodes like toPNG()', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      expect((await image.toPNGAsync()).equals(image.toPNG())).to.be.true();
+
+      const resized = image.resize({ width: 100 });
+      const png = await resized.toPNGAsync();
+      expect(nativeImage.createFromBuffer(png).toBitmap().equals(resized.toBitmap())).to.be.true();
+    });
+
+    it('encodes many images at once', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const sizes = [10, 20, 30, 40, 50, 60, 70, 80, 90, 100];
+      const buffers = await Promise.all(sizes.map(width => image.resize({ width }).toPNGAsync()));
+      expect(buffers.map(buffer => nativeImage.createFromBuffer(buffer).getSize().width)).to.deep.equal(sizes);
+    });
+  });
+
+  describe('toJPEGAsync()', () => {
+    it('encodes like toJPEG()', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      expect((await image.toJPEGAsync(80)).equals(image.toJPEG(80))).to.be.true();
+      expect(await nativeImage.createEmpty().toJPEGAsync(80)).to.be.empty();
+    });
+  });
+
   describe('createFromPath(path)', () => {
     it('returns an empty image for invalid paths', () => {
       expect(nativeImage.createFromPath('').isEmpty()).to.be.true();
@@ -446,6 +554,33 @@ describe('nativeImage module', () => {
     });
   });
 
+  describe('resizeAsync(options)', () => {
+    it('returns a resized image', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      for (const [resizeTo, expectedSize] of new Map([
+        [{}, { width: 538, height: 190 }],
+        [{ width: 269 }, { width: 269, height: 95 }],
+        [{ height: 200 }, { width: 566, height: 200 }],
+        [{ width: 80, height: 65 }, { width: 80, height: 65 }],
+        [{ width: -1, height: -1 }, { width: 0, height: 0 }]
+      ])) {
+        const resized = await image.resizeAsync(resizeTo);
+        expect(resized.getSize()).to.deep.equal(expectedSize);
+      }
+    });
+
+    it('matches resize()', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const options = { width: 100, height: 100, quality: 'good' };
+      const resized = await image.resizeAsync(options);
+      expect(resized.toBitmap().equals(image.resize(options).toBitmap())).to.be.true();
+    });
+
+    it('returns an empty image when called on an empty image', async () => {
+      expect((await nativeImage.createEmpty().resizeAsync({ width: 1, height: 1 })).isEmpty()).to.be.true();
+    });
+  });
+
   describe('crop(bounds)', () => {
     it('returns an empty image when called on an empty image', () => {
       expect(nativeImage.createEmpty().crop({ width: 1, height: 2, x: 0, y: 0 }).isEmpty()).to.be.true();
@@ -474,6 +609,22 @@ describe('nativeImage module', () => {
       const crop = image.crop({ width: 25, height: 64, x: 0, y: 0 });
       expect(crop.toBitmap().length).to.equal(25 * 64 * 4);
     });
+
+    it('matches toBitmap({ rect })', () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const rect = { width: 25, height: 64, x: 30, y: 40 };
+      expect(image.toBitmap({ rect }).equals(image.crop(rect).toBitmap())).to.be.true();
+      expect(image.toBitmap({ rect: { width: 100, height: 100, x: 1000, y: 1000 } })).to.be.empty();
+    });
+
+    it('matches cropAsync()', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const rect = { width: 25, height: 64, x: 30, y: 40 };
+      const cropped = await image.cropAsync(rect);
+      expect(cropped.getSize()).to.deep.equal({ width: 25, height: 64 });
+      expect(cropped.toBitmap().equals(image.crop(rect).toBitmap())).to.be.true();
+      expect((await image.cropAsync({ width: 100, height: 100, x: 1000, y: 1000 })).isEmpty()).to.be.true();
+    });
   });
 
   describe('getAspectRatio()', () => {
@@ -517,6 +668,47 @@ describe('nativeImage module', () => {
     });
   });
 
+  describe('createThumbnailsFromPaths(paths, size)', () => {
+    it('rejects when the size is empty', async () => {
+      await expect(
+        nativeImage.createThumbnailsFromPaths([], { width: 0, height: 0 })
+      ).to.eventually.be.rejectedWith('size must not be empty');
+    });
+
+    it('returns a thumbnail per path', async () => {
+      const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png');
+      const thumbnails = await nativeImage.createThumbnailsFromPaths(
+        [logoPath, 'does-not-exist.png', logoPath], { width: 100, height: 100 });
+      expect(thumbnails).to.have.lengthOf(3);
+      expect(thumbnails[0].getSize()).to.deep.equal({ width: 100, height: 35 });
+      expect(thumbnails[1].isEmpty()).to.be.true();
+      expect(thumbnails[2].toBitmap().equals(thumbnails[0].toBitmap())).to.be.true();
+    });
+
+    it('decodes JPEG files to scale', async () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'logo.png'));
+      const jpegPath = path.join(os.tmpdir(), `electron-thumbnail-${process.pid}.jpg`);
+      fs.writeFileSync(jpegPath, image.toJPEG(90));
+      try {
+        const [thumbnail] = await nativeImage.createThumbnailsFromPaths([jpegPath], { width: 64, height: 64 });
+        expect(thumbnail.getSize()).to.deep.equal({ width: 64, height: 22 });
+      } finally {
+        fs.unlinkSync(jpegPath);
+      }
+    });
+
+    it('does not scale small images up', async () => {
+      const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png');
+      nativeImage.setThumbnailCacheLimit(0);
+      try {
+        const [thumbnail] = await nativeImage.createThumbnailsFromPaths([logoPath], { width: 1000, height: 1000 });
+        expect(thumbnail.getSize()).to.deep.equal({ width: 538, height: 190 });
+      } finally {
+        nativeImage.setThumbnailCacheLimit(64 * 1024 * 1024);
+      }
+    });
+  });
+
   describe('addRepresentation()', () => {
     it('does not add representation when the buffer is too small', () => {
       const image = nativeImage.createEmpty();
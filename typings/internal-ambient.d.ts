@@ -32,6 +32,7 @@ declare namespace NodeJS {
 
   interface IpcRendererBinding {
     send(internal: boolean, channel: string, args: any[]): void;
+    sendBatched(channel: string, args: any[]): void;
     sendSync(internal: boolean, channel: string, args: any[]): any;
     sendToHost(channel: string, args: any[]): void;
     sendTo(webContentsId: number, channel: string, args: any[]): void;
@@ -78,8 +79,12 @@ declare namespace NodeJS {
     getFileInfo(path: string): AsarFileInfo | false;
     stat(path: string): AsarFileStat | false;
     readdir(path: string): string[] | false;
+    readdirMany(paths: string[]): ({ names: string[]; types: number[] } | false)[];
     realpath(path: string): string | false;
     copyFileOut(path: string): string | false;
+    readFile(path: string): Buffer | false;
+    readFileString(path: string): string | false;
+    writeIndex(path?: string): boolean;
     getFdAndValidateIntegrityLater(): number | -1;
   }
 
@@ -93,6 +98,7 @@ declare namespace NodeJS {
       filePath: string;
     };
     initAsarSupport(require: NodeJS.Require): void;
+    getSharedIndexBytes(): number;
   }
 
   interface PowerMonitorBinding extends Electron.PowerMonitor {
@@ -72,6 +72,9 @@ declare namespace Electron {
     _print(options: any, callback?: (success: boolean, failureReason: string) => void): void;
     _getPrinters(): Electron.PrinterInfo[];
     _getPrintersAsync(): Promise<Electron.PrinterInfo[]>;
+    _startRecording(options: any): void;
+    _setRecordingPaused(paused: boolean): void;
+    _stopRecording(): Promise<any>;
     _init(): void;
     canGoToIndex(index: number): boolean;
     getActiveIndex(): number;